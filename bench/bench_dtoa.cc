@@ -7,23 +7,20 @@
 #include <climits>
 #include <cmath>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
 #include <algorithm>
 #include <chrono>
 #include <random>
+#include <string>
 #include <vector>
 
 #include <math.h>
 
-#define BENCH_RYU()             0
-#define BENCH_STD_PRINTF()      0
-#define BENCH_STD_CHARCONV()    0
-#define BENCH_SCHUBFACH()       0
-#define BENCH_GRISU2()          0
-#define BENCH_GRISU2B()         0
-#define BENCH_GRISU3()          1
-#define BENCH_DRAGONBOX()       0
+// All algorithms below are compiled into a single binary and register side by side, so a full
+// cross-algorithm sweep is one run under identical process conditions. Use --algo=<name>[,<name>]*
+// to restrict the run to a subset (or --benchmark_filter, which matches the full benchmark name).
 
 #define BENCH_SINGLE()          0
 #define BENCH_DOUBLE()          1
@@ -34,8 +31,28 @@
 //
 //==================================================================================================
 
-#if BENCH_RYU()
-struct D2S
+#include "dragonbox.h"
+#include "dragonbox_32.h"
+#include "dtoa_cache.h"
+#include "itoa.h"
+#include "grisu2.h"
+#include "grisu2_32.h"
+#include "grisu2b.h"
+#include "grisu3.h"
+#include "schubfach_32.h"
+#include "schubfach_64.h"
+
+#include "stress_gen.h"
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
+// The vendored reference implementations, built from ext/ and run in the same process on the
+// same inputs as our own engines.
+#include "double-conversion/double-conversion.h"
+#include "ryu/ryu.h"
+
+struct D2S_Ryu
 {
     static char const* Name() { return "ryu"; }
     char* operator()(char* buf, int /*buflen*/, float f) const { return ryu::Ftoa(buf, f); }
@@ -44,79 +61,107 @@ struct D2S
     static ryu::FloatingDecimal64 ToDec(double value) { return ryu::ToDecimal64(value); }
 #endif
 };
-#endif
 
-#if BENCH_STD_PRINTF()
-struct D2S
+struct D2S_StdPrintf
 {
     static char const* Name() { return "std::printf"; }
     char* operator()(char* buf, int buflen, float f) const { return buf + std::snprintf(buf, static_cast<size_t>(buflen), "%.9g", f); }
     char* operator()(char* buf, int buflen, double f) const { return buf + std::snprintf(buf, static_cast<size_t>(buflen), "%.17g", f); }
 };
-#endif
 
-#if BENCH_STD_CHARCONV()
-#include <charconv>
-struct D2S
+#if defined(__cpp_lib_to_chars)
+struct D2S_StdCharconv
 {
-#if 0
-    static char const* Name() { return "std::charconv::general"; }
-    char* operator()(char* buf, int buflen, float f) const { return std::to_chars(buf, buf + buflen, f, std::chars_format::general).ptr; }
-    char* operator()(char* buf, int buflen, double f) const { return std::to_chars(buf, buf + buflen, f, std::chars_format::general).ptr; }
-#else
     static char const* Name() { return "std::charconv"; }
     char* operator()(char* buf, int buflen, float f) const { return std::to_chars(buf, buf + buflen, f).ptr; }
     char* operator()(char* buf, int buflen, double f) const { return std::to_chars(buf, buf + buflen, f).ptr; }
-#endif
 };
 #endif
 
-#if BENCH_SCHUBFACH()
-#include "schubfach_32.h"
-#include "schubfach_64.h"
-struct D2S
+struct D2S_Schubfach
 {
     static char const* Name() { return "schubfach"; }
     char* operator()(char* buf, int /*buflen*/, float f) const { return schubfach::Ftoa(buf, f); }
     char* operator()(char* buf, int /*buflen*/, double f) const { return schubfach::Dtoa(buf, f); }
-};
+#if BENCH_TO_DECIMAL()
+    static schubfach::FloatingDecimal64 ToDec(double value) { return schubfach::ToDecimal64(value); }
 #endif
+};
 
-#if BENCH_GRISU2()
-#include "grisu2.h"
-struct D2S
+// The fused storage-layer operation: format, then immediately reparse the same cache-hot
+// buffer (a self-verifying writer; see drachennest::RoundTripCheck in src/round_trip.h).
+// Registered next to the plain engines, so the incremental cost of the verifying read over
+// schubfach alone is directly visible per scenario.
+struct D2S_SchubfachRoundTrip
+{
+    static char const* Name() { return "schubfach+strtod"; }
+    char* operator()(char* buf, int /*buflen*/, double f) const
+    {
+        char* const end = schubfach::Dtoa(buf, f);
+        double parsed = 0;
+        const auto res = ryu::Strtod(buf, end, parsed);
+        return (res && res.next == end && !(parsed < f) && !(parsed > f)) ? end : buf;
+    }
+};
+
+struct D2S_CachedSchubfach
+{
+    static char const* Name() { return "schubfach-cached"; }
+    char* operator()(char* buf, int /*buflen*/, double f) const { return drachennest::CachedDtoa(buf, f); }
+};
+
+struct D2S_Grisu2
 {
     static char const* Name() { return "grisu2"; }
+    char* operator()(char* buf, int /*buflen*/, float f) const { return grisu2::Ftoa(buf, f); }
     char* operator()(char* buf, int /*buflen*/, double f) const { return grisu2::Dtoa(buf, f); }
 };
-#endif
 
-#if BENCH_GRISU2B()
-#include "grisu2b.h"
-struct D2S
+struct D2S_Grisu2b
 {
     static char const* Name() { return "grisu2b"; }
     char* operator()(char* buf, int /*buflen*/, double f) const { return grisu2b::Dtoa(buf, f); }
 };
-#endif
 
-#if BENCH_GRISU3()
-#include "grisu3.h"
-struct D2S
+struct D2S_Grisu3
 {
     static char const* Name() { return "grisu3"; }
     char* operator()(char* buf, int /*buflen*/, double f) const { return grisu3::Dtoa(buf, f); }
 };
-#endif
 
-#if BENCH_DRAGONBOX()
-#include "dragonbox.h"
-struct D2S
+struct D2S_DoubleConversion
+{
+    static char const* Name() { return "double-conversion"; }
+    char* operator()(char* buf, int buflen, float f) const
+    {
+        double_conversion::StringBuilder builder(buf, buflen);
+        double_conversion::DoubleToStringConverter::EcmaScriptConverter().ToShortestSingle(f, &builder);
+        return buf + builder.position();
+    }
+    char* operator()(char* buf, int buflen, double f) const
+    {
+        double_conversion::StringBuilder builder(buf, buflen);
+        double_conversion::DoubleToStringConverter::EcmaScriptConverter().ToShortest(f, &builder);
+        return buf + builder.position();
+    }
+};
+
+struct D2S_RyuUpstream
+{
+    static char const* Name() { return "ryu-upstream"; }
+    char* operator()(char* buf, int /*buflen*/, float f) const { return buf + f2s_buffered_n(f, buf); }
+    char* operator()(char* buf, int /*buflen*/, double f) const { return buf + d2s_buffered_n(f, buf); }
+};
+
+struct D2S_Dragonbox
 {
     static char const* Name() { return "dragonbox"; }
+    char* operator()(char* buf, int /*buflen*/, float f) const { return dragonbox::Ftoa(buf, f); }
     char* operator()(char* buf, int /*buflen*/, double f) const { return dragonbox::Dtoa(buf, f); }
-};
+#if BENCH_TO_DECIMAL()
+    static dragonbox::FloatingDecimal64 ToDec(double value) { return dragonbox::ToDecimal64(value); }
 #endif
+};
 
 //==================================================================================================
 //
@@ -174,7 +219,7 @@ public:
     uint32_t operator()() { return Gen(); }
 };
 
-static JenkinsRandom random;
+static JenkinsRandom rng;
 
 //==================================================================================================
 //
@@ -204,51 +249,413 @@ static inline char const* StrPrintf(char const* format, Args&&... args)
 #endif
 }
 
+
+//--------------------------------------------------------------------------------------------------
+// Hardware counters
+//--------------------------------------------------------------------------------------------------
+
+// On Linux the measured loop is bracketed by perf_event counters (instructions, L1d misses,
+// LLC misses, branch misses), reported per conversion next to the timing -- i.e. not just
+// that schubfach beats dragonbox on a distribution, but whether it does so on executed
+// instructions or on cache behavior. Counters that the kernel refuses (perf is often
+// unavailable in containers) are silently skipped.
+
+#if defined(__linux__)
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+class PerfCounters
+{
+    static constexpr int NumEvents = 4;
+
+    struct Event {
+        char const* name;
+        uint32_t type;
+        uint64_t config;
+    };
+
+    static constexpr Event kEvents[NumEvents] = {
+        { "instructions",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { "branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        { "L1d-misses",    PERF_TYPE_HW_CACHE,
+            PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { "LLC-misses",    PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    };
+
+    int fds[NumEvents];
+
+public:
+    PerfCounters()
+    {
+        for (int i = 0; i < NumEvents; ++i)
+        {
+            perf_event_attr attr = {};
+            attr.size = sizeof(attr);
+            attr.type = kEvents[i].type;
+            attr.config = kEvents[i].config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+    }
+
+    ~PerfCounters()
+    {
+        for (int i = 0; i < NumEvents; ++i)
+        {
+            if (fds[i] >= 0)
+                close(fds[i]);
+        }
+    }
+
+    void Start()
+    {
+        for (int i = 0; i < NumEvents; ++i)
+        {
+            if (fds[i] >= 0)
+            {
+                ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+                ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    // Stops the counters and reports each as a per-iteration benchmark counter.
+    void StopAndReport(benchmark::State& state)
+    {
+        for (int i = 0; i < NumEvents; ++i)
+        {
+            if (fds[i] < 0)
+                continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t count = 0;
+            if (read(fds[i], &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count)))
+            {
+                state.counters[kEvents[i].name] =
+                    benchmark::Counter(static_cast<double>(count), benchmark::Counter::kAvgIterations);
+            }
+        }
+    }
+};
+
+constexpr PerfCounters::Event PerfCounters::kEvents[];
+
+#else // !__linux__
+
+class PerfCounters
+{
+public:
+    void Start() {}
+    void StopAndReport(benchmark::State&) {}
+};
+
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// Latency-distribution mode (--latency)
+//--------------------------------------------------------------------------------------------------
+
+// With --latency every conversion is timed individually (rdtsc on x86, steady_clock
+// elsewhere) and recorded into a log-linear histogram; p50/p99/p99.9/max are reported as
+// extra counters (in cycles resp. ns). The per-call timing adds a fixed overhead to every
+// sample -- use the default mode for throughput numbers and this mode to see the tails
+// (i.e. where the grisu3 -> dragon4 fallback or a subnormal blows a deadline).
+static bool g_latency_mode = false;
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+static inline uint64_t TickNow()
+{
+    return __rdtsc();
+}
+static constexpr char const* TickUnit = "cy";
+#else
+static inline uint64_t TickNow()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+static constexpr char const* TickUnit = "ns";
+#endif
+
+// Log-linear buckets in the style of HdrHistogram: exact up to 32, then 16 sub-buckets per
+// power of two (<= ~6% relative error), which is plenty for percentile reporting.
+struct LatencyHistogram
+{
+    static constexpr int NumBuckets = 32 + 59 * 16;
+
+    uint64_t counts[NumBuckets] = {};
+    uint64_t total = 0;
+
+    static int BucketIndex(uint64_t v)
+    {
+        if (v < 32)
+            return static_cast<int>(v);
+#if defined(_MSC_VER)
+        unsigned long msb;
+        _BitScanReverse64(&msb, v);
+#else
+        const int msb = 63 - __builtin_clzll(v);
+#endif
+        const int sub = static_cast<int>((v >> (msb - 4)) & 15);
+        return 32 + (static_cast<int>(msb) - 5) * 16 + sub;
+    }
+
+    static uint64_t BucketValue(int index)
+    {
+        if (index < 32)
+            return static_cast<uint64_t>(index);
+        const int msb = 5 + (index - 32) / 16;
+        const int sub = (index - 32) % 16;
+        return (uint64_t{1} << msb) | (static_cast<uint64_t>(sub) << (msb - 4));
+    }
+
+    void Record(uint64_t v)
+    {
+        ++counts[BucketIndex(v)];
+        ++total;
+    }
+
+    uint64_t Percentile(double p) const
+    {
+        const uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(total));
+        uint64_t seen = 0;
+        for (int i = 0; i < NumBuckets; ++i)
+        {
+            seen += counts[i];
+            if (seen > rank)
+                return BucketValue(i);
+        }
+        return 0;
+    }
+
+    uint64_t Max() const
+    {
+        for (int i = NumBuckets - 1; i >= 0; --i)
+        {
+            if (counts[i] != 0)
+                return BucketValue(i);
+        }
+        return 0;
+    }
+};
+
 #if BENCH_TO_DECIMAL()
 template <typename D2S, typename Float>
 static inline void BenchIt(benchmark::State& state, std::vector<Float> const& numbers)
 {
-    int index = 0;
+    // Each thread iterates over its own copy of the input (not measured), so the only shared
+    // state is the algorithm's tables and the memory system itself.
+    const std::vector<Float> local(numbers);
+
+    const size_t mask = local.size() - 1; // size is always a power of two
+
+    size_t index = 0;
+    PerfCounters perf;
+    perf.Start();
     for (auto _ : state)
     {
-        benchmark::DoNotOptimize(D2S::ToDec(numbers[index]));
-        index = (index + 1) & (NumFloats - 1);
+        benchmark::DoNotOptimize(D2S::ToDec(local[index]));
+        index = (index + 1) & mask;
     }
+    perf.StopAndReport(state);
+
+    state.SetItemsProcessed(state.iterations());
 }
 #else
 template <typename D2S, typename Float>
 static inline void BenchIt(benchmark::State& state, std::vector<Float> const& numbers)
 {
     D2S d2s;
- 
-    int index = 0;
+
+    // Each thread iterates over its own copy of the input (not measured), so the only shared
+    // state is the algorithm's tables and the memory system itself.
+    const std::vector<Float> local(numbers);
+
+    const size_t mask = local.size() - 1; // size is always a power of two
+
+    size_t index = 0;
 
     uint64_t sum = 0;
-    for (auto _ : state)
+    PerfCounters perf;
+    perf.Start();
+    if (g_latency_mode)
     {
-        char buffer[BufSize];
-        d2s(buffer, BufSize, numbers[index]);
-        sum += static_cast<unsigned char>(buffer[0]);
-        index = (index + 1) & (NumFloats - 1);
+        LatencyHistogram hist;
+        for (auto _ : state)
+        {
+            char buffer[BufSize];
+            const uint64_t t0 = TickNow();
+            d2s(buffer, BufSize, local[index]);
+            hist.Record(TickNow() - t0);
+            sum += static_cast<unsigned char>(buffer[0]);
+            index = (index + 1) & mask;
+        }
+        state.counters[StrPrintf("p50(%s)", TickUnit)] = static_cast<double>(hist.Percentile(0.50));
+        state.counters[StrPrintf("p99(%s)", TickUnit)] = static_cast<double>(hist.Percentile(0.99));
+        state.counters[StrPrintf("p99.9(%s)", TickUnit)] = static_cast<double>(hist.Percentile(0.999));
+        state.counters[StrPrintf("max(%s)", TickUnit)] = static_cast<double>(hist.Max());
     }
+    else
+    {
+        for (auto _ : state)
+        {
+            char buffer[BufSize];
+            d2s(buffer, BufSize, local[index]);
+            sum += static_cast<unsigned char>(buffer[0]);
+            index = (index + 1) & mask;
+        }
+    }
+
+    perf.StopAndReport(state);
+
+    state.SetItemsProcessed(state.iterations());
 
     if (sum == UINT64_MAX)
         abort();
 }
 #endif
 
+static std::vector<std::string> g_algo_filter; // empty: run all algorithms
+static std::vector<int> g_thread_counts = {1};
+
+static inline bool AlgoEnabled(char const* name)
+{
+    if (g_algo_filter.empty())
+        return true;
+    return std::find(g_algo_filter.begin(), g_algo_filter.end(), name) != g_algo_filter.end();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Reproducible input streams (--export-data, --data=<file>.f64/.f32)
+//--------------------------------------------------------------------------------------------------
+
+// With --export-data=<dir> every input vector is also written to <dir>/<scenario>.f64
+// (resp. .f32): the raw IEEE values, little-endian, no header, so the file can be mmap'ed
+// directly. Feeding such a file back via --data= benchmarks the exact same value sequence --
+// on any machine, compiler or code revision -- which takes the generator re-roll out of A/B
+// comparisons. All supported targets are little-endian, so the values are written as-is.
+static std::string g_export_dir;
+
 template <typename Float>
-static inline void RegisterBenchmarks(char const* name, std::vector<Float> const& numbers)
+static void ExportData(char const* name, std::vector<Float> const& numbers)
+{
+    if (g_export_dir.empty())
+        return;
+
+    std::string base = name;
+    while (!base.empty() && base.back() == ' ')
+        base.pop_back();
+    for (char& c : base)
+    {
+        if (c == '/' || c == '\\' || c == ' ' || c == ',')
+            c = '_';
+    }
+
+    // Scenario names repeat (e.g. the warm-up runs) but their data differs: pick the first
+    // unused file name.
+    char const* const ext = (sizeof(Float) == 8) ? "f64" : "f32";
+    std::string path;
+    for (int n = 1; ; ++n)
+    {
+        path = (n == 1)
+            ? StrPrintf("%s/%s.%s", g_export_dir.c_str(), base.c_str(), ext)
+            : StrPrintf("%s/%s_%d.%s", g_export_dir.c_str(), base.c_str(), n, ext);
+        FILE* const exists = fopen(path.c_str(), "rb");
+        if (exists == nullptr)
+            break;
+        fclose(exists);
+    }
+
+    FILE* const file = fopen(path.c_str(), "wb");
+    if (file == nullptr || fwrite(numbers.data(), sizeof(Float), numbers.size(), file) != numbers.size())
+        fprintf(stderr, "failed to export data file '%s'\n", path.c_str());
+    if (file != nullptr)
+        fclose(file);
+}
+
+template <typename D2S, typename Float>
+static inline void RegisterBenchmark(char const* name, std::vector<Float> const& numbers)
 {
+    if (!AlgoEnabled(D2S::Name()))
+        return;
+
     const char* float_name = sizeof(Float) == 4 ? "single" : "double";
-    auto* bench = benchmark::RegisterBenchmark(StrPrintf("%s - %s   ", float_name, name), BenchIt<D2S, Float>, numbers);
+    for (const int threads : g_thread_counts)
+    {
+        auto* bench = benchmark::RegisterBenchmark(StrPrintf("%s/%s - %s   ", D2S::Name(), float_name, name), BenchIt<D2S, Float>, numbers);
+
+        bench->ComputeStatistics("min", [](const std::vector<double>& v) -> double {
+            return *(std::min_element(std::begin(v), std::end(v)));
+        });
+//      bench->Repetitions(8);
+        bench->Repetitions(1);
+        bench->ReportAggregatesOnly();
+        bench->Threads(threads);
+        if (threads > 1)
+        {
+            // Report the aggregate throughput (items_per_second) over the wall clock, so the
+            // scaling over the thread count is directly visible.
+            bench->UseRealTime();
+        }
+    }
+}
 
-    bench->ComputeStatistics("min", [](const std::vector<double>& v) -> double {
-        return *(std::min_element(std::begin(v), std::end(v)));
-    });
-//  bench->Repetitions(8);
-    bench->Repetitions(1);
-    bench->ReportAggregatesOnly();
+static inline void RegisterBenchmarks(char const* name, std::vector<double> const& numbers)
+{
+    ExportData(name, numbers);
+
+#if BENCH_TO_DECIMAL()
+    // The grisu variants have no ToDecimal equivalent: their digit generation emits ASCII
+    // directly, so for them the formatting benchmarks already are the digit-gen numbers.
+    RegisterBenchmark<D2S_Schubfach>(name, numbers);
+    RegisterBenchmark<D2S_Dragonbox>(name, numbers);
+    RegisterBenchmark<D2S_Ryu>(name, numbers);
+#else
+    RegisterBenchmark<D2S_Ryu>(name, numbers);
+    RegisterBenchmark<D2S_StdPrintf>(name, numbers);
+#if defined(__cpp_lib_to_chars)
+    RegisterBenchmark<D2S_StdCharconv>(name, numbers);
+#endif
+    RegisterBenchmark<D2S_Schubfach>(name, numbers);
+    RegisterBenchmark<D2S_SchubfachRoundTrip>(name, numbers);
+    RegisterBenchmark<D2S_Grisu2>(name, numbers);
+    RegisterBenchmark<D2S_Grisu2b>(name, numbers);
+    RegisterBenchmark<D2S_Grisu3>(name, numbers);
+    RegisterBenchmark<D2S_Dragonbox>(name, numbers);
+    RegisterBenchmark<D2S_DoubleConversion>(name, numbers);
+    RegisterBenchmark<D2S_RyuUpstream>(name, numbers);
+#endif
+}
+
+static inline void RegisterBenchmarks(char const* name, std::vector<float> const& numbers)
+{
+    ExportData(name, numbers);
+
+    // Only these algorithms have a single-precision implementation.
+#if BENCH_TO_DECIMAL()
+    static_cast<void>(name);
+    static_cast<void>(numbers);
+#else
+    RegisterBenchmark<D2S_Ryu>(name, numbers);
+    RegisterBenchmark<D2S_StdPrintf>(name, numbers);
+#if defined(__cpp_lib_to_chars)
+    RegisterBenchmark<D2S_StdCharconv>(name, numbers);
+#endif
+    RegisterBenchmark<D2S_Schubfach>(name, numbers);
+    RegisterBenchmark<D2S_Grisu2>(name, numbers);
+    RegisterBenchmark<D2S_Dragonbox>(name, numbers);
+    RegisterBenchmark<D2S_DoubleConversion>(name, numbers);
+    RegisterBenchmark<D2S_RyuUpstream>(name, numbers);
+#endif
 }
 
 //----------------------------------------------------------------------------------------------------------
@@ -259,7 +666,7 @@ static inline void Register_RandomBits_double()
     std::vector<double> numbers(NumFloats);
 
     std::uniform_int_distribution<uint64_t> gen(1, 0x7FF0000000000000ull - 1);
-    std::generate(numbers.begin(), numbers.end(), [&] { return ReinterpretBits<double>(gen(random)); });
+    std::generate(numbers.begin(), numbers.end(), [&] { return ReinterpretBits<double>(gen(rng)); });
 
     RegisterBenchmarks("Random-bits", numbers);
 }
@@ -269,11 +676,31 @@ static inline void Register_RandomBits_single()
     std::vector<float> numbers(NumFloats);
 
     std::uniform_int_distribution<uint32_t> gen(1, 0x7F800000u - 1);
-    std::generate(numbers.begin(), numbers.end(), [&] { return ReinterpretBits<float>(gen(random)); });
+    std::generate(numbers.begin(), numbers.end(), [&] { return ReinterpretBits<float>(gen(rng)); });
 
     RegisterBenchmarks("Random-bits", numbers);
 }
 
+//--------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------
+// Subnormal-dense streams: some scientific datasets carry a significant fraction of
+// subnormals, which cost noticeably more than typical values. 'permille' out of 1000 values
+// are random subnormals, the rest are uniform in [0, 1).
+static inline void Register_Subnormal_double(int permille)
+{
+    std::vector<double> numbers(NumFloats);
+
+    std::uniform_int_distribution<uint64_t> subnormal(1, 0x000FFFFFFFFFFFFFull);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::uniform_int_distribution<int> dice(0, 999);
+    std::generate(numbers.begin(), numbers.end(), [&] {
+        return dice(rng) < permille ? ReinterpretBits<double>(subnormal(rng)) : uniform(rng);
+    });
+
+    RegisterBenchmarks(StrPrintf("Subnormal %d/1000", permille), numbers);
+}
+
 //--------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------
@@ -283,7 +710,7 @@ static inline void Register_Uniform(Float low, Float high)
     std::vector<Float> numbers(NumFloats);
 
     std::uniform_real_distribution<Float> gen(low, high);
-    std::generate(numbers.begin(), numbers.end(), [&] { return gen(random); });
+    std::generate(numbers.begin(), numbers.end(), [&] { return gen(rng); });
 
     RegisterBenchmarks(StrPrintf("Uniform %.1g/%.1g", low, high), numbers);
 }
@@ -325,7 +752,7 @@ static inline void Register_Digits_double(const char* name, int digits, int e10)
     std::uniform_int_distribution<int64_t> gen(kPow10_i64[digits - 1], kPow10_i64[digits] - 1);
 
     std::generate(numbers.begin(), numbers.end(), [&] {
-        int64_t n = gen(random);
+        int64_t n = gen(rng);
         if (n % 10 == 0)
             n += 1;
         std::string s;
@@ -369,7 +796,7 @@ static inline void Register_Digits_single(const char* name, int digits, int e10)
     std::uniform_int_distribution<int32_t> gen(kPow10_i32[digits - 1], kPow10_i32[digits] - 1);
 
     std::generate(numbers.begin(), numbers.end(), [&] {
-        int32_t n = gen(random);
+        int32_t n = gen(rng);
         if (n % 10 == 0)
             n += 1;
         std::string s;
@@ -392,6 +819,51 @@ static inline void Register_Digits_single(const char* name, int digits, int e10)
 //
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------
+
+// Metrics-pipeline workload: a fixed set of quantized gauge values, reused with a Zipfian
+// (skewed) access distribution, i.e. a handful of values dominate the stream while the tail
+// is drawn only occasionally. This is the scenario the memoization layer (dtoa_cache.h) is
+// built for, so both the plain and the cached front-end register here.
+static inline void Register_ZipfReuse_double(int num_distinct, double s)
+{
+    assert(num_distinct >= 1);
+
+    // The distinct values: gauges quantized to two decimal places.
+    std::uniform_real_distribution<double> gen(0.0, 1000.0);
+    std::vector<double> distinct(static_cast<size_t>(num_distinct));
+    std::generate(distinct.begin(), distinct.end(), [&] { return ryu::Round10(gen(rng), -2); });
+
+    // Inverse-CDF sampling of the Zipf rank distribution: P(rank k) ~ 1 / k^s.
+    std::vector<double> cdf(distinct.size());
+    double sum = 0;
+    for (size_t k = 0; k < cdf.size(); ++k)
+    {
+        sum += 1.0 / std::pow(static_cast<double>(k + 1), s);
+        cdf[k] = sum;
+    }
+
+    std::uniform_real_distribution<double> uniform(0.0, sum);
+    std::vector<double> numbers(NumFloats);
+    std::generate(numbers.begin(), numbers.end(), [&] {
+        const auto it = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng));
+        return distinct[static_cast<size_t>(it - cdf.begin())];
+    });
+
+    const char* const name = StrPrintf("Zipf %d/%.1f", num_distinct, s);
+    RegisterBenchmark<D2S_Schubfach>(name, numbers);
+#if !BENCH_TO_DECIMAL()
+    // The cache memoizes formatted output; there is nothing to measure in to-decimal mode.
+    RegisterBenchmark<D2S_CachedSchubfach>(name, numbers);
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------
+
 static inline std::vector<double> GenRandomDigitData_double(int num_digits, int e10, int count)
 {
     std::uniform_real_distribution<double> gen(1, 2);
@@ -401,7 +873,7 @@ static inline std::vector<double> GenRandomDigitData_double(int num_digits, int
 
     for (int i = 0; i < count; ++i)
     {
-        const double d = gen(random);
+        const double d = gen(rng);
         const double rounded = ryu::Round10(d, -num_digits);
         result[i] = rounded;
     }
@@ -418,6 +890,20 @@ static inline void Register_RandomDigits_double(const char* name, int num_digits
 //
 //--------------------------------------------------------------------------------------------------
 
+// Adversarial distributions (stress_gen.h): worst-case throughput, measured continuously
+// next to the average-case scenarios above. The streams are deterministic, so a regression
+// here can be replayed in the unit tests with byte-identical values.
+static inline void Register_Stress_double()
+{
+    RegisterBenchmarks("Stress grisu3-fallback", stress_gen::Grisu3FallbackValues(NumFloats));
+    RegisterBenchmarks("Stress 17-digits", stress_gen::SeventeenDigitValues(NumFloats));
+    RegisterBenchmarks("Stress exp-extremes", stress_gen::ExponentExtremeValues(NumFloats));
+}
+
+//--------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------
+
 static inline std::vector<float> GenRandomDigitData_float(int digits, int count)
 {
     std::uniform_real_distribution<float> gen(1, 2);
@@ -427,7 +913,7 @@ static inline std::vector<float> GenRandomDigitData_float(int digits, int count)
 
     for (int i = 0; i < count; ++i)
     {
-        const float d = gen(random);
+        const float d = gen(rng);
         const float rounded = ryu::Round10(d, -digits);
         result[i] = rounded;
     }
@@ -444,6 +930,173 @@ static inline void Register_RandomDigits_float(const char* name, int digits)
 //
 //--------------------------------------------------------------------------------------------------
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Memory-maps the given file (buffered reads on Windows) and parses all the decimal numbers it
+// contains (canada.txt/mesh.txt style: one or more numbers per line, separated by whitespace or
+// commas). Returns an empty vector on error.
+static std::vector<double> LoadDataFile(char const* path)
+{
+    std::vector<double> numbers;
+
+    char const* data = nullptr;
+    size_t size = 0;
+
+#if !defined(_WIN32)
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return numbers;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return numbers;
+    }
+    size = static_cast<size_t>(st.st_size);
+
+    void* const map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        close(fd);
+        return numbers;
+    }
+    data = static_cast<char const*>(map);
+#else
+    std::string contents;
+
+    FILE* const file = fopen(path, "rb");
+    if (file == nullptr)
+        return numbers;
+    fseek(file, 0, SEEK_END);
+    contents.resize(static_cast<size_t>(ftell(file)));
+    fseek(file, 0, SEEK_SET);
+    if (fread(&contents[0], 1, contents.size(), file) != contents.size())
+        contents.clear();
+    fclose(file);
+
+    data = contents.data();
+    size = contents.size();
+#endif
+
+    char const* next = data;
+    char const* const last = data + size;
+    while (next != last)
+    {
+        // Skip separators and anything else that does not parse as a number.
+        if (*next == '-' || *next == '+' || *next == '.' || ('0' <= *next && *next <= '9'))
+        {
+            double value = 0;
+            const auto res = ryu::Strtod(next, last, value);
+            if (res)
+            {
+                numbers.push_back(value);
+                next = res.next;
+                continue;
+            }
+        }
+        ++next;
+    }
+
+#if !defined(_WIN32)
+    munmap(const_cast<char*>(data), size);
+    close(fd);
+#endif
+
+    return numbers;
+}
+
+// Reads a file written by --export-data: nothing but the raw IEEE values, little-endian.
+// Returns an empty vector on error.
+template <typename Float>
+static std::vector<Float> LoadRawDataFile(char const* path)
+{
+    std::vector<Float> numbers;
+
+    FILE* const file = fopen(path, "rb");
+    if (file == nullptr)
+        return numbers;
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size > 0 && static_cast<size_t>(size) % sizeof(Float) == 0)
+    {
+        numbers.resize(static_cast<size_t>(size) / sizeof(Float));
+        if (fread(numbers.data(), sizeof(Float), numbers.size(), file) != numbers.size())
+            numbers.clear();
+    }
+    fclose(file);
+
+    return numbers;
+}
+
+static inline char const* Basename(char const* path)
+{
+    char const* base = path;
+    for (char const* p = path; *p != '\0'; ++p)
+    {
+        if (*p == '/' || *p == '\\')
+            base = p + 1;
+    }
+    return base;
+}
+
+static inline bool EndsWith(char const* path, char const* suffix)
+{
+    const size_t path_len = std::strlen(path);
+    const size_t suffix_len = std::strlen(suffix);
+    return path_len >= suffix_len && std::memcmp(path + (path_len - suffix_len), suffix, suffix_len) == 0;
+}
+
+template <typename Float>
+static inline void RegisterNumbers(char const* name, std::vector<Float>&& numbers)
+{
+    // The benchmark loop requires a power-of-two size: replicate the values cyclically.
+    const size_t count = numbers.size();
+    size_t n = 1;
+    while (n < count)
+        n *= 2;
+    for (size_t i = count; i < n; ++i)
+        numbers.push_back(numbers[i - count]);
+
+    RegisterBenchmarks(name, numbers);
+}
+
+static inline void Register_DataFile(char const* path)
+{
+    char const* const name = StrPrintf("File %s", Basename(path));
+
+    // Raw exports (see --export-data) are benchmarked as-is; everything else is parsed as text.
+    if (EndsWith(path, ".f32"))
+    {
+        std::vector<float> numbers = LoadRawDataFile<float>(path);
+        if (numbers.empty())
+        {
+            fprintf(stderr, "failed to load data file '%s'\n", path);
+            return;
+        }
+        RegisterNumbers(name, std::move(numbers));
+        return;
+    }
+
+    std::vector<double> numbers = EndsWith(path, ".f64") ? LoadRawDataFile<double>(path) : LoadDataFile(path);
+    if (numbers.empty())
+    {
+        fprintf(stderr, "failed to load data file '%s'\n", path);
+        return;
+    }
+    RegisterNumbers(name, std::move(numbers));
+}
+
+//--------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------
+
 int main(int argc, char** argv)
 {
 #if defined(__clang__)
@@ -454,6 +1107,59 @@ int main(int argc, char** argv)
     printf("msc %d\n", _MSC_FULL_VER);
 #endif
 
+    // Which digit-printing table the engines were built with, see itoa.h; rebuild with
+    // -DITOA_4DIGIT_TABLE=1 resp. =0 to compare the two across the scenarios below.
+    printf("itoa: %s\n", ITOA_4DIGIT_TABLE ? "4-digit table" : "2-digit table");
+
+    // Parse (and strip) --algo=<name>[,<name>]*, --data=<file>[,<file>]*,
+    // --threads=<n>[,<n>]*, --export-data=<dir> and --latency before benchmark::Initialize
+    // sees them.
+    std::string algos;
+    std::string data_files;
+    std::string thread_counts;
+    int num_args = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--algo=", 7) == 0)
+            algos = argv[i] + 7;
+        else if (std::strncmp(argv[i], "--data=", 7) == 0)
+            data_files = argv[i] + 7;
+        else if (std::strncmp(argv[i], "--threads=", 10) == 0)
+            thread_counts = argv[i] + 10;
+        else if (std::strncmp(argv[i], "--export-data=", 14) == 0)
+            g_export_dir = argv[i] + 14;
+        else if (std::strcmp(argv[i], "--latency") == 0)
+            g_latency_mode = true;
+        else
+            argv[num_args++] = argv[i];
+    }
+    argc = num_args;
+
+    if (!thread_counts.empty())
+    {
+        g_thread_counts.clear();
+        for (size_t pos = 0; pos < thread_counts.size();)
+        {
+            const size_t comma = thread_counts.find(',', pos);
+            const size_t end = (comma == std::string::npos) ? thread_counts.size() : comma;
+            const int n = (end > pos) ? atoi(thread_counts.substr(pos, end - pos).c_str()) : 0;
+            if (n >= 1)
+                g_thread_counts.push_back(n);
+            pos = end + 1;
+        }
+        if (g_thread_counts.empty())
+            g_thread_counts = {1};
+    }
+
+    for (size_t pos = 0; pos < algos.size();)
+    {
+        const size_t comma = algos.find(',', pos);
+        const size_t end = (comma == std::string::npos) ? algos.size() : comma;
+        if (end > pos)
+            g_algo_filter.push_back(algos.substr(pos, end - pos));
+        pos = end + 1;
+    }
+
     printf("Preparing benchmarks...\n");
 
 #if BENCH_DOUBLE()
@@ -463,6 +1169,10 @@ int main(int argc, char** argv)
     Register_RandomBits_double();
     Register_Uniform(0.0, 1.0);
     Register_Uniform(0.0, 1.0e+308);
+    Register_ZipfReuse_double(4096, 1.0);
+    Register_Subnormal_double(50);   // a 5% subnormal mix, as seen in scientific datasets
+    Register_Subnormal_double(1000); // pure subnormals: the cost of the tail itself
+    Register_Stress_double();
 
 #if 0
     for (int d = 1; d <= 18; ++d) {
@@ -503,7 +1213,14 @@ int main(int argc, char** argv)
 
 #endif // BENCH_SINGLE()
 
-    printf("Benchmarking %s\n", D2S::Name());
+    for (size_t pos = 0; pos < data_files.size();)
+    {
+        const size_t comma = data_files.find(',', pos);
+        const size_t end = (comma == std::string::npos) ? data_files.size() : comma;
+        if (end > pos)
+            Register_DataFile(data_files.substr(pos, end - pos).c_str());
+        pos = end + 1;
+    }
 
     benchmark::Initialize(&argc, argv);
     benchmark::RunSpecifiedBenchmarks();
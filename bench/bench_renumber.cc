@@ -0,0 +1,128 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+// Macro-benchmark for the JSON number-rewriting pipeline (drachennest::RenumberJson, the
+// core of tools/renumber): scan, bulk parse and columnar re-format run together over a
+// working set far above the last-level cache, so the interactions the per-kernel
+// benchmarks cannot see -- the combined table footprint, the literal-copy memory traffic,
+// the batch hand-off between the stages -- show up in the measured bytes/second.
+//
+// The inputs are synthesized JSON-lines telemetry records, deterministic per scenario:
+//
+//  shortest     values already in shortest form (a pure validate-and-copy pass)
+//  padded17     printf("%.17g") exports, the primary minification use case
+//  random bits  full-exponent-range values, scattering over the pow10 cache
+//  integers     counter-style records, dominated by the itoa fast path
+
+#include "benchmark/benchmark.h"
+
+#include "renumber.h"
+#include "schubfach_64.h"
+
+#include "stress_gen.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Each scenario's input; large enough that neither the input nor the output stays resident
+// in the last-level cache between iterations.
+static constexpr size_t InputSize = 32u << 20;
+
+namespace {
+
+// Appends one {"ts":...,"values":[...]} record.
+void AppendRecord(std::string& text, uint64_t& rng, int flavor)
+{
+    char buf[64];
+
+    text += "{\"ts\":";
+    std::snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(stress_gen::NextRandom(rng) >> 20));
+    text += buf;
+    text += ",\"values\":[";
+
+    for (int i = 0; i < 8; ++i)
+    {
+        if (i != 0)
+            text += ',';
+
+        const uint64_t bits = stress_gen::NextRandom(rng);
+        switch (flavor)
+        {
+        case 0: // shortest: uniform in [0, 1), shortest digits
+            {
+                char* const end = schubfach::Dtoa(buf, static_cast<double>(bits >> 11) * 0x1p-53);
+                text.append(buf, end);
+            }
+            break;
+        case 1: // padded17: uniform in [0, 1), printed with overlong precision
+            std::snprintf(buf, sizeof(buf), "%.17g", static_cast<double>(bits >> 11) * 0x1p-53);
+            text += buf;
+            break;
+        case 2: // random bits: any finite double, printed with overlong precision
+            {
+                const uint64_t finite = bits & 0x7FEFFFFFFFFFFFFFull; // clear top exponent bit: no inf/nan
+                std::snprintf(buf, sizeof(buf), "%.17g", stress_gen::DoubleFromBits(finite));
+                text += buf;
+            }
+            break;
+        default: // integers: counter-style values
+            std::snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(bits >> 40));
+            text += buf;
+            break;
+        }
+    }
+    text += "]}\n";
+}
+
+std::string MakeInput(int flavor)
+{
+    std::string text;
+    text.reserve(InputSize + 256);
+
+    uint64_t rng = 0x5EED + static_cast<uint64_t>(flavor);
+    while (text.size() < InputSize)
+        AppendRecord(text, rng, flavor);
+    return text;
+}
+
+void BenchRenumber(benchmark::State& state, const std::string& input)
+{
+    // Shortest form can be longer than the source text; size the output generously once.
+    std::vector<char> output(input.size() + input.size() / 2);
+
+    for (auto _ : state)
+    {
+        const size_t size = drachennest::RenumberJson(output.data(), output.size(), input.data(), input.data() + input.size());
+        benchmark::DoNotOptimize(size);
+        if (size == 0)
+            state.SkipWithError("output buffer too small");
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    static const std::string inputs[] = {
+        MakeInput(0),
+        MakeInput(1),
+        MakeInput(2),
+        MakeInput(3),
+    };
+
+    benchmark::RegisterBenchmark("renumber shortest", BenchRenumber, inputs[0]);
+    benchmark::RegisterBenchmark("renumber padded17", BenchRenumber, inputs[1]);
+    benchmark::RegisterBenchmark("renumber random bits", BenchRenumber, inputs[2]);
+    benchmark::RegisterBenchmark("renumber integers", BenchRenumber, inputs[3]);
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
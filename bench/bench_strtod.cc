@@ -1,13 +1,17 @@
 #include "benchmark/benchmark.h"
 
+#include <cstdint>
 #include <cstring>
 
 #include <algorithm>
+#include <chrono>
 #include <random>
 #include <string>
 
 #include "ryu_64.h"
 
+#include "stress_gen.h"
+
 #define BENCH_RYU()                 1
 #define BENCH_STD_STRTOD()          0
 #define BENCH_STD_CHARCONV()        0
@@ -24,8 +28,7 @@ struct S2DRyu
     {
         value_type flt = 0;
         const auto res = ryu::Strtod(str.data(), str.data() + str.size(), flt);
-        assert(res.status != ryu::StrtodStatus::invalid);
-        return flt;
+        return res ? flt : 0; // the "invalid ..." scenarios measure the rejection path
     }
 };
 #endif
@@ -53,8 +56,7 @@ struct S2DStdCharconv
     {
         value_type flt = 0;
         const bool ok = std::from_chars(str.data(), str.data() + str.size(), flt).ec == std::errc{};
-        assert(ok);
-        return flt;
+        return ok ? flt : 0;
     }
 };
 #endif
@@ -74,16 +76,141 @@ struct S2DDoubleConversion
 };
 #endif
 
+template <typename ...Args>
+static inline char const* StrPrintf(char const* format, Args&&... args)
+{
+    char buf[1024];
+    snprintf(buf, 1024, format, std::forward<Args>(args)...);
+#ifdef _MSC_VER
+    return _strdup(buf); // leak...
+#else
+    return strdup(buf); // leak...
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+// Latency-distribution mode (--latency)
+//--------------------------------------------------------------------------------------------------
+
+// With --latency every parse is timed individually (rdtsc on x86, steady_clock elsewhere)
+// and recorded into a log-linear histogram; p50/p99/p99.9/max are reported as extra counters
+// (in cycles resp. ns). The per-call timing adds a fixed overhead to every sample -- use the
+// default mode for throughput numbers and this mode to see the tails (i.e. the cost of
+// falling off the <= 17-digit fast path into RYU_STRTOD_FALLBACK).
+static bool g_latency_mode = false;
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+static inline uint64_t TickNow()
+{
+    return __rdtsc();
+}
+static constexpr char const* TickUnit = "cy";
+#else
+static inline uint64_t TickNow()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+static constexpr char const* TickUnit = "ns";
+#endif
+
+// Log-linear buckets in the style of HdrHistogram: exact up to 32, then 16 sub-buckets per
+// power of two (<= ~6% relative error), which is plenty for percentile reporting.
+struct LatencyHistogram
+{
+    static constexpr int NumBuckets = 32 + 59 * 16;
+
+    uint64_t counts[NumBuckets] = {};
+    uint64_t total = 0;
+
+    static int BucketIndex(uint64_t v)
+    {
+        if (v < 32)
+            return static_cast<int>(v);
+#if defined(_MSC_VER)
+        unsigned long msb;
+        _BitScanReverse64(&msb, v);
+#else
+        const int msb = 63 - __builtin_clzll(v);
+#endif
+        const int sub = static_cast<int>((v >> (msb - 4)) & 15);
+        return 32 + (static_cast<int>(msb) - 5) * 16 + sub;
+    }
+
+    static uint64_t BucketValue(int index)
+    {
+        if (index < 32)
+            return static_cast<uint64_t>(index);
+        const int msb = 5 + (index - 32) / 16;
+        const int sub = (index - 32) % 16;
+        return (uint64_t{1} << msb) | (static_cast<uint64_t>(sub) << (msb - 4));
+    }
+
+    void Record(uint64_t v)
+    {
+        ++counts[BucketIndex(v)];
+        ++total;
+    }
+
+    uint64_t Percentile(double p) const
+    {
+        const uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(total));
+        uint64_t seen = 0;
+        for (int i = 0; i < NumBuckets; ++i)
+        {
+            seen += counts[i];
+            if (seen > rank)
+                return BucketValue(i);
+        }
+        return 0;
+    }
+
+    uint64_t Max() const
+    {
+        for (int i = NumBuckets - 1; i >= 0; --i)
+        {
+            if (counts[i] != 0)
+                return BucketValue(i);
+        }
+        return 0;
+    }
+};
+
 template <typename Converter>
 static void BenchIt(benchmark::State& state, std::vector<std::string> const& numbers)
 {
     Converter convert;
 
+    const size_t mask = numbers.size() - 1; // size is always a power of two
+
     size_t index = 0;
-    for (auto _ : state)
+    if (g_latency_mode)
     {
-        benchmark::DoNotOptimize( convert(numbers[index]) );
-        index = (index + 1) & (NumFloats - 1);
+        LatencyHistogram hist;
+        for (auto _ : state)
+        {
+            const uint64_t t0 = TickNow();
+            benchmark::DoNotOptimize( convert(numbers[index]) );
+            hist.Record(TickNow() - t0);
+            index = (index + 1) & mask;
+        }
+        state.counters[StrPrintf("p50(%s)", TickUnit)] = static_cast<double>(hist.Percentile(0.50));
+        state.counters[StrPrintf("p99(%s)", TickUnit)] = static_cast<double>(hist.Percentile(0.99));
+        state.counters[StrPrintf("p99.9(%s)", TickUnit)] = static_cast<double>(hist.Percentile(0.999));
+        state.counters[StrPrintf("max(%s)", TickUnit)] = static_cast<double>(hist.Max());
+    }
+    else
+    {
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize( convert(numbers[index]) );
+            index = (index + 1) & mask;
+        }
     }
 }
 
@@ -141,17 +268,21 @@ public:
     uint32_t operator()() { return Gen(); }
 };
 
-static JenkinsRandom random;
+static JenkinsRandom rng;
 
-template <typename ...Args>
-static inline char const* StrPrintf(char const* format, Args&&... args)
+static inline void RegisterAll(char const* name, std::vector<std::string> const& numbers)
 {
-    char buf[1024];
-    snprintf(buf, 1024, format, std::forward<Args>(args)...);
-#ifdef _MSC_VER
-    return _strdup(buf); // leak...
-#else
-    return strdup(buf); // leak...
+#if BENCH_RYU()
+    RegisterBenchmarks<S2DRyu             >(StrPrintf("%s Ryu               ", name), numbers);
+#endif
+#if BENCH_STD_STRTOD()
+    RegisterBenchmarks<S2DStdStrtod       >(StrPrintf("%s std::strtod       ", name), numbers);
+#endif
+#if BENCH_STD_CHARCONV()
+    RegisterBenchmarks<S2DStdCharconv     >(StrPrintf("%s std::charconv     ", name), numbers);
+#endif
+#if BENCH_DOUBLE_CONVERSION()
+    RegisterBenchmarks<S2DDoubleConversion>(StrPrintf("%s double_conversion ", name), numbers);
 #endif
 }
 
@@ -164,26 +295,207 @@ static inline void RegisterUniform_double(char const* name, double min, double m
     std::generate(numbers.begin(), numbers.end(), [&] {
         char buf[128];
 
-        char* const end = ryu::Dtoa(buf, gen(random));
-        //char* const end = buf + std::snprintf(buf, 128, "%.17g", gen(random));
-        //char* const end = buf + std::snprintf(buf, 128, "%.19g", gen(random));
-        //char* const end = buf + std::snprintf(buf, 128, "%.20g", gen(random));
+        char* const end = ryu::Dtoa(buf, gen(rng));
+        //char* const end = buf + std::snprintf(buf, 128, "%.17g", gen(rng));
+        //char* const end = buf + std::snprintf(buf, 128, "%.19g", gen(rng));
+        //char* const end = buf + std::snprintf(buf, 128, "%.20g", gen(rng));
 
         return std::string(buf, end);
     });
 
-#if BENCH_RYU()
-    RegisterBenchmarks<S2DRyu             >(StrPrintf("%s Ryu               ", name), numbers);
-#endif
-#if BENCH_STD_STRTOD()
-    RegisterBenchmarks<S2DStdStrtod       >(StrPrintf("%s std::strtod       ", name), numbers);
+    RegisterAll(name, numbers);
+}
+
+// Returns a random decimal string with exactly `digits` significant digits (the first digit
+// is never 0), as "d.ddd..." (fixed) or "d.ddd...e[-]dd" (scientific).
+static std::string MakeNumberString(int digits, bool scientific)
+{
+    std::uniform_int_distribution<int> digit(0, 9);
+
+    std::string str;
+    str += static_cast<char>('1' + digit(rng) % 9);
+    if (digits > 1)
+    {
+        str += '.';
+        for (int i = 1; i < digits; ++i)
+            str += static_cast<char>('0' + digit(rng));
+    }
+    if (scientific)
+    {
+        // Small exponents only: the point here is the form of the input, not overflow or
+        // subnormal handling.
+        std::uniform_int_distribution<int> exponent(-20, 20);
+        char buf[8];
+        snprintf(buf, sizeof(buf), "e%d", exponent(rng));
+        str += buf;
+    }
+    return str;
+}
+
+// Inputs with a fixed number of significant digits. Up to 17 digits Strtod stays on the
+// fast path; anything longer goes through the RYU_STRTOD_FALLBACK slow path -- that cliff
+// is exactly what the over-long scenarios measure.
+static inline void RegisterDigits(int digits, bool scientific)
+{
+    std::vector<std::string> numbers(NumFloats);
+
+    std::generate(numbers.begin(), numbers.end(), [&] {
+        return MakeNumberString(digits, scientific);
+    });
+
+    RegisterAll(StrPrintf("%s %3d-digits", scientific ? "scientific" : "fixed", digits), numbers);
+}
+
+// Rejection speed: none of these strings starts like a number, so the parsers fail on the
+// first character or two.
+static inline void RegisterInvalid()
+{
+    static constexpr char const* patterns[] = {
+        "", "+", "-", ".", "+.", "e", "e+5", ".e5", "--1", "junk",
+    };
+    constexpr size_t num_patterns = sizeof(patterns) / sizeof(patterns[0]);
+
+    std::vector<std::string> numbers(NumFloats);
+
+    std::generate(numbers.begin(), numbers.end(), [&] {
+        std::string str = patterns[rng() % num_patterns];
+        // Random tail, avoiding characters that could complete an "inf" or "nan" spelling.
+        const uint32_t tail = rng() % 8;
+        for (uint32_t i = 0; i < tail; ++i)
+            str += static_cast<char>('u' + rng() % 6);
+        return str;
+    });
+
+    RegisterAll("invalid           ", numbers);
+}
+
+// Adversarial distributions (stress_gen.h): the digit-count cliff combined with large
+// exponents. RegisterDigits above keeps its exponents in [-20, 20]; these streams pair
+// 17 digits (the last fast-path length) and 18 digits (the first RYU_STRTOD_FALLBACK
+// length) with exponents near the overflow and subnormal boundaries, where the binary
+// conversion itself is most expensive. Deterministic, so a regression can be replayed in
+// the unit tests with byte-identical strings.
+static inline void RegisterStress()
+{
+    RegisterAll("stress 17-digits e+-300", stress_gen::DigitStrings(NumFloats, 17, -300, 300));
+    RegisterAll("stress 18-digits e+-300", stress_gen::DigitStrings(NumFloats, 18, -300, 300));
+    RegisterAll("stress 17-digits subnormal", stress_gen::DigitStrings(NumFloats, 17, -324, -308));
+}
+
+//--------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
-#if BENCH_STD_CHARCONV()
-    RegisterBenchmarks<S2DStdCharconv     >(StrPrintf("%s std::charconv     ", name), numbers);
+
+// Memory-maps the given file (buffered reads on Windows) and extracts all the decimal numbers it
+// contains (canada.txt/mesh.txt style: one or more numbers per line, separated by whitespace or
+// commas) as strings. Returns an empty vector on error.
+static std::vector<std::string> LoadDataFile(char const* path)
+{
+    std::vector<std::string> numbers;
+
+    char const* data = nullptr;
+    size_t size = 0;
+
+#if !defined(_WIN32)
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return numbers;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return numbers;
+    }
+    size = static_cast<size_t>(st.st_size);
+
+    void* const map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        close(fd);
+        return numbers;
+    }
+    data = static_cast<char const*>(map);
+#else
+    std::string contents;
+
+    FILE* const file = fopen(path, "rb");
+    if (file == nullptr)
+        return numbers;
+    fseek(file, 0, SEEK_END);
+    contents.resize(static_cast<size_t>(ftell(file)));
+    fseek(file, 0, SEEK_SET);
+    if (fread(&contents[0], 1, contents.size(), file) != contents.size())
+        contents.clear();
+    fclose(file);
+
+    data = contents.data();
+    size = contents.size();
 #endif
-#if BENCH_DOUBLE_CONVERSION()
-    RegisterBenchmarks<S2DDoubleConversion>(StrPrintf("%s double_conversion ", name), numbers);
+
+    char const* next = data;
+    char const* const last = data + size;
+    while (next != last)
+    {
+        // Skip separators and anything else that does not parse as a number.
+        if (*next == '-' || *next == '+' || *next == '.' || ('0' <= *next && *next <= '9'))
+        {
+            double value = 0;
+            const auto res = ryu::Strtod(next, last, value);
+            if (res)
+            {
+                numbers.emplace_back(next, res.next);
+                next = res.next;
+                continue;
+            }
+        }
+        ++next;
+    }
+
+#if !defined(_WIN32)
+    munmap(const_cast<char*>(data), size);
+    close(fd);
 #endif
+
+    return numbers;
+}
+
+static inline char const* Basename(char const* path)
+{
+    char const* base = path;
+    for (char const* p = path; *p != '\0'; ++p)
+    {
+        if (*p == '/' || *p == '\\')
+            base = p + 1;
+    }
+    return base;
+}
+
+static inline void RegisterDataFile(char const* path)
+{
+    std::vector<std::string> numbers = LoadDataFile(path);
+    if (numbers.empty())
+    {
+        fprintf(stderr, "failed to load data file '%s'\n", path);
+        return;
+    }
+
+    // The benchmark loop requires a power-of-two size: replicate the values cyclically.
+    const size_t count = numbers.size();
+    size_t n = 1;
+    while (n < count)
+        n *= 2;
+    for (size_t i = count; i < n; ++i)
+        numbers.push_back(numbers[i - count]);
+
+    RegisterAll(StrPrintf("file %s", Basename(path)), numbers);
 }
 
 int main(int argc, char** argv)
@@ -196,6 +508,21 @@ int main(int argc, char** argv)
     printf("msc %d\n", _MSC_FULL_VER);
 #endif
 
+    // Parse (and strip) --data=<file>[,<file>]* and --latency before benchmark::Initialize
+    // sees them.
+    std::string data_files;
+    int num_args = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--data=", 7) == 0)
+            data_files = argv[i] + 7;
+        else if (std::strcmp(argv[i], "--latency") == 0)
+            g_latency_mode = true;
+        else
+            argv[num_args++] = argv[i];
+    }
+    argc = num_args;
+
     RegisterUniform_double("warm up", 0, 1);
     RegisterUniform_double("warm up", 0, 1);
     RegisterUniform_double("warm up", 0, 1);
@@ -212,6 +539,31 @@ int main(int argc, char** argv)
     RegisterUniform_double("uniform [2^20,2^50]", 1ll << 20, 1ll << 50);
     RegisterUniform_double("uniform [0,max]", 0.0, std::numeric_limits<double>::max());
 
+    // Digit-count sweep, fixed and scientific notation. 1..17 digits stay on the fast path;
+    // the over-long inputs fall back (RYU_STRTOD_FALLBACK).
+    for (int digits = 1; digits <= 17; ++digits)
+    {
+        RegisterDigits(digits, /*scientific*/ false);
+        RegisterDigits(digits, /*scientific*/ true);
+    }
+    for (int digits : {18, 19, 25, 50, 100, 400, 800})
+    {
+        RegisterDigits(digits, /*scientific*/ false);
+        RegisterDigits(digits, /*scientific*/ true);
+    }
+
+    RegisterInvalid();
+    RegisterStress();
+
+    for (size_t pos = 0; pos < data_files.size();)
+    {
+        const size_t comma = data_files.find(',', pos);
+        const size_t end = (comma == std::string::npos) ? data_files.size() : comma;
+        if (end > pos)
+            RegisterDataFile(data_files.substr(pos, end - pos).c_str());
+        pos = end + 1;
+    }
+
     benchmark::Initialize(&argc, argv);
     benchmark::RunSpecifiedBenchmarks();
 
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON result files.
+
+Usage:
+    compare.py baseline.json contender.json [--threshold=0.05] [--metric=real_time]
+
+Loads the two result sets (written by bench_dtoa --benchmark_out=... or the
+bench_dtoa_json cmake target), matches scenarios by benchmark name, and flags
+every scenario whose metric moved by more than the noise threshold. Exits
+non-zero if any regression was found, so the comparison can gate a CI job.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_results(path, metric):
+    with open(path) as f:
+        doc = json.load(f)
+    results = {}
+    for b in doc.get("benchmarks", []):
+        if b.get("run_type") == "aggregate" and b.get("aggregate_name") != "mean":
+            continue
+        name = b["name"]
+        if metric not in b:
+            continue
+        results[name] = float(b[metric])
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("baseline")
+    parser.add_argument("contender")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative noise threshold (default: 0.05 = 5%%)")
+    parser.add_argument("--metric", default="real_time",
+                        help="JSON field to compare (default: real_time)")
+    args = parser.parse_args()
+
+    base = load_results(args.baseline, args.metric)
+    cont = load_results(args.contender, args.metric)
+
+    # For time-like metrics larger is worse; for rate-like metrics smaller is worse.
+    larger_is_worse = not args.metric.endswith("per_second")
+
+    common = sorted(set(base) & set(cont))
+    if not common:
+        print("error: no common benchmarks between the two result sets", file=sys.stderr)
+        return 2
+
+    regressions = 0
+    improvements = 0
+    width = max(len(name) for name in common)
+    print("%-*s %12s %12s %8s" % (width, "benchmark", "baseline", "contender", "delta"))
+    for name in common:
+        old = base[name]
+        new = cont[name]
+        delta = (new - old) / old if old != 0 else 0.0
+        worse = delta > args.threshold if larger_is_worse else delta < -args.threshold
+        better = delta < -args.threshold if larger_is_worse else delta > args.threshold
+        flag = ""
+        if worse:
+            flag = "  <-- REGRESSION"
+            regressions += 1
+        elif better:
+            flag = "  (improved)"
+            improvements += 1
+        print("%-*s %12.4g %12.4g %+7.1f%%%s" % (width, name, old, new, 100.0 * delta, flag))
+
+    only_base = sorted(set(base) - set(cont))
+    only_cont = sorted(set(cont) - set(base))
+    for name in only_base:
+        print("only in baseline:  %s" % name)
+    for name in only_cont:
+        print("only in contender: %s" % name)
+
+    print("\n%d compared, %d regressions, %d improvements (threshold %.1f%%)"
+          % (len(common), regressions, improvements, 100.0 * args.threshold))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
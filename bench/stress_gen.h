@@ -0,0 +1,170 @@
+#pragma once
+
+#include "../src/grisu3.h"
+#include "../src/schubfach_64.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Deterministic generators for the algorithmic worst-case input classes: values that force
+// the grisu3 fallback, values whose shortest output is the maximal 17 digits, values at the
+// extremes of the binary exponent range, and decimal strings straddling the Strtod fast-path
+// digit limit. The streams depend only on the seed, so bench_dtoa/bench_strtod can measure
+// worst-case throughput continuously while the unit tests verify the very same values --
+// a regression seen on a stress scenario is replayable with byte-identical inputs.
+
+namespace stress_gen {
+
+// SplitMix64 (the generator of test_stress_f64.cc): tiny, deterministic and portable.
+inline uint64_t NextRandom(uint64_t& state)
+{
+    state += 0x9E3779B97F4A7C15ull;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline double DoubleFromBits(uint64_t bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// The number of significant digits in the shortest decimal representation of 'value': the
+// digit characters of the mantissa with leading and trailing zeros stripped ("12300" are the
+// digits "123" times 10^2). Returns 0 only for zero.
+inline int ShortestDigitCount(double value)
+{
+    char buf[schubfach::DtoaMaxLength];
+    char* const end = schubfach::Dtoa(buf, value);
+
+    int count = 0;
+    int trailing_zeros = 0;
+    bool leading = true;
+    for (char* p = buf; p != end && *p != 'e'; ++p)
+    {
+        if (*p < '0' || *p > '9')
+            continue;
+        if (leading && *p == '0')
+            continue;
+        leading = false;
+        ++count;
+        trailing_zeros = (*p == '0') ? trailing_zeros + 1 : 0;
+    }
+    return count - trailing_zeros;
+}
+
+// Values on which grisu3 gives up and the fallback runs (~0.5% of random bit patterns, so
+// expect ~200 conversions per value generated). This is the worst case of grisu3::Dtoa:
+// a full grisu round plus dragon4's big-integer loop (or the schubfach re-round, with
+// GRISU_BOUNDED_FALLBACK).
+inline std::vector<double> Grisu3FallbackValues(size_t count, uint64_t seed = 1)
+{
+    std::vector<double> values;
+    values.reserve(count);
+
+    uint64_t state = seed;
+    while (values.size() < count)
+    {
+        const uint64_t bits = NextRandom(state) % 0x7FF0000000000000ull;
+        if (bits == 0)
+            continue;
+
+        const double value = DoubleFromBits(bits);
+        char buf[grisu3::DtoaMinBufferLength];
+        if (grisu3::Dtoa(buf, value, grisu3::FallbackPolicy::schubfach).was_fallback)
+            values.push_back(value);
+    }
+    return values;
+}
+
+// Values whose shortest form has the maximal 17 significand digits: the longest digit
+// generation loops and the longest outputs every shortest formatter can produce. (Most
+// random bit patterns qualify; the filter mainly drops the short-output minority that makes
+// plain Random-bits an average rather than a worst case.)
+inline std::vector<double> SeventeenDigitValues(size_t count, uint64_t seed = 1)
+{
+    std::vector<double> values;
+    values.reserve(count);
+
+    uint64_t state = seed;
+    while (values.size() < count)
+    {
+        const uint64_t bits = NextRandom(state) % 0x7FF0000000000000ull;
+        if (bits == 0)
+            continue;
+
+        const double value = DoubleFromBits(bits);
+        if (ShortestDigitCount(value) == 17)
+            values.push_back(value);
+    }
+    return values;
+}
+
+// Values alternating between the bottom 64 binary exponents (subnormals included) and the
+// top 64: the extremes of the pow10 tables, the longest fixed-notation outputs and the
+// boundary handling of the exponent estimates.
+inline std::vector<double> ExponentExtremeValues(size_t count, uint64_t seed = 1)
+{
+    std::vector<double> values;
+    values.reserve(count);
+
+    uint64_t state = seed;
+    while (values.size() < count)
+    {
+        const uint64_t bits = NextRandom(state);
+        const uint64_t significand = bits & 0x000FFFFFFFFFFFFFull;
+        uint64_t exponent = (bits >> 52) & 63;      // [0, 63]
+        if (values.size() % 2 != 0)
+            exponent = 2046 - exponent;             // [1983, 2046]
+        if (exponent == 0 && significand == 0)
+            continue;
+
+        values.push_back(DoubleFromBits((exponent << 52) | significand));
+    }
+    return values;
+}
+
+// Decimal strings "d.ddd...e[-]ddd" with exactly 'digits' significant digits (the first and
+// the last digit are never 0) and a decimal exponent uniform in [min_exp10, max_exp10].
+// 17 digits is the last length ryu::Strtod converts on the fast path, 18 the first that
+// takes the RYU_STRTOD_FALLBACK slow path -- generate both to measure that cliff; pair a
+// large |exponent| range with it to stress the boundary (subnormal/overflow) handling too.
+inline std::vector<std::string> DigitStrings(size_t count, int digits, int min_exp10, int max_exp10, uint64_t seed = 1)
+{
+    assert(digits >= 1);
+    assert(min_exp10 <= max_exp10);
+
+    std::vector<std::string> numbers;
+    numbers.reserve(count);
+
+    uint64_t state = seed;
+    for (size_t n = 0; n < count; ++n)
+    {
+        std::string str;
+        str += static_cast<char>('1' + NextRandom(state) % 9);
+        if (digits > 1)
+        {
+            str += '.';
+            for (int i = 1; i < digits - 1; ++i)
+                str += static_cast<char>('0' + NextRandom(state) % 10);
+            str += static_cast<char>('1' + NextRandom(state) % 9);
+        }
+
+        const int64_t range = static_cast<int64_t>(max_exp10) - min_exp10 + 1;
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "e%d", min_exp10 + static_cast<int>(NextRandom(state) % static_cast<uint64_t>(range)));
+        str += buf;
+
+        numbers.push_back(std::move(str));
+    }
+    return numbers;
+}
+
+} // namespace stress_gen
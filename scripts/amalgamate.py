@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+# Copyright 2020 Alexander Bolz
+#
+# Distributed under the Boost Software License, Version 1.0.
+#  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+"""Generates drachennest_amalgamated.h, a single self-contained header with the schubfach
+formatters and the ryu parsers, for consumers that want full cross-function inlining without
+LTO (see the notes in the generated banner).
+
+Each implementation file is pasted into its own namespace (the file-static helpers of
+schubfach_64.cc and ryu_64.cc collide by name -- Utoa_2Digits, ComputePow10_Double, ... --
+and keep internal linkage), the public entry points are made `inline`, and the public
+namespaces are re-exported with using-directives. System includes are replaced by a fixed
+prelude; local includes are expanded once per namespace.
+
+Usage: amalgamate.py [-o OUTPUT]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+SRC_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src")
+
+# Each unit becomes one implementation namespace; the files are expanded in order, local
+# includes are expanded where they are included (once per unit).
+UNITS = [
+    ("schubfach_64_impl", ["schubfach_64.cc", "pow10_cache_64.cc", "itoa.cc"]),
+    ("ryu_64_impl", ["ryu_64.cc", "itoa.cc"]),
+]
+
+# The re-exported public namespaces: (public name, implementation namespace).
+EXPORTS = [
+    ("schubfach", "schubfach_64_impl"),
+    ("ryu", "ryu_64_impl"),
+]
+
+# The union of the system includes of all amalgamated files (the conditional ones carry the
+# same conditions as in the sources). Including them inside the implementation namespaces
+# would be ill-formed, so they are hoisted into this prelude and the generator checks that
+# no unlisted system include sneaks in.
+PRELUDE = """\
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || (defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#include <emmintrin.h>
+#endif
+"""
+
+# Build-tree generated includes (only present under options the banner rejects): the
+# include lines are kept verbatim instead of being expanded.
+GENERATED_INCLUDES = {"pow10_cache_64_generated.inc"}
+
+KNOWN_SYSTEM_INCLUDES = {
+    "cassert", "climits", "cstddef", "cstdint", "cstdlib", "cstring", "limits", "string_view",
+    "intrin.h", "emmintrin.h",
+    "atomic",  # stats.h, only under DRACHENNEST_STATS (rejected below)
+}
+
+BANNER = """\
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+// GENERATED FILE -- DO NOT EDIT. Regenerate with tools/amalgamate.py.
+//
+// Single-header amalgamation of the schubfach_64 formatters (schubfach::Dtoa & friends) and
+// the ryu_64 parsers (ryu::Strtod & friends), so header-only consumers get full inlining and
+// constant propagation into their hot loops without LTO. Everything is inline; the header
+// may be included from any number of translation units.
+//
+// Do not combine with the drachennest library or its individual headers in the same program:
+// this header defines the same public names (via its own implementation namespaces), and
+// mixing the two is an ODR violation.
+//
+// Limitations versus the library build: the DRACHENNEST_STATS instrumentation, the
+// compressed pow10 cache and the build-time generated pow10 cache are not supported (all
+// are rejected below).
+
+#pragma once
+
+#if defined(DRACHENNEST_STATS) && DRACHENNEST_STATS
+#error "the amalgamation does not support DRACHENNEST_STATS (link the drachennest library instead)"
+#endif
+
+#if defined(DRACHENNEST_COMPRESSED_CACHE) && DRACHENNEST_COMPRESSED_CACHE
+#error "the amalgamation does not support DRACHENNEST_COMPRESSED_CACHE (link the drachennest library instead)"
+#endif
+
+#if defined(DRACHENNEST_GENERATED_CACHE) && DRACHENNEST_GENERATED_CACHE
+#error "the amalgamation does not support DRACHENNEST_GENERATED_CACHE (link the drachennest library instead)"
+#endif
+"""
+
+# File-scope definitions of public (qualified-name) entities must become inline to survive
+# inclusion from multiple translation units. The sources write these signatures on one line.
+INLINE_RE = re.compile(r"^[A-Za-z_](?!.*;\s*$).*\b(schubfach|ryu|pow10cache|drachennest)::.*\(")
+
+# Same for the qualified table definitions (e.g. drachennest::itoa::Digits100 in itoa.cc);
+# these become C++17 inline variables.
+INLINE_VAR_RE = re.compile(r"^const\s.*\b(schubfach|ryu|pow10cache|drachennest)::.*=")
+
+# In the library build internal linkage keeps identically named file-static helpers of
+# different files apart; one namespace per unit does not, so the colliding ones are renamed
+# (per file -- the renames do not apply to the other files of the unit).
+RENAMES = {
+    "itoa.cc": [
+        (re.compile(r"\bDecimalLength\b"), "Itoa_DecimalLength"),
+        (re.compile(r"\bPrintDecimalDigitsBackwards\b"), "Itoa_PrintDecimalDigitsBackwards"),
+    ],
+}
+
+# References to file-scope helpers qualified with the global namespace (e.g. ::ToDecimal64,
+# to bypass the identically named function of the enclosing public namespace) must be
+# requalified: the helper now lives in the unit's implementation namespace.
+GLOBAL_QUALIFIED_RE = re.compile(r"(?<![A-Za-z0-9_>)\]])::(?=[A-Za-z_])")
+
+
+def expand(name, unit_namespace, seen, out):
+    if name in seen:
+        return
+    seen.add(name)
+
+    path = os.path.join(SRC_DIR, name)
+    out.append("// -------------------------------------------------------------------------------- %s" % name)
+    with open(path, "r") as f:
+        for line in f.read().splitlines():
+            stripped = line.strip()
+            if stripped == "#pragma once":
+                continue
+            m = re.match(r'#include\s+"([^"]+)"', stripped)
+            if m:
+                if m.group(1) in GENERATED_INCLUDES:
+                    # Build-tree generated, guarded by an option the banner rejects: keep
+                    # the (dead) include line instead of expanding it.
+                    out.append(line)
+                    continue
+                expand(m.group(1), unit_namespace, seen, out)
+                continue
+            m = re.match(r"#include\s+<([^>]+)>", stripped)
+            if m:
+                if m.group(1) not in KNOWN_SYSTEM_INCLUDES:
+                    sys.exit("amalgamate.py: %s includes <%s>, which is not in the prelude" % (name, m.group(1)))
+                continue
+            line = GLOBAL_QUALIFIED_RE.sub("::drachennest_amalgamated::%s::" % unit_namespace, line)
+            for pattern, replacement in RENAMES.get(name, []):
+                line = pattern.sub(replacement, line)
+            if line.startswith("using") or line.startswith("static"):
+                out.append(line)
+                continue
+            if INLINE_RE.match(line) or INLINE_VAR_RE.match(line):
+                out.append("inline " + line)
+                continue
+            out.append(line)
+    out.append("// -------------------------------------------------------------------------------- end %s" % name)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("-o", "--output", default="drachennest_amalgamated.h")
+    args = parser.parse_args()
+
+    out = [BANNER, PRELUDE]
+    out.append("namespace drachennest_amalgamated {")
+    for namespace, files in UNITS:
+        out.append("")
+        out.append("namespace %s {" % namespace)
+        seen = set()
+        for name in files:
+            expand(name, namespace, seen, out)
+        out.append("} // namespace %s" % namespace)
+    out.append("")
+    out.append("} // namespace drachennest_amalgamated")
+    out.append("")
+    for public, namespace in EXPORTS:
+        out.append("namespace %s { using namespace ::drachennest_amalgamated::%s::%s; }" % (public, namespace, public))
+    out.append("")
+
+    with open(args.output, "w") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
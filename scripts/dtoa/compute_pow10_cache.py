@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+# Copyright 2020 Alexander Bolz
+#
+# Distributed under the Boost Software License, Version 1.0.
+#  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+"""Generates the shared pow10 cache of schubfach_64 and dragonbox (pow10_cache_64.cc).
+
+For each decimal exponent k there are unique beta and r such that 10^k = beta 2^r and
+2^127 <= beta < 2^128; the cache stores g(k) = ceil(beta). With the default parameters the
+output reproduces the frozen tables embedded in pow10_cache_64.cc bit for bit; a narrowed
+exponent range or a different compression stride becomes a configure flag instead of a
+hand-edited constant array -- see the DRACHENNEST_GENERATED_CACHE option in
+src/CMakeLists.txt. The range is in table exponents: values near 10^d use the entries near
+k = 16 - d, so covering values with decimal exponents in [dmin, dmax] needs
+--min-exponent (15 - dmax) and --max-exponent (18 - dmin).
+
+With --stride N > 1 only every Nth entry is stored and the output additionally carries the
+10^offset multipliers and the 2-bit corrections the runtime reconstruction needs (the
+layout of the DRACHENNEST_COMPRESSED_CACHE tables, which were generated with --stride 16).
+
+Usage: compute_pow10_cache.py [--min-exponent K] [--max-exponent K] [--stride N] [-o OUTPUT]
+"""
+
+import argparse
+import sys
+
+
+def FloorDivPow2(x, n):
+    return x >> n
+
+
+def FloorLog2Pow10(e):
+    assert e >= -1233
+    assert e <= 1233
+    return FloorDivPow2(e * 1741647, 19)
+
+
+def CeilDiv(num, den):
+    assert num >= 0
+    assert den > 0
+    return -(-num // den)
+
+
+def ComputePow10Significand(k, bits=128):
+    """Returns g(k) = ceil(beta), where 10^k = beta 2^r and 2^(bits-1) <= beta < 2^bits."""
+    e = FloorLog2Pow10(k) + 1 - bits
+    if k >= 0:
+        num, den = 10**k, 1
+    else:
+        num, den = 1, 10**(-k)
+    if e >= 0:
+        den *= 2**e
+    else:
+        num *= 2**(-e)
+    g = CeilDiv(num, den)
+    assert 2**(bits - 1) <= g < 2**bits
+    return g
+
+
+def FormatEntry(g, k):
+    return "    {{0x{:016X}, 0x{:016X}}}, // {}".format(g >> 64, g % 2**64, k)
+
+
+def EmitFull(out, kmin, kmax):
+    out.append("#define DRACHENNEST_GENERATED_CACHE_COMPRESSED 0")
+    out.append("")
+    out.append("static constexpr int32_t kGeneratedCacheMin = {};".format(kmin))
+    out.append("static constexpr int32_t kGeneratedCacheMax = {};".format(kmax))
+    out.append("")
+    out.append("static constexpr Significand128 kGeneratedCache[{}] = {{".format(kmax - kmin + 1))
+    for k in range(kmin, kmax + 1):
+        out.append(FormatEntry(ComputePow10Significand(k), k))
+    out.append("};")
+
+
+def EmitCompressed(out, kmin, kmax, stride):
+    # The reconstruction computes floor(base * 10^offset / 2^shift) with base the *stored*
+    # (rounded-up) significand, so the result can overshoot the exact g(k) by a small
+    # amount; the per-entry correction makes it exact again. The shift must stay below 64,
+    # which bounds the stride by 19 (10^19 < 2^64 also keeps the multipliers in uint64_t).
+    assert 2 <= stride <= 19
+
+    out.append("#define DRACHENNEST_GENERATED_CACHE_COMPRESSED 1")
+    out.append("")
+    out.append("static constexpr int32_t kGeneratedCacheMin = {};".format(kmin))
+    out.append("static constexpr int32_t kGeneratedCacheMax = {};".format(kmax))
+    out.append("static constexpr int32_t kGeneratedCacheStride = {};".format(stride))
+    out.append("")
+
+    out.append("static constexpr Significand128 kGeneratedCacheBase[{}] = {{".format((kmax - kmin) // stride + 1))
+    for k in range(kmin, kmax + 1, stride):
+        out.append(FormatEntry(ComputePow10Significand(k), k))
+    out.append("};")
+    out.append("")
+
+    out.append("static constexpr uint64_t kGeneratedCachePow10_64[{}] = {{".format(stride))
+    for i in range(stride):
+        out.append("    {},".format(10**i))
+    out.append("};")
+    out.append("")
+
+    corrections = []
+    for k in range(kmin, kmax + 1):
+        offset = (k - kmin) % stride
+        if offset == 0:
+            # The reconstruction returns the stored base directly; no correction.
+            corrections.append(0)
+            continue
+        base = ComputePow10Significand(k - offset)
+        shift = FloorLog2Pow10(k) - FloorLog2Pow10(k - offset)
+        assert 1 <= shift <= 63
+        approx = ((base * 10**offset) >> shift) + 1
+        correction = approx - ComputePow10Significand(k)
+        assert 0 <= correction <= 3, "correction {} for k = {} does not fit 2 bits".format(correction, k)
+        corrections.append(correction)
+    while len(corrections) % 4 != 0:
+        corrections.append(0)
+
+    out.append("// g(kGeneratedCacheMin + i) == floor(kGeneratedCacheBase[i / {0}] * 10^(i % {0}) / 2^shift) + 1 - correction(i),".format(stride))
+    out.append("// 2 bits per entry.")
+    out.append("static constexpr uint8_t kGeneratedCacheCorrections[{}] = {{".format(len(corrections) // 4))
+    packed = ["0x{:02X}".format(corrections[i] | (corrections[i + 1] << 2) | (corrections[i + 2] << 4) | (corrections[i + 3] << 6))
+              for i in range(0, len(corrections), 4)]
+    for i in range(0, len(packed), 16):
+        out.append("    " + ", ".join(packed[i:i + 16]) + ",")
+    out.append("};")
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--min-exponent", type=int, default=-292)
+    parser.add_argument("--max-exponent", type=int, default=326)
+    parser.add_argument("--stride", type=int, default=1)
+    parser.add_argument("-o", "--output", default="pow10_cache_64_generated.inc")
+    args = parser.parse_args()
+
+    if args.min_exponent > args.max_exponent:
+        sys.exit("compute_pow10_cache.py: --min-exponent must be <= --max-exponent")
+    if not (-1000 <= args.min_exponent and args.max_exponent <= 1000):
+        sys.exit("compute_pow10_cache.py: the exponent range must lie within [-1000, 1000]")
+    if not (1 <= args.stride <= 19):
+        sys.exit("compute_pow10_cache.py: --stride must be in [1, 19]")
+
+    out = []
+    out.append("// GENERATED FILE -- DO NOT EDIT. Regenerate with:")
+    out.append("//   scripts/dtoa/compute_pow10_cache.py --min-exponent {} --max-exponent {} --stride {}".format(
+        args.min_exponent, args.max_exponent, args.stride))
+    out.append("")
+    if args.stride == 1:
+        EmitFull(out, args.min_exponent, args.max_exponent)
+    else:
+        EmitCompressed(out, args.min_exponent, args.max_exponent, args.stride)
+    out.append("")
+
+    with open(args.output, "w") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
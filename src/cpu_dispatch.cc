@@ -0,0 +1,110 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "cpu_dispatch.h"
+
+#include "schubfach_64.h"
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define CPU_DISPATCH_X86() 1
+#elif defined(__i386__) || defined(__x86_64__)
+#include <cpuid.h>
+#define CPU_DISPATCH_X86() 1
+#else
+#define CPU_DISPATCH_X86() 0
+#endif
+
+//==================================================================================================
+// CpuInfo
+//==================================================================================================
+
+static inline drachennest::CpuFeatures DetectCpuFeatures()
+{
+    drachennest::CpuFeatures cpu = {};
+
+#if CPU_DISPATCH_X86()
+    uint32_t eax = 0;
+    uint32_t ebx = 0;
+    uint32_t ecx = 0;
+    uint32_t edx = 0;
+
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    const uint32_t max_leaf = static_cast<uint32_t>(regs[0]);
+    if (max_leaf >= 1)
+    {
+        __cpuidex(regs, 1, 0);
+        ecx = static_cast<uint32_t>(regs[2]);
+    }
+    cpu.ssse3 = (ecx & (1u << 9)) != 0;
+    cpu.sse42 = (ecx & (1u << 20)) != 0;
+    if (max_leaf >= 7)
+    {
+        __cpuidex(regs, 7, 0);
+        ebx = static_cast<uint32_t>(regs[1]);
+    }
+    cpu.avx2 = (ebx & (1u << 5)) != 0;
+#else
+    const uint32_t max_leaf = __get_cpuid_max(0, nullptr);
+    if (max_leaf >= 1)
+    {
+        __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    }
+    cpu.ssse3 = (ecx & (1u << 9)) != 0;
+    cpu.sse42 = (ecx & (1u << 20)) != 0;
+    if (max_leaf >= 7)
+    {
+        ebx = 0;
+        __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx);
+    }
+    cpu.avx2 = (ebx & (1u << 5)) != 0;
+#endif
+#endif // CPU_DISPATCH_X86()
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+    cpu.neon = true;
+#endif
+
+    return cpu;
+}
+
+const drachennest::CpuFeatures& drachennest::CpuInfo()
+{
+    static const CpuFeatures cpu = DetectCpuFeatures();
+    return cpu;
+}
+
+//==================================================================================================
+// Kernel selection
+//==================================================================================================
+//
+// One entry per dispatched function. The baseline kernels are compiled for the platform
+// baseline (SSE2 on x86-64, NEON on aarch64); kernels which require an extension beyond the
+// baseline are selected here based on CpuInfo(). Adding a kernel means compiling it in a
+// translation unit built with the matching -m flags and extending the resolver below --
+// callers are unaffected.
+
+static inline char* (*SelectDtoa())(char*, double)
+{
+    // Currently all in-tree Dtoa kernels (including the SSE2 digit printer, see
+    // ITOA_SIMD_DIGITS in itoa.h) require only the platform baseline.
+    return &schubfach::Dtoa;
+}
+
+static inline ryu::StrtodResult (*SelectStrtod())(const char*, const char*, double&)
+{
+    // Currently the only in-tree Strtod kernel requires only the platform baseline.
+    return &ryu::Strtod;
+}
+
+// Resolved during the dynamic initialization of this translation unit, i.e. before main()
+// runs. (A dispatched call from the static initializer of another translation unit would
+// find a null pointer; like all static initialization order dependencies, don't do that.)
+char* (*const drachennest::DtoaDispatch)(char*, double) = SelectDtoa();
+ryu::StrtodResult (*const drachennest::StrtodDispatch)(const char*, const char*, double&) = SelectStrtod();
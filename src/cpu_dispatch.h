@@ -0,0 +1,41 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "ryu_64.h"
+
+namespace drachennest {
+
+// const CpuFeatures& cpu = CpuInfo();
+//
+// The instruction-set extensions of the host CPU, detected once at startup (via cpuid on
+// x86-64; on aarch64 NEON is part of the baseline). SSE2 is part of the x86-64 baseline and
+// is not reported separately.
+
+struct CpuFeatures {
+    bool ssse3;
+    bool sse42;
+    bool avx2;
+    bool neon;
+};
+
+const CpuFeatures& CpuInfo();
+
+// char* output_end = DtoaDispatch(buffer, value);
+// ryu::StrtodResult conversion_result = StrtodDispatch(first, last, value);
+//
+// The hot entry points, bound once at startup to the best kernel for the host CPU, so a
+// single binary deployed across different microarchitectures does not have to be built for
+// the lowest common denominator. Calls go through a function pointer which is resolved
+// before main() runs; there is no per-call feature test.
+//
+// The contracts are exactly those of schubfach::Dtoa resp. ryu::Strtod; see the kernel
+// selection in cpu_dispatch.cc for which implementations are available per ISA.
+
+extern char* (*const DtoaDispatch)(char* buffer, double value);
+extern ryu::StrtodResult (*const StrtodDispatch)(const char* next, const char* last, double& value);
+
+} // namespace drachennest
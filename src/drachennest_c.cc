@@ -0,0 +1,42 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "drachennest_c.h"
+
+#include "ryu_64.h"
+#include "schubfach_64.h"
+
+static_assert(DN_DTOA_MAX_LENGTH == schubfach::DtoaMaxLength, "keep drachennest_c.h in sync");
+
+int dn_dtoa(char* buffer, double value)
+{
+    return static_cast<int>(schubfach::Dtoa(buffer, value) - buffer);
+}
+
+size_t dn_dtoa_batch(char* buffer, const double* values, size_t count, char separator)
+{
+    return static_cast<size_t>(schubfach::DtoaBatch(buffer, values, count, separator) - buffer);
+}
+
+size_t dn_strtod(const char* buffer, size_t length, double* value)
+{
+    const ryu::StrtodResult res = ryu::Strtod(buffer, buffer + length, *value);
+    if (!res)
+        return 0;
+    return static_cast<size_t>(res.next - buffer);
+}
+
+size_t dn_strtod_many(const char* buffer, size_t length, char separator, double* values, size_t max_count, size_t* consumed)
+{
+    const ryu::StrtodManyResult res = ryu::StrtodMany(buffer, buffer + length, separator, values, max_count);
+    if (consumed != nullptr)
+        *consumed = static_cast<size_t>(res.next - buffer);
+    return res.count;
+}
+
+int dn_abi_version(void)
+{
+    return 1;
+}
@@ -0,0 +1,49 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <stddef.h>
+
+// The stable C ABI of the drachennest_c shared library, for cross-language bindings
+// (ctypes, Rust ffi, ...). This header is C; the symbols below are the only ones the
+// library exports (see drachennest_c.map) and carry the version node DRACHENNEST_C_1.
+//
+// The functions are thin extern "C" wrappers over schubfach::Dtoa and ryu::Strtod and
+// inherit their contracts; see schubfach_64.h and ryu_64.h for the details (output format,
+// accepted inputs, round-trip guarantees).
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The worst-case output length of dn_dtoa. (The output is not null-terminated.)
+#define DN_DTOA_MAX_LENGTH 26
+
+// Formats value into buffer (which must hold at least DN_DTOA_MAX_LENGTH characters) and
+// returns the number of characters written.
+int dn_dtoa(char* buffer, double value);
+
+// Formats count values into buffer, separator-joined. The buffer must hold at least
+// count * (DN_DTOA_MAX_LENGTH + 1) characters. Returns the number of characters written.
+size_t dn_dtoa_batch(char* buffer, const double* values, size_t count, char separator);
+
+// Parses a number from [buffer, buffer + length) and stores it in *value. Returns the
+// number of characters consumed, or 0 if the input does not start with a number (*value is
+// unchanged in that case).
+size_t dn_strtod(const char* buffer, size_t length, double* value);
+
+// Parses up to max_count separator-joined numbers from [buffer, buffer + length) into
+// values and returns the number of values parsed. If consumed is not NULL, *consumed
+// receives the number of characters consumed (see ryu::StrtodMany for the exact contract).
+size_t dn_strtod_many(const char* buffer, size_t length, char separator, double* values, size_t max_count, size_t* consumed);
+
+// Returns the version of this ABI (the N of the DRACHENNEST_C_N version node), so bindings
+// can sanity-check the library they loaded.
+int dn_abi_version(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
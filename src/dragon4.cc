@@ -17,6 +17,38 @@
 #define DRAGON4_ASSERT(X) assert(X)
 #endif
 
+// Some targets (e.g. wasm32) offer unsigned __int128 but lower the 64x64->128 multiplies to
+// a libcall; defining DRACHENNEST_NO_INT128=1 (see the cmake option) forces the 32x32->64
+// decomposition instead.
+#ifndef DRACHENNEST_NO_INT128
+#define DRACHENNEST_NO_INT128 0
+#endif
+
+// If enabled, the DiyInt shift kernel processes 4 limbs at a time with SSE2 and the multiply
+// kernels consume the limbs in 64-bit pairs, shrinking the Dragon4 fallback tail behind
+// grisu3. (May be disabled by defining DRAGON4_SIMD_LIMBS=0.)
+#ifndef DRAGON4_SIMD_LIMBS
+#if defined(__SSE2__) || (defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define DRAGON4_SIMD_LIMBS 1
+#else
+#define DRAGON4_SIMD_LIMBS 0
+#endif
+#endif
+
+#if DRAGON4_SIMD_LIMBS
+#include <emmintrin.h>
+#endif
+
+// The multiply kernels walk the limbs in 64-bit pairs where a 128-bit product is available;
+// the pairs are loaded with memcpy, which requires little-endian limb order.
+#ifndef DRAGON4_64BIT_LIMBS
+#if defined(__SIZEOF_INT128__) && !DRACHENNEST_NO_INT128 && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define DRAGON4_64BIT_LIMBS 1
+#else
+#define DRAGON4_64BIT_LIMBS 0
+#endif
+#endif
+
 //==================================================================================================
 // Dragon4
 //
@@ -49,18 +81,27 @@ static inline void Memmove(uint32_t* dst, const uint32_t* src, int n)
 namespace {
 struct DiyInt
 {
-    static constexpr int MaxBits = 1130;
+    // Sized for the largest intermediate values of the extended formats handled by
+    // Dragon4Wide: for binary128 (resp. x87 80-bit extended) the scaled value s reaches
+    // 2^(2 - e) with e >= -16494, plus a few bits of headroom for the Mul10 fixup steps.
+    // (Doubles only ever use the first ~1130 bits.)
+    static constexpr int MaxBits = 16640;
     static constexpr int Capacity = (MaxBits + (32 - 1)) / 32;
 
-    uint32_t bigits[Capacity]; // Significand stored in little-endian form.
-    int      size = 0;
+    uint32_t* bigits;   // Significand stored in little-endian form.
+    int       size = 0;
 
-    DiyInt() = default;
+    // The limbs are provided by the caller (a stack buffer, or a dragon4::Arena), so that
+    // they can be placed in caller-controlled storage and reused across conversions.
+    explicit DiyInt(uint32_t* limbs) : bigits(limbs) {}
     DiyInt(const DiyInt&) = delete;             // (not needed here)
     DiyInt& operator=(const DiyInt&) = delete;  // (not needed here)
 };
 }
 
+static_assert(sizeof(dragon4::Arena) == 2 * DiyInt::Capacity * sizeof(uint32_t),
+    "dragon4::Arena must provide the limbs for exactly two DiyInts");
+
 static inline void AssignU32(DiyInt& x, uint32_t value)
 {
     x.bigits[0] = value;
@@ -90,7 +131,19 @@ static inline void MulAddU32(DiyInt& x, uint32_t A, uint32_t B = 0)
     }
 
     uint32_t carry = B;
-    for (int i = 0; i < x.size; ++i)
+    int i = 0;
+#if DRAGON4_64BIT_LIMBS
+    for ( ; i + 2 <= x.size; i += 2)
+    {
+        uint64_t pair;
+        std::memcpy(&pair, &x.bigits[i], sizeof(pair));
+        const unsigned __int128 p = static_cast<unsigned __int128>(pair) * A + carry;
+        pair = static_cast<uint64_t>(p);
+        std::memcpy(&x.bigits[i], &pair, sizeof(pair));
+        carry = static_cast<uint32_t>(p >> 64);
+    }
+#endif
+    for ( ; i < x.size; ++i)
     {
         const uint64_t p = uint64_t{x.bigits[i]} * A + carry;
         x.bigits[i]      = static_cast<uint32_t>(p);
@@ -118,6 +171,36 @@ static inline void MulPow2(DiyInt& x, int e2) // aka left-shift
 
     if (bit_shift > 0)
     {
+#if DRAGON4_SIMD_LIMBS
+        // The shifted limb i is (x[i] << s) | (x[i-1] >> (32 - s)): unlike a multiply there
+        // is no carry chain, so 4 limbs can be computed at once. Process the blocks from the
+        // most significant one down, so that the (unaligned, overlapping) loads only read
+        // limbs that have not been overwritten yet.
+        const uint32_t carry = x.bigits[x.size - 1] >> (32 - bit_shift);
+
+        const __m128i shl = _mm_cvtsi32_si128(bit_shift);
+        const __m128i shr = _mm_cvtsi32_si128(32 - bit_shift);
+
+        int i = x.size;
+        for ( ; i >= 5; i -= 4)
+        {
+            const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&x.bigits[i - 4]));
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&x.bigits[i - 5]));
+            const __m128i v  = _mm_or_si128(_mm_sll_epi32(hi, shl), _mm_srl_epi32(lo, shr));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&x.bigits[i - 4]), v);
+        }
+        for ( ; i >= 2; --i)
+        {
+            x.bigits[i - 1] = x.bigits[i - 1] << bit_shift | x.bigits[i - 2] >> (32 - bit_shift);
+        }
+        x.bigits[0] <<= bit_shift;
+
+        if (carry != 0)
+        {
+            DRAGON4_ASSERT(x.size < DiyInt::Capacity);
+            x.bigits[x.size++] = carry;
+        }
+#else
         uint32_t carry = 0;
         for (int i = 0; i < x.size; ++i)
         {
@@ -131,6 +214,7 @@ static inline void MulPow2(DiyInt& x, int e2) // aka left-shift
             DRAGON4_ASSERT(x.size < DiyInt::Capacity);
             x.bigits[x.size++] = carry;
         }
+#endif
     }
 
     if (bigit_shift > 0)
@@ -203,7 +287,19 @@ static inline void Mul10(DiyInt& x)
     MulAddU32(x, 10, 0);
 #else
     uint32_t carry = 0;
-    for (int i = 0; i < x.size; ++i)
+    int i = 0;
+#if DRAGON4_64BIT_LIMBS
+    for ( ; i + 2 <= x.size; i += 2)
+    {
+        uint64_t pair;
+        std::memcpy(&pair, &x.bigits[i], sizeof(pair));
+        const unsigned __int128 p = static_cast<unsigned __int128>(pair) * 10 + carry;
+        pair = static_cast<uint64_t>(p);
+        std::memcpy(&x.bigits[i], &pair, sizeof(pair));
+        carry = static_cast<uint32_t>(p >> 64);
+    }
+#endif
+    for ( ; i < x.size; ++i)
     {
         const uint64_t p = uint64_t{x.bigits[i]} * 10 + carry;
         x.bigits[i]      = static_cast<uint32_t>(p);
@@ -315,6 +411,36 @@ static inline void AssignPow2MulPow5(DiyInt& x, int e2, int e5)
     //MulPow2(x, e2);
 }
 
+// x := hi * 2^64 + lo
+static inline void AssignU128(DiyInt& x, uint64_t hi, uint64_t lo)
+{
+    if (hi == 0)
+    {
+        AssignU64(x, lo);
+        return;
+    }
+
+    x.bigits[0] = static_cast<uint32_t>(lo);
+    x.bigits[1] = static_cast<uint32_t>(lo >> 32);
+    x.bigits[2] = static_cast<uint32_t>(hi);
+    x.bigits[3] = static_cast<uint32_t>(hi >> 32);
+    x.size = (x.bigits[3] != 0) ? 4 : 3;
+}
+
+// x := (hi * 2^64 + lo) * 2^e2
+static inline void AssignU128MulPow2(DiyInt& x, uint64_t hi, uint64_t lo, int e2)
+{
+    AssignU128(x, hi, lo);
+    MulPow2(x, e2);
+}
+
+// x := (hi * 2^64 + lo) * 10^e10
+static inline void AssignU128MulPow10(DiyInt& x, uint64_t hi, uint64_t lo, int e10)
+{
+    AssignU128MulPow2(x, hi, lo, e10);
+    MulPow5(x, e10);
+}
+
 // Returns the number of leading 0-bits in x, starting at the most significant bit position.
 // If x is 0, the result is undefined.
 static inline int CountLeadingZeros32(uint32_t x)
@@ -712,6 +838,11 @@ static inline int EffectivePrecision(uint64_t f)
     return 64 - CountLeadingZeros64(f);
 }
 
+static inline int EffectivePrecision(uint64_t f_hi, uint64_t f_lo)
+{
+    return (f_hi != 0) ? 128 - CountLeadingZeros64(f_hi) : EffectivePrecision(f_lo);
+}
+
 // Returns: floor(x / 2^n)
 static inline int SAR(int x, int n)
 {
@@ -727,29 +858,36 @@ static inline int SAR(int x, int n)
 // Returns: ceil(log_10(2^e))
 static inline int CeilLog10Pow2(int e)
 {
-    DRAGON4_ASSERT(e >= -2620);
-    DRAGON4_ASSERT(e <=  2620);
-    return SAR(e * 315653 + ((1 << 20) - 1), 20);
+    // The 32-bit fixed-point approximation of log_10(2) is exact for the full exponent
+    // range of the extended formats handled by Dragon4Wide (|e| <= 1650 would suffice for
+    // doubles, but binary128 exponents reach +-16500).
+    DRAGON4_ASSERT(e >= -16700);
+    DRAGON4_ASSERT(e <=  16700);
+    return static_cast<int>((e * int64_t{1292913986} + ((int64_t{1} << 32) - 1)) >> 32);
 }
 
-static inline int ComputeInitialValuesAndEstimate(DiyInt& r, DiyInt& s, DiyInt& delta, uint64_t f, int e, bool lower_boundary_is_closer)
+static inline int ComputeInitialValuesAndEstimate(DiyInt& r, DiyInt& s, DiyInt& delta, uint64_t f_hi, uint64_t f_lo, int e, bool lower_boundary_is_closer)
 {
     const int boundary_shift = lower_boundary_is_closer ? 2 : 1;
-    const int p = EffectivePrecision(f);
+    const int p = EffectivePrecision(f_hi, f_lo);
     DRAGON4_ASSERT(p >= 1);
-    DRAGON4_ASSERT(p <= 53);
+    DRAGON4_ASSERT(p <= 113); // double: 53, x87 extended: 64, binary128: 113
     const int k = CeilLog10Pow2(e + (p - 1));
 
-//  const int cmpf = CompareEstimate((f << boundary_shift) + 1, boundary_shift - e, k);
+    // fs = f * 2^boundary_shift (f < 2^113, so the shift cannot overflow the 128-bit pair)
+    const uint64_t fs_hi = f_hi << boundary_shift | f_lo >> (64 - boundary_shift);
+    const uint64_t fs_lo = f_lo << boundary_shift;
+
+//  const int cmpf = CompareEstimate(fs + 1, boundary_shift - e, k);
     if (e >= 0)
     {
         DRAGON4_ASSERT(e >= 0);
-        DRAGON4_ASSERT(e <= 971);
+        DRAGON4_ASSERT(e <= 16320);
         DRAGON4_ASSERT(k >= 0);
-        DRAGON4_ASSERT(k <= 308);
+        DRAGON4_ASSERT(k <= 4940);
 
         // r = f * 2^(boundary_shift + e)
-        AssignU64MulPow2(r, f << boundary_shift, e);
+        AssignU128MulPow2(r, fs_hi, fs_lo, e);
         // s = 2^boundary_shift * 10^k
         AssignPow2MulPow5(s, boundary_shift + k, k);
         // delta = 2^e
@@ -757,13 +895,13 @@ static inline int ComputeInitialValuesAndEstimate(DiyInt& r, DiyInt& s, DiyInt&
     }
     else if (k < 0)
     {
-        DRAGON4_ASSERT(e >= -1074);
+        DRAGON4_ASSERT(e >= -16494);
         DRAGON4_ASSERT(e <= -1);
-        DRAGON4_ASSERT(k >= -323);
+        DRAGON4_ASSERT(k >= -4960);
         DRAGON4_ASSERT(k <= -1);
 
         // r = f * 2^boundary_shift * 10^(-k)
-        AssignU64MulPow10(r, f << boundary_shift, -k);
+        AssignU128MulPow10(r, fs_hi, fs_lo, -k);
         // s = 2^(boundary_shift - e)
         AssignPow2(s, boundary_shift - e);
         // delta = 10^(-k)
@@ -771,13 +909,13 @@ static inline int ComputeInitialValuesAndEstimate(DiyInt& r, DiyInt& s, DiyInt&
     }
     else
     {
-        DRAGON4_ASSERT(e >= -55);
+        DRAGON4_ASSERT(e >= -120);
         DRAGON4_ASSERT(e <= -1);
         DRAGON4_ASSERT(k >= 0);
-        DRAGON4_ASSERT(k <= 16);
+        DRAGON4_ASSERT(k <= 40);
 
         // r = f * 2^boundary_shift
-        AssignU64(r, f << boundary_shift);
+        AssignU128(r, fs_hi, fs_lo);
         // s = 2^(boundary_shift - e) * 10^k
         AssignPow2MulPow5(s, boundary_shift - e + k, k);
         // delta = 1
@@ -787,17 +925,18 @@ static inline int ComputeInitialValuesAndEstimate(DiyInt& r, DiyInt& s, DiyInt&
     return k;
 }
 
-void dragon4::Dragon4(uint64_t& digits, int& exponent, uint64_t f, int e, bool accept_bounds, bool lower_boundary_is_closer)
+char* dragon4::Dragon4Wide(char* buffer, int& exponent, uint64_t f_hi, uint64_t f_lo, int e, bool accept_bounds, bool lower_boundary_is_closer)
 {
-    DiyInt r;
-    DiyInt s;
-    DiyInt delta;
+    uint32_t limbs[3 * DiyInt::Capacity];
+    DiyInt r(limbs + 0 * DiyInt::Capacity);
+    DiyInt s(limbs + 1 * DiyInt::Capacity);
+    DiyInt delta(limbs + 2 * DiyInt::Capacity);
 
     //
     // Compute initial values.
     // Estimate k.
     //
-    int k = ComputeInitialValuesAndEstimate(r, s, delta, f, e, lower_boundary_is_closer);
+    int k = ComputeInitialValuesAndEstimate(r, s, delta, f_hi, f_lo, e, lower_boundary_is_closer);
 
     //
     // Fixup, in case k is too low.
@@ -815,10 +954,8 @@ void dragon4::Dragon4(uint64_t& digits, int& exponent, uint64_t f, int e, bool a
     Mul10(r);       // (Move into init step above?)
     Mul10(delta);   // (Move into init step above?)
 
-    uint64_t d10 = 0;
     for (;;)
     {
-        DRAGON4_ASSERT(d10 <= 9999999999999999ull);
         DRAGON4_ASSERT(r.size > 0);
 
         // q = r / s
@@ -852,7 +989,7 @@ void dragon4::Dragon4(uint64_t& digits, int& exponent, uint64_t f, int e, bool a
         }
 
         DRAGON4_ASSERT(q <= 9);
-        d10 = d10 * 10 + q;
+        *buffer++ = static_cast<char>('0' + static_cast<int>(q));
         k--;
 
         if (tc1 || tc2)
@@ -862,6 +999,152 @@ void dragon4::Dragon4(uint64_t& digits, int& exponent, uint64_t f, int e, bool a
         MulAddU32(delta, lower_boundary_is_closer ? 5 : 10);
     }
 
+    exponent = k;
+    return buffer;
+}
+
+void dragon4::Dragon4(uint64_t& digits, int& exponent, uint64_t f, int e, bool accept_bounds, bool lower_boundary_is_closer)
+{
+    DRAGON4_ASSERT(EffectivePrecision(f) <= 53);
+
+    // Doubles produce at most 17 digits, which always fit into a uint64_t.
+    char buffer[20];
+    const char* const end = Dragon4Wide(buffer, exponent, 0, f, e, accept_bounds, lower_boundary_is_closer);
+    DRAGON4_ASSERT(end - buffer <= 17);
+
+    uint64_t d10 = 0;
+    for (const char* p = buffer; p != end; ++p)
+        d10 = 10 * d10 + static_cast<uint32_t>(*p - '0');
+
     digits = d10;
+}
+
+//==================================================================================================
+// DigitGenerator
+//
+// Generates the exact decimal digits of f * 2^e from left to right, reusing the DiyInt
+// machinery above. The invariant maintained between calls to Generate is
+//
+//  remaining value = (r / s) * 10^(Exponent() - digits generated so far) / 10
+//
+// with 0 <= r < 10 * s; each digit is one DivMod/Mul10 step.
+//==================================================================================================
+
+dragon4::DigitGenerator::DigitGenerator(Arena& arena, uint64_t f, int e)
+    : limbs_(arena.limbs)
+{
+    DRAGON4_ASSERT(f != 0);
+
+    DiyInt r(limbs_ + 0 * DiyInt::Capacity);
+    DiyInt s(limbs_ + 1 * DiyInt::Capacity);
+
+    // Estimate k = ceil(log_10(f * 2^e)) and compute r and s with r / s = (f * 2^e) / 10^k.
+    // Unlike ComputeInitialValuesAndEstimate there are no boundaries here.
+    const int p = EffectivePrecision(f);
+    int k = CeilLog10Pow2(e + p);
+
+    if (e >= 0)
+    {
+        // r = f * 2^e
+        AssignU64MulPow2(r, f, e);
+        // s = 10^k
+        AssignPow10(s, k);
+    }
+    else if (k < 0)
+    {
+        // r = f * 10^(-k)
+        AssignU64MulPow10(r, f, -k);
+        // s = 2^(-e)
+        AssignPow2(s, -e);
+    }
+    else
+    {
+        // r = f
+        AssignU64(r, f);
+        // s = 2^(-e) * 10^k
+        AssignPow2MulPow5(s, -e + k, k);
+    }
+
+    // r / s < 1 now; the digit loop computes r := 10 * r first.
+    Mul10(r);
+
+    // The estimate k is exact or one too high. In the latter case the first digit would be 0:
+    // skip it and adjust the exponent.
+    if (Compare(r, s) < 0)
+    {
+        Mul10(r);
+        k--;
+    }
+
+    exponent_ = k;
+    r_size_ = r.size;
+    s_size_ = s.size;
+}
+
+char* dragon4::DigitGenerator::Generate(char* buffer, int count)
+{
+    DiyInt r(limbs_ + 0 * DiyInt::Capacity);
+    DiyInt s(limbs_ + 1 * DiyInt::Capacity);
+    r.size = r_size_;
+    s.size = s_size_;
+
+    for (int i = 0; i < count; ++i)
+    {
+        uint32_t q = 0;
+        if (r.size > 0)
+        {
+            // q = r / s
+            // r = 10 * (r % s)
+            q = DivMod(r, s);
+            Mul10(r);
+        }
+        DRAGON4_ASSERT(q <= 9);
+        *buffer++ = static_cast<char>('0' + static_cast<int>(q));
+    }
+
+    r_size_ = r.size;
+    return buffer;
+}
+
+char* dragon4::Dragon4Fixed(char* buffer, int num_digits, int& exponent, uint64_t f, int e)
+{
+    DRAGON4_ASSERT(num_digits >= 1);
+
+    Arena arena;
+    DigitGenerator gen(arena, f, e);
+
+    char* const end = gen.Generate(buffer, num_digits);
+
+    // Round according to the next digit; the expansion is exact, so a trailing '5' with
+    // Finished() is a true tie (round to even).
+    char next;
+    gen.Generate(&next, 1);
+    const bool round_up = next > '5'
+        || (next == '5' && (!gen.Finished() || (end[-1] - '0') % 2 != 0));
+
+    int k = gen.Exponent();
+    if (round_up)
+    {
+        char* p = end;
+        for (;;)
+        {
+            --p;
+            if (*p != '9')
+            {
+                ++*p;
+                break;
+            }
+            *p = '0';
+            if (p == buffer)
+            {
+                // All digits were '9': the result is 0.100...0 * 10^(k + 1).
+                *p = '1';
+                k++;
+                break;
+            }
+        }
+    }
+
     exponent = k;
+    return end;
 }
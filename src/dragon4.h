@@ -11,4 +11,79 @@ namespace dragon4 {
 
 void Dragon4(uint64_t& digits, int& exponent, uint64_t f, int e, bool accept_bounds, bool lower_boundary_is_closer);
 
+// char* digits_end = Dragon4Wide(buffer, exponent, f_hi, f_lo, e, accept_bounds, lower_boundary_is_closer);
+//
+// As Dragon4, but for significands of up to 113 bits: f = f_hi * 2^64 + f_lo. This covers
+// x87 80-bit extended (64-bit significand including the explicit integer bit, f_hi = 0) and
+// IEEE binary128 (113-bit significand) in addition to the formats handled by Dragon4.
+//
+// Since the shortest form of a binary128 value can need up to 36 digits, the digits are
+// written as characters into [buffer, digits_end) instead of being packed into a uint64_t.
+// The buffer must hold at least Dragon4WideMaxDigits characters.
+//
+// Note:
+// The boundaries (and therefore the digits) are those of the *format implied by (f, e)*:
+// the same value converted from a double and from its binary128 widening has much closer
+// neighbors in the latter and may produce more digits.
+
+constexpr int Dragon4WideMaxDigits = 36;
+
+char* Dragon4Wide(char* buffer, int& exponent, uint64_t f_hi, uint64_t f_lo, int e, bool accept_bounds, bool lower_boundary_is_closer);
+
+// Arena provides the storage for the big-integer limbs used by DigitGenerator (~4 KB; the
+// limbs are sized for the binary128 exponent range, doubles use only the first ~300 bytes).
+// It may be obtained from a caller-provided arena and reused across conversions; it does not
+// need to be initialized.
+
+struct Arena {
+    uint32_t limbs[2 * ((16640 + (32 - 1)) / 32)]; // Must match DiyInt in dragon4.cc.
+};
+
+// DigitGenerator generates the exact decimal digits of a floating-point number incrementally,
+// i.e. the value is decomposed as
+//
+//  f * 2^e = 0.D[1] D[2] D[3] ... * 10^Exponent()
+//
+// with D[1] != 0, and the D[i] are obtained (in order, as characters) by repeated calls to
+// Generate. The expansion is exact: once Finished() returns true, all remaining digits are
+// zero (and are still generated on request).
+//
+// The big-integer machinery is the same as Dragon4's; there are no allocations.
+
+class DigitGenerator {
+public:
+    // Initializes generation of the decimal digits of f * 2^e. (f must be != 0.)
+    // The arena holds the big-integer limbs and must be kept alive (and unchanged) as long as
+    // digits are generated.
+    DigitGenerator(Arena& arena, uint64_t f, int e);
+
+    // The decimal exponent of the value, see above.
+    int Exponent() const { return exponent_; }
+
+    // Have all non-zero digits been generated?
+    bool Finished() const { return r_size_ == 0; }
+
+    // Generates the next 'count' decimal digits into [buffer, buffer + count).
+    // Returns the end of the generated digits, i.e. buffer + count.
+    char* Generate(char* buffer, int count);
+
+private:
+    uint32_t* limbs_;
+    int r_size_;
+    int s_size_;
+    int exponent_;
+};
+
+// char* digits_end = Dragon4Fixed(buffer, num_digits, exponent, f, e);
+//
+// Generates the first num_digits decimal digits of f * 2^e, correctly rounded to the last
+// digit (round-to-nearest-even), i.e. the digits satisfy
+//
+//  0.D[1] D[2] ... D[num_digits] * 10^exponent ~= f * 2^e
+//
+// Use this for exact fixed-precision ("%.50f") formatting; shortest output is Dragon4.
+// The buffer must hold at least num_digits characters. (f must be != 0, num_digits >= 1.)
+
+char* Dragon4Fixed(char* buffer, int num_digits, int& exponent, uint64_t f, int e);
+
 } // namespace dragon4
@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 namespace dragonbox {
 
 // char* output_end = Dtoa(buffer, value);
@@ -12,7 +15,7 @@ namespace dragonbox {
 // Converts the given double-precision number into decimal form and stores the result in the given
 // buffer.
 //
-// The buffer must be large enough, i.e. >= DtoaMinBufferLength.
+// The buffer must be large enough, i.e. >= DtoaMaxLength.
 // The output format is similar to printf("%g").
 // The output is _not_ null-terminted.
 //
@@ -22,10 +25,76 @@ namespace dragonbox {
 //  3. is as close to the input number as possible.
 //
 // Note:
-// This function may temporarily write up to DtoaMinBufferLength characters into the buffer.
+// Dtoa never writes past buffer + DtoaMaxLength, so output slots of exactly DtoaMaxLength
+// characters can be formatted in place, without a bounce buffer.
+
+// The worst case output (and write extent) of Dtoa: a sign, "0." plus six leading zeros (the
+// fixed notation window extends down to 1e-7), and 17 significand digits, e.g.
+//  -0.00000088817841970012523
+constexpr int DtoaMaxLength = 26;
 
-constexpr int DtoaMinBufferLength = 64;
+// Historical name: formatting used to require 64 characters of scratch headroom.
+constexpr int DtoaMinBufferLength = DtoaMaxLength;
 
 char* Dtoa(char* buffer, double value);
 
+// char* output_end = DtoaJson(buffer, value, nonfinite, keep_minus_zero);
+//
+// Like Dtoa, but with RFC 8259 (JSON) conformant output for every input: finite values
+// format exactly as with Dtoa (whose output already fits the JSON number grammar), while
+// infinities and NaNs emit the nonfinite replacement token (default: "null"). With
+// keep_minus_zero = false, negative zero emits "0".
+//
+// The buffer must be large enough, i.e. >= DtoaMaxLength, and the replacement token must
+// not be longer than DtoaMaxLength characters.
+
+char* DtoaJson(char* buffer, double value, const char* nonfinite = "null", bool keep_minus_zero = true);
+
+// FloatingDecimal64 dec = ToDecimal64(value);
+//
+// Converts the given double-precision number into the decimal form (significand, exponent), i.e.
+//  value = significand * 10^exponent
+//
+// The returned significand is optimal in the same sense as for Dtoa. Use this function instead of
+// Dtoa if the decimal representation is needed, but not its ASCII form.
+//
+// PRE: value must be finite and non-zero. The sign of value is ignored.
+//
+// The second overload operates directly on the (biased) IEEE representation, i.e. on the
+// physical significand and exponent fields of the double.
+
+struct FloatingDecimal64 {
+    uint64_t significand;
+    int32_t exponent;
+};
+
+FloatingDecimal64 ToDecimal64(double value);
+FloatingDecimal64 ToDecimal64(uint64_t ieee_significand, uint64_t ieee_exponent);
+
+// ToDecimal64x4(values, results);
+//
+// Converts four double-precision numbers at once; results[i] is exactly what
+// ToDecimal64(values[i]) returns. Running the four conversions in lockstep lets the four
+// pow10 table loads issue back to back and overlaps the dependent 128-bit multiply chains
+// of the four lanes, hiding most of their latency -- the shape of work columnar writers
+// produce.
+//
+// PRE: all four values must be finite and non-zero. The signs are ignored.
+
+void ToDecimal64x4(const double* values, FloatingDecimal64* results);
+
+// char* output_end = DtoaBatch(buffer, values, count, separator);
+//
+// Converts the given array of double-precision numbers into decimal form and stores the
+// separator-joined results in the given buffer, i.e. the output is
+//  values[0] <separator> values[1] <separator> ... values[count - 1]
+//
+// Each number is formatted exactly as by Dtoa; groups of four finite, non-zero values run
+// through the 4-wide ToDecimal64x4 kernel.
+//
+// The buffer must be large enough, i.e. >= count * (DtoaMaxLength + 1).
+// The output is _not_ null-terminated.
+
+char* DtoaBatch(char* buffer, const double* values, size_t count, char separator = ',');
+
 } // namespace dragonbox
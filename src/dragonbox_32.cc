@@ -0,0 +1,776 @@
+// Copyright 2020 Junekey Jeon
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "dragonbox_32.h"
+
+#include "itoa.h"
+
+#include "pow10_cache_32.h"
+
+//--------------------------------------------------------------------------------------------------
+// This file contains an implementation of Junekey Jeon's Dragonbox algorithm for
+// single-precision numbers; the double-precision version lives in dragonbox.cc.
+//
+// It is a simplified version of the reference implementation found here:
+// https://github.com/jk-jeon/dragonbox
+//--------------------------------------------------------------------------------------------------
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#ifndef DRAGONBOX_ASSERT
+#define DRAGONBOX_ASSERT(X) assert(X)
+#endif
+
+// Some targets (e.g. wasm32) offer unsigned __int128 but lower the 64x64->128 multiplies to
+// a libcall; defining DRACHENNEST_NO_INT128=1 (see the cmake option) forces the 32x32->64
+// decomposition instead.
+#ifndef DRACHENNEST_NO_INT128
+#define DRACHENNEST_NO_INT128 0
+#endif
+
+//==================================================================================================
+//
+//==================================================================================================
+
+template <typename Dest, typename Source>
+static inline Dest ReinterpretBits(Source source)
+{
+    static_assert(sizeof(Dest) == sizeof(Source), "size mismatch");
+
+    Dest dest;
+    std::memcpy(&dest, &source, sizeof(Source));
+    return dest;
+}
+
+namespace {
+struct Single
+{
+    static_assert(std::numeric_limits<float>::is_iec559
+               && std::numeric_limits<float>::digits == 24
+               && std::numeric_limits<float>::max_exponent == 128,
+        "IEEE-754 single-precision implementation required");
+
+    using value_type = float;
+    using bits_type = uint32_t;
+
+//  static constexpr int32_t   MaxDigits10     = std::numeric_limits<value_type>::max_digits10;
+    static constexpr int32_t   SignificandSize = std::numeric_limits<value_type>::digits; // = p   (includes the hidden bit)
+    static constexpr int32_t   ExponentBias    = std::numeric_limits<value_type>::max_exponent - 1 + (SignificandSize - 1);
+//  static constexpr int32_t   MaxExponent     = std::numeric_limits<value_type>::max_exponent - 1 - (SignificandSize - 1);
+//  static constexpr int32_t   MinExponent     = std::numeric_limits<value_type>::min_exponent - 1 - (SignificandSize - 1);
+    static constexpr bits_type MaxIeeeExponent = bits_type{2 * std::numeric_limits<value_type>::max_exponent - 1};
+    static constexpr bits_type HiddenBit       = bits_type{1} << (SignificandSize - 1);   // = 2^(p-1)
+    static constexpr bits_type SignificandMask = HiddenBit - 1;                           // = 2^(p-1) - 1
+    static constexpr bits_type ExponentMask    = MaxIeeeExponent << (SignificandSize - 1);
+    static constexpr bits_type SignMask        = ~(~bits_type{0} >> 1);
+
+    bits_type bits;
+
+    explicit Single(bits_type bits_) : bits(bits_) {}
+    explicit Single(value_type value) : bits(ReinterpretBits<bits_type>(value)) {}
+
+    bits_type PhysicalSignificand() const {
+        return bits & SignificandMask;
+    }
+
+    bits_type PhysicalExponent() const {
+        return (bits & ExponentMask) >> (SignificandSize - 1);
+    }
+
+    bool IsFinite() const {
+        return (bits & ExponentMask) != ExponentMask;
+    }
+
+    bool IsInf() const {
+        return (bits & ExponentMask) == ExponentMask && (bits & SignificandMask) == 0;
+    }
+
+    bool IsNaN() const {
+        return (bits & ExponentMask) == ExponentMask && (bits & SignificandMask) != 0;
+    }
+
+    bool IsZero() const {
+        return (bits & ~SignMask) == 0;
+    }
+
+    bool SignBit() const {
+        return (bits & SignMask) != 0;
+    }
+};
+} // namespace
+
+//==================================================================================================
+//
+//==================================================================================================
+
+// Returns floor(x / 2^n).
+//
+// Technically, right-shift of negative integers is implementation defined...
+// Should easily be optimized into SAR (or equivalent) instruction.
+static inline int32_t FloorDivPow2(int32_t x, int32_t n)
+{
+#if 0
+    return x < 0 ? ~(~x >> n) : (x >> n);
+#else
+    return x >> n;
+#endif
+}
+
+static inline int32_t FloorLog2Pow10(int32_t e)
+{
+    DRAGONBOX_ASSERT(e >= -1233);
+    DRAGONBOX_ASSERT(e <=  1233);
+    return FloorDivPow2(e * 1741647, 19);
+}
+
+static inline int32_t FloorLog10Pow2(int32_t e)
+{
+    DRAGONBOX_ASSERT(e >= -1500);
+    DRAGONBOX_ASSERT(e <=  1500);
+    return FloorDivPow2(e * 1262611, 22);
+}
+
+static inline int32_t FloorLog10ThreeQuartersPow2(int32_t e)
+{
+    DRAGONBOX_ASSERT(e >= -1500);
+    DRAGONBOX_ASSERT(e <=  1500);
+    return FloorDivPow2(e * 1262611 - 524031, 22);
+}
+
+//==================================================================================================
+//
+//==================================================================================================
+
+static inline uint64_t ComputePow10_Single(int32_t k)
+{
+    DRAGONBOX_ASSERT(k >= pow10cache::kMinDecimalExponent32);
+    DRAGONBOX_ASSERT(k <= pow10cache::kMaxDecimalExponent32);
+
+    // The shared cache stores ceil(2^-r 10^k); dragonbox expects floor(2^-r 10^k) for k >= 28,
+    // where 10^k is no longer exactly representable in 64 bits.
+    uint64_t g = pow10cache::GetPow10Significand32(k);
+    if (k >= 28)
+    {
+        g -= 1;
+    }
+    return g;
+}
+
+// Returns whether value is divisible by 2^e2
+static inline bool MultipleOfPow2(uint32_t value, int32_t e2)
+{
+    DRAGONBOX_ASSERT(e2 >= 0);
+    return e2 < 32 && (value & ((uint32_t{1} << e2) - 1)) == 0;
+}
+
+// Returns whether value is divisible by 5^e5
+static inline bool MultipleOfPow5(uint32_t value, int32_t e5)
+{
+    struct MulCmp {
+        uint32_t mul;
+        uint32_t cmp;
+    };
+
+    static constexpr MulCmp Mod5[] = {
+        {0x00000001u, 0xFFFFFFFFu}, // 5^0
+        {0xCCCCCCCDu, 0x33333333u}, // 5^1
+        {0xC28F5C29u, 0x0A3D70A3u}, // 5^2
+        {0x26E978D5u, 0x020C49BAu}, // 5^3
+        {0x3AFB7E91u, 0x0068DB8Bu}, // 5^4
+        {0x0BCBE61Du, 0x0014F8B5u}, // 5^5
+        {0x68C26139u, 0x000431BDu}, // 5^6
+        {0xAE8D46A5u, 0x0000D6BFu}, // 5^7
+        {0x22E90E21u, 0x00002AF3u}, // 5^8
+        {0x3A2E9C6Du, 0x00000897u}, // 5^9
+        {0x3ED61F49u, 0x000001B7u}, // 5^10
+        {0x0C913975u, 0x00000057u}, // 5^11
+        {0xCF503EB1u, 0x00000011u}, // 5^12
+    };
+
+    DRAGONBOX_ASSERT(e5 >= 0);
+    DRAGONBOX_ASSERT(e5 <= 12);
+    const MulCmp m5 = Mod5[static_cast<unsigned>(e5)];
+
+    return value * m5.mul <= m5.cmp;
+}
+
+using dragonbox::FloatingDecimal32;
+
+static inline FloatingDecimal32 ToDecimal32_asymmetric_interval(int32_t e2)
+{
+    // NB:
+    // accept_lower_endpoint = true
+    // accept_upper_endpoint = true
+
+    static constexpr int32_t P = Single::SignificandSize;
+
+    // Compute k and beta
+    const int32_t minus_k = FloorLog10ThreeQuartersPow2(e2);
+    const int32_t beta_minus_1 = e2 + FloorLog2Pow10(-minus_k);
+
+    // Compute xi and zi
+    const uint64_t pow10 = ComputePow10_Single(-minus_k);
+
+    const uint32_t lower_endpoint = static_cast<uint32_t>((pow10 - (pow10 >> (P + 1))) >> (64 - P - beta_minus_1));
+    const uint32_t upper_endpoint = static_cast<uint32_t>((pow10 + (pow10 >> (P + 0))) >> (64 - P - beta_minus_1));
+
+    // If we don't accept the left endpoint (but we do!) or
+    // if the left endpoint is not an integer, increase it
+    const bool lower_endpoint_is_integer = (2 <= e2 && e2 <= 3);
+
+    const uint32_t xi = lower_endpoint + !lower_endpoint_is_integer;
+    const uint32_t zi = upper_endpoint;
+
+    // Try bigger divisor
+    uint32_t q = zi / 10;
+    if (q * 10 >= xi)
+    {
+        return {q, minus_k + 1};
+    }
+
+    // Otherwise, compute the round-up of y
+    q = (static_cast<uint32_t>(pow10 >> (64 - (P + 1) - beta_minus_1)) + 1) / 2;
+
+    // When tie occurs, choose one of them according to the rule
+    if (e2 == -35)
+    {
+        q -= (q % 2 != 0); // Round to even.
+    }
+    else
+    {
+        q += (q < xi);
+    }
+
+    return {q, minus_k};
+}
+
+static inline uint32_t ComputeDelta(uint64_t pow10, int32_t beta_minus_1)
+{
+    DRAGONBOX_ASSERT(beta_minus_1 >= 0);
+    DRAGONBOX_ASSERT(beta_minus_1 <= 63);
+    return static_cast<uint32_t>(pow10 >> (64 - 1 - beta_minus_1));
+}
+
+static inline uint32_t Lo32(uint64_t x)
+{
+    return static_cast<uint32_t>(x);
+}
+
+static inline uint32_t Hi32(uint64_t x)
+{
+    return static_cast<uint32_t>(x >> 32);
+}
+
+#if defined(__SIZEOF_INT128__) && !DRACHENNEST_NO_INT128
+
+// Returns (x * y) / 2^64
+static inline uint32_t MulShift(uint32_t x, uint64_t y) // 1 mulx
+{
+    __extension__ using uint128_t = unsigned __int128;
+
+    const uint128_t p = uint128_t{x} * y;
+    return static_cast<uint32_t>(static_cast<uint64_t>(p >> 64));
+}
+
+static inline bool MulParity(uint32_t two_f, uint64_t pow10, int32_t beta_minus_1) // 1 mulx
+{
+    DRAGONBOX_ASSERT(beta_minus_1 >= 1);
+    DRAGONBOX_ASSERT(beta_minus_1 <= 32);
+
+    __extension__ using uint128_t = unsigned __int128;
+
+    const uint128_t p = uint128_t{two_f} * pow10;
+    return ((static_cast<uint64_t>(p >> 32) >> (32 - beta_minus_1)) & 1) != 0;
+}
+
+#else
+
+// Returns (x * y) / 2^64
+static inline uint32_t MulShift(uint32_t x, uint64_t y) // 2 mul
+{
+    const uint64_t p1 = uint64_t{x} * Hi32(y);
+    const uint64_t p0 = uint64_t{x} * Lo32(y);
+    return static_cast<uint32_t>((p1 + Hi32(p0)) >> 32);
+}
+
+static inline bool MulParity(uint32_t two_f, uint64_t pow10, int32_t beta_minus_1) // 2 mul
+{
+    DRAGONBOX_ASSERT(beta_minus_1 >= 1);
+    DRAGONBOX_ASSERT(beta_minus_1 <= 32);
+
+    // mid holds bits [32, 96) of the 96-bit product two_f * pow10 (exactly: the two partial
+    // products cannot carry past bit 96); the parity bit 64 - beta_minus_1 of the full
+    // product is bit 32 - beta_minus_1 of mid.
+    const uint64_t mid = uint64_t{two_f} * Hi32(pow10) + Hi32(uint64_t{two_f} * Lo32(pow10));
+    return (mid & (uint64_t{1} << (32 - beta_minus_1))) != 0;
+}
+
+#endif
+
+static inline bool IsIntegralEndpoint(uint32_t two_f, int32_t e2, int32_t minus_k)
+{
+    if (e2 < -1)
+        return false;
+    if (e2 <= 6)
+        return true;
+    if (e2 <= 39)
+        return MultipleOfPow5(two_f, minus_k);
+
+    return false;
+}
+
+static inline bool IsIntegralMidpoint(uint32_t two_f, int32_t e2, int32_t minus_k)
+{
+    if (e2 < -2)
+        return MultipleOfPow2(two_f, minus_k - e2 + 1);
+    if (e2 <= 6)
+        return true;
+    if (e2 <= 39)
+        return MultipleOfPow5(two_f, minus_k);
+
+    return false;
+}
+
+static constexpr int32_t Kappa = 1;
+static constexpr uint32_t BigDivisor   = 100; // 10^(kappa + 1)
+static constexpr uint32_t SmallDivisor = 10;  // 10^(kappa)
+
+static inline FloatingDecimal32 ToDecimal32(const uint32_t ieee_significand, const uint32_t ieee_exponent)
+{
+    //
+    // Step 1:
+    // integer promotion & Schubfach multiplier calculation.
+    //
+
+    uint32_t m2;
+    int32_t  e2;
+    if (ieee_exponent != 0)
+    {
+        m2 = Single::HiddenBit | ieee_significand;
+        e2 = static_cast<int32_t>(ieee_exponent) - Single::ExponentBias;
+
+        if /*unlikely*/ (0 <= -e2 && -e2 < Single::SignificandSize && MultipleOfPow2(m2, -e2))
+        {
+            // Small integer.
+            return {m2 >> -e2, 0};
+        }
+
+        if /*unlikely*/ (ieee_significand == 0 && ieee_exponent > 1)
+        {
+            // Shorter interval case; proceed like Schubfach.
+            return ToDecimal32_asymmetric_interval(e2);
+        }
+    }
+    else
+    {
+        // Subnormal case; interval is always regular.
+        m2 = ieee_significand;
+        e2 = 1 - Single::ExponentBias;
+    }
+
+    const bool is_even = (m2 % 2 == 0);
+    const bool accept_lower = is_even;
+    const bool accept_upper = is_even;
+
+    const uint32_t two_fl = 2 * m2 - 1;
+    const uint32_t two_fc = 2 * m2;
+    const uint32_t two_fr = 2 * m2 + 1; // (25 bits)
+
+    // Compute k and beta.
+    const int32_t minus_k = FloorLog10Pow2(e2) - Kappa;
+    const int32_t beta_minus_1 = e2 + FloorLog2Pow10(-minus_k);
+    DRAGONBOX_ASSERT(beta_minus_1 >= 3);
+    DRAGONBOX_ASSERT(beta_minus_1 <= 6);
+
+    const uint64_t pow10 = ComputePow10_Single(-minus_k);
+
+    // Compute delta
+    // 10^kappa <= delta < 10^(kappa + 1)
+    //       10 <= delta < 100
+    const uint32_t delta = ComputeDelta(pow10, beta_minus_1);
+    DRAGONBOX_ASSERT(delta >= SmallDivisor);
+    DRAGONBOX_ASSERT(delta <  BigDivisor  );
+
+    // Compute zi
+    //  (25 + 6 = 31 bits)
+    const uint32_t zi = MulShift(two_fr << beta_minus_1, pow10); // 1 mulx
+
+    //
+    // Step 2:
+    // Try larger divisor.
+    //
+
+    uint32_t q = zi / BigDivisor;
+    uint32_t r = zi - BigDivisor * q; // r = zi % BigDivisor
+    // 0 <= r < 100
+
+    if /*likely ~50% ?!*/ (r < delta)
+    {
+        // Exclude the right endpoint if necessary
+        if /*likely*/ (r != 0 || accept_upper || !IsIntegralEndpoint(two_fr, e2, minus_k))
+        {
+            return {q, minus_k + Kappa + 1};
+        }
+
+        DRAGONBOX_ASSERT(q != 0);
+        --q;
+        r = BigDivisor;
+    }
+    else if /*unlikely*/ (r == delta)
+    {
+        // Compare fractional parts.
+        // Check conditions in the order different from the paper
+        // to take advantage of short-circuiting
+        if ((accept_lower && IsIntegralEndpoint(two_fl, e2, minus_k)) || MulParity(two_fl, pow10, beta_minus_1)) // 1 mulx
+        {
+            return {q, minus_k + Kappa + 1};
+        }
+    }
+    else /*likely ~50% ?!*/ // (r > deltai)
+    {
+    }
+
+    //
+    // Step 3:
+    // Find the significand with the smaller divisor
+    //
+
+    q *= 10; // 1 mul
+
+    // 0 <= r <= 100
+
+    const uint32_t dist = r - (delta / 2) + (SmallDivisor / 2);
+
+    const uint32_t dist_q = dist / 10; // 1 mul
+//  const uint32_t dist_r = dist % 10;
+    q += dist_q;
+
+//  if /*likely*/ (dist_r == 0)
+    if /*likely*/ (dist == dist_q * 10) // 1 mul32
+    {
+        // NB: SmallDivisor / 2 == 5 is odd, so (unlike in the double-precision version) the
+        // parity of dist alone is not the parity of y.
+        const bool approx_y_parity = ((dist ^ (SmallDivisor / 2)) & 1) != 0;
+
+        // Check z^(f) >= epsilon^(f)
+        // We have either yi == zi - epsiloni or yi == (zi - epsiloni) - 1,
+        // where yi == zi - epsiloni if and only if z^(f) >= epsilon^(f)
+        // Since there are only 2 possibilities, we only need to care about the
+        // parity. Also, zi and r should have the same parity since the divisor
+        // is an even number
+        if /*likely*/ (MulParity(two_fc, pow10, beta_minus_1) != approx_y_parity) // 1 mulx
+        {
+            --q;
+        }
+        // If z^(f) >= epsilon^(f), we might have a tie
+        // when z^(f) == epsilon^(f), or equivalently, when y is an integer
+        else if (q % 2 != 0 && IsIntegralMidpoint(two_fc, e2, minus_k))
+        {
+            --q;
+        }
+    }
+
+    return {q, minus_k + Kappa};
+}
+
+//==================================================================================================
+// ToChars
+//==================================================================================================
+
+// The digit pairs table and the low-level digit printers are shared by all engines, see
+// itoa.h.
+using drachennest::itoa::Utoa_2Digits;
+using drachennest::itoa::TrailingZeros_2Digits;
+
+static inline int32_t PrintDecimalDigitsBackwards(char* buf, uint32_t output)
+{
+    int32_t tz = 0; // number of trailing zeros removed.
+    int32_t nd = 0; // number of decimal digits processed.
+
+    // At most 9 digits remaining
+
+    if (output >= 10000)
+    {
+        const uint32_t q = output / 10000;
+        const uint32_t r = output % 10000;
+        output = q;
+        buf -= 4;
+        if (r != 0)
+        {
+            const uint32_t rH = r / 100;
+            const uint32_t rL = r % 100;
+            Utoa_2Digits(buf + 0, rH);
+            Utoa_2Digits(buf + 2, rL);
+
+            tz = TrailingZeros_2Digits(rL == 0 ? rH : rL) + (rL == 0 ? 2 : 0);
+        }
+        else
+        {
+            tz = 4;
+        }
+        nd = 4;
+    }
+
+    // At most 5 digits remaining.
+
+    if (output >= 100)
+    {
+        const uint32_t q = output / 100;
+        const uint32_t r = output % 100;
+        output = q;
+        buf -= 2;
+        Utoa_2Digits(buf, r);
+        if (tz == nd)
+        {
+            tz += TrailingZeros_2Digits(r);
+        }
+        nd += 2;
+
+        if (output >= 100)
+        {
+            const uint32_t q2 = output / 100;
+            const uint32_t r2 = output % 100;
+            output = q2;
+            buf -= 2;
+            Utoa_2Digits(buf, r2);
+            if (tz == nd)
+            {
+                tz += TrailingZeros_2Digits(r2);
+            }
+            nd += 2;
+        }
+    }
+
+    // At most 2 digits remaining.
+
+    DRAGONBOX_ASSERT(output >= 1);
+    DRAGONBOX_ASSERT(output <= 99);
+
+    if (output >= 10)
+    {
+        const uint32_t q = output;
+        buf -= 2;
+        Utoa_2Digits(buf, q);
+        if (tz == nd)
+        {
+            tz += TrailingZeros_2Digits(q);
+        }
+//      nd += 2;
+    }
+    else
+    {
+        const uint32_t q = output;
+        DRAGONBOX_ASSERT(q >= 1);
+        DRAGONBOX_ASSERT(q <= 9);
+        *--buf = static_cast<char>('0' + q);
+    }
+
+    return tz;
+}
+
+static inline int32_t DecimalLength(uint32_t v)
+{
+    DRAGONBOX_ASSERT(v >= 1);
+    DRAGONBOX_ASSERT(v <= 999999999u);
+
+    if (v >= 100000000u) { return 9; }
+    if (v >= 10000000u) { return 8; }
+    if (v >= 1000000u) { return 7; }
+    if (v >= 100000u) { return 6; }
+    if (v >= 10000u) { return 5; }
+    if (v >= 1000u) { return 4; }
+    if (v >= 100u) { return 3; }
+    if (v >= 10u) { return 2; }
+    return 1;
+}
+
+static inline char* FormatDigits(char* buffer, uint32_t digits, int32_t decimal_exponent, bool force_trailing_dot_zero = false)
+{
+    static constexpr int32_t MinFixedDecimalPoint = -4;
+    static constexpr int32_t MaxFixedDecimalPoint =  9;
+    static_assert(MinFixedDecimalPoint <= -1, "internal error");
+    static_assert(MaxFixedDecimalPoint >=  1, "internal error");
+
+    DRAGONBOX_ASSERT(digits >= 1);
+    DRAGONBOX_ASSERT(digits <= 999999999u);
+    DRAGONBOX_ASSERT(decimal_exponent >= -99);
+    DRAGONBOX_ASSERT(decimal_exponent <=  99);
+
+    int32_t num_digits = DecimalLength(digits);
+    const int32_t decimal_point = num_digits + decimal_exponent;
+
+    const bool use_fixed = MinFixedDecimalPoint <= decimal_point && decimal_point <= MaxFixedDecimalPoint;
+
+    // Prepare the buffer.
+    // Avoid calling memset/memcpy with variable arguments below...
+
+    std::memset(buffer +  0, '0', 16);
+    std::memset(buffer + 16, '0', 16);
+    static_assert(MinFixedDecimalPoint >= -30, "internal error");
+    static_assert(MaxFixedDecimalPoint <=  32, "internal error");
+
+    int32_t decimal_digits_position;
+    if (use_fixed)
+    {
+        if (decimal_point <= 0)
+        {
+            // 0.[000]digits
+            decimal_digits_position = 2 - decimal_point;
+        }
+        else
+        {
+            // dig.its
+            // digits[000]
+            decimal_digits_position = 0;
+        }
+    }
+    else
+    {
+        // dE+123 or d.igitsE+123
+        decimal_digits_position = 1;
+    }
+
+    char* digits_end = buffer + decimal_digits_position + num_digits;
+
+    const int32_t tz = PrintDecimalDigitsBackwards(digits_end, digits);
+    digits_end -= tz;
+    num_digits -= tz;
+//  decimal_exponent += tz; // => decimal_point unchanged.
+
+    if (use_fixed)
+    {
+        if (decimal_point <= 0)
+        {
+            // 0.[000]digits
+            buffer[1] = '.';
+            buffer = digits_end;
+        }
+        else if (decimal_point < num_digits)
+        {
+            // dig.its
+            std::memmove(buffer + decimal_point + 1, buffer + decimal_point, 8);
+            buffer[decimal_point] = '.';
+            buffer = digits_end + 1;
+        }
+        else
+        {
+            // digits[000]
+            buffer += decimal_point;
+            if (force_trailing_dot_zero)
+            {
+                std::memcpy(buffer, ".0", 2);
+                buffer += 2;
+            }
+        }
+    }
+    else
+    {
+        buffer[0] = buffer[1];
+        if (num_digits == 1)
+        {
+            // dE+123
+            ++buffer;
+        }
+        else
+        {
+            // d.igitsE+123
+            buffer[1] = '.';
+            buffer = digits_end;
+        }
+
+        const int32_t scientific_exponent = decimal_point - 1;
+//      DRAGONBOX_ASSERT(scientific_exponent != 0);
+
+        std::memcpy(buffer, scientific_exponent < 0 ? "e-" : "e+", 2);
+        buffer += 2;
+
+        const uint32_t k = static_cast<uint32_t>(scientific_exponent < 0 ? -scientific_exponent : scientific_exponent);
+        if (k < 10)
+        {
+            *buffer++ = static_cast<char>('0' + k);
+        }
+        else
+        {
+            Utoa_2Digits(buffer, k);
+            buffer += 2;
+        }
+    }
+
+    return buffer;
+}
+
+static inline char* ToChars(char* buffer, float value, bool force_trailing_dot_zero = false)
+{
+    const Single v(value);
+
+    const uint32_t significand = v.PhysicalSignificand();
+    const uint32_t exponent = v.PhysicalExponent();
+
+    if (exponent != Single::MaxIeeeExponent) // [[likely]]
+    {
+        // Finite
+
+        buffer[0] = '-';
+        buffer += v.SignBit();
+
+        if (exponent != 0 || significand != 0) // [[likely]]
+        {
+            // != 0
+
+            const auto dec = ToDecimal32(significand, exponent);
+            return FormatDigits(buffer, dec.significand, dec.exponent, force_trailing_dot_zero);
+        }
+        else
+        {
+            std::memcpy(buffer, "0.0 ", 4);
+            buffer += force_trailing_dot_zero ? 3 : 1;
+            return buffer;
+        }
+    }
+
+    if (significand == 0)
+    {
+        buffer[0] = '-';
+        buffer += v.SignBit();
+
+        std::memcpy(buffer, "inf ", 4);
+        return buffer + 3;
+    }
+    else
+    {
+        std::memcpy(buffer, "nan ", 4);
+        return buffer + 3;
+    }
+}
+
+//==================================================================================================
+//
+//==================================================================================================
+
+char* dragonbox::Ftoa(char* buffer, float value)
+{
+    return ToChars(buffer, value);
+}
+
+dragonbox::FloatingDecimal32 dragonbox::ToDecimal32(float value)
+{
+    const Single v(value);
+    DRAGONBOX_ASSERT(v.IsFinite());
+    DRAGONBOX_ASSERT(!v.IsZero());
+
+    return ::ToDecimal32(v.PhysicalSignificand(), v.PhysicalExponent());
+}
+
+dragonbox::FloatingDecimal32 dragonbox::ToDecimal32(uint32_t ieee_significand, uint32_t ieee_exponent)
+{
+    DRAGONBOX_ASSERT(ieee_exponent != Single::MaxIeeeExponent);
+    DRAGONBOX_ASSERT(ieee_exponent != 0 || ieee_significand != 0);
+
+    return ::ToDecimal32(ieee_significand, ieee_exponent);
+}
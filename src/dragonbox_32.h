@@ -0,0 +1,54 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+namespace dragonbox {
+
+// char* output_end = Ftoa(buffer, value);
+//
+// Converts the given single-precision number into decimal form and stores the result in the given
+// buffer.
+//
+// The buffer must be large enough, i.e. >= FtoaMinBufferLength.
+// The output format is similar to printf("%g").
+// The output is _not_ null-terminted.
+//
+// The output is optimal, i.e. the output string
+//  1. rounds back to the input number when read in (using round-to-nearest-even)
+//  2. is as short as possible,
+//  3. is as close to the input number as possible.
+//
+// Note:
+// This function may temporarily write up to FtoaMinBufferLength characters into the buffer.
+
+constexpr int FtoaMinBufferLength = 32;
+
+char* Ftoa(char* buffer, float value);
+
+// FloatingDecimal32 dec = ToDecimal32(value);
+//
+// Converts the given single-precision number into the decimal form (significand, exponent), i.e.
+//  value = significand * 10^exponent
+//
+// The returned significand is optimal in the same sense as for Ftoa. Use this function instead of
+// Ftoa if the decimal representation is needed, but not its ASCII form.
+//
+// PRE: value must be finite and non-zero. The sign of value is ignored.
+//
+// The second overload operates directly on the (biased) IEEE representation, i.e. on the
+// physical significand and exponent fields of the float.
+
+struct FloatingDecimal32 {
+    uint32_t significand;
+    int32_t exponent;
+};
+
+FloatingDecimal32 ToDecimal32(float value);
+FloatingDecimal32 ToDecimal32(uint32_t ieee_significand, uint32_t ieee_exponent);
+
+} // namespace dragonbox
@@ -0,0 +1,87 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "dtoa_cache.h"
+
+#include "schubfach_64.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#ifndef DC_ASSERT
+#define DC_ASSERT(X) assert(X)
+#endif
+
+//==================================================================================================
+//
+//==================================================================================================
+
+namespace {
+
+// The longest output of schubfach::Dtoa is DtoaMaxLength characters, so the text always
+// fits and the copy-out can be a single fixed-size memcpy.
+struct CacheEntry {
+    uint64_t key;  // IEEE bit pattern of the cached value
+    uint32_t len;  // 0 marks an unused entry
+    char text[schubfach::DtoaMaxLength];
+};
+
+constexpr uint32_t NumBuckets = 256; // * 2 ways * sizeof(CacheEntry) = 20 KB per thread
+
+struct Cache {
+    // Each bucket has two ways: entries[2 * b] holds the hot entry, entries[2 * b + 1] the
+    // probationary one.
+    CacheEntry entries[2 * NumBuckets];
+};
+
+thread_local Cache thread_cache;
+
+static inline uint32_t BucketIndex(uint64_t key)
+{
+    // Fibonacci hashing: the bit patterns of quantized values differ mostly in the low
+    // significand bits, which a multiply spreads over the whole word.
+    return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> 32) % NumBuckets;
+}
+
+} // namespace
+
+char* drachennest::CachedDtoa(char* buffer, double value)
+{
+    uint64_t key;
+    std::memcpy(&key, &value, sizeof(value));
+
+    Cache& cache = thread_cache;
+    CacheEntry* const bucket = &cache.entries[2 * BucketIndex(key)];
+
+    if (bucket[0].len != 0 && bucket[0].key == key)
+    {
+        std::memcpy(buffer, bucket[0].text, sizeof(bucket[0].text));
+        return buffer + bucket[0].len;
+    }
+
+    if (bucket[1].len != 0 && bucket[1].key == key)
+    {
+        // Promote: a second hit means the value is reused, so it should survive evictions.
+        const CacheEntry tmp = bucket[0];
+        bucket[0] = bucket[1];
+        bucket[1] = tmp;
+
+        std::memcpy(buffer, bucket[0].text, sizeof(bucket[0].text));
+        return buffer + bucket[0].len;
+    }
+
+    char* const end = schubfach::Dtoa(buffer, value);
+    const uint32_t len = static_cast<uint32_t>(end - buffer);
+    DC_ASSERT(len <= sizeof(bucket[1].text));
+
+    // Insert into the probationary way only: one-shot values churn through here without
+    // displacing the hot entry in way 0.
+    bucket[1].key = key;
+    bucket[1].len = len;
+    std::memcpy(bucket[1].text, buffer, sizeof(bucket[1].text));
+
+    return end;
+}
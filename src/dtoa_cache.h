@@ -0,0 +1,28 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+namespace drachennest {
+
+// char* output_end = CachedDtoa(buffer, value);
+//
+// Formats the given double-precision number exactly as schubfach::Dtoa, but fronts the
+// conversion with a small per-thread memoization cache keyed on the IEEE bit pattern.
+// Workloads which format the same values over and over (quantized gauges, a few thousand
+// distinct bit patterns across millions of calls) turn into a hash probe plus a fixed-size
+// memcpy; workloads without reuse pay one probe and one store per call.
+//
+// The cache is a fixed-size, open-addressing table with two ways per bucket: a hit in the
+// second way promotes the entry to the first, so under skewed (Zipf-like) distributions the
+// hot values stay resident while the cold tail churns through the second way only.
+//
+// The buffer must be large enough, i.e. >= schubfach::DtoaMaxLength; like schubfach::Dtoa,
+// this function never writes past buffer + schubfach::DtoaMaxLength.
+// The output is _not_ null-terminated.
+
+char* CachedDtoa(char* buffer, double value);
+
+} // namespace drachennest
@@ -0,0 +1,433 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "dtoa_column.h"
+
+#include "itoa.h"
+#include "schubfach_64.h"
+
+#include <cassert>
+#include <cstring>
+
+#ifndef COL_ASSERT
+#define COL_ASSERT(X) assert(X)
+#endif
+
+// Non-temporal flushing for DtoaColumnStream. (May be disabled by defining COL_SIMD_STREAM=0.)
+#ifndef COL_SIMD_STREAM
+#if defined(__SSE2__) || (defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define COL_SIMD_STREAM 1
+#else
+#define COL_SIMD_STREAM 0
+#endif
+#endif
+
+#if COL_SIMD_STREAM
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define COL_PREFETCH(P) __builtin_prefetch(P)
+#elif COL_SIMD_STREAM
+#define COL_PREFETCH(P) _mm_prefetch(reinterpret_cast<const char*>(P), _MM_HINT_T0)
+#else
+#define COL_PREFETCH(P) (static_cast<void>(0))
+#endif
+
+//==================================================================================================
+//
+//==================================================================================================
+
+// The statistics accumulation is a compile-time policy: the plain entry points run with
+// NoStats, whose empty Update inlines to nothing, so they pay nothing for the hook.
+namespace {
+struct NoStats
+{
+    void Update(double) {}
+};
+}
+
+template <typename Stats>
+static inline size_t DtoaColumnImpl(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets, Stats& stats)
+{
+    COL_ASSERT(buffer_size <= static_cast<size_t>(INT32_MAX));
+
+    char* next = buffer;
+    char* const last = buffer + buffer_size;
+
+    offsets[0] = 0;
+
+    // Fast path: with DtoaMaxLength characters of headroom the value can be formatted at
+    // its final position, and the offset is simply where Dtoa stopped.
+    size_t i = 0;
+    for (; i < count && last - next >= schubfach::DtoaMaxLength; ++i)
+    {
+        stats.Update(values[i]);
+        next = schubfach::Dtoa(next, values[i]);
+        offsets[i + 1] = static_cast<int32_t>(next - buffer);
+    }
+
+    // Tail: too little headroom to let Dtoa write freely; format into a bounce buffer and
+    // copy what actually fits.
+    for (; i < count; ++i)
+    {
+        char buf[schubfach::DtoaMaxLength];
+        const size_t len = static_cast<size_t>(schubfach::Dtoa(buf, values[i]) - buf);
+        if (len > static_cast<size_t>(last - next))
+            return 0;
+        stats.Update(values[i]);
+        std::memcpy(next, buf, len);
+        next += len;
+        offsets[i + 1] = static_cast<int32_t>(next - buffer);
+    }
+
+    return static_cast<size_t>(next - buffer);
+}
+
+size_t drachennest::DtoaColumn(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets)
+{
+    NoStats none;
+    return DtoaColumnImpl(buffer, buffer_size, values, count, offsets, none);
+}
+
+size_t drachennest::DtoaColumn(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets, ColumnStats& stats)
+{
+    return DtoaColumnImpl(buffer, buffer_size, values, count, offsets, stats);
+}
+
+//==================================================================================================
+// DtoaColumnStream
+//==================================================================================================
+
+// Destinations at least this large get flushed with non-temporal stores: the column cannot
+// stay resident anyway, and streaming it straight to memory keeps it from evicting the
+// working set. (Half of a typical last-level cache.)
+static constexpr size_t kNonTemporalThreshold = 8 * 1024 * 1024;
+
+// The cache-resident staging block the values are formatted into before each flush.
+static constexpr size_t kStageSize = 8 * 1024;
+
+#if COL_SIMD_STREAM
+
+// Copies n bytes with non-temporal 16-byte stores; the unaligned head and tail go through
+// regular stores. src is the (cache-resident) staging block.
+static inline void StreamFlush(char* dst, const char* src, size_t n)
+{
+    const size_t misaligned = static_cast<size_t>(reinterpret_cast<uintptr_t>(dst) % 16);
+    size_t head = misaligned != 0 ? 16 - misaligned : 0;
+    if (head > n)
+        head = n;
+    std::memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    n -= head;
+
+    for (; n >= 16; dst += 16, src += 16, n -= 16)
+    {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    }
+
+    std::memcpy(dst, src, n);
+}
+
+#endif // COL_SIMD_STREAM
+
+template <typename Stats>
+static inline size_t DtoaColumnStreamImpl(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets, Stats& stats, size_t prefetch_distance)
+{
+    COL_ASSERT(buffer_size <= static_cast<size_t>(INT32_MAX));
+
+#if COL_SIMD_STREAM
+    if (buffer_size >= kNonTemporalThreshold)
+    {
+        offsets[0] = 0;
+
+        alignas(16) char stage[kStageSize];
+
+        size_t flushed = 0; // bytes already streamed into buffer
+        size_t staged = 0;  // bytes pending in stage
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (prefetch_distance != 0 && i + prefetch_distance < count)
+                COL_PREFETCH(values + i + prefetch_distance);
+
+            if (kStageSize - staged < static_cast<size_t>(schubfach::DtoaMaxLength))
+            {
+                StreamFlush(buffer + flushed, stage, staged);
+                flushed += staged;
+                staged = 0;
+            }
+
+            const size_t len = static_cast<size_t>(schubfach::Dtoa(stage + staged, values[i]) - (stage + staged));
+            if (len > buffer_size - flushed - staged)
+            {
+                _mm_sfence();
+                return 0;
+            }
+            stats.Update(values[i]);
+            staged += len;
+            offsets[i + 1] = static_cast<int32_t>(flushed + staged);
+        }
+
+        StreamFlush(buffer + flushed, stage, staged);
+        _mm_sfence();
+        return flushed + staged;
+    }
+#endif // COL_SIMD_STREAM
+
+    // The destination fits in cache (or there are no non-temporal stores on this target):
+    // regular stores, but still prefetch the input stream.
+    char* next = buffer;
+    char* const last = buffer + buffer_size;
+
+    offsets[0] = 0;
+
+    size_t i = 0;
+    for (; i < count && last - next >= schubfach::DtoaMaxLength; ++i)
+    {
+        if (prefetch_distance != 0 && i + prefetch_distance < count)
+            COL_PREFETCH(values + i + prefetch_distance);
+
+        stats.Update(values[i]);
+        next = schubfach::Dtoa(next, values[i]);
+        offsets[i + 1] = static_cast<int32_t>(next - buffer);
+    }
+
+    for (; i < count; ++i)
+    {
+        char buf[schubfach::DtoaMaxLength];
+        const size_t len = static_cast<size_t>(schubfach::Dtoa(buf, values[i]) - buf);
+        if (len > static_cast<size_t>(last - next))
+            return 0;
+        stats.Update(values[i]);
+        std::memcpy(next, buf, len);
+        next += len;
+        offsets[i + 1] = static_cast<int32_t>(next - buffer);
+    }
+
+    return static_cast<size_t>(next - buffer);
+}
+
+size_t drachennest::DtoaColumnStream(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets, size_t prefetch_distance)
+{
+    NoStats none;
+    return DtoaColumnStreamImpl(buffer, buffer_size, values, count, offsets, none, prefetch_distance);
+}
+
+size_t drachennest::DtoaColumnStream(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets, ColumnStats& stats, size_t prefetch_distance)
+{
+    return DtoaColumnStreamImpl(buffer, buffer_size, values, count, offsets, stats, prefetch_distance);
+}
+
+//==================================================================================================
+// DtoaColumnSorted
+//==================================================================================================
+
+// The chunk the exponent sort runs over: large enough that the buckets build real runs over
+// the pow10 cache, small enough that the per-chunk scratch (decimals, order, histogram)
+// stays cache-resident.
+static constexpr size_t kSortChunkSize = 1024;
+
+static inline uint32_t BiasedExponent(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return static_cast<uint32_t>((bits >> 52) & 0x7FF);
+}
+
+size_t drachennest::DtoaColumnSorted(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets)
+{
+    COL_ASSERT(buffer_size <= static_cast<size_t>(INT32_MAX));
+
+    char* next = buffer;
+    char* const last = buffer + buffer_size;
+
+    offsets[0] = 0;
+
+    schubfach::FloatingDecimal64 decs[kSortChunkSize];
+    uint16_t order[kSortChunkSize];
+
+    for (size_t chunk = 0; chunk < count; chunk += kSortChunkSize)
+    {
+        const size_t n = count - chunk < kSortChunkSize ? count - chunk : kSortChunkSize;
+        const double* const chunk_values = values + chunk;
+
+        // Counting sort of the chunk's indices by the 11-bit biased exponent. The sort only
+        // needs to group equal (and order adjacent) exponents, which map to the same or
+        // adjacent pow10 cache lines; it does not need to be stable.
+        uint16_t counts[2048] = {0};
+        for (size_t i = 0; i < n; ++i)
+            ++counts[BiasedExponent(chunk_values[i])];
+
+        uint16_t sum = 0;
+        for (size_t e = 0; e < 2048; ++e)
+        {
+            const uint16_t c = counts[e];
+            counts[e] = sum;
+            sum = static_cast<uint16_t>(sum + c);
+        }
+
+        for (size_t i = 0; i < n; ++i)
+            order[counts[BiasedExponent(chunk_values[i])]++] = static_cast<uint16_t>(i);
+
+        // The decimal conversions -- the only part that loads the pow10 cache -- run in
+        // exponent order.
+        for (size_t s = 0; s < n; ++s)
+        {
+            const size_t i = order[s];
+
+            uint64_t bits;
+            std::memcpy(&bits, &chunk_values[i], sizeof(bits));
+
+            const uint64_t significand = bits & 0x000FFFFFFFFFFFFFull;
+            const uint64_t exponent = (bits >> 52) & 0x7FF;
+            if (exponent != 0x7FF && (bits & 0x7FFFFFFFFFFFFFFFull) != 0)
+                decs[i] = schubfach::ToDecimal64(significand, exponent);
+            else
+                decs[i] = {1, 0}; // ignored for zero and non-finite values
+        }
+
+        // Emission runs in the original input order (FormatKnownLength does not touch the
+        // cache), with the headroom fast path and bounce-buffer tail of DtoaColumn.
+        size_t i = 0;
+        for (; i < n && last - next >= schubfach::DtoaMaxLength; ++i)
+        {
+            next = schubfach::FormatKnownLength(next, chunk_values[i], decs[i]);
+            offsets[chunk + i + 1] = static_cast<int32_t>(next - buffer);
+        }
+
+        for (; i < n; ++i)
+        {
+            char buf[schubfach::DtoaMaxLength];
+            const size_t len = static_cast<size_t>(schubfach::FormatKnownLength(buf, chunk_values[i], decs[i]) - buf);
+            if (len > static_cast<size_t>(last - next))
+                return 0;
+            std::memcpy(next, buf, len);
+            next += len;
+            offsets[chunk + i + 1] = static_cast<int32_t>(next - buffer);
+        }
+    }
+
+    return static_cast<size_t>(next - buffer);
+}
+
+//==================================================================================================
+// DtoaSequence
+//==================================================================================================
+
+static_assert(schubfach::DtoaMaxLength <= 32, "DtoaSequence::text_ must hold a full Dtoa output");
+
+char* drachennest::DtoaSequence::Format(char* buffer, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const uint64_t abs_bits = bits & 0x7FFFFFFFFFFFFFFFull;
+    if (abs_bits - 1 >= 0x7FF0000000000000ull - 1)
+    {
+        // Zero, inf or nan: no digits to share.
+        length_ = 0;
+        return schubfach::Dtoa(buffer, value);
+    }
+
+    // Strip the trailing zeros up front (as FormatDigits does), so equal digit counts imply
+    // equal text layouts and the changed low digits sit at the same text positions.
+    schubfach::FloatingDecimal64 dec = schubfach::ToDecimal64(value);
+    while (dec.digits % 10 == 0)
+    {
+        dec.digits /= 10;
+        ++dec.exponent;
+    }
+
+    const int32_t num_digits = static_cast<int32_t>(drachennest::itoa::DecimalLength(dec.digits));
+    const int32_t decimal_point = num_digits + dec.exponent;
+    const bool negative = (bits >> 63) != 0;
+
+    // Scientific outputs could share prefixes too, but the exponent suffix makes the
+    // position bookkeeping not worth it for the monotone (fixed notation) sequences this
+    // formatter is for.
+    const bool use_fixed = -6 <= decimal_point && decimal_point <= 17;
+
+    if (length_ != 0 && use_fixed && negative == negative_ && num_digits == num_digits_ && decimal_point == decimal_point_)
+    {
+        // Same layout: the texts differ exactly in the differing low digits.
+        uint64_t a = dec.digits;
+        uint64_t b = digits_;
+        int32_t k = 0;
+        while (a != b)
+        {
+            a /= 10;
+            b /= 10;
+            ++k;
+        }
+
+        std::memcpy(buffer, text_, static_cast<size_t>(length_));
+
+        // Rewrite the k low digits at their (end-relative) positions in the FormatDigits
+        // layouts "0.[000]digits", "dig.its" and "digits[000]".
+        const int32_t num_fraction_digits = decimal_point < num_digits ? num_digits - decimal_point : 0;
+        const int32_t num_trailing_zeros  = decimal_point > num_digits ? decimal_point - num_digits : 0;
+
+        uint64_t t = dec.digits;
+        for (int32_t j = 0; j < k; ++j)
+        {
+            int32_t pos = length_ - 1 - num_trailing_zeros - j;
+            if (num_fraction_digits != 0 && j >= num_fraction_digits)
+                --pos; // skip the '.'
+            buffer[pos] = static_cast<char>('0' + t % 10);
+            t /= 10;
+        }
+
+        digits_ = dec.digits;
+        std::memcpy(text_, buffer, static_cast<size_t>(length_));
+        return buffer + length_;
+    }
+
+    // No previous value, or it does not line up: format from scratch (reusing the decimal
+    // computed above) and remember the output.
+    char* const end = schubfach::FormatKnownLength(buffer, value, dec);
+
+    digits_ = dec.digits;
+    num_digits_ = num_digits;
+    decimal_point_ = decimal_point;
+    negative_ = negative;
+    length_ = static_cast<int32_t>(end - buffer);
+    std::memcpy(text_, buffer, static_cast<size_t>(length_));
+
+    return end;
+}
+
+size_t drachennest::DtoaColumnSequence(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets)
+{
+    COL_ASSERT(buffer_size <= static_cast<size_t>(INT32_MAX));
+
+    DtoaSequence seq;
+
+    char* next = buffer;
+    char* const last = buffer + buffer_size;
+
+    offsets[0] = 0;
+
+    size_t i = 0;
+    for (; i < count && last - next >= schubfach::DtoaMaxLength; ++i)
+    {
+        next = seq.Format(next, values[i]);
+        offsets[i + 1] = static_cast<int32_t>(next - buffer);
+    }
+
+    for (; i < count; ++i)
+    {
+        char buf[schubfach::DtoaMaxLength];
+        const size_t len = static_cast<size_t>(seq.Format(buf, values[i]) - buf);
+        if (len > static_cast<size_t>(last - next))
+            return 0;
+        std::memcpy(next, buf, len);
+        next += len;
+        offsets[i + 1] = static_cast<int32_t>(next - buffer);
+    }
+
+    return static_cast<size_t>(next - buffer);
+}
@@ -0,0 +1,133 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace drachennest {
+
+// size_t size = DtoaColumn(buffer, buffer_size, values, count, offsets);
+//
+// Formats the given values (schubfach::Dtoa) back-to-back -- no separators -- into the
+// caller-provided buffer and fills the columnar (Apache Arrow string array style) offsets:
+// offsets[0] == 0 and offsets[i + 1] is the end of the i-th value, so count + 1 entries are
+// written.
+//
+// While at least DtoaMaxLength characters of headroom remain, every value is formatted
+// directly at its final position: Dtoa never writes past that extent, so there are no
+// per-value temporaries, copies or bounds checks on this path. A buffer with
+// count * DtoaMaxLength capacity stays on it for all values; tail values with less headroom
+// go through a bounds-checked bounce buffer.
+//
+// Returns the number of characters written, or 0 if the buffer is too small (the contents
+// of buffer and offsets are unspecified in this case).
+//
+// PRE: buffer_size must fit into the int32 offsets, i.e. be <= INT32_MAX.
+
+size_t DtoaColumn(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets);
+
+// size_t size = DtoaColumnStream(buffer, buffer_size, values, count, offsets, prefetch_distance);
+//
+// Like DtoaColumn, tuned for inputs that stream from DRAM: the conversion itself is fast
+// enough that the value loads dominate, so the loop issues a software prefetch
+// prefetch_distance values ahead of the conversion cursor (0 disables prefetching). For
+// destination buffers too large to live in the last-level cache, the output additionally
+// goes through a small cache-resident staging block and is flushed with non-temporal
+// stores, so the column does not evict the working set on its way to memory (SSE2 targets;
+// elsewhere this degrades to regular stores).
+//
+// Output, offsets and the return value are exactly those of DtoaColumn.
+
+size_t DtoaColumnStream(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets, size_t prefetch_distance = 64);
+
+// size_t size = DtoaColumnSorted(buffer, buffer_size, values, count, offsets);
+//
+// Like DtoaColumn, tuned for unsorted columns (random-bits style data) whose values
+// scatter over the pow10 cache. The column is processed in chunks: each chunk's indices
+// are bucket-sorted by their binary exponent (a single counting pass), the decimal
+// conversions -- the only part that loads the cache -- run in that order so every cache
+// line stays hot across its whole bucket, and the text is then emitted in the original
+// input order from the precomputed decimals. Uniform columns, whose values cluster on a
+// few exponents anyway, gain nothing over DtoaColumn.
+//
+// Output, offsets and the return value are exactly those of DtoaColumn.
+
+size_t DtoaColumnSorted(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets);
+
+// drachennest::ColumnStats stats;
+// size_t size = DtoaColumn(buffer, buffer_size, values, count, offsets, stats);
+//
+// Like DtoaColumn (and DtoaColumnStream below), but additionally accumulates the column
+// statistics file formats like Apache Parquet and ORC keep in their footers -- min, max and
+// the NaN count -- during the formatting pass, which touches every value anyway; computing
+// them here saves a separate sweep over the column.
+//
+// min and max ignore NaNs and compare with operator< (so for columns containing both zeros,
+// whether min/max report -0.0 or 0.0 depends on the input order). A default-constructed
+// ColumnStats has min/max at +-infinity; accumulation continues across calls, so one
+// ColumnStats can collect the statistics of a column formatted in chunks.
+//
+// If the buffer is too small (return value 0), the statistics are unspecified, like the
+// buffer contents.
+
+struct ColumnStats
+{
+    double min = +std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    size_t num_nans = 0;
+
+    void Update(double value) {
+        if (value != value) { // nan
+            ++num_nans;
+            return;
+        }
+        min = value < min ? value : min;
+        max = max < value ? value : max;
+    }
+};
+
+size_t DtoaColumn(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets, ColumnStats& stats);
+size_t DtoaColumnStream(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets, ColumnStats& stats, size_t prefetch_distance = 64);
+
+// drachennest::DtoaSequence seq;
+// char* output_end = seq.Format(buffer, value);
+//
+// Formats the given value exactly as schubfach::Dtoa, but remembers the digits and the text
+// of the previous call: when consecutive values line up -- same sign, same decimal point,
+// same number of significant digits, fixed notation -- the shared leading digits are
+// memcpy'd from the previous output and only the changed low digits are rewritten in place.
+// Monotone sequences ("1724832000.001", "1724832000.002", ...) share almost the whole
+// string; unrelated consecutive values pay one comparison and format from scratch.
+//
+// The buffer must provide the schubfach::DtoaMaxLength headroom of Dtoa; the output is not
+// null-terminated. A default-constructed formatter (or one whose previous value did not
+// line up) behaves exactly like Dtoa.
+
+class DtoaSequence
+{
+public:
+    char* Format(char* buffer, double value);
+
+private:
+    uint64_t digits_ = 0;      // decimal digits of the previous value, trailing zeros stripped
+    int32_t num_digits_ = 0;
+    int32_t decimal_point_ = 0;
+    int32_t length_ = 0;       // formatted length; 0 if there is no previous value
+    bool negative_ = false;
+    char text_[32];            // >= schubfach::DtoaMaxLength (checked in dtoa_column.cc)
+};
+
+// size_t size = DtoaColumnSequence(buffer, buffer_size, values, count, offsets);
+//
+// DtoaColumn through a DtoaSequence: output, offsets and return value are exactly those of
+// DtoaColumn, tuned for monotone columns (timestamps) where consecutive formatted values
+// share a long prefix.
+
+size_t DtoaColumnSequence(char* buffer, size_t buffer_size, const double* values, size_t count, int32_t* offsets);
+
+} // namespace drachennest
@@ -0,0 +1,181 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "dtoa_parallel.h"
+
+#include "schubfach_64.h"
+
+#include <cassert>
+#include <cstring>
+#include <thread>
+
+#ifndef PD_ASSERT
+#define PD_ASSERT(X) assert(X)
+#endif
+
+// If enabled, the spawned workers are pinned to CPUs, spread evenly over the process
+// affinity mask. The worker of slice i gets the same CPU in the format and the gather pass,
+// so on a multi-socket machine each staging arena is faulted, filled and merged on one node
+// (first-touch locality). Only the short-lived workers spawned here are pinned; the calling
+// thread is never touched. (May be disabled by defining PD_PIN_WORKERS=0.)
+#ifndef PD_PIN_WORKERS
+#if defined(__linux__)
+#define PD_PIN_WORKERS 1
+#else
+#define PD_PIN_WORKERS 0
+#endif
+#endif
+
+#if PD_PIN_WORKERS
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using drachennest::ParallelDtoaResult;
+
+//==================================================================================================
+//
+//==================================================================================================
+
+namespace {
+
+// Slices shorter than this are not worth a thread of their own: formatting ~1000 values
+// takes on the order of the time it takes to start one.
+constexpr size_t kMinValuesPerSlice = 1024;
+
+// One thread's share of the input: formats values [first, first + count) into a private
+// arena, then copies the arena into its precomputed place in the final buffer.
+struct Slice
+{
+    const double* values = nullptr;
+    size_t first = 0;
+    size_t count = 0;
+    char separator = '\n';
+
+    std::vector<char> arena;
+    std::vector<size_t> ends;   // end offset of each field, relative to the arena
+    size_t base = 0;            // offset of the arena in the final buffer (set after the prefix sum)
+
+    void Format()
+    {
+        // DtoaMaxLength is the write extent of Dtoa, so formatting at arena.size() - that
+        // many characters is always in bounds; the exact size is known afterwards.
+        arena.resize(count * static_cast<size_t>(schubfach::DtoaMaxLength + 1));
+        ends.resize(count);
+
+        char* const data = arena.data();
+        char* next = data;
+        for (size_t i = 0; i < count; ++i)
+        {
+            next = schubfach::Dtoa(next, values[first + i]);
+            *next++ = separator;
+            ends[i] = static_cast<size_t>(next - data);
+        }
+        arena.resize(static_cast<size_t>(next - data));
+    }
+
+    void Gather(ParallelDtoaResult& result) const
+    {
+        std::memcpy(result.text.data() + base, arena.data(), arena.size());
+
+        size_t* const out = result.offsets.data() + first;
+        for (size_t i = 0; i < count; ++i)
+            out[i] = base + ends[i];
+    }
+};
+
+#if PD_PIN_WORKERS
+// Pins the given worker to the (index * num_cpus / num_workers)-th CPU of the process
+// affinity mask.
+static void PinWorker(std::thread& worker, size_t index, size_t num_workers)
+{
+    cpu_set_t process_mask;
+    if (sched_getaffinity(0, sizeof(process_mask), &process_mask) != 0)
+        return;
+
+    const int num_cpus = CPU_COUNT(&process_mask);
+    if (num_cpus <= 1)
+        return;
+
+    int nth = static_cast<int>(index * static_cast<size_t>(num_cpus) / num_workers);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (!CPU_ISSET(cpu, &process_mask))
+            continue;
+        if (nth-- == 0)
+        {
+            cpu_set_t worker_mask;
+            CPU_ZERO(&worker_mask);
+            CPU_SET(cpu, &worker_mask);
+            pthread_setaffinity_np(worker.native_handle(), sizeof(worker_mask), &worker_mask);
+            return;
+        }
+    }
+}
+#else
+static void PinWorker(std::thread&, size_t, size_t) {}
+#endif
+
+// Runs member function F on every slice: [1, n) on worker threads, slice 0 on the calling
+// thread, then joins. The worker of slice i is pinned to the same CPU on every call (see
+// PD_PIN_WORKERS above).
+template <typename F>
+static void RunOnSlices(std::vector<Slice>& slices, F&& fun)
+{
+    std::vector<std::thread> workers;
+    workers.reserve(slices.size() - 1);
+    for (size_t i = 1; i < slices.size(); ++i)
+    {
+        workers.emplace_back(fun, &slices[i]);
+        PinWorker(workers.back(), i, slices.size());
+    }
+
+    fun(&slices[0]);
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+} // namespace
+
+ParallelDtoaResult drachennest::ParallelDtoa(const double* values, size_t count, char separator, int num_threads)
+{
+    ParallelDtoaResult result;
+    if (count == 0)
+        return result;
+
+    if (num_threads <= 0)
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    size_t num_slices = (num_threads >= 1) ? static_cast<size_t>(num_threads) : 1;
+    if (num_slices > (count + kMinValuesPerSlice - 1) / kMinValuesPerSlice)
+        num_slices = (count + kMinValuesPerSlice - 1) / kMinValuesPerSlice;
+
+    std::vector<Slice> slices(num_slices);
+    for (size_t i = 0; i < num_slices; ++i)
+    {
+        const size_t lo = count * i / num_slices;
+        const size_t hi = count * (i + 1) / num_slices;
+        slices[i].values = values;
+        slices[i].first = lo;
+        slices[i].count = hi - lo;
+        slices[i].separator = separator;
+    }
+
+    RunOnSlices(slices, [](Slice* slice) { slice->Format(); });
+
+    size_t total = 0;
+    for (auto& slice : slices)
+    {
+        slice.base = total;
+        total += slice.arena.size();
+    }
+
+    result.text.resize(total);
+    result.offsets.resize(count);
+    RunOnSlices(slices, [&result](Slice* slice) { slice->Gather(result); });
+
+    PD_ASSERT(result.offsets[count - 1] == total);
+    return result;
+}
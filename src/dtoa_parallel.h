@@ -0,0 +1,40 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace drachennest {
+
+// ParallelDtoaResult result = ParallelDtoa(values, count, separator, num_threads);
+//
+// Formats the given values (schubfach::Dtoa), each followed by 'separator', into one
+// contiguous character buffer, splitting the work over 'num_threads' threads (0 uses the
+// hardware concurrency; 1 formats on the calling thread without spawning).
+//
+// The values are statically partitioned; each thread formats its slice into its own arena,
+// and after a prefix sum over the slice sizes every thread copies its arena into the final
+// buffer in parallel. The output is identical to a sequential loop over the values.
+//
+// On Linux the worker threads are pinned to CPUs so that on multi-socket machines every
+// staging arena stays on the NUMA node that first touched it (see PD_PIN_WORKERS in
+// dtoa_parallel.cc).
+//
+// result.offsets[i] is the end of the i-th field, i.e. the text of value i (including its
+// separator) is
+//
+//     [i == 0 ? 0 : result.offsets[i - 1], result.offsets[i])
+
+struct ParallelDtoaResult
+{
+    std::vector<char> text;
+    std::vector<size_t> offsets; // one entry per value: the end offset of its field
+};
+
+ParallelDtoaResult ParallelDtoa(const double* values, size_t count, char separator = '\n', int num_threads = 0);
+
+} // namespace drachennest
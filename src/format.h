@@ -0,0 +1,152 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "itoa.h"
+#include "schubfach_64.h"
+
+#include <cstdint>
+#include <cstring>
+
+// char* output_end = Format(buffer, DRACHENNEST_FMT("ts={} val={} q={}"), ts, val, q);
+//
+// A small compile-time format-template engine over the Dtoa/Itoa kernels, for fixed-shape
+// output lines (log serialization etc.). The format string is parsed entirely at compile
+// time: each call site compiles into straight-line code -- fixed-size copies of the literal
+// segments, with the "{}" placeholders wired directly to schubfach::Dtoa (double/float
+// arguments) or Itoa (integer arguments). There is no runtime format-string scan, no
+// allocation, and a wrong argument count fails to compile.
+//
+// DRACHENNEST_FMT wraps the string literal into a type, which is what carries it to compile
+// time under C++17 (class-type template parameters holding the characters are C++20). The
+// macro argument must be a string literal.
+//
+// Only "{}" is recognized; every other character (including single braces) is copied
+// verbatim. The numbers are formatted exactly as by Dtoa resp. Itoa.
+//
+// The buffer must be large enough, i.e. >= FormatMaxLength (the literal characters plus the
+// worst case of every placeholder); like Dtoa, Format never writes past that bound.
+
+#define DRACHENNEST_FMT(s)                                          \
+    [] {                                                            \
+        struct DrachennestFmt {                                     \
+            constexpr const char* Str() const { return s; }         \
+            constexpr int32_t Size() const { return sizeof(s) - 1; }\
+        };                                                          \
+        return DrachennestFmt{};                                    \
+    }()
+
+namespace drachennest {
+
+namespace format_detail {
+
+// Returns the position of the next "{}" at or after pos, or the length of the format string
+// if there is none.
+template <typename FormatHolder>
+constexpr int32_t FindPlaceholder(int32_t pos)
+{
+    constexpr const char* str = FormatHolder{}.Str();
+    constexpr int32_t size = FormatHolder{}.Size();
+    for (int32_t i = pos; i + 1 < size; ++i)
+    {
+        if (str[i] == '{' && str[i + 1] == '}')
+            return i;
+    }
+    return size;
+}
+
+template <typename FormatHolder>
+constexpr int32_t CountPlaceholders()
+{
+    int32_t n = 0;
+    int32_t pos = 0;
+    while (FindPlaceholder<FormatHolder>(pos) != FormatHolder{}.Size())
+    {
+        pos = FindPlaceholder<FormatHolder>(pos) + 2;
+        ++n;
+    }
+    return n;
+}
+
+// The literal segment [Pos, End) is copied with a compile-time size, so the call inlines
+// into fixed load/store pairs.
+template <int32_t Pos, int32_t End, typename FormatHolder>
+inline char* CopyLiteral(char* buffer, FormatHolder fmt)
+{
+    static_assert(Pos <= End, "internal error");
+    std::memcpy(buffer, fmt.Str() + Pos, static_cast<size_t>(End - Pos));
+    return buffer + (End - Pos);
+}
+
+inline char* WriteArg(char* buffer, double value)
+{
+    return schubfach::Dtoa(buffer, value);
+}
+
+inline char* WriteArg(char* buffer, float value)
+{
+    return schubfach::Dtoa(buffer, static_cast<double>(value));
+}
+
+inline char* WriteArg(char* buffer, uint32_t value) { return Itoa(buffer, value); }
+inline char* WriteArg(char* buffer, uint64_t value) { return Itoa(buffer, value); }
+inline char* WriteArg(char* buffer, int32_t value) { return Itoa(buffer, value); }
+inline char* WriteArg(char* buffer, int64_t value) { return Itoa(buffer, value); }
+
+inline char* WriteArg(char* buffer, char value)
+{
+    *buffer = value;
+    return buffer + 1;
+}
+
+template <typename T> struct ArgMaxLength;
+template <> struct ArgMaxLength<double> { static constexpr int32_t value = schubfach::DtoaMaxLength; };
+template <> struct ArgMaxLength<float> { static constexpr int32_t value = schubfach::DtoaMaxLength; };
+template <> struct ArgMaxLength<uint32_t> { static constexpr int32_t value = ItoaMaxLength; };
+template <> struct ArgMaxLength<uint64_t> { static constexpr int32_t value = ItoaMaxLength; };
+template <> struct ArgMaxLength<int32_t> { static constexpr int32_t value = ItoaMaxLength; };
+template <> struct ArgMaxLength<int64_t> { static constexpr int32_t value = ItoaMaxLength; };
+template <> struct ArgMaxLength<char> { static constexpr int32_t value = 1; };
+
+template <int32_t Pos, typename FormatHolder>
+inline char* FormatFrom(char* buffer, FormatHolder fmt)
+{
+    // No arguments left: copy the remaining literal.
+    return CopyLiteral<Pos, FormatHolder{}.Size()>(buffer, fmt);
+}
+
+template <int32_t Pos, typename FormatHolder, typename Arg, typename... Rest>
+inline char* FormatFrom(char* buffer, FormatHolder fmt, const Arg& arg, const Rest&... rest)
+{
+    constexpr int32_t placeholder = FindPlaceholder<FormatHolder>(Pos);
+    buffer = CopyLiteral<Pos, placeholder>(buffer, fmt);
+    buffer = WriteArg(buffer, arg);
+    return FormatFrom<placeholder + 2>(buffer, fmt, rest...);
+}
+
+} // namespace format_detail
+
+// The worst-case length of Format(buffer, DRACHENNEST_FMT(...), Args...); see above.
+template <typename FormatHolder, typename... Args>
+constexpr int32_t FormatMaxLength()
+{
+    int32_t n = FormatHolder{}.Size() - 2 * format_detail::CountPlaceholders<FormatHolder>();
+    const int32_t arg_lengths[] = {0, format_detail::ArgMaxLength<Args>::value...};
+    for (const int32_t len : arg_lengths)
+        n += len;
+    return n;
+}
+
+template <typename FormatHolder, typename... Args>
+inline char* Format(char* buffer, FormatHolder fmt, const Args&... args)
+{
+    static_assert(format_detail::CountPlaceholders<FormatHolder>() == static_cast<int32_t>(sizeof...(Args)),
+        "number of arguments does not match the number of \"{}\" placeholders");
+
+    return format_detail::FormatFrom<0>(buffer, fmt, args...);
+}
+
+} // namespace drachennest
@@ -5,9 +5,20 @@
 
 #include "grisu2.h"
 
+#include "itoa.h"
+
 #define GRISU_SMALL_INT_OPTIMIZATION() 1
 #define GRISU_ROUND() 0
 
+// Store only every 5th cached power of ten (32 entries, 256 bytes, instead of 159 entries)
+// and synthesize the intermediates on the fly with one extra 64x64 multiply by an exact
+// power of ten. This trades a few cycles per conversion for most of the table -- meant for
+// footprint-constrained deployments. (Enable by defining GRISU_COMPRESSED_CACHE=1, or via
+// the CMake option GRISU2_COMPRESSED_CACHE.)
+#ifndef GRISU_COMPRESSED_CACHE
+#define GRISU_COMPRESSED_CACHE 0
+#endif
+
 #include <cassert>
 #include <cstdint>
 #include <cstring>
@@ -20,6 +31,13 @@
 #define GRISU_ASSERT(X) assert(X)
 #endif
 
+// Some targets (e.g. wasm32) offer unsigned __int128 but lower the 64x64->128 multiplies to
+// a libcall; defining DRACHENNEST_NO_INT128=1 (see the cmake option) forces the 32x32->64
+// decomposition instead.
+#ifndef DRACHENNEST_NO_INT128
+#define DRACHENNEST_NO_INT128 0
+#endif
+
 //==================================================================================================
 //
 //==================================================================================================
@@ -169,7 +187,7 @@ static inline uint64_t MultiplyHighRoundUp(uint64_t x, uint64_t y)
     // Computes:
     //  f = round((x.f * y.f) / 2^q)
 
-#if defined(__SIZEOF_INT128__)
+#if defined(__SIZEOF_INT128__) && !DRACHENNEST_NO_INT128
     __extension__ using uint128_t = unsigned __int128;
 
     const uint128_t p = uint128_t{x} * y;
@@ -337,6 +355,125 @@ static constexpr int32_t kCachedPowersDecExpStep =    4;
 //
 //      kAlpha <= e_c + e + q <= kGamma.
 //
+#if GRISU_COMPRESSED_CACHE
+
+// Computes the full 128-bit product x * y.
+static inline void Mul64x64(uint64_t x, uint64_t y, uint64_t& hi, uint64_t& lo)
+{
+#if defined(__SIZEOF_INT128__) && !DRACHENNEST_NO_INT128
+    __extension__ using uint128_t = unsigned __int128;
+    const uint128_t p = uint128_t{x} * y;
+    hi = static_cast<uint64_t>(p >> 64);
+    lo = static_cast<uint64_t>(p);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    lo = _umul128(x, y, &hi);
+#else
+    const uint64_t b00 = uint64_t{static_cast<uint32_t>(x)} * static_cast<uint32_t>(y);
+    const uint64_t b01 = uint64_t{static_cast<uint32_t>(x)} * static_cast<uint32_t>(y >> 32);
+    const uint64_t b10 = uint64_t{static_cast<uint32_t>(x >> 32)} * static_cast<uint32_t>(y);
+    const uint64_t b11 = uint64_t{static_cast<uint32_t>(x >> 32)} * static_cast<uint32_t>(y >> 32);
+
+    const uint64_t mid1 = b10 + (b00 >> 32);
+    const uint64_t mid2 = b01 + static_cast<uint32_t>(mid1);
+
+    hi = b11 + (mid1 >> 32) + (mid2 >> 32);
+    lo = static_cast<uint32_t>(b00) | (mid2 << 32);
+#endif
+}
+
+static inline CachedPower GetCachedPowerForBinaryExponent(int32_t e)
+{
+    // Every 5th entry of the full table below, i.e. the round-to-nearest 64-bit
+    // significands of 10^k for k = -304 + 20*i.
+    static constexpr uint64_t kBaseSignificands[32] = {
+        0x8C71DCD9BA0B4926, // k = -304
+        0xBE5691EF416BD60C, // k = -284
+        0x80FA687F881C7F8E, // k = -264
+        0xAECC49914078536D, // k = -244
+        0xECE53CEC4A314EBE, // k = -224
+        0xA086CFCD97BF97F4, // k = -204
+        0xD98DDAEE19068C76, // k = -184
+        0x936B9FCEBB25C996, // k = -164
+        0xC7CABA6E7C5382C9, // k = -144
+        0x87625F056C7C4A8B, // k = -124
+        0xB77ADA0617E3BBCB, // k = -104
+        0xF8A95FCF88747D94, // k =  -84
+        0xA87FEA27A539E9A5, // k =  -64
+        0xE45C10C42A2B3B06, // k =  -44
+        0x9ABE14CD44753B53, // k =  -24
+        0xD1B71758E219652C, // k =   -4
+        0x8E1BC9BF04000000, // k =   16
+        0xC097CE7BC90715B3, // k =   36
+        0x82818F1281ED44A0, // k =   56
+        0xB0DE65388CC8ADA8, // k =   76
+        0xEFB3AB16C59B14A3, // k =   96
+        0xA26DA3999AEF774A, // k =  116
+        0xDC21A1171D42645D, // k =  136
+        0x952AB45CFA97A0B3, // k =  156
+        0xCA28A291859BBF93, // k =  176
+        0x88FCF317F22241E2, // k =  196
+        0xB9A74A0637CE2EE1, // k =  216
+        0xFB9B7CD9A4A7443C, // k =  236
+        0xAA7EEBFB9DF9DE8E, // k =  256
+        0xE7109BFBA19C0C9D, // k =  276
+        0x9C935E00D4B9D8D2, // k =  296
+        0xD433179D9C8CB841, // k =  316
+    };
+
+    // 10^(4*offset); all exactly representable in 64 bits.
+    static constexpr uint64_t kPow10_64[5] = {
+        1,
+        10000,
+        100000000,
+        1000000000000,
+        10000000000000000,
+    };
+
+    GRISU_ASSERT(e >= -1137);
+    GRISU_ASSERT(e <=   960);
+
+    const int32_t k = CeilLog10Pow2(kAlpha - e - 1);
+    GRISU_ASSERT(k >= kCachedPowersMinDecExp - (kCachedPowersDecExpStep - 1));
+    GRISU_ASSERT(k <= kCachedPowersMaxDecExp);
+
+    const unsigned index = static_cast<unsigned>(k - (kCachedPowersMinDecExp - (kCachedPowersDecExpStep - 1))) / kCachedPowersDecExpStep;
+    GRISU_ASSERT(index < kCachedPowersSize);
+
+    const int32_t k_cached = kCachedPowersMinDecExp + static_cast<int32_t>(index) * kCachedPowersDecExpStep;
+    const int32_t e_cached = FloorLog2Pow10(k_cached) + 1 - 64;
+
+    uint64_t f = kBaseSignificands[index / 5];
+    const unsigned offset = index % 5;
+    if (offset != 0)
+    {
+        // Synthesize 10^k_cached ~= 10^k_base * 10^(4*offset): take the full 128-bit
+        // product and renormalize (round to nearest). The result is off by < 1.5 ulp
+        // instead of the <= 0.5 ulp of a stored entry; the widened safety margin in
+        // ToDecimal64 accounts for this.
+        const int32_t k_base = k_cached - 4 * static_cast<int32_t>(offset);
+        const int32_t e_base = FloorLog2Pow10(k_base) + 1 - 64;
+        const int32_t shift = e_cached - e_base;
+        GRISU_ASSERT(shift >= 13);
+        GRISU_ASSERT(shift <= 54);
+
+        uint64_t p_hi;
+        uint64_t p_lo;
+        Mul64x64(f, kPow10_64[offset], p_hi, p_lo);
+
+        f = (p_hi << (64 - shift)) | (p_lo >> shift);
+        f += (p_lo >> (shift - 1)) & 1; // round, ties up
+        GRISU_ASSERT((f >> 63) == 1);   // normalized (checked exhaustively in the tests)
+    }
+
+    const CachedPower cached = {f, e_cached, k_cached};
+    GRISU_ASSERT(kAlpha <= cached.e + e + 64);
+    GRISU_ASSERT(kGamma >= cached.e + e + 64);
+
+    return cached;
+}
+
+#else // !GRISU_COMPRESSED_CACHE
+
 static inline CachedPower GetCachedPowerForBinaryExponent(int32_t e)
 {
     static constexpr uint64_t kSignificands[] = {
@@ -521,6 +658,8 @@ static inline CachedPower GetCachedPowerForBinaryExponent(int32_t e)
     return cached;
 }
 
+#endif // !GRISU_COMPRESSED_CACHE
+
 namespace {
 struct FloatingDecimal64 {
     uint64_t digits;
@@ -715,8 +854,17 @@ static inline FloatingDecimal64 ToDecimal64(double value)
     //GRISU_ASSERT(w_plus - w_minus >= (3 * Pow2(64 - Double::SignificandSize - 2)) / 2); // >= delta_m / 2
     // w_plus - w_minus >= 768          (double precision)
     // w_plus - w_minus >= 412316860416 (single precision)
+#if GRISU_COMPRESSED_CACHE
+    // The synthesized cached powers are off by < 1.5 ulp instead of <= 0.5 ulp, so
+    // w/w-/w+ are off by < 2 ulp: widen the safety margin accordingly. (The interval
+    // shrinks by 2 more ulps out of >= 768 -- an output may very rarely be one digit
+    // longer than with the full table, round-trips are unaffected.)
+    const uint64_t L = w_minus + 2;
+    const uint64_t H = w_plus  - 2;
+#else
     const uint64_t L = w_minus + 1;
     const uint64_t H = w_plus  - 1;
+#endif
     //GRISU_ASSERT(H - L >= (3 * Pow2(64 - Double::SignificandSize - 2)) / 2 - 2);
 
     //
@@ -1013,23 +1161,10 @@ static inline FloatingDecimal64 ToDecimal64(double value)
 // ToChars
 //==================================================================================================
 
+// The digit pairs table is shared by all engines, see itoa.h.
 static inline char* Utoa_2Digits(char* buf, uint32_t digits)
 {
-    static constexpr char Digits100[200] = {
-        '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
-        '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
-        '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
-        '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
-        '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
-        '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
-        '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
-        '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
-        '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
-        '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
-    };
-
-    GRISU_ASSERT(digits <= 99);
-    std::memcpy(buf, &Digits100[2 * digits], 2);
+    drachennest::itoa::Utoa_2Digits(buf, digits);
     return buf + 2;
 }
 
@@ -0,0 +1,717 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "grisu2_32.h"
+
+#include "itoa.h"
+
+#define GRISU_SMALL_INT_OPTIMIZATION() 1
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#ifndef GRISU_ASSERT
+#define GRISU_ASSERT(X) assert(X)
+#endif
+
+//==================================================================================================
+//
+//==================================================================================================
+
+template <typename Dest, typename Source>
+static inline Dest ReinterpretBits(Source source)
+{
+    static_assert(sizeof(Dest) == sizeof(Source), "size mismatch");
+
+    Dest dest;
+    std::memcpy(&dest, &source, sizeof(Source));
+    return dest;
+}
+
+namespace {
+struct Single
+{
+    static_assert(std::numeric_limits<float>::is_iec559
+               && std::numeric_limits<float>::digits == 24
+               && std::numeric_limits<float>::max_exponent == 128,
+        "IEEE-754 single-precision implementation required");
+
+    using value_type = float;
+    using bits_type = uint32_t;
+
+    static constexpr int32_t   SignificandSize = std::numeric_limits<value_type>::digits; // = p   (includes the hidden bit)
+    static constexpr int32_t   ExponentBias    = std::numeric_limits<value_type>::max_exponent - 1 + (SignificandSize - 1);
+    static constexpr bits_type HiddenBit       = bits_type{1} << (SignificandSize - 1);   // = 2^(p-1)
+    static constexpr bits_type SignificandMask = HiddenBit - 1;                           // = 2^(p-1) - 1
+    static constexpr bits_type ExponentMask    = (bits_type{2 * std::numeric_limits<value_type>::max_exponent - 1}) << (SignificandSize - 1);
+    static constexpr bits_type SignMask        = ~(~bits_type{0} >> 1);
+
+    bits_type bits;
+
+    explicit Single(bits_type bits_) : bits(bits_) {}
+    explicit Single(value_type value) : bits(ReinterpretBits<bits_type>(value)) {}
+
+    bits_type PhysicalSignificand() const {
+        return bits & SignificandMask;
+    }
+
+    bits_type PhysicalExponent() const {
+        return (bits & ExponentMask) >> (SignificandSize - 1);
+    }
+
+    bool IsFinite() const {
+        return (bits & ExponentMask) != ExponentMask;
+    }
+
+    bool IsNaN() const {
+        return (bits & ExponentMask) == ExponentMask && (bits & SignificandMask) != 0;
+    }
+
+    bool IsZero() const {
+        return (bits & ~SignMask) == 0;
+    }
+
+    bool SignBit() const {
+        return (bits & SignMask) != 0;
+    }
+
+    value_type AbsValue() const {
+        return ReinterpretBits<value_type>(bits & ~SignMask);
+    }
+};
+} // namespace
+
+//==================================================================================================
+//
+//==================================================================================================
+
+// Returns: floor(x / 2^n)
+static inline int32_t SAR(int32_t x, int32_t n)
+{
+    // Technically, right-shift of negative integers is implementation defined...
+    // Should easily get optimized into SAR (or equivalent) instruction.
+    return x >> n;
+}
+
+// Returns: floor(log_2(10^e))
+static inline int32_t FloorLog2Pow10(int32_t e)
+{
+    GRISU_ASSERT(e >= -1233);
+    GRISU_ASSERT(e <=  1232);
+    return SAR(e * 1741647, 19);
+}
+
+// Returns: ceil(log_10(2^e))
+static inline int32_t CeilLog10Pow2(int32_t e)
+{
+    GRISU_ASSERT(e >= -2620);
+    GRISU_ASSERT(e <=  2620);
+    return SAR(e * 315653 + ((1 << 20) - 1), 20);
+}
+
+//==================================================================================================
+// Grisu2 (q = 32)
+//
+// Implements the Grisu2 algorithm for (IEEE) binary to decimal floating-point conversion,
+// specialized to single precision: with p = 24, a 32-bit DiyFp satisfies the q >= p + 3
+// requirement, so all the arithmetic below is 32-bit (the multiplies produce 64-bit products),
+// and the cached-powers table only needs to cover the single-precision binary exponent range
+// [-180, 96]. See grisu2.cc for the derivation and the references.
+//==================================================================================================
+// Constant data: 42 * 32 bits = 168 bytes
+
+namespace {
+struct DiyFp // f * 2^e
+{
+    static constexpr int32_t SignificandSize = 32; // = q
+
+    uint32_t f = 0;
+    int32_t e = 0;
+
+    constexpr DiyFp() = default;
+    constexpr DiyFp(uint32_t f_, int32_t e_) : f(f_), e(e_) {}
+};
+}
+
+// Returns x * y.
+// The result is rounded (ties up). (Only the upper q bits are returned.)
+static inline uint32_t MultiplyHighRoundUp(uint32_t x, uint32_t y)
+{
+    // Computes:
+    //  f = round((x.f * y.f) / 2^q)
+
+    const uint64_t p = uint64_t{x} * y;
+
+    uint32_t h = static_cast<uint32_t>(p >> 32);
+    const uint32_t l = static_cast<uint32_t>(p);
+    h += l >> 31; // round, ties up: [h, l] += 2^q / 2
+
+    return h;
+}
+
+// Returns the number of leading 0-bits in x, starting at the most significant
+// bit position.
+// If x is 0, the result is undefined.
+static inline int32_t CountLeadingZeros32(uint32_t x)
+{
+    GRISU_ASSERT(x != 0);
+
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clz(x);
+#elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+    return static_cast<int32_t>(_CountLeadingZeros(x));
+#elif defined(_MSC_VER)
+    return static_cast<int32_t>(__lzcnt(x));
+#else
+    int32_t lz = 0;
+    while ((x >> 31) == 0) {
+        x <<= 1;
+        ++lz;
+    }
+    return lz;
+#endif
+}
+
+namespace {
+struct CachedPower { // c = f * 2^e ~= 10^k
+    uint32_t f;
+    int32_t e; // binary exponent
+    int32_t k; // decimal exponent
+};
+}
+
+// The (alpha, gamma) window for q = 32. gamma = -21 keeps the integral part p1 = f >> -e small,
+// and alpha = -28 guarantees 10 * p2 < 2^32 in the digit generation loop below: there is no
+// headroom for the 4-digits-at-a-time extraction of the 64-bit implementation, so the table
+// spacing is 2 decimal exponents (~6.7 bits) instead of 4, fitting the window of 8.
+static constexpr int32_t kAlpha = -28;
+static constexpr int32_t kGamma = -21;
+// k_min = -37
+// k_max =  46
+
+static constexpr int32_t kCachedPowersSize       =  42;
+static constexpr int32_t kCachedPowersMinDecExp  = -36;
+static constexpr int32_t kCachedPowersMaxDecExp  =  46;
+static constexpr int32_t kCachedPowersDecExpStep =   2;
+
+// For a normalized DiyFp w = f * 2^e, this function returns a (normalized) cached power-of-ten
+// c = f_c * 2^e_c, such that the exponent of the product w * c satisfies
+//
+//      kAlpha <= e_c + e + q <= kGamma.
+//
+// (The full table is 168 bytes; compressing it as for the 64-bit engines would not pay off.)
+static inline CachedPower GetCachedPowerForBinaryExponent(int32_t e)
+{
+    static constexpr uint32_t kSignificands[] = {
+        0xAA242499, // e = -151, k = -36
+        0x84EC3C98, // e = -144, k = -34
+        0xCFB11EAD, // e = -138, k = -32
+        0xA2425FF7, // e = -131, k = -30
+        0xFD87B5F3, // e = -125, k = -28
+        0xC6120625, // e = -118, k = -26
+        0x9ABE14CD, // e = -111, k = -24
+        0xF1C90081, // e = -105, k = -22
+        0xBCE50865, // e =  -98, k = -20
+        0x9392EE8F, // e =  -91, k = -18
+        0xE69594BF, // e =  -85, k = -16
+        0xB424DC35, // e =  -78, k = -14
+        0x8CBCCC09, // e =  -71, k = -12
+        0xDBE6FECF, // e =  -65, k = -10
+        0xABCC7712, // e =  -58, k =  -8
+        0x8637BD06, // e =  -51, k =  -6
+        0xD1B71759, // e =  -45, k =  -4
+        0xA3D70A3D, // e =  -38, k =  -2
+        0x80000000, // e =  -31, k =   0
+        0xC8000000, // e =  -25, k =   2
+        0x9C400000, // e =  -18, k =   4
+        0xF4240000, // e =  -12, k =   6
+        0xBEBC2000, // e =   -5, k =   8
+        0x9502F900, // e =    2, k =  10
+        0xE8D4A510, // e =    8, k =  12
+        0xB5E620F5, // e =   15, k =  14
+        0x8E1BC9BF, // e =   22, k =  16
+        0xDE0B6B3A, // e =   28, k =  18
+        0xAD78EBC6, // e =   35, k =  20
+        0x87867832, // e =   42, k =  22
+        0xD3C21BCF, // e =   48, k =  24
+        0xA56FA5BA, // e =   55, k =  26
+        0x813F3979, // e =   62, k =  28
+        0xC9F2C9CD, // e =   68, k =  30
+        0x9DC5ADA8, // e =   75, k =  32
+        0xF684DF57, // e =   81, k =  34
+        0xC097CE7C, // e =   88, k =  36
+        0x96769951, // e =   95, k =  38
+        0xEB194F8E, // e =  101, k =  40
+        0xB7ABC627, // e =  108, k =  42
+        0x8F7E32CE, // e =  115, k =  44
+        0xE0352F63, // e =  121, k =  46
+    };
+    static_assert(sizeof(kSignificands) / sizeof(kSignificands[0]) == kCachedPowersSize, "table size mismatch");
+
+    GRISU_ASSERT(e >= -180);
+    GRISU_ASSERT(e <=   96);
+
+    const int32_t k = CeilLog10Pow2(kAlpha - e - 1);
+    GRISU_ASSERT(k >= kCachedPowersMinDecExp - (kCachedPowersDecExpStep - 1));
+    GRISU_ASSERT(k <= kCachedPowersMaxDecExp);
+
+    const unsigned index = static_cast<unsigned>(k - (kCachedPowersMinDecExp - (kCachedPowersDecExpStep - 1))) / kCachedPowersDecExpStep;
+    GRISU_ASSERT(index < kCachedPowersSize);
+
+    const int32_t k_cached = kCachedPowersMinDecExp + static_cast<int32_t>(index) * kCachedPowersDecExpStep;
+    const int32_t e_cached = FloorLog2Pow10(k_cached) + 1 - 32;
+
+    const CachedPower cached = {kSignificands[index], e_cached, k_cached};
+    GRISU_ASSERT(kAlpha <= cached.e + e + 32);
+    GRISU_ASSERT(kGamma >= cached.e + e + 32);
+
+    return cached;
+}
+
+namespace {
+struct FloatingDecimal32 {
+    uint32_t digits;
+    int32_t exponent;
+};
+}
+
+static inline FloatingDecimal32 ToDecimal32(float value)
+{
+    static_assert(DiyFp::SignificandSize >= std::numeric_limits<float>::digits + 3,
+        "Grisu2 requires q >= p + 3");
+    static_assert(DiyFp::SignificandSize == 32,
+        "This implementation requires q = 32");
+
+    GRISU_ASSERT(Single(value).IsFinite());
+    GRISU_ASSERT(value > 0);
+
+    const auto ieee_value = Single(value);
+    const auto ieee_significand = ieee_value.PhysicalSignificand();
+    const auto ieee_exponent    = ieee_value.PhysicalExponent();
+
+    // Compute the boundaries m- and m+ of the floating-point value v = f * 2^e. All real
+    // numbers _strictly_ between m- and m+ round to v. (See grisu2.cc for the full
+    // derivation; the only difference here is q = 32, i.e. shift = 32 - 24 - 2.)
+
+    int32_t shared_exponent;
+    uint32_t m_minus;
+    uint32_t m_plus;
+    if (ieee_exponent != 0) // normalized floating-point number
+    {
+        const bool lower_boundary_is_closer = (ieee_significand == 0 && ieee_exponent > 1);
+
+        const auto f2 = ieee_significand | Single::HiddenBit;
+        const auto e2 = static_cast<int32_t>(ieee_exponent) - Single::ExponentBias;
+
+#if GRISU_SMALL_INT_OPTIMIZATION()
+        if (0 <= -e2 && -e2 < 24)
+        {
+            const uint32_t d2 = f2 >> -e2;
+            if (d2 << -e2 == f2)
+                return {d2, 0};
+        }
+#endif
+
+        const auto fm = 4 * f2 - 2 + (lower_boundary_is_closer ? 1 : 0);
+        const auto fp = 4 * f2 + 2;
+
+        const auto shift = DiyFp::SignificandSize - Single::SignificandSize - 2;
+
+        shared_exponent = e2 - 2 - shift;
+        m_minus = uint32_t{fm} << shift;
+        m_plus  = uint32_t{fp} << shift;
+    }
+    else
+    {
+        const auto f2 = ieee_significand;
+        const auto e2 = 1 - Single::ExponentBias;
+
+        const auto fm = 4 * f2 - 2;
+        const auto fp = 4 * f2 + 2;
+
+        const auto shift = CountLeadingZeros32(fp);
+
+        shared_exponent = e2 - 2 - shift;
+        m_minus = uint32_t{fm} << shift;
+        m_plus  = uint32_t{fp} << shift;
+    }
+
+    //
+    // Step 1:
+    // Compute the rounding interval: scale m- and m+ such that the exponent is in the range
+    // [alpha, gamma].
+    //
+
+    const auto cached = GetCachedPowerForBinaryExponent(shared_exponent);
+
+    const uint32_t w_minus = MultiplyHighRoundUp(m_minus, cached.f);
+    const uint32_t w_plus  = MultiplyHighRoundUp(m_plus,  cached.f);
+
+    // The exponent of the products is = v.e + cached.e + q and is in the
+    // range [alpha, gamma].
+    const int32_t e = shared_exponent + cached.e + 32;
+    GRISU_ASSERT(e >= kAlpha);
+    GRISU_ASSERT(e <= kGamma);
+
+    // Note:
+    // The result of the multiplication is **NOT** neccessarily normalized.
+    // But since m+ and c are normalized, w+ >= 2^(q - 2).
+    GRISU_ASSERT(w_plus >= (uint32_t{1} << (32 - 2)));
+
+    // Multiply rounds its result and the cached power is rounded too; w- and w+ are off by
+    // less than 1 ulp each. Add resp. subtract 1 ulp, so that any number in [L, H] (bounds
+    // included) rounds back to v, regardless of how the input rounding breaks ties.
+
+    // w_plus - w_minus >= 94 (= 3 * 2^(32 - 24 - 2) / 2 - 2)
+    const uint32_t L = w_minus + 1;
+    const uint32_t H = w_plus  - 1;
+
+    //
+    // Step 2:
+    // Generate the digits (and the exponent) of a decimal floating-point number
+    // V = digits * 10^exponent in the range [L, H], from left to right, stopping as soon as
+    // V is in [L, H].
+    //
+
+    GRISU_ASSERT(H >= L);
+    uint32_t delta = H - L; // (significand of (H - L), implicit exponent is H.e)
+    uint32_t rest;
+    uint32_t ten_kappa;
+
+    // Split H = f * 2^e into two parts p1 and p2 (note: e < 0):
+    //
+    //      H = f * 2^e
+    //           = ((f div 2^-e) * 2^-e + (f mod 2^-e)) * 2^e
+    //           = ((p1        ) * 2^-e + (p2        )) * 2^e
+    //           = p1 + p2 * 2^e
+
+    const DiyFp one(uint32_t{1} << -e, e); // one = 2^-e * 2^e
+
+    uint32_t p1 = H >> -one.e;     // p1 = f div 2^-e
+    uint32_t p2 = H & (one.f - 1); // p2 = f mod 2^-e
+
+    GRISU_ASSERT(p1 >= 3); // (2^(32-2) - 1) >> 28
+
+    uint32_t digits = p1;
+    int32_t exponent = 0;
+
+    if (p2 > delta)
+    {
+        // Generate the digits of the fractional part p2 * 2^e, one per iteration, using
+        //
+        //      10 * p2 = (10 * p2 div 2^-e) * 2^-e + (10 * p2 mod 2^-e)
+        //
+        // and stop as soon as the remainder (scaled back) is <= delta. Unlike the 64-bit
+        // implementation, which pulls out up to 4 digits per iteration, there is no headroom
+        // here for 10000 * p2: p2 < 2^-e <= 2^28, so only 10 * p2 < 2^32 is guaranteed.
+
+        for (;;)
+        {
+            GRISU_ASSERT(digits <= 999999999u / 10);
+            GRISU_ASSERT(p2 <= UINT32_MAX / 10);
+
+            const uint32_t s1 = 10 * p2;
+            const uint32_t r1 = s1 & (one.f - 1);
+            const uint32_t q1 = s1 >> -one.e;
+            GRISU_ASSERT(q1 <= 9);
+
+            digits = 10 * digits + q1;
+            exponent -= 1;
+
+            p2 = r1;
+            delta *= 10;
+            if (p2 <= delta)
+                break;
+        }
+
+        // V = digits * 10^exponent, with L <= V <= H.
+    }
+    else // p2 <= delta
+    {
+        GRISU_ASSERT((uint32_t{p1} << -one.e) + p2 > delta); // Loop terminates.
+
+        // In this case: p1 contains too many digits. Drop digits from the right as long as
+        // the dropped tail (in units of 2^e)
+        //
+        //      rest * 2^e = (p1 mod 10^n) * 2^-e + p2
+        //
+        // stays <= delta. (See grisu2.cc; the arithmetic never overflows: rest is always a
+        // tail of H and therefore < 2^32.)
+
+        rest = p2;
+
+        // 10^n is now 1 ulp in the decimal representation V. The rounding
+        // procedure works with DiyFp's with an implicit exponent of e.
+        //
+        //      10^n = (10^n * 2^-e) * 2^e = ten_kappa * 2^e
+        //
+        ten_kappa = one.f; // Start with 2^-e
+
+        // n = 0
+        for (;;)
+        {
+            GRISU_ASSERT(rest <= delta);
+
+            const uint32_t q = p1 / 10;
+            const uint32_t r = p1 % 10;
+            const uint32_t r_next = ten_kappa * r + rest;
+
+            if (r_next > delta)
+            {
+                digits = p1;
+                break;
+            }
+
+            p1 = q;
+            exponent += 1; // n += 1
+            rest = r_next;
+            ten_kappa *= 10;
+        }
+    }
+
+    //
+    // Done.
+    //
+
+    // v = decimal_digits * 10^decimal_exponent
+
+    return {digits, exponent - cached.k};
+}
+
+//==================================================================================================
+// ToChars
+//==================================================================================================
+
+// The digit pairs table is shared by all engines, see itoa.h.
+static inline char* Utoa_2Digits(char* buf, uint32_t digits)
+{
+    drachennest::itoa::Utoa_2Digits(buf, digits);
+    return buf + 2;
+}
+
+static inline char* Utoa_4Digits(char* buf, uint32_t digits)
+{
+    GRISU_ASSERT(digits <= 9999);
+    const uint32_t q = digits / 100;
+    const uint32_t r = digits % 100;
+    Utoa_2Digits(buf + 0, q);
+    Utoa_2Digits(buf + 2, r);
+    return buf + 4;
+}
+
+static inline int32_t DecimalLength(uint32_t v)
+{
+    GRISU_ASSERT(v >= 1);
+    GRISU_ASSERT(v <= 999999999u);
+
+    if (v >= 100000000u) { return 9; }
+    if (v >= 10000000u) { return 8; }
+    if (v >= 1000000u) { return 7; }
+    if (v >= 100000u) { return 6; }
+    if (v >= 10000u) { return 5; }
+    if (v >= 1000u) { return 4; }
+    if (v >= 100u) { return 3; }
+    if (v >= 10u) { return 2; }
+    return 1;
+}
+
+static inline void PrintDecimalDigits(char* buf, uint32_t output, int32_t output_length)
+{
+    while (output >= 10000)
+    {
+        GRISU_ASSERT(output_length > 4);
+        const uint32_t q = output / 10000;
+        const uint32_t r = output % 10000;
+        output = q;
+        output_length -= 4;
+        Utoa_4Digits(buf + output_length, r);
+    }
+
+    if (output >= 100)
+    {
+        GRISU_ASSERT(output_length > 2);
+        const uint32_t q = output / 100;
+        const uint32_t r = output % 100;
+        output = q;
+        output_length -= 2;
+        Utoa_2Digits(buf + output_length, r);
+    }
+
+    if (output >= 10)
+    {
+        GRISU_ASSERT(output_length == 2);
+        Utoa_2Digits(buf, output);
+    }
+    else
+    {
+        GRISU_ASSERT(output_length == 1);
+        buf[0] = static_cast<char>('0' + output);
+    }
+}
+
+static inline char* FormatDigits(char* buffer, uint32_t digits, int32_t decimal_exponent, bool force_trailing_dot_zero = false)
+{
+    GRISU_ASSERT(digits >= 1);
+    GRISU_ASSERT(digits <= 999999999u);
+    GRISU_ASSERT(decimal_exponent >= -99);
+    GRISU_ASSERT(decimal_exponent <=  99);
+
+    const int32_t num_digits = DecimalLength(digits);
+    const int32_t decimal_point = num_digits + decimal_exponent;
+
+    static constexpr int32_t MaxFixedDecimalPoint =  9;
+    static constexpr int32_t MinFixedDecimalPoint = -4;
+
+    const bool use_fixed = MinFixedDecimalPoint <= decimal_point && decimal_point <= MaxFixedDecimalPoint;
+
+    // Prepare the buffer.
+    // Avoid calling memset/memcpy with variable arguments below...
+
+    int32_t decimal_digits_position;
+    if (use_fixed)
+    {
+        if (decimal_point <= 0)
+        {
+            // 0.[000]digits
+            // -4 <= decimal_point <= 0
+            //  ==> 2 <= 2 + -decimal_point <= 6
+            // Pre-filling the buffer with 8 '0's is therefore sufficient.
+            std::memset(buffer, '0', 8);
+            decimal_digits_position = 2 + (-decimal_point);
+        }
+        else if (decimal_point < num_digits)
+        {
+            // dig.its
+            // 0 < decimal_point <= 8
+            // We need to move at most 8 bytes to the right.
+            decimal_digits_position = 0;
+        }
+        else
+        {
+            // digits[000]
+            // 1 <= num_digits <= 9, decimal_point <= 9.
+            // Pre-filling the buffer with 16 '0's is therefore sufficient.
+            static_assert(MaxFixedDecimalPoint <= 16, "invalid parameter");
+            std::memset(buffer, '0', 16);
+            decimal_digits_position = 0;
+        }
+    }
+    else
+    {
+        // dE+123 or d.igitsE+123
+        // We only need to copy the first digit one position to the left.
+        decimal_digits_position = 1;
+    }
+
+    PrintDecimalDigits(buffer + decimal_digits_position, digits, num_digits);
+
+    if (use_fixed)
+    {
+        if (decimal_point <= 0)
+        {
+            // 0.[000]digits
+            buffer[1] = '.';
+            buffer += 2 + (-decimal_point) + num_digits;
+        }
+        else if (decimal_point < num_digits)
+        {
+            // dig.its
+            // We need to move at most 8 bytes one place to the right.
+            std::memmove(buffer + (decimal_point + 1), buffer + decimal_point, 8);
+            buffer[decimal_point] = '.';
+            buffer += num_digits + 1;
+        }
+        else // 0 < num_digits <= decimal_point
+        {
+            // digits[000]
+            buffer += decimal_point;
+            if (force_trailing_dot_zero)
+            {
+                std::memcpy(buffer, ".0", 2);
+                buffer += 2;
+            }
+        }
+    }
+    else
+    {
+        // Copy the first digit one place to the left.
+        buffer[0] = buffer[1];
+        if (num_digits == 1)
+        {
+            // dE+123
+            buffer += 1;
+        }
+        else
+        {
+            // d.igitsE+123
+            buffer[1] = '.';
+            buffer += 1 + num_digits;
+        }
+
+        const auto scientific_exponent = decimal_point - 1;
+//      GRISU_ASSERT(scientific_exponent != 0);
+
+        std::memcpy(buffer, scientific_exponent < 0 ? "e-" : "e+", 2);
+        buffer += 2;
+        const uint32_t k = static_cast<uint32_t>(scientific_exponent < 0 ? -scientific_exponent : scientific_exponent);
+        if (k < 10)
+        {
+            *buffer++ = static_cast<char>('0' + k);
+        }
+        else
+        {
+            buffer = Utoa_2Digits(buffer, k);
+        }
+    }
+
+    return buffer;
+}
+
+static inline char* ToChars(char* buffer, float value, bool force_trailing_dot_zero = false)
+{
+    const Single v(value);
+
+    if (!v.IsFinite())
+    {
+        if (v.IsNaN())
+        {
+            std::memcpy(buffer, "nan ", 4);
+            return buffer + 3;
+        }
+        if (v.SignBit())
+        {
+            *buffer++ = '-';
+        }
+        std::memcpy(buffer, "inf ", 4);
+        return buffer + 3;
+    }
+
+    if (v.SignBit())
+    {
+        value = v.AbsValue();
+        *buffer++ = '-';
+    }
+
+    if (v.IsZero())
+    {
+        std::memcpy(buffer, "0.0 ", 4);
+        buffer += 1 + (force_trailing_dot_zero ? 2 : 0);
+        return buffer;
+    }
+
+    const auto dec = ToDecimal32(value);
+    return FormatDigits(buffer, dec.digits, dec.exponent, force_trailing_dot_zero);
+}
+
+//==================================================================================================
+//
+//==================================================================================================
+
+char* grisu2::Ftoa(char* buffer, float value)
+{
+    return ToChars(buffer, value);
+}
@@ -0,0 +1,34 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+namespace grisu2 {
+
+// char* output_end = Ftoa(buffer, value);
+//
+// Converts the given single-precision number into decimal form and stores the result in the given
+// buffer.
+//
+// The buffer must be large enough, i.e. >= FtoaMinBufferLength.
+// The output format is similar to printf("%g").
+// The output is _not_ null-terminted.
+//
+// This is a genuine 32-bit specialization of the Grisu2 algorithm: a float's 24-bit significand
+// fits a 32-bit DiyFp, so the conversion runs entirely in 32-bit arithmetic (the multiplies
+// produce 64-bit products) with a 42-entry (168 byte) cached-powers table. It does not promote
+// to the 64-bit machinery in grisu2.cc.
+//
+// Like Dtoa, the output is guaranteed to round back to the input number, but is not always as
+// short as possible.
+//
+// Note:
+// This function may temporarily write up to FtoaMinBufferLength characters into the buffer.
+
+constexpr int FtoaMinBufferLength = 32;
+
+char* Ftoa(char* buffer, float value);
+
+} // namespace grisu2
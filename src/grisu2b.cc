@@ -5,6 +5,8 @@
 
 #include "grisu2b.h"
 
+#include "itoa.h"
+
 #define GRISU_SMALL_INT_OPTIMIZATION() 1
 #define GRISU_ROUND() 0
 
@@ -20,6 +22,13 @@
 #define GRISU_ASSERT(X) assert(X)
 #endif
 
+// Some targets (e.g. wasm32) offer unsigned __int128 but lower the 64x64->128 multiplies to
+// a libcall; defining DRACHENNEST_NO_INT128=1 (see the cmake option) forces the 32x32->64
+// decomposition instead.
+#ifndef DRACHENNEST_NO_INT128
+#define DRACHENNEST_NO_INT128 0
+#endif
+
 //==================================================================================================
 //
 //==================================================================================================
@@ -169,7 +178,7 @@ static inline uint64_t MultiplyHighRoundUp(uint64_t x, uint64_t y)
     // Computes:
     //  f = round((x.f * y.f) / 2^q)
 
-#if defined(__SIZEOF_INT128__)
+#if defined(__SIZEOF_INT128__) && !DRACHENNEST_NO_INT128
     __extension__ using uint128_t = unsigned __int128;
 
     const uint128_t p = uint128_t{x} * y;
@@ -898,23 +907,10 @@ static inline FloatingDecimal64 ToDecimal64(double value)
 // ToChars
 //==================================================================================================
 
+// The digit pairs table is shared by all engines, see itoa.h.
 static inline char* Utoa_2Digits(char* buf, uint32_t digits)
 {
-    static constexpr char Digits100[200] = {
-        '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
-        '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
-        '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
-        '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
-        '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
-        '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
-        '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
-        '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
-        '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
-        '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
-    };
-
-    GRISU_ASSERT(digits <= 99);
-    std::memcpy(buf, &Digits100[2 * digits], 2);
+    drachennest::itoa::Utoa_2Digits(buf, digits);
     return buf + 2;
 }
 
@@ -1143,6 +1139,108 @@ static inline char* FormatDigits(char* buffer, uint64_t digits, int32_t decimal_
     return buffer;
 }
 
+//==================================================================================================
+// ToDecimalApprox
+//==================================================================================================
+
+// Like ToDecimal64, but generates at most max_digits significant digits of v itself: no
+// boundaries m-/m+, no delta/rest bookkeeping, no shortness search. The last digit is
+// rounded (half-up) against the remaining fraction, and trailing zeros are stripped so the
+// formatting below applies unchanged.
+static inline FloatingDecimal64 ToDecimalApprox(double value, int32_t max_digits)
+{
+    GRISU_ASSERT(Double(value).IsFinite());
+    GRISU_ASSERT(value > 0);
+    GRISU_ASSERT(max_digits >= 1);
+    GRISU_ASSERT(max_digits <= 17);
+
+    const auto ieee_value = Double(value);
+    const auto ieee_significand = ieee_value.PhysicalSignificand();
+    const auto ieee_exponent    = ieee_value.PhysicalExponent();
+
+    uint64_t f2;
+    int32_t e2;
+    if (ieee_exponent != 0) // normalized floating-point number
+    {
+        f2 = ieee_significand | Double::HiddenBit;
+        e2 = static_cast<int32_t>(ieee_exponent) - Double::ExponentBias;
+    }
+    else
+    {
+        f2 = ieee_significand;
+        e2 = 1 - Double::ExponentBias;
+    }
+
+    // Normalize v = f * 2^e and scale with the cached power of ten, exactly as in
+    // ToDecimal64 -- but for v alone.
+    const int32_t shift = CountLeadingZeros64(f2);
+    const uint64_t f = f2 << shift;
+    const int32_t e = e2 - shift;
+
+    const auto cached = GetCachedPowerForBinaryExponent(e);
+
+    const uint64_t w = MultiplyHighRoundUp(f, cached.f);
+    const int32_t e_w = e + cached.e + 64;
+    GRISU_ASSERT(e_w >= kAlpha);
+    GRISU_ASSERT(e_w <= kGamma);
+
+    // Split w = p1 + p2 * 2^(e_w) into the integer and the fractional part, as in
+    // ToDecimal64.
+    const uint64_t one = uint64_t{1} << -e_w;
+
+    uint32_t p1 = static_cast<uint32_t>(w >> -e_w); // p1 fits into 32 bits since -e_w >= 32
+    uint64_t p2 = w & (one - 1);
+
+    GRISU_ASSERT(p1 >= 4); // (2^(64-2) - 1) >> 60
+
+    uint64_t digits;
+    int32_t exponent;
+
+    const int32_t p1_length = DecimalLength(p1);
+    if (p1_length > max_digits)
+    {
+        // The integer part alone has too many digits: cut decimally and round on the rest.
+        // (The case p1_length == max_digits must take the branch below, since there the
+        // rounding information lives entirely in the fractional part p2.)
+        static constexpr uint32_t kPow10_u32[] = {
+            1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+        };
+        const uint32_t cut = kPow10_u32[p1_length - max_digits];
+        digits = p1 / cut;
+        exponent = p1_length - max_digits;
+        if (2 * uint64_t{p1 % cut} >= cut)
+            ++digits;
+    }
+    else
+    {
+        // Generate the missing digits from the fractional part, then round on what
+        // remains.
+        digits = p1;
+        exponent = 0;
+        for (int32_t i = p1_length; i < max_digits; ++i)
+        {
+            GRISU_ASSERT(p2 <= UINT64_MAX / 10);
+            p2 *= 10;
+            digits = 10 * digits + (p2 >> -e_w);
+            p2 &= one - 1;
+            --exponent;
+        }
+        if (p2 >= (one >> 1))
+            ++digits;
+    }
+
+    // A round-up can carry through all digits, turning 99...9 into 100...0 with one digit
+    // too many; the trailing-zero strip reduces that case to a single digit again.
+    GRISU_ASSERT(digits >= 1);
+    while (digits % 10 == 0)
+    {
+        digits /= 10;
+        ++exponent;
+    }
+
+    return {digits, exponent - cached.k};
+}
+
 static inline char* ToChars(char* buffer, double value, bool force_trailing_dot_zero = false)
 {
     const Double v(value);
@@ -1187,3 +1285,43 @@ char* grisu2b::Dtoa(char* buffer, double value)
 {
     return ToChars(buffer, value);
 }
+
+char* grisu2b::DtoaApprox(char* buffer, double value, int max_digits)
+{
+    if (max_digits < 1)
+        max_digits = 1;
+    if (max_digits > 17)
+        max_digits = 17;
+
+    const Double v(value);
+
+    if (!v.IsFinite())
+    {
+        if (v.IsNaN())
+        {
+            std::memcpy(buffer, "nan ", 4);
+            return buffer + 3;
+        }
+        if (v.SignBit())
+        {
+            *buffer++ = '-';
+        }
+        std::memcpy(buffer, "inf ", 4);
+        return buffer + 3;
+    }
+
+    if (v.SignBit())
+    {
+        value = v.AbsValue();
+        *buffer++ = '-';
+    }
+
+    if (v.IsZero())
+    {
+        *buffer++ = '0';
+        return buffer;
+    }
+
+    const auto dec = ToDecimalApprox(value, max_digits);
+    return FormatDigits(buffer, dec.digits, dec.exponent);
+}
@@ -23,4 +23,20 @@ constexpr int DtoaMinBufferLength = 64;
 
 char* Dtoa(char* buffer, double value);
 
+// char* output_end = DtoaApprox(buffer, value, max_digits);
+//
+// Converts the given double-precision number into decimal form with at most max_digits
+// significant digits (clamped to [1, 17]), rounded at the last digit and with trailing
+// zeros removed. The output format is the same as for Dtoa.
+//
+// Unlike Dtoa, the digit generation carries no boundary or uncertainty tracking: the
+// output is not the shortest round-trip representation, and the last digit can be off by
+// one unit for values very close to a rounding boundary. Intended for telemetry/dashboard
+// style output where a fixed, small precision is plenty and the optimality machinery is
+// wasted work.
+//
+// The buffer must be large enough, i.e. >= DtoaMinBufferLength.
+
+char* DtoaApprox(char* buffer, double value, int max_digits);
+
 } // namespace grisu2b
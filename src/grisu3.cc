@@ -8,6 +8,9 @@
 #define GRISU_SMALL_INT_OPTIMIZATION() 1
 
 #include "dragon4.h"
+#include "itoa.h"
+#include "schubfach_64.h"
+#include "stats.h"
 
 #include <cassert>
 #include <cstdint>
@@ -21,6 +24,19 @@
 #define GRISU_ASSERT(X) assert(X)
 #endif
 
+// Use the schubfach re-round instead of dragon4 for the plain Dtoa entry point, bounding the
+// worst-case conversion time (see the cmake option GRISU3_BOUNDED_FALLBACK).
+#ifndef GRISU_BOUNDED_FALLBACK
+#define GRISU_BOUNDED_FALLBACK 0
+#endif
+
+// Some targets (e.g. wasm32) offer unsigned __int128 but lower the 64x64->128 multiplies to
+// a libcall; defining DRACHENNEST_NO_INT128=1 (see the cmake option) forces the 32x32->64
+// decomposition instead.
+#ifndef DRACHENNEST_NO_INT128
+#define DRACHENNEST_NO_INT128 0
+#endif
+
 //==================================================================================================
 //
 //==================================================================================================
@@ -185,7 +201,7 @@ static inline uint64_t MultiplyHighRoundUp(uint64_t x, uint64_t y)
     // Computes:
     //  f = round((x.f * y.f) / 2^q)
 
-#if defined(__SIZEOF_INT128__)
+#if defined(__SIZEOF_INT128__) && !DRACHENNEST_NO_INT128
     __extension__ using uint128_t = unsigned __int128;
 
     const uint128_t p = uint128_t{x} * y;
@@ -914,20 +930,42 @@ static inline bool Grisu3(FloatingDecimal64& dec, double value)
     return true;
 }
 
-static inline FloatingDecimal64 ToDecimal64(double value)
+static inline FloatingDecimal64 ToDecimal64(double value, grisu3::FallbackPolicy policy, bool& was_fallback)
 {
     FloatingDecimal64 dec;
 
     const bool ok = Grisu3(dec, value);
-    if (!ok)
+    was_fallback = !ok;
+    if (ok)
     {
-        const auto v = Double(value).Decompose();
+        DRACHENNEST_COUNT(grisu3_ok);
+    }
+    else
+    {
+        DRACHENNEST_COUNT(grisu3_fallback);
+        if (policy == grisu3::FallbackPolicy::schubfach)
+        {
+            auto sf = schubfach::ToDecimal64(value);
+            // Schubfach may report the digits with a trailing zero; normalize, as FormatDigits
+            // (like Grisu3 and Dragon4) expects the shortest digits.
+            while (sf.digits % 10 == 0)
+            {
+                sf.digits /= 10;
+                sf.exponent++;
+            }
+            dec.digits = sf.digits;
+            dec.exponent = sf.exponent;
+        }
+        else
+        {
+            const auto v = Double(value).Decompose();
 
-        const bool is_even = (v.f % 2 == 0);
-        const bool accept_bounds = is_even;
-        const bool lower_boundary_is_closer = (v.f == Double::HiddenBit && v.e > Double::MinExponent);
+            const bool is_even = (v.f % 2 == 0);
+            const bool accept_bounds = is_even;
+            const bool lower_boundary_is_closer = (v.f == Double::HiddenBit && v.e > Double::MinExponent);
 
-        dragon4::Dragon4(dec.digits, dec.exponent, v.f, v.e, accept_bounds, lower_boundary_is_closer);
+            dragon4::Dragon4(dec.digits, dec.exponent, v.f, v.e, accept_bounds, lower_boundary_is_closer);
+        }
     }
 
     GRISU_ASSERT(dec.digits >= 1);
@@ -940,23 +978,10 @@ static inline FloatingDecimal64 ToDecimal64(double value)
 // ToChars
 //==================================================================================================
 
+// The digit pairs table is shared by all engines, see itoa.h.
 static inline char* Utoa_2Digits(char* buf, uint32_t digits)
 {
-    static constexpr char Digits100[200] = {
-        '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
-        '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
-        '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
-        '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
-        '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
-        '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
-        '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
-        '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
-        '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
-        '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
-    };
-
-    GRISU_ASSERT(digits <= 99);
-    std::memcpy(buf, &Digits100[2 * digits], 2);
+    drachennest::itoa::Utoa_2Digits(buf, digits);
     return buf + 2;
 }
 
@@ -1185,8 +1210,10 @@ static inline char* FormatDigits(char* buffer, uint64_t digits, int32_t decimal_
     return buffer;
 }
 
-static inline char* ToChars(char* buffer, double value, bool force_trailing_dot_zero = false)
+static inline char* ToChars(char* buffer, double value, grisu3::FallbackPolicy policy, bool& was_fallback, bool force_trailing_dot_zero = false)
 {
+    was_fallback = false;
+
     const Double v(value);
 
     if (!v.IsFinite())
@@ -1217,7 +1244,7 @@ static inline char* ToChars(char* buffer, double value, bool force_trailing_dot_
         return buffer;
     }
 
-    const auto dec = ToDecimal64(value);
+    const auto dec = ToDecimal64(value, policy, was_fallback);
     return FormatDigits(buffer, dec.digits, dec.exponent, force_trailing_dot_zero);
 }
 
@@ -1227,5 +1254,18 @@ static inline char* ToChars(char* buffer, double value, bool force_trailing_dot_
 
 char* grisu3::Dtoa(char* buffer, double value)
 {
-    return ToChars(buffer, value);
+    bool was_fallback;
+#if GRISU_BOUNDED_FALLBACK
+    return ToChars(buffer, value, FallbackPolicy::schubfach, was_fallback);
+#else
+    return ToChars(buffer, value, FallbackPolicy::dragon4, was_fallback);
+#endif
+}
+
+grisu3::DtoaResult grisu3::Dtoa(char* buffer, double value, FallbackPolicy policy)
+{
+    DtoaResult result;
+    result.was_fallback = false;
+    result.end = ToChars(buffer, value, policy, result.was_fallback);
+    return result;
 }
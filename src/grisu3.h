@@ -23,4 +23,32 @@ constexpr int DtoaMinBufferLength = 64;
 
 char* Dtoa(char* buffer, double value);
 
+// DtoaResult res = Dtoa(buffer, value, policy);
+//
+// Like Dtoa above, but surfaces the fallback: Grisu3 cannot guarantee shortest output for a
+// small fraction of the inputs (~0.5%), in which case the result is computed by the selected
+// fallback algorithm and 'was_fallback' is set. Use the flag to measure real-world fallback
+// rates.
+//
+// FallbackPolicy::dragon4 (the default, and what Dtoa above uses) handles the failure case
+// with exact big-integer arithmetic; FallbackPolicy::schubfach re-rounds with a second table
+// lookup instead, which also always produces shortest output and is much cheaper.
+//
+// Compiling with GRISU_BOUNDED_FALLBACK=1 (cmake option GRISU3_BOUNDED_FALLBACK) makes the
+// plain Dtoa above use the schubfach fallback as well, bounding the worst-case conversion
+// time: dragon4's big-integer loop is data-dependent, the schubfach re-round is a fixed
+// sequence of multiplies. The output is still shortest and correctly rounded either way.
+
+enum class FallbackPolicy {
+    dragon4,
+    schubfach,
+};
+
+struct DtoaResult {
+    char* end;
+    bool was_fallback;
+};
+
+DtoaResult Dtoa(char* buffer, double value, FallbackPolicy policy);
+
 } // namespace grisu3
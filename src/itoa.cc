@@ -0,0 +1,141 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "itoa.h"
+
+//==================================================================================================
+//
+//==================================================================================================
+
+const char drachennest::itoa::Digits100[200] = {
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
+};
+
+const int8_t drachennest::itoa::TrailingZeros100[100] = {
+    2, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static constexpr drachennest::itoa::ExponentCharsTable GenerateExponentChars()
+{
+    drachennest::itoa::ExponentCharsTable table = {};
+    for (int32_t e = drachennest::itoa::MinTableExponent; e <= drachennest::itoa::MaxTableExponent; ++e)
+    {
+        const int32_t i = 4 * (e - drachennest::itoa::MinTableExponent);
+        const int32_t k = e < 0 ? -e : e;
+        table.data[i + 0] = e < 0 ? '-' : '+';
+        table.data[i + 1] = static_cast<char>('0' + (k / 100) % 10);
+        table.data[i + 2] = static_cast<char>('0' + (k / 10) % 10);
+        table.data[i + 3] = static_cast<char>('0' + (k / 1) % 10);
+    }
+    return table;
+}
+
+const drachennest::itoa::ExponentCharsTable drachennest::itoa::ExponentChars = GenerateExponentChars();
+
+#if ITOA_4DIGIT_TABLE
+
+static constexpr drachennest::itoa::Digits10000Table GenerateDigits10000()
+{
+    drachennest::itoa::Digits10000Table table = {};
+    for (int32_t i = 0; i < 10000; ++i)
+    {
+        table.data[4 * i + 0] = static_cast<char>('0' + (i / 1000) % 10);
+        table.data[4 * i + 1] = static_cast<char>('0' + (i / 100) % 10);
+        table.data[4 * i + 2] = static_cast<char>('0' + (i / 10) % 10);
+        table.data[4 * i + 3] = static_cast<char>('0' + (i / 1) % 10);
+    }
+    return table;
+}
+
+const drachennest::itoa::Digits10000Table drachennest::itoa::Digits10000 = GenerateDigits10000();
+
+#endif // ITOA_4DIGIT_TABLE
+
+//==================================================================================================
+//
+//==================================================================================================
+
+static inline int32_t DecimalLength(uint64_t v)
+{
+    int32_t len = 1;
+    for (; v >= 10; v /= 10)
+    {
+        ++len;
+    }
+    return len;
+}
+
+// Writes the digits of value backwards, ending at buf.
+static inline void PrintDecimalDigitsBackwards(char* buf, uint64_t value)
+{
+    while (value >= 10000)
+    {
+        buf -= 4;
+        drachennest::itoa::Utoa_4Digits(buf, static_cast<uint32_t>(value % 10000));
+        value /= 10000;
+    }
+
+    if (value >= 100)
+    {
+        buf -= 2;
+        drachennest::itoa::Utoa_2Digits(buf, static_cast<uint32_t>(value % 100));
+        value /= 100;
+    }
+
+    if (value >= 10)
+    {
+        drachennest::itoa::Utoa_2Digits(buf - 2, static_cast<uint32_t>(value));
+    }
+    else
+    {
+        buf[-1] = static_cast<char>('0' + value);
+    }
+}
+
+char* drachennest::Itoa(char* buffer, uint64_t value)
+{
+    char* const end = buffer + DecimalLength(value);
+    PrintDecimalDigitsBackwards(end, value);
+    return end;
+}
+
+char* drachennest::Itoa(char* buffer, uint32_t value)
+{
+    return Itoa(buffer, static_cast<uint64_t>(value));
+}
+
+char* drachennest::Itoa(char* buffer, int64_t value)
+{
+    uint64_t u = static_cast<uint64_t>(value);
+    if (value < 0)
+    {
+        *buffer++ = '-';
+        u = 0 - u;
+    }
+    return Itoa(buffer, u);
+}
+
+char* drachennest::Itoa(char* buffer, int32_t value)
+{
+    return Itoa(buffer, static_cast<int64_t>(value));
+}
@@ -0,0 +1,442 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#ifndef ITOA_ASSERT
+#define ITOA_ASSERT(X) assert(X)
+#endif
+
+// Digit-printing policy: with ITOA_4DIGIT_TABLE=1 (e.g. via the cmake option of the same
+// name) the printers use a 4-digit lookup table (10000 entries * 4 bytes = 40 KB), halving
+// the number of dependent table loads and stores per long output at the cost of a larger
+// dcache footprint. The default is the 2-digit table (200 bytes).
+#ifndef ITOA_4DIGIT_TABLE
+#define ITOA_4DIGIT_TABLE 0
+#endif
+
+// If enabled, PrintDecimalDigitsBackwards converts the digits to ASCII with an SSE2
+// multiply-shift kernel instead of the scalar divide-by-100 chain. (May be disabled by
+// defining ITOA_SIMD_DIGITS=0.)
+#ifndef ITOA_SIMD_DIGITS
+#if defined(__SSE2__) || (defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define ITOA_SIMD_DIGITS 1
+#else
+#define ITOA_SIMD_DIGITS 0
+#endif
+#endif
+
+#if ITOA_SIMD_DIGITS
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace drachennest {
+
+// char* output_end = Itoa(buffer, value);
+//
+// Converts the given integer into decimal form and stores the result in the given buffer.
+// These are the digit printers the Dtoa engines are built on, exposed as a supported API.
+//
+// The buffer must be large enough, i.e. >= ItoaMaxLength; exactly the output characters are
+// written. The output is _not_ null-terminated.
+
+constexpr int ItoaMaxLength = 20; // 18446744073709551615 resp. -9223372036854775808
+
+char* Itoa(char* buffer, uint32_t value);
+char* Itoa(char* buffer, uint64_t value);
+char* Itoa(char* buffer, int32_t value);
+char* Itoa(char* buffer, int64_t value);
+
+// The building blocks shared by the Dtoa engines. All of them write a fixed number of
+// characters (no bounds are taken); the tables live in itoa.cc, so every engine shares a
+// single copy.
+namespace itoa {
+
+extern const char Digits100[200];       // the digit pairs "00".."99"
+extern const int8_t TrailingZeros100[100];
+
+#if ITOA_4DIGIT_TABLE
+struct Digits10000Table {
+    char data[4 * 10000];               // the digit quadruples "0000".."9999"
+};
+extern const Digits10000Table Digits10000;
+#endif
+
+// Writes the two (possibly leading-zero) digits of 0 <= digits <= 99.
+inline void Utoa_2Digits(char* buf, uint32_t digits)
+{
+    ITOA_ASSERT(digits <= 99);
+    std::memcpy(buf, &Digits100[2 * digits], 2);
+}
+
+// Writes the four (possibly leading-zero) digits of 0 <= digits <= 9999.
+inline void Utoa_4Digits(char* buf, uint32_t digits)
+{
+    ITOA_ASSERT(digits <= 9999);
+#if ITOA_4DIGIT_TABLE
+    std::memcpy(buf, &Digits10000.data[4 * digits], 4);
+#else
+    Utoa_2Digits(buf + 0, digits / 100);
+    Utoa_2Digits(buf + 2, digits % 100);
+#endif
+}
+
+// Returns the number of trailing decimal zeros in the two-digit output, i.e. 2 for 0,
+// 1 for 10, 20, ..., 90, and 0 otherwise.
+inline int32_t TrailingZeros_2Digits(uint32_t digits)
+{
+    ITOA_ASSERT(digits <= 99);
+    return TrailingZeros100[digits];
+}
+
+// Writes the eight (possibly leading-zero) digits of 1 <= digits <= 99999999 and returns the
+// number of trailing decimal zeros. Groups of four trailing zeros are not written; the
+// caller must have pre-filled the buffer with '0'.
+inline int32_t Utoa_8Digits_skip_trailing_zeros(char* buf, uint32_t digits)
+{
+    ITOA_ASSERT(digits >= 1);
+    ITOA_ASSERT(digits <= 99999999);
+
+    const uint32_t q = digits / 10000;
+    const uint32_t r = digits % 10000;
+
+    Utoa_4Digits(buf + 0, q);
+
+    if (r == 0)
+    {
+        const uint32_t qH = q / 100;
+        const uint32_t qL = q % 100;
+        return TrailingZeros_2Digits(qL == 0 ? qH : qL) + (qL == 0 ? 6 : 4);
+    }
+    else
+    {
+        Utoa_4Digits(buf + 4, r);
+
+        const uint32_t rH = r / 100;
+        const uint32_t rL = r % 100;
+        return TrailingZeros_2Digits(rL == 0 ? rH : rL) + (rL == 0 ? 2 : 0);
+    }
+}
+
+// The exponent suffixes of the scientific notations: for each exponent in
+// [MinTableExponent, MaxTableExponent] the sign and the three zero-padded decimal digits,
+// e.g. "-005". Exponents cluster tightly in real data, so the table stays cached; the
+// writers below turn the "e+XXX" suffix into fixed-size copies, with no divisions.
+//
+// The range covers every exponent the Dtoa engines can produce: binary64 needs [-324, 308],
+// decimal64 (schubfach::DtoaDecimal64) needs [-398, 384].
+constexpr int32_t MinTableExponent = -399;
+constexpr int32_t MaxTableExponent =  399;
+
+struct ExponentCharsTable {
+    // Two bytes of padding at the end: ExponentToChars below always copies three digit
+    // characters, starting inside the entry.
+    char data[4 * (MaxTableExponent - MinTableExponent + 1) + 2];
+};
+extern const ExponentCharsTable ExponentChars;
+
+// Writes "e[+-]ddd" with exactly three exponent digits; writes (and uses) 5 characters.
+inline char* ExponentToChars_3Digits(char* buf, int32_t e)
+{
+    ITOA_ASSERT(e >= MinTableExponent);
+    ITOA_ASSERT(e <= MaxTableExponent);
+
+    buf[0] = 'e';
+    std::memcpy(buf + 1, &ExponentChars.data[4 * (e - MinTableExponent)], 4);
+    return buf + 5;
+}
+
+// Writes "e[+-]d", "e[+-]dd" or "e[+-]ddd" without leading zeros (pass min_digits = 2 for
+// the printf convention of at least two exponent digits). Always writes 5 characters, of
+// which the first 3..5 are the output; the returned end points at the unused tail.
+inline char* ExponentToChars(char* buf, int32_t e, int32_t min_digits = 1)
+{
+    ITOA_ASSERT(e >= MinTableExponent);
+    ITOA_ASSERT(e <= MaxTableExponent);
+    ITOA_ASSERT(min_digits == 1 || min_digits == 2);
+
+    const int32_t k = e < 0 ? -e : e;
+    const int32_t n = (k >= 100) ? 3 : (k >= 10 ? 2 : min_digits);
+
+    const char* const src = &ExponentChars.data[4 * (e - MinTableExponent)];
+    buf[0] = 'e';
+    buf[1] = src[0];
+    std::memcpy(buf + 2, src + 1 + (3 - n), 3);
+    return buf + 2 + n;
+}
+
+//--------------------------------------------------------------------------------------------------
+// The digit-generation introspection kit: together with schubfach::ToDecimal64 (resp.
+// dragonbox::ToDecimal64) these are the pieces custom formatters are built on -- fixed-width
+// scaled decimals, exponent-aligned columns, etc. -- without re-parsing Dtoa's text output.
+//--------------------------------------------------------------------------------------------------
+
+// Returns the number of decimal digits of 1 <= v <= 99999999999999999 (at most 17 digits,
+// the range of ToDecimal64's digits).
+inline int32_t DecimalLength(uint64_t v)
+{
+    ITOA_ASSERT(v >= 1);
+    ITOA_ASSERT(v <= 99999999999999999ull);
+
+    if (static_cast<uint32_t>(v >> 32) != 0)
+    {
+        if (v >= 10000000000000000ull) { return 17; }
+        if (v >= 1000000000000000ull) { return 16; }
+        if (v >= 100000000000000ull) { return 15; }
+        if (v >= 10000000000000ull) { return 14; }
+        if (v >= 1000000000000ull) { return 13; }
+        if (v >= 100000000000ull) { return 12; }
+        if (v >= 10000000000ull) { return 11; }
+        return 10;
+    }
+
+    const uint32_t v32 = static_cast<uint32_t>(v);
+    if (v32 >= 1000000000u) { return 10; }
+    if (v32 >= 100000000u) { return 9; }
+    if (v32 >= 10000000u) { return 8; }
+    if (v32 >= 1000000u) { return 7; }
+    if (v32 >= 100000u) { return 6; }
+    if (v32 >= 10000u) { return 5; }
+    if (v32 >= 1000u) { return 4; }
+    if (v32 >= 100u) { return 3; }
+    if (v32 >= 10u) { return 2; }
+    return 1;
+}
+
+#if ITOA_SIMD_DIGITS
+
+inline int32_t CountLeadingZeros32(uint32_t x)
+{
+    ITOA_ASSERT(x != 0);
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse(&index, x);
+    return 31 - static_cast<int32_t>(index);
+#else
+    return __builtin_clz(x);
+#endif
+}
+
+inline int32_t CountTrailingZeros32(uint32_t x)
+{
+    ITOA_ASSERT(x != 0);
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return static_cast<int32_t>(index);
+#else
+    return __builtin_ctz(x);
+#endif
+}
+
+// Converts the 8-digit number abcdefgh into 8 packed 16-bit digits { a, b, c, d, e, f, g, h }.
+//
+// See: Wojciech Mula, "SSE: conversion integers to decimal representation",
+//      http://0x80.pl/articles/sse-itoa.html
+inline __m128i Utoa_8Digits_Sse2(uint32_t digits)
+{
+    ITOA_ASSERT(digits <= 99999999);
+
+    // abcd, efgh = abcdefgh divmod 10000
+    const __m128i abcdefgh = _mm_cvtsi32_si128(static_cast<int32_t>(digits));
+    const __m128i abcd = _mm_srli_epi64(_mm_mul_epu32(abcdefgh, _mm_set1_epi32(static_cast<int32_t>(0xD1B71759))), 45);
+    const __m128i efgh = _mm_sub_epi32(abcdefgh, _mm_mul_epu32(abcd, _mm_set1_epi32(10000)));
+
+    // v2 = { 4*abcd, 4*abcd, 4*abcd, 4*abcd, 4*efgh, 4*efgh, 4*efgh, 4*efgh }
+    const __m128i v1 = _mm_unpacklo_epi16(abcd, efgh);
+    const __m128i v1a = _mm_slli_epi64(v1, 2);
+    const __m128i v2a = _mm_unpacklo_epi16(v1a, v1a);
+    const __m128i v2 = _mm_unpacklo_epi32(v2a, v2a);
+
+    // v4 = v2 div { 1000, 100, 10, 1 } = { a, ab, abc, abcd, e, ef, efg, efgh }
+    const __m128i div_powers = _mm_setr_epi16(8389, 5243, 13108, static_cast<int16_t>(0x8000u), 8389, 5243, 13108, static_cast<int16_t>(0x8000u));
+    const __m128i shift_powers = _mm_setr_epi16(1 << 7, 1 << 11, 1 << 13, static_cast<int16_t>(0x8000u), 1 << 7, 1 << 11, 1 << 13, static_cast<int16_t>(0x8000u));
+    const __m128i v3 = _mm_mulhi_epu16(v2, div_powers);
+    const __m128i v4 = _mm_mulhi_epu16(v3, shift_powers);
+
+    // v7 = v4 - 10 * (v4 << 16) = { a, b, c, d, e, f, g, h }
+    const __m128i v5 = _mm_mullo_epi16(v4, _mm_set1_epi16(10));
+    const __m128i v6 = _mm_slli_epi64(v5, 16);
+    const __m128i v7 = _mm_sub_epi16(v4, v6);
+
+    return v7;
+}
+
+#endif // ITOA_SIMD_DIGITS
+
+// Writes the decimal digits of 1 <= output64 <= 99999999999999999 _ending_ at buf, i.e. into
+// buf[-DecimalLength(output64)] ... buf[-1], and returns the number of trailing decimal
+// zeros. Some of the trailing zeros may be skipped instead of written: a caller who needs
+// them must pre-fill the buffer with '0' (cf. FormatDigits in schubfach_64.cc).
+
+#if ITOA_SIMD_DIGITS
+
+inline int32_t PrintDecimalDigitsBackwards(char* buf, uint64_t output64)
+{
+    ITOA_ASSERT(output64 >= 1);
+    ITOA_ASSERT(output64 <= 99999999999999999ull);
+
+    const uint32_t hi_digit = static_cast<uint32_t>(output64 / 10000000000000000ull); // 0..9
+    const uint64_t lo16 = output64 % 10000000000000000ull;
+
+    const uint32_t hi8 = static_cast<uint32_t>(lo16 / 100000000);
+    const uint32_t lo8 = static_cast<uint32_t>(lo16 % 100000000);
+
+    // All 16 (possibly leading-zero) digits as ASCII, most significant digit first.
+    const __m128i ascii = _mm_add_epi8(_mm_packus_epi16(Utoa_8Digits_Sse2(hi8), Utoa_8Digits_Sse2(lo8)), _mm_set1_epi8('0'));
+
+    // Bit i of nonzero is set iff digit i is != 0 (bit 0 = most significant digit).
+    const uint32_t nonzero = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ascii, _mm_set1_epi8('0')))) & 0xFFFF;
+
+    if (hi_digit != 0)
+    {
+        buf[-17] = static_cast<char>('0' + hi_digit);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buf - 16), ascii);
+        return nonzero == 0 ? 16 : CountLeadingZeros32(nonzero << 16);
+    }
+
+    ITOA_ASSERT(nonzero != 0);
+    const int32_t num_digits = 16 - CountTrailingZeros32(nonzero);
+
+    // The buffer is only guaranteed to have room for num_digits characters before buf, so the
+    // vector must not be stored directly.
+    char tmp[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&tmp[0]), ascii);
+    std::memcpy(buf - num_digits, &tmp[16 - num_digits], static_cast<size_t>(num_digits));
+
+    return CountLeadingZeros32(nonzero << 16);
+}
+
+#else // !ITOA_SIMD_DIGITS
+
+inline int32_t PrintDecimalDigitsBackwards(char* buf, uint64_t output64)
+{
+    ITOA_ASSERT(output64 >= 1);
+    ITOA_ASSERT(output64 <= 99999999999999999ull);
+
+    int32_t tz = 0; // number of trailing zeros removed.
+    int32_t nd = 0; // number of decimal digits processed.
+
+    // At most 17 digits remaining
+
+    if (output64 >= 100000000)
+    {
+        const uint64_t q = output64 / 100000000;
+        const uint32_t r = static_cast<uint32_t>(output64 % 100000000);
+        output64 = q;
+        buf -= 8;
+        if (r != 0)
+        {
+            tz = Utoa_8Digits_skip_trailing_zeros(buf, r);
+            ITOA_ASSERT(tz >= 0);
+            ITOA_ASSERT(tz <= 7);
+        }
+        else
+        {
+            tz = 8;
+        }
+        nd = 8;
+    }
+
+    // At most 9 digits remaining.
+    ITOA_ASSERT(output64 <= UINT32_MAX);
+    uint32_t output = static_cast<uint32_t>(output64);
+
+    if (output >= 10000)
+    {
+        const uint32_t q = output / 10000;
+        const uint32_t r = output % 10000;
+        output = q;
+        buf -= 4;
+        if (r != 0)
+        {
+            Utoa_4Digits(buf, r);
+            if (tz == nd)
+            {
+                const uint32_t rH = r / 100;
+                const uint32_t rL = r % 100;
+                tz += TrailingZeros_2Digits(rL == 0 ? rH : rL) + (rL == 0 ? 2 : 0);
+            }
+        }
+        else
+        {
+            if (tz == nd)
+                tz += 4;
+            else
+                std::memset(buf, '0', 4); // (actually not required...)
+        }
+        nd += 4;
+    }
+
+    // At most 5 digits remaining.
+
+    if (output >= 100)
+    {
+        const uint32_t q = output / 100;
+        const uint32_t r = output % 100;
+        output = q;
+        buf -= 2;
+        Utoa_2Digits(buf, r);
+        if (tz == nd)
+        {
+            tz += TrailingZeros_2Digits(r);
+        }
+        nd += 2;
+
+        if (output >= 100)
+        {
+            const uint32_t q2 = output / 100;
+            const uint32_t r2 = output % 100;
+            output = q2;
+            buf -= 2;
+            Utoa_2Digits(buf, r2);
+            if (tz == nd)
+            {
+                tz += TrailingZeros_2Digits(r2);
+            }
+            nd += 2;
+        }
+    }
+
+    // At most 2 digits remaining.
+
+    ITOA_ASSERT(output >= 1);
+    ITOA_ASSERT(output <= 99);
+
+    if (output >= 10)
+    {
+        const uint32_t q = output;
+        buf -= 2;
+        Utoa_2Digits(buf, q);
+        if (tz == nd)
+        {
+            tz += TrailingZeros_2Digits(q);
+        }
+//      nd += 2;
+    }
+    else
+    {
+        const uint32_t q = output;
+        ITOA_ASSERT(q >= 1);
+        ITOA_ASSERT(q <= 9);
+        *--buf = static_cast<char>('0' + q);
+    }
+
+    return tz;
+}
+
+#endif // !ITOA_SIMD_DIGITS
+
+} // namespace itoa
+} // namespace drachennest
@@ -0,0 +1,363 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "parse_file.h"
+
+#include "ryu_64.h"
+
+#include <cassert>
+#include <cstring>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef PF_ASSERT
+#define PF_ASSERT(X) assert(X)
+#endif
+
+// If enabled, the spawned workers are pinned to CPUs, spread evenly over the process
+// affinity mask. The worker of chunk i gets the same CPU in the counting and the parsing
+// pass, so on a multi-socket machine each chunk is parsed on the node that faulted its
+// (mmap'ed) pages during the count (first-touch locality). Only the short-lived workers
+// spawned here are pinned; the calling thread is never touched. (May be disabled by
+// defining PF_PIN_WORKERS=0.)
+#ifndef PF_PIN_WORKERS
+#if defined(__linux__)
+#define PF_PIN_WORKERS 1
+#else
+#define PF_PIN_WORKERS 0
+#endif
+#endif
+
+#if PF_PIN_WORKERS
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+//==================================================================================================
+//
+//==================================================================================================
+
+using drachennest::ParseFileChunk;
+using drachennest::ParseFileError;
+using drachennest::ParseFileResult;
+using drachennest::ParseFileStatus;
+
+namespace {
+
+// The records of one chunk, parsed independently on one thread.
+struct ChunkOutput {
+    size_t num_records = 0;
+    size_t num_values = 0;
+    std::vector<ParseFileError> errors;
+};
+
+} // namespace
+
+#if PF_PIN_WORKERS
+// Pins the given worker to the (index * num_cpus / num_workers)-th CPU of the process
+// affinity mask.
+static void PinWorker(std::thread& worker, size_t index, size_t num_workers)
+{
+    cpu_set_t process_mask;
+    if (sched_getaffinity(0, sizeof(process_mask), &process_mask) != 0)
+        return;
+
+    const int num_cpus = CPU_COUNT(&process_mask);
+    if (num_cpus <= 1)
+        return;
+
+    int nth = static_cast<int>(index * static_cast<size_t>(num_cpus) / num_workers);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (!CPU_ISSET(cpu, &process_mask))
+            continue;
+        if (nth-- == 0)
+        {
+            cpu_set_t worker_mask;
+            CPU_ZERO(&worker_mask);
+            CPU_SET(cpu, &worker_mask);
+            pthread_setaffinity_np(worker.native_handle(), sizeof(worker_mask), &worker_mask);
+            return;
+        }
+    }
+}
+#else
+static void PinWorker(std::thread&, size_t, size_t) {}
+#endif
+
+// Returns the end of the record starting at 'next': one past the next '\n', or 'last'.
+static inline const char* FindRecordEnd(const char* next, const char* last)
+{
+    const void* const nl = std::memchr(next, '\n', static_cast<size_t>(last - next));
+    if (nl == nullptr)
+        return last;
+    return static_cast<const char*>(nl) + 1;
+}
+
+// Strips the record separator (and a preceding '\r') from [next, end).
+static inline const char* TrimRecordEnd(const char* next, const char* end)
+{
+    if (end != next && end[-1] == '\n')
+        --end;
+    if (end != next && end[-1] == '\r')
+        --end;
+    return end;
+}
+
+static size_t CountRecords(const char* next, const char* last)
+{
+    size_t count = 0;
+    while (next != last)
+    {
+        const char* const end = FindRecordEnd(next, last);
+        if (TrimRecordEnd(next, end) != next) // skip empty lines
+            ++count;
+        next = end;
+    }
+    return count;
+}
+
+static void ParseRecords(const char* base, const char* next, const char* last, double* values, ChunkOutput& out)
+{
+    while (next != last)
+    {
+        const char* const end = FindRecordEnd(next, last);
+        const char* const field_end = TrimRecordEnd(next, end);
+        if (field_end != next) // skip empty lines
+        {
+            ++out.num_records;
+
+            double value = 0;
+            const auto res = ryu::Strtod(next, field_end, value);
+            if (res && res.next == field_end)
+            {
+                values[out.num_values++] = value;
+            }
+            else
+            {
+                // res.next points at the offending character: the start of the field if it is
+                // not a number, or the first trailing character that is not part of one.
+                out.errors.push_back({static_cast<size_t>(res.next - base)});
+            }
+        }
+        next = end;
+    }
+}
+
+ParseFileResult drachennest::ParseBuffer(const char* first, const char* last, double* values, size_t max_count, int num_threads)
+{
+    PF_ASSERT(first <= last);
+
+    ParseFileResult result;
+    result.status = ParseFileStatus::ok;
+    result.num_records = 0;
+    result.num_values = 0;
+
+    const size_t size = static_cast<size_t>(last - first);
+
+    if (num_threads <= 0)
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (num_threads < 1)
+        num_threads = 1;
+
+    // Below this size the thread fan-out costs more than it saves.
+    constexpr size_t MinBytesPerThread = 1u << 16;
+    if (size / MinBytesPerThread < static_cast<size_t>(num_threads))
+        num_threads = static_cast<int>(size / MinBytesPerThread) + 1;
+
+    // Split [first, last) into one byte range per thread, moving each split point forward to
+    // the next record boundary. The boundaries are stored as chunks[i].first / chunks[i].last.
+    std::vector<ParseFileChunk> chunks;
+    {
+        const char* chunk_first = first;
+        for (int i = 1; chunk_first != last; ++i)
+        {
+            const char* chunk_last = last;
+            if (i < num_threads)
+            {
+                chunk_last = first + (size / static_cast<size_t>(num_threads)) * static_cast<size_t>(i);
+                if (chunk_last < chunk_first) // a record spanning multiple split points
+                    chunk_last = chunk_first;
+                chunk_last = FindRecordEnd(chunk_last, last);
+            }
+            chunks.push_back({static_cast<size_t>(chunk_first - first), static_cast<size_t>(chunk_last - first), 0, 0, 0, 0});
+            chunk_first = chunk_last;
+        }
+    }
+
+    // Count the records per chunk first, so that each thread of the parsing pass below knows
+    // where in 'values' its chunk starts. This pass is cheap (memchr) compared to the parse.
+    std::vector<size_t> record_counts(chunks.size(), 0);
+    {
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < chunks.size(); ++i)
+        {
+            threads.emplace_back([&, i] {
+                record_counts[i] = CountRecords(first + chunks[i].first, first + chunks[i].last);
+            });
+            PinWorker(threads.back(), i, chunks.size());
+        }
+        if (!chunks.empty())
+            record_counts[0] = CountRecords(first + chunks[0].first, first + chunks[0].last);
+        for (auto& t : threads)
+            t.join();
+    }
+
+    for (const size_t n : record_counts)
+        result.num_records += n;
+
+    if (result.num_records > max_count)
+    {
+        result.status = ParseFileStatus::buffer_too_small;
+        return result;
+    }
+
+    // Parse the chunks. Each chunk writes values starting at the sum of the record counts of
+    // the preceding chunks; the slices are compacted below once the value counts are known.
+    std::vector<ChunkOutput> outputs(chunks.size());
+    {
+        std::vector<std::thread> threads;
+        size_t values_offset = 0;
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            chunks[i].values_offset = values_offset;
+            values_offset += record_counts[i];
+            if (i == 0)
+                continue;
+            threads.emplace_back([&, i] {
+                ParseRecords(first, first + chunks[i].first, first + chunks[i].last, values + chunks[i].values_offset, outputs[i]);
+            });
+            PinWorker(threads.back(), i, chunks.size());
+        }
+        if (!chunks.empty())
+            ParseRecords(first, first + chunks[0].first, first + chunks[0].last, values + chunks[0].values_offset, outputs[0]);
+        for (auto& t : threads)
+            t.join();
+    }
+
+    // Close the gaps left by failed records, so that [values, values + num_values) is
+    // contiguous, and concatenate the per-chunk errors (in chunk order, i.e. by offset).
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        ChunkOutput& out = outputs[i];
+        PF_ASSERT(out.num_records == record_counts[i]);
+
+        if (result.num_values != chunks[i].values_offset && out.num_values != 0)
+            std::memmove(values + result.num_values, values + chunks[i].values_offset, out.num_values * sizeof(double));
+
+        chunks[i].values_offset = result.num_values;
+        chunks[i].num_values = out.num_values;
+        chunks[i].errors_offset = result.errors.size();
+        chunks[i].num_errors = out.errors.size();
+
+        result.num_values += out.num_values;
+        result.errors.insert(result.errors.end(), out.errors.begin(), out.errors.end());
+    }
+
+    result.chunks = std::move(chunks);
+    return result;
+}
+
+//==================================================================================================
+//
+//==================================================================================================
+
+#if defined(_WIN32)
+
+ParseFileResult drachennest::ParseFile(const char* path, double* values, size_t max_count, int num_threads)
+{
+    ParseFileResult result;
+    result.status = ParseFileStatus::io_error;
+    result.num_records = 0;
+    result.num_values = 0;
+
+    const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return result;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size))
+    {
+        CloseHandle(file);
+        return result;
+    }
+
+    if (file_size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return ParseBuffer(nullptr, nullptr, values, max_count, num_threads);
+    }
+
+    const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return result;
+    }
+
+    const void* const data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data != nullptr)
+    {
+        const char* const first = static_cast<const char*>(data);
+        result = ParseBuffer(first, first + file_size.QuadPart, values, max_count, num_threads);
+        UnmapViewOfFile(data);
+    }
+
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return result;
+}
+
+#else
+
+ParseFileResult drachennest::ParseFile(const char* path, double* values, size_t max_count, int num_threads)
+{
+    ParseFileResult result;
+    result.status = ParseFileStatus::io_error;
+    result.num_records = 0;
+    result.num_values = 0;
+
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return result;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 0)
+    {
+        close(fd);
+        return result;
+    }
+
+    if (st.st_size == 0)
+    {
+        close(fd);
+        return ParseBuffer(nullptr, nullptr, values, max_count, num_threads);
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+
+    void* const data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED)
+    {
+        const char* const first = static_cast<const char*>(data);
+        result = ParseBuffer(first, first + size, values, max_count, num_threads);
+        munmap(data, size);
+    }
+
+    close(fd);
+    return result;
+}
+
+#endif
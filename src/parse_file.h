@@ -0,0 +1,74 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace drachennest {
+
+// ParseFile memory-maps a text file of newline-separated numbers and parses it on a thread
+// pool into a caller-provided double array, using ryu::Strtod for the individual fields.
+//
+// The file is split into one byte range per thread, with each split point moved forward to
+// the next record boundary ('\n'), so no record is ever parsed by two threads. Records are
+// the non-empty lines of the file ('\r' before a '\n' is ignored); a record must consist of
+// exactly one number, with no surrounding whitespace.
+//
+// A record that fails to parse produces an error entry (the byte offset of the offending
+// character) instead of a value and is skipped; the parsed values are stored contiguously
+// in their file order. The per-chunk entries describe which slice of 'values' and 'errors'
+// each byte range produced, so errors can be attributed to chunks (and re-parsed or logged
+// per chunk) by the caller.
+
+enum class ParseFileStatus {
+    ok,
+    io_error,           // The file could not be opened or mapped.
+    buffer_too_small,   // There are more records than max_count; num_records is the required size.
+};
+
+struct ParseFileChunk {
+    size_t first;           // byte range of this chunk: [first, last)
+    size_t last;
+    size_t values_offset;   // values of this chunk: [values_offset, values_offset + num_values)
+    size_t num_values;
+    size_t errors_offset;   // errors of this chunk: [errors_offset, errors_offset + num_errors)
+    size_t num_errors;
+};
+
+struct ParseFileError {
+    size_t offset;          // byte offset of the offending character
+};
+
+struct ParseFileResult {
+    ParseFileStatus status;
+    size_t num_records;     // number of records seen (== num_values + errors.size())
+    size_t num_values;      // number of values stored
+    std::vector<ParseFileChunk> chunks;
+    std::vector<ParseFileError> errors; // sorted by offset
+
+    // Test for success.
+    explicit operator bool() const noexcept
+    {
+        return status == ParseFileStatus::ok;
+    }
+};
+
+// Parses the numbers in [first, last), which must remain valid for the duration of the call.
+//
+// num_threads == 0 uses one thread per hardware thread; the input is parsed on the calling
+// thread if it is small or num_threads == 1. On Linux the worker threads are pinned to CPUs
+// so that on multi-socket machines every chunk is parsed on the NUMA node that first touched
+// its pages (see PF_PIN_WORKERS in parse_file.cc).
+
+ParseFileResult ParseBuffer(const char* first, const char* last, double* values, size_t max_count, int num_threads = 0);
+
+// Memory-maps the given file and parses it as above. The mapping is released before the
+// function returns.
+
+ParseFileResult ParseFile(const char* path, double* values, size_t max_count, int num_threads = 0);
+
+} // namespace drachennest
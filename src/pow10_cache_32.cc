@@ -0,0 +1,103 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "pow10_cache_32.h"
+
+#include <cassert>
+
+#ifndef P10_ASSERT
+#define P10_ASSERT(X) assert(X)
+#endif
+
+static constexpr int32_t kMin = pow10cache::kMinDecimalExponent32;
+static constexpr int32_t kMax = pow10cache::kMaxDecimalExponent32;
+
+uint64_t pow10cache::GetPow10Significand32(int32_t k)
+{
+    static constexpr uint64_t g[kMax - kMin + 1] = {
+        0x81CEB32C4B43FCF5, // -31
+        0xA2425FF75E14FC32, // -30
+        0xCAD2F7F5359A3B3F, // -29
+        0xFD87B5F28300CA0E, // -28
+        0x9E74D1B791E07E49, // -27
+        0xC612062576589DDB, // -26
+        0xF79687AED3EEC552, // -25
+        0x9ABE14CD44753B53, // -24
+        0xC16D9A0095928A28, // -23
+        0xF1C90080BAF72CB2, // -22
+        0x971DA05074DA7BEF, // -21
+        0xBCE5086492111AEB, // -20
+        0xEC1E4A7DB69561A6, // -19
+        0x9392EE8E921D5D08, // -18
+        0xB877AA3236A4B44A, // -17
+        0xE69594BEC44DE15C, // -16
+        0x901D7CF73AB0ACDA, // -15
+        0xB424DC35095CD810, // -14
+        0xE12E13424BB40E14, // -13
+        0x8CBCCC096F5088CC, // -12
+        0xAFEBFF0BCB24AAFF, // -11
+        0xDBE6FECEBDEDD5BF, // -10
+        0x89705F4136B4A598, //  -9
+        0xABCC77118461CEFD, //  -8
+        0xD6BF94D5E57A42BD, //  -7
+        0x8637BD05AF6C69B6, //  -6
+        0xA7C5AC471B478424, //  -5
+        0xD1B71758E219652C, //  -4
+        0x83126E978D4FDF3C, //  -3
+        0xA3D70A3D70A3D70B, //  -2
+        0xCCCCCCCCCCCCCCCD, //  -1
+        0x8000000000000000, //   0
+        0xA000000000000000, //   1
+        0xC800000000000000, //   2
+        0xFA00000000000000, //   3
+        0x9C40000000000000, //   4
+        0xC350000000000000, //   5
+        0xF424000000000000, //   6
+        0x9896800000000000, //   7
+        0xBEBC200000000000, //   8
+        0xEE6B280000000000, //   9
+        0x9502F90000000000, //  10
+        0xBA43B74000000000, //  11
+        0xE8D4A51000000000, //  12
+        0x9184E72A00000000, //  13
+        0xB5E620F480000000, //  14
+        0xE35FA931A0000000, //  15
+        0x8E1BC9BF04000000, //  16
+        0xB1A2BC2EC5000000, //  17
+        0xDE0B6B3A76400000, //  18
+        0x8AC7230489E80000, //  19
+        0xAD78EBC5AC620000, //  20
+        0xD8D726B7177A8000, //  21
+        0x878678326EAC9000, //  22
+        0xA968163F0A57B400, //  23
+        0xD3C21BCECCEDA100, //  24
+        0x84595161401484A0, //  25
+        0xA56FA5B99019A5C8, //  26
+        0xCECB8F27F4200F3A, //  27
+        0x813F3978F8940985, //  28
+        0xA18F07D736B90BE6, //  29
+        0xC9F2C9CD04674EDF, //  30
+        0xFC6F7C4045812297, //  31
+        0x9DC5ADA82B70B59E, //  32
+        0xC5371912364CE306, //  33
+        0xF684DF56C3E01BC7, //  34
+        0x9A130B963A6C115D, //  35
+        0xC097CE7BC90715B4, //  36
+        0xF0BDC21ABB48DB21, //  37
+        0x96769950B50D88F5, //  38
+        0xBC143FA4E250EB32, //  39
+        0xEB194F8E1AE525FE, //  40
+        0x92EFD1B8D0CF37BF, //  41
+        0xB7ABC627050305AE, //  42
+        0xE596B7B0C643C71A, //  43
+        0x8F7E32CE7BEA5C70, //  44
+        0xB35DBF821AE4F38C, //  45
+        0xE0352F62A19E306F, //  46
+    };
+
+    P10_ASSERT(k >= kMin);
+    P10_ASSERT(k <= kMax);
+    return g[static_cast<uint32_t>(k - kMin)];
+}
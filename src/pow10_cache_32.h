@@ -0,0 +1,26 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+namespace pow10cache {
+
+// The 64-bit significands of the powers of ten used by the single-precision engines, shared
+// by schubfach_32 and dragonbox_32.
+//
+// For each k there are unique beta and r such that 10^k = beta 2^r and 2^63 <= beta < 2^64,
+// namely r = floor(log_2 10^k) - 63. GetPow10Significand32 returns g = ceil(beta).
+//
+// NB: For k >= 28, 10^k is not exactly representable in 64 bits; consumers that need
+//     floor(beta) (dragonbox_32) must subtract 1 for these k.
+
+constexpr int32_t kMinDecimalExponent32 = -31;
+constexpr int32_t kMaxDecimalExponent32 =  46;
+
+uint64_t GetPow10Significand32(int32_t k);
+
+} // namespace pow10cache
@@ -0,0 +1,35 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+namespace pow10cache {
+
+// The 128-bit significands of the powers of ten, shared by schubfach_64 and dragonbox (which
+// would otherwise each carry their own ~10KB copy of the same constants).
+//
+// For each k there are unique beta and r such that 10^k = beta 2^r and 2^127 <= beta < 2^128,
+// namely r = floor(log_2 10^k) - 127. GetPow10Significand returns g = ceil(beta).
+//
+// NB: For k >= 56, 10^k is not exactly representable in 128 bits; consumers that need
+//     floor(beta) (dragonbox) must subtract 1 for these k.
+//
+// NB: With a build-time generated cache (the DRACHENNEST_GENERATED_CACHE cmake option) the
+//     table may cover a narrower, deployment-specific range than
+//     [kMinDecimalExponent, kMaxDecimalExponent]; the lookup asserts the generated bounds.
+
+struct Significand128 {
+    uint64_t hi;
+    uint64_t lo;
+};
+
+constexpr int32_t kMinDecimalExponent = -292;
+constexpr int32_t kMaxDecimalExponent =  326;
+
+Significand128 GetPow10Significand(int32_t k);
+
+} // namespace pow10cache
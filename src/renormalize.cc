@@ -0,0 +1,255 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "renormalize.h"
+
+#include "ryu_64.h"
+#include "schubfach_64.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#ifndef RN_ASSERT
+#define RN_ASSERT(X) assert(X)
+#endif
+
+using drachennest::RenormalizeResult;
+
+//==================================================================================================
+//
+//==================================================================================================
+
+namespace {
+
+// The fixed-notation window of schubfach's FormatDigits: values whose decimal point falls
+// into [Min, Max] are formatted without an exponent. Must match schubfach_64.cc.
+constexpr int32_t MinFixedDecimalPoint = -6;
+constexpr int32_t MaxFixedDecimalPoint = 17;
+
+inline bool IsDigit(char c)
+{
+    return '0' <= c && c <= '9';
+}
+
+inline int32_t DecimalLength(uint64_t v)
+{
+    int32_t len = 1;
+    for (; v >= 10; v /= 10)
+        ++len;
+    return len;
+}
+
+// The decimal a canonical text denotes: digits has no trailing zeros, and the value is
+// 0.digits * 10^decimal_point (the same convention as FormatDigits' decimal point).
+struct CanonicalNumber
+{
+    uint64_t digits;
+    int32_t decimal_point;
+};
+
+// Scans a canonical exponent part: 'e', a mandatory sign, and 1 to 3 exponent digits
+// without leading zeros, ending the input. On success sets the decimal point implied by the
+// scientific exponent and checks that it lies outside the fixed-notation window (inside it,
+// the canonical form has no exponent at all).
+bool ScanCanonicalExponent(const char* next, const char* last, int32_t& decimal_point)
+{
+    if (next == last || *next != 'e')
+        return false;
+    ++next;
+    if (next == last || (*next != '+' && *next != '-'))
+        return false;
+    const bool is_negative = *next == '-';
+    ++next;
+
+    if (next == last || !IsDigit(*next) || *next == '0')
+        return false;
+    int32_t k = 0;
+    int32_t exponent_digits = 0;
+    while (next != last && IsDigit(*next))
+    {
+        if (exponent_digits == 3)
+            return false;
+        k = 10 * k + (*next - '0');
+        ++exponent_digits;
+        ++next;
+    }
+    if (next != last)
+        return false;
+
+    decimal_point = (is_negative ? -k : k) + 1;
+    return decimal_point < MinFixedDecimalPoint || decimal_point > MaxFixedDecimalPoint;
+}
+
+// Checks whether [next, last) is exactly a text schubfach's FormatDigits produces -- one of
+// the layouts
+//
+//  0.[000]digits | dig.its | digits[000] | d.igitsE+123 | dE+123
+//
+// with an optional leading '-', no redundant zeros, and the canonical exponent shape -- and
+// if so, extracts the decimal it denotes. The input is already known to parse as a number;
+// this only decides canonicity, so rejecting is always safe (it merely forces a reformat).
+bool ScanCanonical(const char* next, const char* last, CanonicalNumber& result)
+{
+    if (next != last && *next == '-')
+        ++next;
+    if (next == last || !IsDigit(*next))
+        return false;
+
+    uint64_t digits = 0;
+    int32_t num_digits = 0;
+    int32_t decimal_point;
+
+    if (*next == '0')
+    {
+        // A leading zero is canonical only as "0.[000]digits".
+        ++next;
+        if (next == last || *next != '.')
+            return false;
+        ++next;
+
+        int32_t leading_zeros = 0;
+        while (next != last && *next == '0')
+        {
+            ++leading_zeros;
+            ++next;
+        }
+        decimal_point = -leading_zeros;
+        if (decimal_point < MinFixedDecimalPoint)
+            return false;
+
+        if (next == last) // "0." resp. "0.000"
+            return false;
+        while (next != last && IsDigit(*next))
+        {
+            if (num_digits == 17)
+                return false; // shortest output never has more
+            digits = 10 * digits + static_cast<uint32_t>(*next - '0');
+            ++num_digits;
+            ++next;
+        }
+        if (next != last || last[-1] == '0') // junk resp. trailing zero
+            return false;
+    }
+    else
+    {
+        int32_t integer_digits = 0;
+        while (next != last && IsDigit(*next))
+        {
+            if (num_digits == 17)
+                return false;
+            digits = 10 * digits + static_cast<uint32_t>(*next - '0');
+            ++num_digits;
+            ++integer_digits;
+            ++next;
+        }
+
+        if (next == last)
+        {
+            // "digits[000]": the trailing zeros are padding, not significand.
+            decimal_point = integer_digits;
+            if (decimal_point > MaxFixedDecimalPoint)
+                return false;
+            while (num_digits > 1 && digits % 10 == 0)
+            {
+                digits /= 10;
+                --num_digits;
+            }
+        }
+        else if (*next == '.')
+        {
+            ++next;
+            const char* const fraction_digits = next;
+            while (next != last && IsDigit(*next))
+            {
+                if (num_digits == 17)
+                    return false;
+                digits = 10 * digits + static_cast<uint32_t>(*next - '0');
+                ++num_digits;
+                ++next;
+            }
+            if (next == fraction_digits || next[-1] == '0') // "d." resp. trailing zero
+                return false;
+
+            if (next == last)
+            {
+                // "dig.its"
+                decimal_point = integer_digits;
+                if (decimal_point > MaxFixedDecimalPoint)
+                    return false;
+            }
+            else
+            {
+                // "d.igitsE+123"
+                if (integer_digits != 1)
+                    return false;
+                if (!ScanCanonicalExponent(next, last, decimal_point))
+                    return false;
+            }
+        }
+        else
+        {
+            // "dE+123"
+            if (integer_digits != 1)
+                return false;
+            if (!ScanCanonicalExponent(next, last, decimal_point))
+                return false;
+        }
+    }
+
+    result.digits = digits;
+    result.decimal_point = decimal_point;
+    return true;
+}
+
+} // namespace
+
+RenormalizeResult drachennest::Renormalize(const char* first, const char* last, char* out)
+{
+    double value = 0;
+    const auto res = ryu::Strtod(first, last, value);
+    if (!res)
+        return {res.next, nullptr, false};
+
+    const size_t consumed = static_cast<size_t>(res.next - first);
+
+    // Special values ("inf", "-NaN", "1e999", ...) and zeros are rare and short: format and
+    // compare directly. Note that overflowing inputs like "1e999" parse with a regular status
+    // but a non-finite value.
+    const bool is_special = res.status == ryu::StrtodStatus::inf || res.status == ryu::StrtodStatus::nan
+        || !std::isfinite(value);
+    if (is_special || value == 0)
+    {
+        char* const end = schubfach::Dtoa(out, value);
+        const size_t length = static_cast<size_t>(end - out);
+        const bool changed = length != consumed || std::memcmp(out, first, length) != 0;
+        return {res.next, end, changed};
+    }
+
+    // One run of the digit generation serves both the canonicity check and, if that fails,
+    // the reformat.
+    const schubfach::FloatingDecimal64 dec = schubfach::ToDecimal64(value);
+
+    CanonicalNumber parsed;
+    if (ScanCanonical(first, res.next, parsed))
+    {
+        uint64_t digits = dec.digits;
+        int32_t exponent = dec.exponent;
+        while (digits % 10 == 0)
+        {
+            digits /= 10;
+            ++exponent;
+        }
+        if (parsed.digits == digits && parsed.decimal_point == DecimalLength(digits) + exponent)
+        {
+            // Already shortest form: a straight copy, no formatting.
+            std::memcpy(out, first, consumed);
+            return {res.next, out + consumed, false};
+        }
+    }
+
+    return {res.next, schubfach::FormatKnownLength(out, value, dec), true};
+}
@@ -0,0 +1,45 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+namespace drachennest {
+
+// RenormalizeResult res = Renormalize(first, last, out);
+//
+// Reads one number from [first, last) (the same grammar as ryu::Strtod) and writes it to
+// 'out' in canonical shortest form, i.e. exactly as schubfach::Dtoa formats the parsed
+// value. Use this to rewrite numeric text streams so that equal values have equal text.
+//
+// The parse and the conversion are fused: if the input text already is the canonical form
+// -- which is detected from the parse plus one run of the digit generation, without
+// formatting -- the text is simply copied and 'changed' is false. Only inputs whose text
+// actually changes ("+1.5", "2.50", "1e5", over-long digit strings, ...) pay for the
+// formatting, and the digit generation is shared between the check and the formatting
+// instead of running twice.
+//
+// The output is never longer than schubfach::DtoaMaxLength characters, and 'out' must
+// provide that much headroom (canonical inputs are themselves Dtoa outputs, so the copy
+// obeys the same bound).
+//
+// On failure (the input does not start with a number), nothing is written, out_end is
+// nullptr, and 'next' points at the offending character.
+
+struct RenormalizeResult
+{
+    const char* next;   // one past the consumed number (the error position on failure)
+    char* out_end;      // one past the last character written (nullptr on failure)
+    bool changed;       // false iff the output is byte-identical to the consumed input
+
+    // Test for success.
+    explicit operator bool() const noexcept
+    {
+        return out_end != nullptr;
+    }
+};
+
+RenormalizeResult Renormalize(const char* first, const char* last, char* out);
+
+} // namespace drachennest
@@ -0,0 +1,234 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "renumber.h"
+
+#include "dtoa_column.h"
+#include "ryu_64.h"
+#include "scan_number.h"
+#include "schubfach_64.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#ifndef RN_ASSERT
+#define RN_ASSERT(X) assert(X)
+#endif
+
+// SIMD literal skipping: the text between numbers is scanned 16 characters at a time for
+// the next character of interest. (May be disabled by defining RN_SIMD_SCAN=0.)
+#ifndef RN_SIMD_SCAN
+#if defined(__SSE2__) || (defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define RN_SIMD_SCAN 1
+#else
+#define RN_SIMD_SCAN 0
+#endif
+#endif
+
+#if RN_SIMD_SCAN
+#include <emmintrin.h>
+#endif
+
+static inline bool IsDigit(char ch)
+{
+    return static_cast<unsigned>(ch - '0') <= 9u;
+}
+
+// May 'ch' start a JSON number? ('+' may not; RFC 8259 numbers have no leading plus.)
+static inline bool StartsNumber(char ch)
+{
+    return IsDigit(ch) || ch == '-';
+}
+
+// Returns the first character of [next, last) that may start a number or a string, or last
+// if there is none. Everything skipped is literal text, copied verbatim.
+static inline const char* SkipLiteral(const char* next, const char* last)
+{
+#if RN_SIMD_SCAN
+    // All characters involved are ASCII (< 0x80), so the signed 8-bit comparisons below are
+    // exact for them; bytes >= 0x80 compare as negative and correctly fail every test.
+    const __m128i digit_lo = _mm_set1_epi8('0' - 1);
+    const __m128i digit_hi = _mm_set1_epi8('9' + 1);
+    const __m128i minus = _mm_set1_epi8('-');
+    const __m128i quote = _mm_set1_epi8('"');
+
+    for ( ; last - next >= 16; next += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(next));
+
+        const __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(chunk, digit_lo), _mm_cmplt_epi8(chunk, digit_hi));
+        const __m128i is_other = _mm_or_si128(_mm_cmpeq_epi8(chunk, minus), _mm_cmpeq_epi8(chunk, quote));
+
+        const uint32_t hit = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(is_digit, is_other)));
+        if (hit != 0)
+        {
+            // Locate the character of interest in this chunk.
+            while (!StartsNumber(*next) && *next != '"')
+                ++next;
+            return next;
+        }
+    }
+#endif
+
+    for ( ; next != last; ++next)
+    {
+        if (StartsNumber(*next) || *next == '"')
+            break;
+    }
+    return next;
+}
+
+// Returns one past the closing quote of the string literal starting at 'next' (which points
+// at the opening quote), or last if the string is unterminated. Only the quote/backslash
+// structure matters here -- the content is copied verbatim, not validated.
+static inline const char* SkipString(const char* next, const char* last)
+{
+    RN_ASSERT(next != last);
+    RN_ASSERT(*next == '"');
+    ++next;
+
+    for (;;)
+    {
+#if RN_SIMD_SCAN
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+
+        for ( ; last - next >= 16; next += 16)
+        {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(next));
+            const uint32_t hit = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash))));
+            if (hit != 0)
+                break;
+        }
+#endif
+        while (next != last && *next != '"' && *next != '\\')
+            ++next;
+
+        if (next == last)
+            return last; // unterminated
+        if (*next == '"')
+            return next + 1;
+
+        // An escape: the escaped character is part of the string, whatever it is (this
+        // also keeps \" and \\ from ending or re-entering the string).
+        next += (last - next >= 2) ? 2 : 1;
+    }
+}
+
+size_t drachennest::RenumberJson(char* buffer, size_t buffer_size, const char* first, const char* last, RenumberStats* stats)
+{
+    RN_ASSERT(first <= last);
+    RN_ASSERT(last - first <= INT32_MAX);
+
+    // The batch scratch: small enough to live on the stack (and in L1/L2) for the whole
+    // call, large enough that each pipeline stage runs a few hundred iterations per flush.
+    constexpr size_t BatchSize = 256;
+
+    ScanNumberToken tokens[BatchSize];
+    double values[BatchSize];
+    int32_t column_offsets[BatchSize + 1];
+    char column[BatchSize * schubfach::DtoaMaxLength];
+
+    char* out = buffer;
+    char* const out_last = buffer + buffer_size;
+
+    size_t num_numbers = 0;
+    size_t num_invalid = 0;
+    size_t num_nonfinite = 0;
+
+    const char* next = first;   // scan cursor
+    const char* copied = first; // input before this position has been emitted
+
+    for (;;)
+    {
+        // Stage 1: collect a batch of number tokens (the extents of everything the
+        // conversion stages will touch). Strings and malformed tokens stay literal text.
+        size_t count = 0;
+        while (next != last && count < BatchSize)
+        {
+            next = SkipLiteral(next, last);
+            if (next == last)
+                break;
+
+            if (*next == '"')
+            {
+                next = SkipString(next, last);
+                continue;
+            }
+
+            const auto scan = ScanNumber(next, last);
+            if (scan.status != ScanNumberStatus::ok)
+            {
+                ++num_invalid;
+                next = (scan.next != next) ? scan.next : next + 1;
+                continue;
+            }
+
+            tokens[count].first = static_cast<int32_t>(next - first);
+            tokens[count].last = static_cast<int32_t>(scan.next - first);
+            ++count;
+            next = scan.next;
+        }
+
+        if (count != 0)
+        {
+            // Stage 2: bulk conversion. Every token passed the RFC 8259 grammar above, so
+            // the validated parse applies; the batch formats into one columnar buffer whose
+            // offsets delimit the individual numbers.
+            ryu::StrtodValidated(first, tokens, count, values);
+
+            const size_t column_size = DtoaColumn(column, sizeof(column), values, count, column_offsets);
+            RN_ASSERT(column_size != 0); // the column always has the full-headroom capacity
+            static_cast<void>(column_size);
+
+            // Stage 3: emit, interleaving the literal run before each number with its
+            // shortest form (or its original text, if the value exceeds the double range).
+            for (size_t i = 0; i < count; ++i)
+            {
+                const size_t literal_size = static_cast<size_t>(tokens[i].first - (copied - first));
+
+                const char* number = column + column_offsets[i];
+                size_t number_size = static_cast<size_t>(column_offsets[i + 1] - column_offsets[i]);
+                if (values[i] - values[i] == 0)
+                {
+                    ++num_numbers;
+                }
+                else
+                {
+                    ++num_nonfinite;
+                    number = first + tokens[i].first;
+                    number_size = static_cast<size_t>(tokens[i].last - tokens[i].first);
+                }
+
+                if (static_cast<size_t>(out_last - out) < literal_size + number_size)
+                    return 0;
+                std::memcpy(out, copied, literal_size);
+                std::memcpy(out + literal_size, number, number_size);
+                out += literal_size + number_size;
+                copied = first + tokens[i].last;
+            }
+        }
+
+        if (next == last)
+            break;
+    }
+
+    // The trailing literal run.
+    const size_t literal_size = static_cast<size_t>(last - copied);
+    if (static_cast<size_t>(out_last - out) < literal_size)
+        return 0;
+    std::memcpy(out, copied, literal_size);
+    out += literal_size;
+
+    if (stats != nullptr)
+    {
+        stats->num_numbers += num_numbers;
+        stats->num_invalid += num_invalid;
+        stats->num_nonfinite += num_nonfinite;
+    }
+    return static_cast<size_t>(out - buffer);
+}
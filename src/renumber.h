@@ -0,0 +1,45 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+
+namespace drachennest {
+
+// size_t size = RenumberJson(buffer, buffer_size, first, last, &stats);
+//
+// Rewrites every number of the JSON text [first, last) in shortest round-trip form
+// (schubfach::Dtoa) and stores the result in 'buffer'; everything else -- structure,
+// whitespace, strings (number-shaped text inside string literals is left alone) -- is
+// copied verbatim. This is the in-memory core of tools/renumber and the macro-benchmark
+// bench_renumber: numbers are collected a few hundred at a time and run through the batch
+// pipeline ScanNumber -> ryu::StrtodValidated -> DtoaColumn, so each stage stays in its
+// tight loop and the per-batch state stays cache resident.
+//
+// The rewrite preserves the double value (round-to-nearest), not the decimal text: a stored
+// "2.5000000000000001" becomes "2.5", and digits beyond what a double holds are dropped --
+// the same notion of equivalence tools/audit_shortest audits. Shortest form is usually
+// shorter, but need not be ("1e5" becomes "100000").
+//
+// Two kinds of tokens are copied verbatim instead of rewritten: malformed number-shaped
+// text ("1e+", "-x"; counted in stats->num_invalid), so non-JSON input degrades to a copy
+// instead of corrupted output, and numbers exceeding the double range ("1e999"; counted in
+// stats->num_nonfinite), whose shortest form would be the non-JSON token "inf".
+//
+// Returns the number of characters written, or 0 if buffer_size is too small (the buffer
+// contents are unspecified in this case; retry with a larger buffer).
+//
+// PRE: last - first must be <= INT32_MAX (the batch tokens use int32 offsets).
+
+struct RenumberStats {
+    size_t num_numbers = 0;   // numbers rewritten in shortest form
+    size_t num_invalid = 0;   // malformed number-shaped tokens, copied verbatim
+    size_t num_nonfinite = 0; // numbers exceeding the double range, copied verbatim
+};
+
+size_t RenumberJson(char* buffer, size_t buffer_size, const char* first, const char* last, RenumberStats* stats = nullptr);
+
+} // namespace drachennest
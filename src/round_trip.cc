@@ -0,0 +1,32 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "round_trip.h"
+
+#include "ryu_64.h"
+#include "schubfach_64.h"
+
+#include <cstring>
+
+bool drachennest::RoundTripCheck(double value)
+{
+    char buffer[schubfach::DtoaMaxLength];
+    char* const end = schubfach::Dtoa(buffer, value);
+
+    double parsed = 0;
+    const auto res = ryu::Strtod(buffer, end, parsed);
+    if (!res || res.next != end)
+        return false;
+
+    uint64_t value_bits;
+    uint64_t parsed_bits;
+    std::memcpy(&value_bits, &value, sizeof(value_bits));
+    std::memcpy(&parsed_bits, &parsed, sizeof(parsed_bits));
+    if (value_bits == parsed_bits)
+        return true;
+
+    // The text "nan" does not carry the payload bits; any NaN reads back as some NaN.
+    return value != value && parsed != parsed;
+}
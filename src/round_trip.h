@@ -0,0 +1,24 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+namespace drachennest {
+
+// bool ok = RoundTripCheck(value);
+//
+// Formats 'value' (schubfach::Dtoa) into a stack buffer and immediately parses the text
+// back (ryu::Strtod): the fused format-then-reparse operation of a self-verifying writer.
+// Calling the two conversions separately pays for a caller-side buffer that has usually
+// left the cache by the time the verifying read runs; here the intermediate text never
+// leaves the stack, so the reparse reads cache-hot (or register-allocated) bytes.
+//
+// Returns true iff the parse consumes the whole output and reproduces 'value' bit for bit.
+// NaNs count as reproduced if a NaN is parsed back (the text "nan" does not carry the
+// payload bits); -0.0 and 0.0 are distinguished.
+
+bool RoundTripCheck(double value);
+
+} // namespace drachennest
@@ -6,6 +6,8 @@
 
 #include "ryu_32.h"
 
+#include "itoa.h"
+
 #if defined(__has_include) && __has_include(<version>)
 #include <version>
 #else
@@ -38,6 +40,13 @@
 #define RYU_ASSERT(X) assert(X)
 #endif
 
+// Some targets (e.g. wasm32) offer unsigned __int128 but lower the 64x64->128 multiplies to
+// a libcall; defining DRACHENNEST_NO_INT128=1 (see the cmake option) forces the 32x32->64
+// decomposition instead.
+#ifndef DRACHENNEST_NO_INT128
+#define DRACHENNEST_NO_INT128 0
+#endif
+
 #ifndef RYU_NEVER_INLINE
 #if _MSC_VER
 #define RYU_NEVER_INLINE __declspec(noinline) inline
@@ -48,6 +57,20 @@
 #endif
 #endif
 
+// If enabled, Strtof scans digit runs 16 characters at a time using SSE2 compares instead of one
+// character per iteration. (May be disabled by defining RYU_SIMD_SCAN=0.)
+#ifndef RYU_SIMD_SCAN
+#if defined(__SSE2__) || (defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define RYU_SIMD_SCAN 1
+#else
+#define RYU_SIMD_SCAN 0
+#endif
+#endif
+
+#if RYU_SIMD_SCAN
+#include <emmintrin.h>
+#endif
+
 //==================================================================================================
 //
 //==================================================================================================
@@ -302,7 +325,7 @@ static inline uint64_t MulShift(uint32_t m, uint64_t mul, int32_t j)
     RYU_ASSERT(j >= 32);
     RYU_ASSERT(j <= 95);
 
-#if defined(__SIZEOF_INT128__)
+#if defined(__SIZEOF_INT128__) && !DRACHENNEST_NO_INT128
     __extension__ using uint128_t = unsigned __int128;
     const uint64_t shifted_sum = static_cast<uint64_t>((uint128_t{mul} * m) >> j);
 #elif defined(_MSC_VER) && defined(_M_X64)
@@ -662,24 +685,10 @@ static inline FloatingDecimal32 ToDecimal32(uint32_t ieee_significand, uint32_t
 // ToChars
 //==================================================================================================
 
-static inline void Utoa_2Digits(char* buf, uint32_t digits)
-{
-    static constexpr char Digits100[200] = {
-        '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
-        '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
-        '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
-        '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
-        '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
-        '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
-        '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
-        '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
-        '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
-        '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
-    };
-
-    RYU_ASSERT(digits <= 99);
-    std::memcpy(buf, &Digits100[2 * digits], 2);
-}
+// The digit pairs table and the low-level digit printers are shared by all engines, see
+// itoa.h.
+using drachennest::itoa::Utoa_2Digits;
+using drachennest::itoa::TrailingZeros_2Digits;
 
 static inline char* PrintDecimalDigitsBackwards(char* buf, uint32_t output)
 {
@@ -1141,6 +1150,82 @@ static inline int32_t DigitValue(char ch)
     return ch - '0';
 }
 
+// Returns a pointer to the first character in [next, last) which is not a decimal digit.
+//
+// NB: Single-precision inputs in shortest form have at most 9 significant digits, so the whole
+// digit run is classified by the first 16-byte load.
+#if RYU_SIMD_SCAN
+static inline const char* ScanDigits(const char* next, const char* last)
+{
+    while (last - next >= 16)
+    {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(next));
+        const __m128i t = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+        const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(9)), t);
+
+        const uint32_t non_digits = static_cast<uint32_t>(_mm_movemask_epi8(is_digit)) ^ 0xFFFF;
+        if (non_digits != 0)
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward(&index, non_digits);
+            return next + index;
+#else
+            return next + __builtin_ctz(non_digits);
+#endif
+        }
+
+        next += 16;
+    }
+
+    while (next != last && IsDigit(*next))
+        ++next;
+
+    return next;
+}
+#else
+static inline const char* ScanDigits(const char* next, const char* last)
+{
+    while (next != last && IsDigit(*next))
+        ++next;
+
+    return next;
+}
+#endif
+
+// Returns significand * 10^(last - next) + value(next, last) (mod 2^32),
+// i.e. appends the decimal digits [next, last) to the given significand.
+//
+// As in the scalar digit loop, the result is allowed to wrap: it is only used if the total
+// number of significant digits is <= 9, and all the operations here are exact mod 2^32.
+static inline uint32_t ReadDecimalDigits(uint32_t significand, const char* next, const char* last)
+{
+#if defined(_MSC_VER) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    while (last - next >= 8)
+    {
+        // Convert 8 digits at a time using a SWAR multiply-accumulate.
+        // See: https://johnnylee-sde.github.io/Fast-numeric-string-to-int/
+        uint64_t chunk;
+        std::memcpy(&chunk, next, sizeof(chunk));
+
+        chunk = (chunk & 0x0F0F0F0F0F0F0F0Full) * 2561 >> 8;            // 2-digit pairs
+        chunk = (chunk & 0x00FF00FF00FF00FFull) * 6553601 >> 16;        // 4-digit groups
+        chunk = (chunk & 0x0000FFFF0000FFFFull) * 42949672960001 >> 32; // the full 8 digits
+
+        significand = significand * 100000000 + static_cast<uint32_t>(chunk);
+        next += 8;
+    }
+#endif
+
+    while (next != last)
+    {
+        significand = 10 * significand + static_cast<uint32_t>(DigitValue(*next));
+        ++next;
+    }
+
+    return significand;
+}
+
 static inline bool IsLowerASCII(char ch)
 {
     return 'a' <= ch && ch <= 'z';
@@ -1314,13 +1399,8 @@ StrtofResult ryu::Strtof(const char* next, const char* last, float& value)
     {
         const char* const p = next;
 
-        significand = DigitValue(*next);
-        ++next;
-        while (next != last && IsDigit(*next))
-        {
-            significand = 10 * significand + DigitValue(*next);
-            ++next;
-        }
+        next = ScanDigits(next + 1, last);
+        significand = ReadDecimalDigits(0, p, next);
 
         num_digits = next - p;
     }
@@ -1343,13 +1423,8 @@ StrtofResult ryu::Strtof(const char* next, const char* last, float& value)
 
             const char* const p = next;
 
-            significand = 10 * significand + DigitValue(*next);
-            ++next;
-            while (next != last && IsDigit(*next))
-            {
-                significand = 10 * significand + DigitValue(*next);
-                ++next;
-            }
+            next = ScanDigits(next + 1, last);
+            significand = ReadDecimalDigits(significand, p, next);
 
             const char* nz = p;
             if (num_digits == 0)
@@ -1464,6 +1539,31 @@ StrtofResult ryu::Strtof(const char* next, const char* last, float& value)
     return {next, status};
 }
 
+ryu::StrtofManyResult ryu::StrtofMany(const char* next, const char* last, char separator, float* values, size_t max_count)
+{
+    size_t count = 0;
+
+    // Strtof is called directly (same TU), so the per-field cost is a single call into the
+    // already-hot parser instead of a round-trip through the exported symbol.
+    while (count < max_count)
+    {
+        float value;
+        const auto res = Strtof(next, last, value);
+        if (res.status == StrtofStatus::invalid)
+            break;
+
+        values[count++] = value;
+        next = res.next;
+
+        if (next == last || *next != separator || count == max_count)
+            break;
+
+        ++next; // skip the separator
+    }
+
+    return {next, count};
+}
+
 //==================================================================================================
 // Round10
 //==================================================================================================
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #define RYU_STRTOD_FALLBACK() 1
 
 namespace ryu {
@@ -75,6 +77,26 @@ struct StrtofResult
 
 StrtofResult Strtof(const char* first, const char* last, float& value);
 
+// StrtofManyResult res = StrtofMany(first, last, separator, values, max_count);
+//
+// Parses up to max_count separator-joined numbers from [first, last) and stores them in values,
+// i.e. the expected input is
+//  number <separator> number <separator> ... number
+//
+// Each number is parsed exactly as by Strtof.
+//
+// Returns the number of values parsed and a pointer to the first character that was not consumed:
+// either last, or the start of the field that failed to parse, or the character following the
+// last parsed value if it is not a separator.
+
+struct StrtofManyResult
+{
+    const char* next;
+    size_t count;
+};
+
+StrtofManyResult StrtofMany(const char* first, const char* last, char separator, float* values, size_t max_count);
+
 // Round10(x, n) returns: round(x * 10^-n) / 10^-n
 //
 // Use this function to round the given value to a specific number of decimal places.
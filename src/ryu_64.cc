@@ -6,17 +6,9 @@
 
 #include "ryu_64.h"
 
-#if defined(__has_include) && __has_include(<version>)
-#include <version>
-#else
-#include <cassert>
-#endif
-
-#if defined(__cpp_lib_to_chars)
-#define HAS_CHARCONV() 1
-#else
-#define HAS_CHARCONV() 0
-#endif
+#include "itoa.h"
+#include "scan_number.h"
+#include "stats.h"
 
 //#undef NDEBUG
 #include <cassert>
@@ -25,11 +17,6 @@
 #include <cstdlib>
 #include <cstring>
 #include <limits>
-#if HAS_CHARCONV()
-#include <charconv>
-#else
-#include <string>
-#endif
 #if _MSC_VER
 #include <intrin.h>
 #endif
@@ -38,6 +25,13 @@
 #define RYU_ASSERT(X) assert(X)
 #endif
 
+// Some targets (e.g. wasm32) offer unsigned __int128 but lower the 64x64->128 multiplies to
+// a libcall; defining DRACHENNEST_NO_INT128=1 (see the cmake option) forces the 32x32->64
+// decomposition instead.
+#ifndef DRACHENNEST_NO_INT128
+#define DRACHENNEST_NO_INT128 0
+#endif
+
 #ifndef RYU_NEVER_INLINE
 #if _MSC_VER
 #define RYU_NEVER_INLINE __declspec(noinline) inline
@@ -48,6 +42,27 @@
 #endif
 #endif
 
+// If enabled, Strtod scans digit runs 16 characters at a time using SSE2 compares instead of one
+// character per iteration. (May be disabled by defining RYU_SIMD_SCAN=0.)
+#ifndef RYU_SIMD_SCAN
+#if defined(__SSE2__) || (defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define RYU_SIMD_SCAN 1
+#else
+#define RYU_SIMD_SCAN 0
+#endif
+#endif
+
+#if RYU_SIMD_SCAN
+#include <emmintrin.h>
+#endif
+
+// If enabled, the 128-bit powers of 5 are computed from a compact table instead of being stored
+// in full (~850 bytes of constant data instead of ~10.4KB, at the cost of one extra 128x64-bit
+// multiply per conversion). See the cmake option RYU_OPTIMIZE_SIZE.
+#ifndef RYU_OPTIMIZE_SIZE
+#define RYU_OPTIMIZE_SIZE 0
+#endif
+
 //==================================================================================================
 //
 //==================================================================================================
@@ -188,6 +203,8 @@ struct uint64x2 {
 };
 }
 
+#if !RYU_OPTIMIZE_SIZE
+
 static inline uint64x2 ComputePow5_Double(int32_t k)
 {
     // Let e = FloorLog2Pow5(k) + 1 - BitsPerPow5_Double
@@ -869,7 +886,165 @@ static inline uint64x2 ComputePow5_Double(int32_t k)
     return Pow5[static_cast<unsigned>(k - MinDecExp)];
 }
 
-#if defined(__SIZEOF_INT128__)
+#else // RYU_OPTIMIZE_SIZE
+
+static inline uint64x2 ComputePow5_Double(int32_t k)
+{
+    // Instead of storing all 666 entries of the table above, store every 26-th entry and derive
+    // the rest by multiplying the preceding stored entry with an exact power 5^d, d in [1, 25]
+    // (5^25 < 2^59 fits into a uint64_t). The top 128 bits of the 128x64-bit product are off by
+    // at most one in either direction from the table entry; the correction is precomputed and
+    // stored with 2 bits per entry (biased by +1).
+    static constexpr int32_t MinDecExp = -340;
+    static constexpr int32_t MaxDecExp =  325;
+    static constexpr int32_t Step      =   26;
+
+    // Let e = FloorLog2Pow5(k) + 1 - BitsPerPow5_Double (as above).
+    // The k = -364 entry only serves as the base for k in [-340, -339].
+    static constexpr uint64x2 Pow5Base[] = {
+        {0xE1AFA13AFBD14D6D, 0x82189C09A3A1EC22}, // e =  -973, k = -364
+        {0x91D8A02BB6C10594, 0x79071B9B8A4BE86A}, // e =  -912, k = -338
+        {0xBC807527ED3E12BC, 0xC605083704F5ECF3}, // e =  -852, k = -312
+        {0xF3A20279ED56D48A, 0x6B43527578C11110}, // e =  -792, k = -286
+        {0x9D71AC8FADA6C9B5, 0x6F773FC3603DB4AA}, // e =  -731, k = -260
+        {0xCB7DDCDDA26DA268, 0xA9942F5DCF7DFD0A}, // e =  -671, k = -234
+        {0x8380DEA93DA4BC60, 0x4247CB9E59F71E6E}, // e =  -610, k = -208
+        {0xA9F6D30A038D1DBC, 0x5E9FCF4CCD211F4D}, // e =  -550, k = -182
+        {0xDBAC6C247D62A583, 0xDF45F746B74ABF3A}, // e =  -490, k = -156
+        {0x8DF5EFABC5979C8F, 0xCA8D3FFA1EF463C2}, // e =  -429, k = -130
+        {0xB77ADA0617E3BBCB, 0x09CE6EBB40173745}, // e =  -369, k = -104
+        {0xED246723473E3813, 0x290123E9AAB23B69}, // e =  -309, k =  -78
+        {0x993FE2C6D07B7FAB, 0xE546A8038EFE402A}, // e =  -248, k =  -52
+        {0xC612062576589DDA, 0x95364AFE032A819E}, // e =  -188, k =  -26
+        {0x8000000000000000, 0x0000000000000000}, // e =  -127, k =    0
+        {0xA56FA5B99019A5C8, 0x0000000000000000}, // e =   -67, k =   26
+        {0xD5D238A4ABE98068, 0x72A4904598D6D880}, // e =    -7, k =   52
+        {0x8A2DBF142DFCC7AB, 0x6E3569326C784337}, // e =    54, k =   78
+        {0xB2977EE300C50FE7, 0x58EDEC91EC2CB657}, // e =   114, k =  104
+        {0xE6D3102AD96CEC1D, 0xA60DC059157491E5}, // e =   174, k =  130
+        {0x952AB45CFA97A0B2, 0xDD945A747BF26183}, // e =   235, k =  156
+        {0xC0CB28A98FCF3C7F, 0x84576A1BB416A7DD}, // e =   295, k =  182
+        {0xF92E0C3537826145, 0xA7709A56CCDF8A82}, // e =   355, k =  208
+        {0xA1075A24E4421730, 0xB24CF65B8612F81F}, // e =   416, k =  234
+        {0xD01FEF10A657842C, 0x2D2B7569B0432D85}, // e =   476, k =  260
+        {0x867F59A9D4BED6C0, 0x49ED8EABCCCC485D}, // e =   537, k =  286
+        {0xADD57A27D29339F6, 0x79C5DB9AF1F9B563}, // e =   597, k =  312
+    };
+
+    // 5^0, 5^1, ..., 5^25
+    static constexpr uint64_t Pow5_64[] = {
+        0x0000000000000001, 0x0000000000000005, // 5^0, 5^1
+        0x0000000000000019, 0x000000000000007D, // 5^2, 5^3
+        0x0000000000000271, 0x0000000000000C35, // 5^4, 5^5
+        0x0000000000003D09, 0x000000000001312D, // 5^6, 5^7
+        0x000000000005F5E1, 0x00000000001DCD65, // 5^8, 5^9
+        0x00000000009502F9, 0x0000000002E90EDD, // 5^10, 5^11
+        0x000000000E8D4A51, 0x0000000048C27395, // 5^12, 5^13
+        0x000000016BCC41E9, 0x000000071AFD498D, // 5^14, 5^15
+        0x0000002386F26FC1, 0x000000B1A2BC2EC5, // 5^16, 5^17
+        0x000003782DACE9D9, 0x00001158E460913D, // 5^18, 5^19
+        0x000056BC75E2D631, 0x0001B1AE4D6E2EF5, // 5^20, 5^21
+        0x000878678326EAC9, 0x002A5A058FC295ED, // 5^22, 5^23
+        0x00D3C21BCECCEDA1, 0x0422CA8B0A00A425, // 5^24, 5^25
+    };
+
+    // (Error of the derived product) + 1, two bits per offset d.
+    static constexpr uint64_t Pow5Adjust[] = {
+        0x0009000000000000, // k = -364
+        0x000A9A55656A6AA8, // k = -338
+        0x0005155965A56564, // k = -312
+        0x0006959969565554, // k = -286
+        0x000A596559555554, // k = -260
+        0x0005A6566AAA5AA8, // k = -234
+        0x0005559665555564, // k = -208
+        0x0005555546195554, // k = -182
+        0x00055A5555569954, // k = -156
+        0x000959A96A6AAA98, // k = -130
+        0x000A9AA9555AAAA4, // k = -104
+        0x000A9AAAAAA6AA98, // k =  -78
+        0x0005555555545154, // k =  -52
+        0x0005956555966954, // k =  -26
+        0x0005555555555554, // k =    0
+        0x0005555555555554, // k =   26
+        0x0005555555555554, // k =   52
+        0x00069565A5556964, // k =   78
+        0x0006AAA5A995A5A8, // k =  104
+        0x000A69A9AA66A5A4, // k =  130
+        0x000A69A9A5A66AA8, // k =  156
+        0x000AEAAAAAB9AAA8, // k =  182
+        0x00059595A5995694, // k =  208
+        0x000AA66AA56AAA68, // k =  234
+        0x0005555555555554, // k =  260
+        0x0006A665AAA56994, // k =  286
+        0x0000000006AAA558, // k =  312
+    };
+
+    RYU_ASSERT(k >= MinDecExp);
+    RYU_ASSERT(k <= MaxDecExp);
+
+    const int32_t b = (k + 14 * Step) / Step - 14; // = FloorDiv(k, Step), since k + 14 * Step >= 0
+    const int32_t d = k - Step * b;
+    RYU_ASSERT(d >= 0);
+    RYU_ASSERT(d <= 25);
+
+    const uint64x2 base = Pow5Base[b + 14];
+    if (d == 0)
+        return base;
+
+    const uint64_t m = Pow5_64[d];
+    const int32_t delta = FloorLog2Pow5(k) - FloorLog2Pow5(Step * b);
+    RYU_ASSERT(delta >= 2);
+    RYU_ASSERT(delta <= 59);
+    const uint32_t adjust = Lo32(Pow5Adjust[b + 14] >> (2 * d)) & 3;
+
+    // The (at most) 187-bit product base * m = p2 2^128 + p1 2^64 + p0, shifted right by delta.
+#if defined(__SIZEOF_INT128__) && !DRACHENNEST_NO_INT128
+    __extension__ using uint128_t = unsigned __int128;
+
+    const uint128_t b0 = uint128_t{base.lo} * m;
+    const uint128_t b2 = uint128_t{base.hi} * m + static_cast<uint64_t>(b0 >> 64);
+    const uint64_t p0 = static_cast<uint64_t>(b0);
+    const uint64_t p1 = static_cast<uint64_t>(b2);
+    const uint64_t p2 = static_cast<uint64_t>(b2 >> 64);
+#else
+    // 64x64 -> 128-bit multiplies using 32x32 -> 64-bit parts (cf. Mul128 below).
+    const uint64_t c00 = uint64_t{Lo32(base.lo)} * Lo32(m);
+    const uint64_t c01 = uint64_t{Lo32(base.lo)} * Hi32(m);
+    const uint64_t c10 = uint64_t{Hi32(base.lo)} * Lo32(m);
+    const uint64_t c11 = uint64_t{Hi32(base.lo)} * Hi32(m);
+    const uint64_t cm1 = c10 + Hi32(c00);
+    const uint64_t cm2 = c01 + Lo32(cm1);
+    const uint64_t p0  = Lo32(c00) | uint64_t{Lo32(cm2)} << 32;
+    const uint64_t b0h = c11 + Hi32(cm1) + Hi32(cm2);
+
+    const uint64_t d00 = uint64_t{Lo32(base.hi)} * Lo32(m);
+    const uint64_t d01 = uint64_t{Lo32(base.hi)} * Hi32(m);
+    const uint64_t d10 = uint64_t{Hi32(base.hi)} * Lo32(m);
+    const uint64_t d11 = uint64_t{Hi32(base.hi)} * Hi32(m);
+    const uint64_t dm1 = d10 + Hi32(d00);
+    const uint64_t dm2 = d01 + Lo32(dm1);
+    const uint64_t b2l = Lo32(d00) | uint64_t{Lo32(dm2)} << 32;
+    const uint64_t b2h = d11 + Hi32(dm1) + Hi32(dm2);
+
+    const uint64_t p1 = b2l + b0h;
+    const uint64_t p2 = b2h + (p1 < b2l ? 1 : 0);
+#endif
+
+    uint64x2 result;
+    result.lo = (p0 >> delta) | (p1 << (64 - delta));
+    result.hi = (p1 >> delta) | (p2 << (64 - delta));
+
+    // result += adjust - 1
+    const uint64_t lo1 = result.lo + adjust;
+    const uint64_t hi1 = result.hi + (lo1 < adjust ? 1 : 0);
+    result.lo = lo1 - 1;
+    result.hi = hi1 - (lo1 == 0 ? 1 : 0);
+    return result;
+}
+
+#endif // RYU_OPTIMIZE_SIZE
+
+#if defined(__SIZEOF_INT128__) && !DRACHENNEST_NO_INT128
 
 static inline uint64_t MulShift(uint64_t m, const uint64x2* mul, int32_t j)
 {
@@ -1054,15 +1229,8 @@ static inline bool MultipleOfPow2(uint64_t value, int32_t e2)
     return (value & ((uint64_t{1} << e2) - 1)) == 0;
 }
 
-namespace {
-struct FloatingDecimal64 {
-    uint64_t digits; // num_digits <= 17
-    int32_t exponent;
-};
-}
+using ryu::FloatingDecimal64;
 
-// TODO:
-// Export?!
 static inline FloatingDecimal64 ToDecimal64(uint64_t ieee_significand, uint64_t ieee_exponent)
 {
     //
@@ -1321,28 +1489,31 @@ static inline FloatingDecimal64 ToDecimal64(uint64_t ieee_significand, uint64_t
     return {b, e10};
 }
 
+FloatingDecimal64 ryu::ToDecimal64(double value)
+{
+    const Double v(value);
+    RYU_ASSERT(v.IsFinite());
+    RYU_ASSERT(!v.IsZero());
+
+    return ::ToDecimal64(v.PhysicalSignificand(), v.PhysicalExponent());
+}
+
+FloatingDecimal64 ryu::ToDecimal64(uint64_t ieee_significand, uint64_t ieee_exponent)
+{
+    RYU_ASSERT(ieee_exponent != static_cast<uint64_t>(Double::MaxIeeeExponent));
+    RYU_ASSERT(ieee_exponent != 0 || ieee_significand != 0);
+
+    return ::ToDecimal64(ieee_significand, ieee_exponent);
+}
+
 //==================================================================================================
 // ToChars
 //==================================================================================================
 
-static inline void Utoa_2Digits(char* buf, uint32_t digits)
-{
-    static constexpr char Digits100[200] = {
-        '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
-        '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
-        '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
-        '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
-        '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
-        '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
-        '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
-        '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
-        '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
-        '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
-    };
-
-    RYU_ASSERT(digits <= 99);
-    std::memcpy(buf, &Digits100[2 * digits], 2);
-}
+// The digit pairs table and the low-level digit printers are shared by all engines, see
+// itoa.h.
+using drachennest::itoa::Utoa_2Digits;
+using drachennest::itoa::TrailingZeros_2Digits;
 
 static inline void Utoa_4Digits(char* buf, uint32_t digits)
 {
@@ -1472,9 +1643,9 @@ static inline char* FormatDigits(char* buffer, uint64_t digits, int32_t decimal_
         {
             // digits[000]
             decimal_digits_position = 0;
-            static_assert(MaxFixedDecimalPoint <= 32, "internal error");
-            std::memset(buffer +  0, '0', 16);
-            std::memset(buffer + 16, '0', 16);
+            static_assert(MaxFixedDecimalPoint <= 17, "internal error");
+            std::memset(buffer + 0, '0', 16);
+            std::memset(buffer + 1, '0', 16);
         }
     }
     else
@@ -1496,16 +1667,34 @@ static inline char* FormatDigits(char* buffer, uint64_t digits, int32_t decimal_
         else if (decimal_point < num_digits)
         {
             // dig.its
+            // The move size is fixed (16 or 8 characters), so the calls below inline; the
+            // split on the decimal point keeps the writes within DtoaMaxLength characters
+            // (at most 8 digits follow the decimal point once it exceeds 8).
 #if defined(_MSC_VER) && !defined(__clang__)
-            // VC does not inline the memmove call below. (Even if compiled with /arch:AVX2.)
+            // VC does not inline the memmove calls below. (Even if compiled with /arch:AVX2.)
             // However, memcpy will be inlined.
             uint8_t tmp[16];
             char* const src = buffer + decimal_point;
             char* const dst = src + 1;
-            std::memcpy(tmp, src, 16);
-            std::memcpy(dst, tmp, 16);
+            if (decimal_point <= 8)
+            {
+                std::memcpy(tmp, src, 16);
+                std::memcpy(dst, tmp, 16);
+            }
+            else
+            {
+                std::memcpy(tmp, src, 8);
+                std::memcpy(dst, tmp, 8);
+            }
 #else
-            std::memmove(buffer + decimal_point + 1, buffer + decimal_point, 16);
+            if (decimal_point <= 8)
+            {
+                std::memmove(buffer + decimal_point + 1, buffer + decimal_point, 16);
+            }
+            else
+            {
+                std::memmove(buffer + decimal_point + 1, buffer + decimal_point, 8);
+            }
 #endif
             buffer[decimal_point] = '.';
             buffer = digits_end + 1;
@@ -1619,6 +1808,29 @@ char* ryu::Dtoa(char* buffer, double value)
     return ToChars(buffer, value);
 }
 
+char* ryu::DtoaJson(char* buffer, double value, const char* nonfinite, bool keep_minus_zero)
+{
+    const Double v(value);
+
+    if (v.PhysicalExponent() != Double::MaxIeeeExponent) // [[likely]]
+    {
+        // Finite; the finite output of Dtoa already fits the RFC 8259 number grammar.
+        if (!keep_minus_zero && value == 0)
+        {
+            buffer[0] = '0';
+            return buffer + 1;
+        }
+        return ToChars(buffer, value);
+    }
+
+    // JSON has no representation for infinities and NaNs: write the caller's replacement
+    // token instead.
+    const size_t len = std::strlen(nonfinite);
+    RYU_ASSERT(len <= static_cast<size_t>(DtoaMaxLength));
+    std::memcpy(buffer, nonfinite, len);
+    return buffer + len;
+}
+
 //==================================================================================================
 // ToBinary64
 //==================================================================================================
@@ -1675,7 +1887,17 @@ static inline int32_t ExtractBit(uint64_t x, int32_t n)
     return (x & (uint64_t{1} << n)) != 0;
 }
 
-static inline double ToBinary64(uint64_t m10, int32_t m10_digits, int32_t e10)
+// Rounding mode for the decimal -> binary conversion, applied to the magnitude: the sign is
+// stripped before and re-applied after the conversion, so the directed modes of StrtodRounded
+// (toward -/+ infinity) map onto rounding the magnitude down or up depending on the sign.
+enum class MagRounding {
+    nearest_even,
+    down, // toward zero
+    up,   // away from zero
+};
+
+template <MagRounding Rounding>
+static inline double ToBinary64Rounded(uint64_t m10, int32_t m10_digits, int32_t e10)
 {
     static constexpr int32_t MantissaBits = Double::SignificandSize - 1;
     static constexpr int32_t ExponentBias = Double::ExponentBias - (Double::SignificandSize - 1);
@@ -1756,15 +1978,20 @@ static inline double ToBinary64(uint64_t m10, int32_t m10_digits, int32_t e10)
     // NB:
     // num_digits is unused...
 
-    if (m10 <= (uint64_t{1} << 53) && -22 <= e10 && e10 <= 22)
+    // The multiply/divide below is correctly rounded under round-to-nearest-even only, so the
+    // directed modes skip this shortcut (the division may be inexact).
+    if constexpr (Rounding == MagRounding::nearest_even)
     {
-        double flt = static_cast<double>(static_cast<int64_t>(m10));
-        if (e10 < 0)
-            flt /= ExactPowersOfTen[static_cast<uint32_t>(-e10)];
-        else
-            flt *= ExactPowersOfTen[static_cast<uint32_t>( e10)];
+        if (m10 <= (uint64_t{1} << 53) && -22 <= e10 && e10 <= 22)
+        {
+            double flt = static_cast<double>(static_cast<int64_t>(m10));
+            if (e10 < 0)
+                flt /= ExactPowersOfTen[static_cast<uint32_t>(-e10)];
+            else
+                flt *= ExactPowersOfTen[static_cast<uint32_t>( e10)];
 
-        return flt;
+            return flt;
+        }
     }
 #endif
 #endif
@@ -1872,7 +2099,11 @@ static inline double ToBinary64(uint64_t m10, int32_t m10_digits, int32_t e10)
     {
         // Overflow:
         // Final IEEE exponent is larger than the maximum representable.
-        return std::numeric_limits<double>::infinity();
+        // Rounding the magnitude down never overflows: the result is the largest finite double.
+        if constexpr (Rounding == MagRounding::down)
+            return std::numeric_limits<double>::max();
+        else
+            return std::numeric_limits<double>::infinity();
     }
 
     // We need to figure out how much we need to shift m2.
@@ -1882,15 +2113,29 @@ static inline double ToBinary64(uint64_t m10, int32_t m10_digits, int32_t e10)
     RYU_ASSERT(shift > 0);
     RYU_ASSERT(shift < 64);
 
-    // We need to round up if the exact value is more than 0.5 above the value we computed. That's
-    // equivalent to checking if the last removed bit was 1 and either the value was not just
-    // trailing zeros or the result would otherwise be odd.
-    const auto trailing_zeros
-        = is_exact && MultipleOfPow2(m2, shift - 1);
-    const auto last_removed_bit
-        = ExtractBit(m2, shift - 1);
-    const auto round_up
-        = last_removed_bit != 0 && (!trailing_zeros || ExtractBit(m2, shift) != 0);
+    bool round_up;
+    if constexpr (Rounding == MagRounding::nearest_even)
+    {
+        // We need to round up if the exact value is more than 0.5 above the value we computed.
+        // That's equivalent to checking if the last removed bit was 1 and either the value was
+        // not just trailing zeros or the result would otherwise be odd.
+        const auto trailing_zeros
+            = is_exact && MultipleOfPow2(m2, shift - 1);
+        const auto last_removed_bit
+            = ExtractBit(m2, shift - 1);
+        round_up
+            = last_removed_bit != 0 && (!trailing_zeros || ExtractBit(m2, shift) != 0);
+    }
+    else if constexpr (Rounding == MagRounding::down)
+    {
+        round_up = false;
+    }
+    else
+    {
+        // Round up unless the truncated significand is exact, i.e. unless the conversion to
+        // m2 * 2^e2 was exact and the shift removes only zero bits.
+        round_up = !(is_exact && MultipleOfPow2(m2, shift));
+    }
 
     uint64_t significand = (m2 >> shift) + round_up;
     RYU_ASSERT(significand <= 2 * Double::HiddenBit); // significand <= 2^p = 2^53
@@ -1911,6 +2156,11 @@ static inline double ToBinary64(uint64_t m10, int32_t m10_digits, int32_t e10)
     return ReinterpretBits<double>(ieee);
 }
 
+static inline double ToBinary64(uint64_t m10, int32_t m10_digits, int32_t e10)
+{
+    return ToBinary64Rounded<MagRounding::nearest_even>(m10, m10_digits, e10);
+}
+
 //==================================================================================================
 // Strtod
 //==================================================================================================
@@ -1929,6 +2179,85 @@ static inline int32_t DigitValue(char ch)
     return ch - '0';
 }
 
+// Exponents larger than this limit will be treated as +Infinity.
+// But we must still scan all the digits if this happens to be the case.
+static constexpr int32_t MaxExp = 999999;
+static_assert(MaxExp >= 999, "invalid parameter");
+static_assert(MaxExp <= (INT_MAX - 9) / 10, "invalid parameter");
+
+// Returns a pointer to the first character in [next, last) which is not a decimal digit.
+#if RYU_SIMD_SCAN
+static inline const char* ScanDigits(const char* next, const char* last)
+{
+    while (last - next >= 16)
+    {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(next));
+        const __m128i t = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+        const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(9)), t);
+
+        const uint32_t non_digits = static_cast<uint32_t>(_mm_movemask_epi8(is_digit)) ^ 0xFFFF;
+        if (non_digits != 0)
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward(&index, non_digits);
+            return next + index;
+#else
+            return next + __builtin_ctz(non_digits);
+#endif
+        }
+
+        next += 16;
+    }
+
+    while (next != last && IsDigit(*next))
+        ++next;
+
+    return next;
+}
+#else
+static inline const char* ScanDigits(const char* next, const char* last)
+{
+    while (next != last && IsDigit(*next))
+        ++next;
+
+    return next;
+}
+#endif
+
+// Returns significand * 10^(last - next) + value(next, last) (mod 2^64),
+// i.e. appends the decimal digits [next, last) to the given significand.
+//
+// As in the scalar digit loop, the result is allowed to wrap: it is only used if the total
+// number of significant digits is small enough, and all the operations here are exact mod 2^64.
+static inline uint64_t ReadDecimalDigits(uint64_t significand, const char* next, const char* last)
+{
+#if defined(_MSC_VER) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    while (last - next >= 8)
+    {
+        // Convert 8 digits at a time using a SWAR multiply-accumulate.
+        // See: https://johnnylee-sde.github.io/Fast-numeric-string-to-int/
+        uint64_t chunk;
+        std::memcpy(&chunk, next, sizeof(chunk));
+
+        chunk = (chunk & 0x0F0F0F0F0F0F0F0Full) * 2561 >> 8;            // 2-digit pairs
+        chunk = (chunk & 0x00FF00FF00FF00FFull) * 6553601 >> 16;        // 4-digit groups
+        chunk = (chunk & 0x0000FFFF0000FFFFull) * 42949672960001 >> 32; // the full 8 digits
+
+        significand = significand * 100000000 + chunk;
+        next += 8;
+    }
+#endif
+
+    while (next != last)
+    {
+        significand = 10 * significand + static_cast<uint32_t>(DigitValue(*next));
+        ++next;
+    }
+
+    return significand;
+}
+
 static inline bool IsLowerASCII(char ch)
 {
     return 'a' <= ch && ch <= 'z';
@@ -2026,121 +2355,718 @@ static RYU_NEVER_INLINE StrtodResult ParseSpecial(bool is_negative, const char*
     return {next, StrtodStatus::invalid};
 }
 
-#if RYU_STRTOD_FALLBACK()
-static RYU_NEVER_INLINE double ToBinary64Slow(const char* next, const char* last)
-{
-#if HAS_CHARCONV()
-    double flt = 0;
-    std::from_chars(next, last, flt);
-    return flt;
-#else
-    //
-    // FIXME:
-    // _strtod_l( ..., C_LOCALE )
-    //
-
-    // std::strtod expects null-terminated inputs. So we need to make a copy and null-terminate the input.
-    // This function is actually almost never going to be called, so that should be ok.
-    const std::string inp(next, last);
-    const char* const ptr = inp.c_str();
-
-    char* end;
-    const auto flt = ::strtod(ptr, &end);
-
-    // std::strtod should have consumed all of the input.
-    RYU_ASSERT(ptr != end);
-    RYU_ASSERT(last - next == end - ptr);
+//--------------------------------------------------------------------------------------------------
+// ParseHex
+//
+// The hexadecimal floating-point format of strtod (printf's %a): the token's value is
+// hex-significand * 2^exponent, so the conversion is pure bit manipulation -- none of the
+// decimal machinery below is involved.
+//--------------------------------------------------------------------------------------------------
 
-    return flt;
-#endif
+static inline bool IsHexDigit(char ch)
+{
+    return IsDigit(ch) || static_cast<unsigned>((ch | 0x20) - 'a') <= 5u;
 }
-#endif
 
-StrtodResult ryu::Strtod(const char* next, const char* last, double& value)
+static inline int32_t HexDigitValue(char ch)
 {
-    if (next == last)
-        return {next, StrtodStatus::invalid};
-
-    // Decompose the input into the form significand * 10^exponent,
-    // where significand has num_digits decimal digits.
-
-    uint64_t significand = 0; // only valid iff num_digits <= 19
-    int64_t  num_digits  = 0; // 64-bit to avoid overflow...
-    int64_t  exponent    = 0; // 64-bit to avoid overflow...
-    StrtodStatus status = StrtodStatus::integer;
+    RYU_ASSERT(IsHexDigit(ch));
+    return IsDigit(ch) ? (ch - '0') : ((ch | 0x20) - 'a' + 10);
+}
 
-// [-]
+// Returns the number of leading 0-bits in x, starting at the most significant
+// bit position.
+// If x is 0, the result is undefined.
+static inline int32_t CountLeadingZeros64(uint64_t x)
+{
+    RYU_ASSERT(x != 0);
 
-    const bool is_negative = (*next == '-');
-    if (is_negative || *next == '+')
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+    return static_cast<int32_t>(_CountLeadingZeros64(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int32_t>(__lzcnt64(x));
+#else
+    int32_t lz = 0;
+    while ((x >> 63) == 0)
     {
-        ++next;
-        if (next == last)
-            return {next, StrtodStatus::invalid};
+        x <<= 1;
+        ++lz;
     }
-
-// int32_t
-
-#if RYU_STRTOD_FALLBACK()
-    const char* const start = next;
+    return lz;
 #endif
+}
 
-    const bool has_leading_zero = (*next == '0');
-    const bool has_leading_dot  = (*next == '.');
+// Called with next pointing at the "0x" prefix; the caller has checked that a significand
+// digit follows the prefix (possibly after a '.').
+template <MagRounding Rounding>
+static RYU_NEVER_INLINE StrtodResult ParseHex(bool is_negative, const char* next, const char* last, double& value)
+{
+    RYU_ASSERT(last - next >= 3);
+    next += 2; // skip "0x"
 
-    if (has_leading_zero)
+    // Accumulate the leading 60 significand bits; further digits only adjust the exponent
+    // and the sticky bit. (53 bits plus guard and sticky would do; 15 hex digits fit.)
+    uint64_t significand = 0;
+    int64_t  exponent    = 0; // base 2
+    bool     sticky      = false;
+
+    for (; next != last && IsHexDigit(*next); ++next)
     {
-        for (;;)
+        if (significand >> 60 == 0)
         {
-            ++next;
-            if (next == last || *next != '0')
-                break;
+            significand = (significand << 4) | static_cast<uint32_t>(HexDigitValue(*next));
+        }
+        else
+        {
+            sticky = sticky || *next != '0';
+            exponent += 4;
         }
     }
 
-    if (next != last && IsDigit(*next)) // non-0
+    if (next != last && *next == '.')
     {
-        const char* const p = next;
-
-        significand = DigitValue(*next);
         ++next;
-        while (next != last && IsDigit(*next))
+        for (; next != last && IsHexDigit(*next); ++next)
         {
-            significand = 10 * significand + DigitValue(*next);
-            ++next;
+            if (significand >> 60 == 0)
+            {
+                significand = (significand << 4) | static_cast<uint32_t>(HexDigitValue(*next));
+                exponent -= 4;
+            }
+            else
+            {
+                sticky = sticky || *next != '0';
+            }
         }
-
-        num_digits = next - p;
-    }
-    else if (!has_leading_zero && !has_leading_dot)
-    {
-        return ParseSpecial(is_negative, next, last, value);
     }
 
-// frac
-
-    if (has_leading_dot || (next != last && *next == '.'))
+    // The optional binary exponent ("p+ddd"). Like the decimal exponent of StrtodImpl, the
+    // prefix is only consumed if at least one digit follows ("0x1p" parses as 1).
+    if (next != last && (*next == 'p' || *next == 'P'))
     {
-        status = StrtodStatus::fixed;
-
-        ++next; // skip '.'
-        if (next != last && IsDigit(*next))
+        const char* p = next + 1;
+        if (p != last)
         {
-            // TODO:
-            // Ignore trailing zeros...
-
-            const char* const p = next;
+            const bool parsed_exponent_is_negative = (*p == '-');
+            if (parsed_exponent_is_negative || *p == '+')
+                ++p;
 
-            significand = 10 * significand + DigitValue(*next);
-            ++next;
-            while (next != last && IsDigit(*next))
+            if (p != last && IsDigit(*p))
             {
-                significand = 10 * significand + DigitValue(*next);
-                ++next;
-            }
+                int32_t parsed_exponent = 0;
+                for (; p != last && IsDigit(*p); ++p)
+                {
+                    if (parsed_exponent <= MaxExp)
+                        parsed_exponent = 10 * parsed_exponent + DigitValue(*p);
+                }
 
-            const char* nz = p;
-            if (num_digits == 0)
+                exponent += parsed_exponent_is_negative ? -int64_t{parsed_exponent} : int64_t{parsed_exponent};
+                next = p;
+            }
+        }
+    }
+
+    double flt;
+    if (significand == 0)
+    {
+        flt = 0;
+    }
+    else
+    {
+        // Normalize the leading bit to position 63: |value| = significand * 2^(exponent - lz),
+        // i.e. |value| = 1.f * 2^e2 with the leading-bit exponent e2 below.
+        const int32_t lz = CountLeadingZeros64(significand);
+        significand <<= lz;
+        const int64_t e2 = exponent - lz + 63;
+
+        if (e2 > 1023)
+        {
+            if constexpr (Rounding == MagRounding::down)
+                flt = std::numeric_limits<double>::max();
+            else
+                flt = std::numeric_limits<double>::infinity();
+        }
+        else
+        {
+            // Round the 64 normalized bits (plus the sticky bit of the dropped digits) to
+            // the 53-bit significand; subnormals drop further bits.
+            int64_t drop = 11;
+            if (e2 < -1022)
+                drop += -1022 - e2;
+
+            uint64_t mantissa;
+            bool guard;
+            if (drop >= 65)
+            {
+                mantissa = 0;
+                guard = false;
+                sticky = true; // significand != 0
+            }
+            else if (drop == 64)
+            {
+                mantissa = 0;
+                guard = (significand >> 63) != 0;
+                sticky = sticky || (significand << 1) != 0;
+            }
+            else
+            {
+                const int32_t shift = static_cast<int32_t>(drop);
+                mantissa = significand >> shift;
+                guard = ((significand >> (shift - 1)) & 1) != 0;
+                sticky = sticky || (significand << (64 - (shift - 1))) != 0;
+            }
+
+            bool round_up;
+            if constexpr (Rounding == MagRounding::nearest_even)
+                round_up = guard && (sticky || (mantissa & 1) != 0);
+            else if constexpr (Rounding == MagRounding::up)
+                round_up = guard || sticky;
+            else
+                round_up = false;
+
+            mantissa += round_up ? 1u : 0u;
+
+            // For normals the carry out of a rounded-up all-ones mantissa bumps the
+            // exponent field (possibly into the infinity encoding); for subnormals it
+            // yields the smallest normal. Both fall out of the addition.
+            uint64_t bits;
+            if (e2 < -1022)
+                bits = mantissa;
+            else
+                bits = (static_cast<uint64_t>(e2 + 1023) << 52) + (mantissa - (uint64_t{1} << 52));
+            flt = ReinterpretBits<double>(bits);
+        }
+    }
+
+    value = is_negative ? -flt : flt;
+    return {next, StrtodStatus::hex};
+}
+
+#if RYU_STRTOD_FALLBACK()
+
+//--------------------------------------------------------------------------------------------------
+// ToBinary64Slow
+//
+// Converts inputs with more than ToBinaryMaxDecimalDigits significant digits.
+//
+// The first 17 significant digits are converted with ToBinary64, which yields either the correct
+// result or the double immediately below it. The decision between the two is then made by
+// comparing the exact decimal input with the halfway point between them, using fixed-size
+// big-integer arithmetic (cf. dragon4.cc's DiyInt). This keeps the slow path allocation-free and
+// independent of the C library.
+//--------------------------------------------------------------------------------------------------
+
+static inline int Min(int x, int y) { return y < x ? y : x; }
+
+namespace {
+struct DiyInt
+{
+    // The decimal significand is limited to SlowMaxSignificantDigits = 780 digits (< 2^2592).
+    // Scaling the comparison below by (at most) 2^1075 or 10^1104 requires 3696 bits; round up
+    // and leave some room for carries.
+    static constexpr int MaxBits = 3800;
+    static constexpr int Capacity = (MaxBits + (32 - 1)) / 32;
+
+    uint32_t bigits[Capacity]; // Significand stored in little-endian form.
+    int      size = 0;
+
+    DiyInt() = default;
+    DiyInt(const DiyInt&) = delete;             // (not needed here)
+    DiyInt& operator=(const DiyInt&) = delete;  // (not needed here)
+};
+}
+
+static inline void AssignU32(DiyInt& x, uint32_t value)
+{
+    x.bigits[0] = value;
+    x.size = (value != 0) ? 1 : 0;
+}
+
+static inline void AssignU64(DiyInt& x, uint64_t value)
+{
+    x.bigits[0] = static_cast<uint32_t>(value);
+    x.bigits[1] = static_cast<uint32_t>(value >> 32);
+    x.size = (x.bigits[1] != 0) ? 2 : ((x.bigits[0] != 0) ? 1 : 0);
+}
+
+// x := A * x + B
+static inline void MulAddU32(DiyInt& x, uint32_t A, uint32_t B = 0)
+{
+    RYU_ASSERT(x.size >= 0);
+
+    if (A == 1 && B == 0)
+    {
+        return;
+    }
+    if (A == 0 || x.size <= 0)
+    {
+        AssignU32(x, B);
+        return;
+    }
+
+    uint32_t carry = B;
+    for (int i = 0; i < x.size; ++i)
+    {
+        const uint64_t p = uint64_t{x.bigits[i]} * A + carry;
+        x.bigits[i]      = static_cast<uint32_t>(p);
+        carry            = static_cast<uint32_t>(p >> 32);
+    }
+
+    if (carry != 0)
+    {
+        RYU_ASSERT(x.size < DiyInt::Capacity);
+        x.bigits[x.size++] = carry;
+    }
+}
+
+// x := x * 2^e2 (aka left-shift)
+static inline void MulPow2(DiyInt& x, int e2)
+{
+    RYU_ASSERT(x.size >= 0);
+    RYU_ASSERT(e2 >= 0);
+
+    if (x.size <= 0 || e2 == 0)
+        return;
+
+    const int bigit_shift = static_cast<int>(static_cast<unsigned>(e2) / 32);
+    const int bit_shift   = static_cast<int>(static_cast<unsigned>(e2) % 32);
+
+    if (bit_shift > 0)
+    {
+        uint32_t carry = 0;
+        for (int i = 0; i < x.size; ++i)
+        {
+            const uint32_t h = x.bigits[i] >> (32 - bit_shift);
+            x.bigits[i]      = x.bigits[i] << bit_shift | carry;
+            carry            = h;
+        }
+
+        if (carry != 0)
+        {
+            RYU_ASSERT(x.size < DiyInt::Capacity);
+            x.bigits[x.size++] = carry;
+        }
+    }
+
+    if (bigit_shift > 0)
+    {
+        RYU_ASSERT(bigit_shift <= DiyInt::Capacity);
+        RYU_ASSERT(x.size <= DiyInt::Capacity - bigit_shift);
+
+        std::memmove(x.bigits + bigit_shift, x.bigits, static_cast<unsigned>(x.size) * sizeof(uint32_t));
+        std::memset(x.bigits, 0, static_cast<unsigned>(bigit_shift) * sizeof(uint32_t));
+        x.size += bigit_shift;
+    }
+}
+
+// x := x * 5^e5
+static inline void MulPow5(DiyInt& x, int e5)
+{
+    static constexpr uint32_t kPow5_32[] = {
+        1, // (unused)
+        5,
+        25,
+        125,
+        625,
+        3125,
+        15625,
+        78125,
+        390625,
+        1953125,
+        9765625,
+        48828125,
+        244140625,
+        1220703125, // 5^13
+    };
+
+    RYU_ASSERT(x.size >= 0);
+    RYU_ASSERT(e5 >= 0);
+
+    if (x.size <= 0)
+        return;
+
+    while (e5 > 0)
+    {
+        const int n = Min(e5, 13);
+        MulAddU32(x, kPow5_32[n]);
+        e5 -= n;
+    }
+}
+
+// x := x * 10^e10
+static inline void MulPow10(DiyInt& x, int e10)
+{
+    MulPow2(x, e10);
+    MulPow5(x, e10);
+}
+
+// x := digits
+static inline void AssignDecimalDigits(DiyInt& x, const char* digits, int num_digits)
+{
+    static constexpr uint32_t kPow10_32[] = {
+        1,
+        10,
+        100,
+        1000,
+        10000,
+        100000,
+        1000000,
+        10000000,
+        100000000,
+        1000000000, // 10^9
+    };
+
+    x.size = 0;
+    while (num_digits > 0)
+    {
+        const int n = Min(num_digits, 9);
+
+        uint32_t chunk = 0;
+        for (int i = 0; i < n; ++i)
+            chunk = 10 * chunk + static_cast<uint32_t>(DigitValue(*digits++));
+
+        MulAddU32(x, kPow10_32[n], chunk);
+        num_digits -= n;
+    }
+}
+
+static inline int Compare(const DiyInt& x, const DiyInt& y)
+{
+    if (x.size != y.size)
+        return x.size < y.size ? -1 : +1;
+
+    for (int i = x.size - 1; i >= 0; --i)
+    {
+        if (x.bigits[i] != y.bigits[i])
+            return x.bigits[i] < y.bigits[i] ? -1 : +1;
+    }
+
+    return 0;
+}
+
+// The smallest denormal double has 767 significant decimal digits. Digits beyond
+// SlowMaxSignificantDigits can therefore only influence the comparison with a halfway point
+// through their being non-zero, which is recorded in a single sentinel digit.
+static constexpr int32_t SlowMaxSignificantDigits = 780;
+
+template <MagRounding Rounding>
+static RYU_NEVER_INLINE double ToBinary64Slow(const char* next, const char* last)
+{
+    static constexpr int32_t ExponentBias = Double::ExponentBias;
+
+    // Re-scan the (unsigned) input "digits[.digits][e[+-]digits]", collecting the significant
+    // digits. Strtod has already validated the input and checked that the result is neither
+    // (+/-)0 nor too large for a double.
+
+    char digits[SlowMaxSignificantDigits];
+    int32_t num_digits = 0;
+    int64_t exponent = 0; // Decimal exponent of the collected digits (64-bit to avoid overflow).
+    bool truncated_nonzero = false;
+
+// int
+
+    while (next != last && *next == '0')
+        ++next;
+    while (next != last && IsDigit(*next))
+    {
+        if (num_digits < SlowMaxSignificantDigits - 1)
+        {
+            digits[num_digits++] = *next;
+        }
+        else
+        {
+            ++exponent;
+            truncated_nonzero |= (*next != '0');
+        }
+        ++next;
+    }
+
+// frac
+
+    if (next != last && *next == '.')
+    {
+        ++next; // skip '.'
+        if (num_digits == 0)
+        {
+            while (next != last && *next == '0')
+            {
+                --exponent;
+                ++next;
+            }
+        }
+        while (next != last && IsDigit(*next))
+        {
+            if (num_digits < SlowMaxSignificantDigits - 1)
+            {
+                digits[num_digits++] = *next;
+                --exponent;
+            }
+            else
+            {
+                truncated_nonzero |= (*next != '0');
+            }
+            ++next;
+        }
+    }
+
+// exp
+
+    if (next != last && (*next == 'e' || *next == 'E'))
+    {
+        ++next; // skip 'e'
+        RYU_ASSERT(next != last);
+
+        const bool parsed_exponent_is_negative = (*next == '-');
+        if (parsed_exponent_is_negative || *next == '+')
+            ++next;
+
+        int64_t parsed_exponent = 0;
+        while (next != last && IsDigit(*next))
+        {
+            if (parsed_exponent <= INT32_MAX)
+                parsed_exponent = 10 * parsed_exponent + DigitValue(*next);
+            ++next;
+        }
+
+        exponent += parsed_exponent_is_negative ? -parsed_exponent : parsed_exponent;
+    }
+
+    RYU_ASSERT(num_digits > 0);
+
+    // Remove trailing zeros...
+    while (num_digits > 0 && digits[num_digits - 1] == '0')
+    {
+        --num_digits;
+        ++exponent;
+    }
+
+    if (truncated_nonzero)
+    {
+        // All the removed digits can only influence the result through their being non-zero.
+        digits[num_digits++] = '1';
+        --exponent;
+    }
+
+    // Convert the first (at most) 17 significant digits.
+
+    const int32_t prefix_digits = Min(num_digits, ToBinaryMaxDecimalDigits);
+
+    uint64_t prefix = 0;
+    for (int32_t i = 0; i < prefix_digits; ++i)
+        prefix = 10 * prefix + static_cast<uint32_t>(DigitValue(digits[i]));
+
+    const int64_t prefix_exponent = exponent + (num_digits - prefix_digits);
+
+    const double guess = ToBinary64Rounded<Rounding>(prefix, prefix_digits, static_cast<int32_t>(prefix_exponent));
+    if (num_digits <= ToBinaryMaxDecimalDigits)
+    {
+        // (The input only had trailing zeros beyond the 17th significant digit.)
+        return guess;
+    }
+
+    const Double v(guess);
+    if (v.bits == Double::ExponentMask) // +Infinity
+        return guess;
+    if constexpr (Rounding == MagRounding::down)
+    {
+        // Rounding the magnitude down never overflows; with guess at the largest finite double
+        // there is no successor to decide against.
+        if (guess == std::numeric_limits<double>::max())
+            return guess;
+    }
+
+    // The exact value lies in [prefix, prefix + 10^prefix_exponent) and prefix rounds to guess,
+    // so the correctly rounded result is either guess or its successor. Decide by comparing the
+    // input with the mode's decision boundary, expressed in units of 2^(e - 1), where
+    // guess = f * 2^e: the halfway point (2f + 1) for round-to-nearest, the successor (2f + 2)
+    // for rounding down, and guess itself (2f) for rounding up.
+
+    uint64_t f;
+    int32_t e;
+    if (v.PhysicalExponent() != 0)
+    {
+        f = Double::HiddenBit | v.PhysicalSignificand();
+        e = static_cast<int32_t>(v.PhysicalExponent()) - ExponentBias;
+    }
+    else
+    {
+        f = v.PhysicalSignificand();
+        e = 1 - ExponentBias;
+    }
+
+    uint64_t boundary;
+    if constexpr (Rounding == MagRounding::nearest_even)
+        boundary = 2 * f + 1;
+    else if constexpr (Rounding == MagRounding::down)
+        boundary = 2 * f + 2;
+    else
+        boundary = 2 * f;
+
+    DiyInt lhs; // exact input
+    DiyInt rhs; // decision boundary
+
+    AssignDecimalDigits(lhs, digits, num_digits);
+    AssignU64(rhs, boundary);
+
+    RYU_ASSERT(exponent >= -1105);
+    RYU_ASSERT(exponent <= 309);
+    if (exponent >= 0)
+        MulPow10(lhs, static_cast<int>(exponent));
+    else
+        MulPow10(rhs, static_cast<int>(-exponent));
+
+    if (e - 1 >= 0)
+        MulPow2(rhs, e - 1);
+    else
+        MulPow2(lhs, -(e - 1));
+
+    const int cmp = Compare(lhs, rhs);
+
+    bool bump_to_successor;
+    if constexpr (Rounding == MagRounding::nearest_even)
+        bump_to_successor = cmp > 0 || (cmp == 0 && (f & 1) != 0); // above the halfway point (or ties-to-even)
+    else if constexpr (Rounding == MagRounding::down)
+        bump_to_successor = cmp >= 0; // at or above the successor
+    else
+        bump_to_successor = cmp > 0;  // strictly above guess
+
+    if (bump_to_successor)
+    {
+        // Round up to the next larger double.
+        // Due to how the IEEE representation is ordered, this also correctly handles the
+        // transitions denormal -> normal and max-finite -> +Infinity.
+        return ReinterpretBits<double>(v.bits + 1);
+    }
+
+    return guess;
+}
+#endif
+
+// The common core of Strtod and StrtodJson.
+//
+// With JsonFormat == true, exactly the RFC 8259 number grammar is accepted: no leading '+', no
+// leading or trailing '.', no redundant leading zeros, no "inf"/"nan" forms, and an exponent
+// prefix must be followed by at least one digit. On failure, the returned 'next' points at the
+// offending character.
+//
+// Rounding selects the magnitude rounding mode of the decimal -> binary conversion; the caller
+// (StrtodRounded) has already mapped the directed modes onto down/up using the sign.
+template <bool JsonFormat, MagRounding Rounding = MagRounding::nearest_even>
+static inline StrtodResult StrtodImpl(const char* next, const char* last, double& value)
+{
+    if (next == last)
+        return {next, StrtodStatus::invalid};
+
+    // Decompose the input into the form significand * 10^exponent,
+    // where significand has num_digits decimal digits.
+
+    uint64_t significand = 0; // only valid iff num_digits <= 19
+    int64_t  num_digits  = 0; // 64-bit to avoid overflow...
+    int64_t  exponent    = 0; // 64-bit to avoid overflow...
+    StrtodStatus status = StrtodStatus::integer;
+
+// [-]
+
+    const bool is_negative = (*next == '-');
+    if (is_negative || (!JsonFormat && *next == '+'))
+    {
+        ++next;
+        if (next == last)
+            return {next, StrtodStatus::invalid};
+    }
+
+// int32_t
+
+#if RYU_STRTOD_FALLBACK()
+    const char* const start = next;
+#endif
+
+    const bool has_leading_zero = (*next == '0');
+    const bool has_leading_dot  = (*next == '.');
+
+    if (JsonFormat && has_leading_dot)
+        return {next, StrtodStatus::invalid};
+
+    // Hexadecimal (strtod's %a format; not part of the JSON grammar). The prefix only
+    // counts if a significand digit follows: "0x!" parses as the number 0 with next
+    // pointing at the 'x', like strtod.
+    if (!JsonFormat && has_leading_zero && last - next >= 3 && (next[1] == 'x' || next[1] == 'X'))
+    {
+        if (IsHexDigit(next[2]) || (next[2] == '.' && last - next >= 4 && IsHexDigit(next[3])))
+            return ParseHex<Rounding>(is_negative, next, last, value);
+    }
+
+    if (has_leading_zero)
+    {
+        if (JsonFormat)
+        {
+            // JSON does not allow redundant leading zeros ("00", "01").
+            ++next;
+            if (next != last && IsDigit(*next))
+                return {next, StrtodStatus::invalid};
+        }
+        else
+        {
+            for (;;)
+            {
+                ++next;
+                if (next == last || *next != '0')
+                    break;
+            }
+        }
+    }
+
+    if (next != last && IsDigit(*next)) // non-0
+    {
+        const char* const p = next;
+
+        next = ScanDigits(next + 1, last);
+        significand = ReadDecimalDigits(0, p, next);
+
+        num_digits = next - p;
+
+        // Integer fast path:
+        // If the number ends here, no '.' or exponent can change the value anymore. With at most
+        // 19 digits the accumulated significand did not wrap, and if it is <= 2^53 a single
+        // int->double conversion is exact -- no need to run the decimal->binary machinery.
+        if ((next == last || (*next != '.' && *next != 'e' && *next != 'E'))
+            && num_digits <= 19 && significand <= (uint64_t{1} << 53))
+        {
+            DRACHENNEST_COUNT(strtod_integer);
+            const double dbl = static_cast<double>(significand);
+            value = is_negative ? -dbl : dbl;
+            return {next, StrtodStatus::integer, num_digits, 0};
+        }
+    }
+    else if (!has_leading_zero && !has_leading_dot)
+    {
+        if (JsonFormat)
+            return {next, StrtodStatus::invalid};
+
+        return ParseSpecial(is_negative, next, last, value);
+    }
+
+// frac
+
+    if (has_leading_dot || (next != last && *next == '.'))
+    {
+        status = StrtodStatus::fixed;
+
+        ++next; // skip '.'
+        if (next != last && IsDigit(*next))
+        {
+            // TODO:
+            // Ignore trailing zeros...
+
+            const char* const p = next;
+
+            next = ScanDigits(next + 1, last);
+            significand = ReadDecimalDigits(significand, p, next);
+
+            const char* nz = p;
+            if (num_digits == 0)
             {
                 // Number is of the form "0.xxx...".
                 // Move the leading zeros in the fractional part into the exponent.
@@ -2155,24 +3081,20 @@ StrtodResult ryu::Strtod(const char* next, const char* last, double& value)
         {
             // No digits in the fractional part.
             // But at least one digit must appear in either the integral or the fractional part.
-            if (has_leading_dot)
+            // (JSON additionally requires at least one digit after the '.'.)
+            if (JsonFormat || has_leading_dot)
                 return {next, StrtodStatus::invalid};
         }
     }
 
 // exp
 
-    // Exponents larger than this limit will be treated as +Infinity.
-    // But we must still scan all the digits if this happens to be the case.
-    static constexpr int32_t MaxExp = 999999;
-    static_assert(MaxExp >= 999, "invalid parameter");
-    static_assert(MaxExp <= (INT_MAX - 9) / 10, "invalid parameter");
-
     int32_t parsed_exponent = 0;
     if (next != last && (*next == 'e' || *next == 'E'))
     {
         // Possibly the start of an exponent...
         // We accept (and ignore!) invalid or incomplete exponents.
+        // (JSON instead requires at least one digit after the exponent prefix.)
         // The 'next' pointer is updated if and only if a valid exponent has been found.
         const char* p = next;
 
@@ -2183,6 +3105,9 @@ StrtodResult ryu::Strtod(const char* next, const char* last, double& value)
             if (parsed_exponent_is_negative || *p == '+')
                 ++p;
 
+            if (JsonFormat && (p == last || !IsDigit(*p)))
+                return {p, StrtodStatus::invalid};
+
             if (p != last && IsDigit(*p))
             {
                 // Found a valid exponent.
@@ -2214,6 +3139,10 @@ StrtodResult ryu::Strtod(const char* next, const char* last, double& value)
                 exponent += parsed_exponent;
             }
         }
+        else if (JsonFormat)
+        {
+            return {p, StrtodStatus::invalid};
+        }
     }
 
     RYU_ASSERT(num_digits >= 0);
@@ -2228,33 +3157,615 @@ StrtodResult ryu::Strtod(const char* next, const char* last, double& value)
         // input = x * 10^-inf = 0
         // or
         // input < 10^MinDecimalExponent, which rounds to +-0.
-        flt = 0;
+        // (Unless the (non-zero) magnitude is rounded up, in which case the result is the
+        // smallest denormal.)
+        if constexpr (Rounding == MagRounding::up)
+            flt = std::numeric_limits<double>::denorm_min();
+        else
+            flt = 0;
     }
     else if (parsed_exponent > +MaxExp || exponent + num_digits > MaxDecimalExponent)
     {
         // input = x * 10^+inf = +inf
         // or
         // input >= 10^MaxDecimalExponent, which rounds to +-infinity.
-        flt = std::numeric_limits<double>::infinity();
+        // (Unless the magnitude is rounded down, in which case the result is the largest
+        // finite double.)
+        if constexpr (Rounding == MagRounding::down)
+            flt = std::numeric_limits<double>::max();
+        else
+            flt = std::numeric_limits<double>::infinity();
     }
     else if (num_digits <= ToBinaryMaxDecimalDigits)
     {
+        DRACHENNEST_COUNT(strtod_to_binary);
         RYU_ASSERT(exponent >= INT_MIN);
         RYU_ASSERT(exponent <= INT_MAX);
-        flt = ToBinary64(significand, static_cast<int32_t>(num_digits), static_cast<int32_t>(exponent));
+        flt = ToBinary64Rounded<Rounding>(significand, static_cast<int32_t>(num_digits), static_cast<int32_t>(exponent));
     }
     else
     {
         // We need to fall back to another algorithm if the input is too long.
+        DRACHENNEST_COUNT(strtod_long);
 #if RYU_STRTOD_FALLBACK()
-        flt = ToBinary64Slow(start, next);
+        flt = ToBinary64Slow<Rounding>(start, next);
 #else
-        return {next, StrtodStatus::input_too_long};
+        return {next, StrtodStatus::input_too_long, num_digits, exponent};
 #endif
     }
 
     value = is_negative ? -flt : flt;
-    return {next, status};
+    return {next, status, num_digits, exponent};
+}
+
+StrtodResult ryu::Strtod(const char* next, const char* last, double& value)
+{
+    return StrtodImpl<false>(next, last, value);
+}
+
+StrtodResult ryu::StrtodJson(const char* next, const char* last, double& value)
+{
+    return StrtodImpl<true>(next, last, value);
+}
+
+StrtodResult ryu::StrtodRounded(const char* next, const char* last, double& value, StrtodRounding rounding)
+{
+    // The sign is determined by the first character, so the directed modes can be mapped onto
+    // magnitude rounding up front and the conversion instantiated per mode. (A leading '+' is
+    // positive; "inf"/"nan"/invalid inputs do not depend on the mode.)
+    const bool is_negative = (next != last && *next == '-');
+
+    switch (rounding)
+    {
+    case StrtodRounding::toward_zero:
+        return StrtodImpl<false, MagRounding::down>(next, last, value);
+    case StrtodRounding::toward_neg_infinity:
+        return is_negative
+            ? StrtodImpl<false, MagRounding::up>(next, last, value)
+            : StrtodImpl<false, MagRounding::down>(next, last, value);
+    case StrtodRounding::toward_pos_infinity:
+        return is_negative
+            ? StrtodImpl<false, MagRounding::down>(next, last, value)
+            : StrtodImpl<false, MagRounding::up>(next, last, value);
+    case StrtodRounding::nearest_even:
+    default:
+        return StrtodImpl<false, MagRounding::nearest_even>(next, last, value);
+    }
+}
+
+ryu::StrtodManyResult ryu::StrtodMany(const char* next, const char* last, char separator, double* values, size_t max_count)
+{
+    size_t count = 0;
+
+    // Strtod is called directly (same TU), so the per-field cost is a single call into the
+    // already-hot parser instead of a round-trip through the exported symbol.
+    while (count < max_count)
+    {
+        double value;
+        const auto res = Strtod(next, last, value);
+        if (res.status == StrtodStatus::invalid)
+            break;
+
+        values[count++] = value;
+        next = res.next;
+
+        if (next == last || *next != separator || count == max_count)
+            break;
+
+        ++next; // skip the separator
+    }
+
+    return {next, count};
+}
+
+ryu::StrtodBulkResult ryu::StrtodBulk(const char* first, const char* last, char separator, double* values, size_t max_count)
+{
+    const char* next = first;
+    size_t count = 0;
+
+    // An empty chunk (or max_count == 0) fails at offset 0; every parsed value overwrites
+    // this with its own status, so the happy path never tests for errors.
+    StrtodStatus status = StrtodStatus::invalid;
+
+    while (count < max_count)
+    {
+        double value;
+        const auto res = Strtod(next, last, value);
+        if (!res)
+        {
+            // Skip the bad token (up to and including the next separator), so the caller
+            // can resume directly after reporting the error.
+            const size_t error_offset = static_cast<size_t>(next - first);
+            while (next != last && *next != separator)
+                ++next;
+            if (next != last)
+                ++next;
+            return {next, count, error_offset, res.status};
+        }
+
+        values[count++] = value;
+        status = res.status;
+        next = res.next;
+
+        if (next == last || *next != separator)
+            break;
+
+        ++next; // skip the separator; next is the start of the following field
+    }
+
+    return {next, count, 0, status};
+}
+
+ryu::StrtodManyResult ryu::StrtodFields(const char* first, const char* last, char separator, double* values, size_t count)
+{
+    const char* next = first;
+    size_t n = 0;
+
+    while (count - n >= 4)
+    {
+        // Locate the extents of the next four fields up front. (e[i] points at the
+        // separator terminating field i, or at last.)
+        const char* b[4];
+        const char* e[4];
+
+        int32_t located = 0;
+        for (const char* p = next; located < 4; ++located)
+        {
+            b[located] = p;
+            const void* sep = std::memchr(p, separator, static_cast<size_t>(last - p));
+            if (sep == nullptr)
+            {
+                e[located++] = last;
+                break;
+            }
+            e[located] = static_cast<const char*>(sep);
+            p = e[located] + 1;
+        }
+        if (located < 4)
+            break; // fewer than four fields left; the serial loop below handles them
+
+        // Speculate that each field is a plain fixed-notation number (sign, digits, '.',
+        // digits). The step below consumes one character per field per round: the four
+        // 10 * m + d significand chains are independent, so the multiply-adds of adjacent
+        // fields overlap instead of serializing behind one field's chain, and with the
+        // similar field widths of a fixed-layout line the lanes retire in lockstep. A lane
+        // whose field does not match the pattern is deactivated and re-parsed with Strtod
+        // below -- the speculation only costs the characters consumed until the mismatch.
+        const char* q[4];
+        uint64_t m[4] = {0, 0, 0, 0};
+        int32_t frac[4] = {0, 0, 0, 0};
+        int32_t ndigits[4] = {0, 0, 0, 0};
+        bool in_fraction[4] = {false, false, false, false};
+        bool negative[4];
+        bool simple[4] = {true, true, true, true};
+
+        for (int32_t i = 0; i < 4; ++i)
+        {
+            negative[i] = (b[i] != e[i] && *b[i] == '-');
+            q[i] = b[i] + (negative[i] ? 1 : 0);
+        }
+
+        for (;;)
+        {
+            bool any = false;
+            for (int32_t i = 0; i < 4; ++i)
+            {
+                if (q[i] == e[i])
+                    continue;
+                const char c = *q[i];
+                ++q[i];
+                any = true;
+                if (IsDigit(c))
+                {
+                    m[i] = 10 * m[i] + static_cast<uint32_t>(DigitValue(c));
+                    ++ndigits[i];
+                    frac[i] += in_fraction[i] ? 1 : 0;
+                }
+                else if (c == '.' && !in_fraction[i])
+                {
+                    in_fraction[i] = true;
+                }
+                else
+                {
+                    simple[i] = false;
+                    q[i] = e[i]; // deactivate the lane
+                }
+            }
+            if (!any)
+                break;
+        }
+
+        for (int32_t i = 0; i < 4; ++i)
+        {
+            // With at most 19 digit characters the accumulated significand did not wrap.
+            // (The digit count includes leading zeros, which contribute nothing to m: the
+            // number of significant digits is just DecimalLength(m).)
+            bool converted = false;
+            if (simple[i] && ndigits[i] >= 1 && ndigits[i] <= 19)
+            {
+                if (m[i] == 0)
+                {
+                    values[n + i] = negative[i] ? -0.0 : 0.0;
+                    converted = true;
+                }
+                else if (m[i] <= 99999999999999999ull) // i.e. DecimalLength(m) <= ToBinaryMaxDecimalDigits
+                {
+                    const double flt = ToBinary64(m[i], DecimalLength(m[i]), -frac[i]);
+                    values[n + i] = negative[i] ? -flt : flt;
+                    converted = true;
+                }
+            }
+            if (!converted)
+            {
+                // The speculation failed for this field (exponent notation, "inf"/"nan",
+                // more than 17 significant digits, empty field, ...): re-parse it with
+                // Strtod, replicating StrtodMany exactly.
+                double value;
+                const auto res = Strtod(b[i], last, value);
+                if (res.status == StrtodStatus::invalid)
+                    return {b[i], n + static_cast<size_t>(i)};
+
+                values[n + i] = value;
+                RYU_ASSERT(res.next <= e[i]); // see the PRE on the separator
+                if (res.next != e[i])
+                    return {res.next, n + static_cast<size_t>(i) + 1};
+            }
+        }
+
+        n += 4;
+        next = e[3];
+        if (n == count || next == last)
+            return {next, n};
+
+        ++next; // skip the separator; next is the start of the following field
+    }
+
+    // Fewer than four fields (or columns) remain: parse them serially.
+    const auto res = StrtodMany(next, last, separator, values + n, count - n);
+    return {res.next, n + res.count};
+}
+
+void ryu::StrtodValidated(const char* buffer, const drachennest::ScanNumberToken* tokens, size_t count, double* values)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto res = Strtod(buffer + tokens[i].first, buffer + tokens[i].last, values[i]);
+        RYU_ASSERT(res); // the tokens are validated; see the PRE in ryu_64.h
+        static_cast<void>(res);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// StrtodChunked
+//--------------------------------------------------------------------------------------------------
+
+// Parser states for StrtodChunked.
+//
+// The characters consumed in the Exp*/Inf/NaN states are tentative until the state commits
+// (an exponent digit, the third character of "inf"/"nan", the 'y' of "infinity"): they are
+// only part of the number if the right continuation follows. StrtodChunked::pending_ counts
+// them, so that a suspend/stop inside a tentative prefix can give them back to the caller.
+//
+// The exponent prefix states come in two flavors which remember whether a fractional part
+// preceded the 'e', so that a retracted exponent still reports the right status.
+enum ChunkedState : uint32_t {
+    ChunkedState_Start,       // nothing consumed: expect a sign, digit, '.', "inf" or "nan"
+    ChunkedState_Sign,        // sign consumed
+    ChunkedState_Zeros,       // consuming redundant leading zeros of the integer part
+    ChunkedState_Int,         // consuming integer digits
+    ChunkedState_Dot,         // leading '.' consumed, no digit seen yet (invalid if the number ends here)
+    ChunkedState_Frac,        // '.' consumed, consuming fractional digits
+    ChunkedState_ExpInt,      // 'e'/'E' consumed after the integer part (tentative)
+    ChunkedState_ExpIntSign,  //   + exponent sign (tentative)
+    ChunkedState_ExpFrac,     // 'e'/'E' consumed after the fractional part (tentative)
+    ChunkedState_ExpFracSign, //   + exponent sign (tentative)
+    ChunkedState_Exp,         // consuming exponent digits (the exponent is committed)
+    ChunkedState_Inf,         // matching "inf"/"infinity" (special_ = #matched characters)
+    ChunkedState_NaN,         // matching "nan" (special_ = #matched characters)
+};
+
+void ryu::StrtodChunked::Reset()
+{
+    significand_ = 0;
+    num_digits_ = 0;
+    exponent_ = 0;
+    parsed_exponent_ = 0;
+    state_ = ChunkedState_Start;
+    pending_ = 0;
+    special_ = 0;
+    is_negative_ = false;
+    parsed_exponent_is_negative_ = false;
+}
+
+const char* ryu::StrtodChunked::Feed(const char* next, const char* last)
+{
+    const char* const first = next;
+
+    // The number is complete (or invalid) at p: return as many of the tentatively consumed
+    // characters as lie in the current segment. The rest is reported by Finish as 'retract'.
+    const auto Stop = [&](const char* p)
+    {
+        const size_t available = static_cast<size_t>(p - first);
+        const size_t give_back = (pending_ <= available) ? pending_ : available;
+        pending_ -= static_cast<uint32_t>(give_back);
+        return p - give_back;
+    };
+
+    while (next != last)
+    {
+        const char ch = *next;
+
+        switch (state_)
+        {
+        case ChunkedState_Start:
+        case ChunkedState_Sign:
+            if (IsDigit(ch))
+            {
+                if (ch == '0')
+                {
+                    state_ = ChunkedState_Zeros;
+                    ++next;
+                }
+                else
+                {
+                    state_ = ChunkedState_Int; // the digits are consumed below
+                }
+            }
+            else if (ch == '.')
+            {
+                state_ = ChunkedState_Dot;
+                ++next;
+            }
+            else if (state_ == ChunkedState_Start && (ch == '-' || ch == '+'))
+            {
+                is_negative_ = (ch == '-');
+                state_ = ChunkedState_Sign;
+                ++next;
+            }
+            else if (ch == 'i' || ch == 'I')
+            {
+                state_ = ChunkedState_Inf;
+                special_ = 1;
+                pending_ = 1;
+                ++next;
+            }
+            else if (ch == 'n' || ch == 'N')
+            {
+                state_ = ChunkedState_NaN;
+                special_ = 1;
+                pending_ = 1;
+                ++next;
+            }
+            else
+            {
+                return Stop(next); // invalid
+            }
+            break;
+
+        case ChunkedState_Zeros:
+            while (next != last && *next == '0')
+                ++next;
+            if (next == last)
+                return last;
+            if (IsDigit(*next))
+                state_ = ChunkedState_Int;
+            else if (*next == '.')
+            {
+                state_ = ChunkedState_Frac;
+                ++next;
+            }
+            else if (*next == 'e' || *next == 'E')
+            {
+                state_ = ChunkedState_ExpInt;
+                ++pending_;
+                ++next;
+            }
+            else
+                return Stop(next);
+            break;
+
+        case ChunkedState_Int:
+        {
+            const char* const p = next;
+            next = ScanDigits(next, last);
+            significand_ = ReadDecimalDigits(significand_, p, next);
+            num_digits_ += next - p;
+            if (next == last)
+                return last;
+            if (*next == '.')
+            {
+                state_ = ChunkedState_Frac;
+                ++next;
+            }
+            else if (*next == 'e' || *next == 'E')
+            {
+                state_ = ChunkedState_ExpInt;
+                ++pending_;
+                ++next;
+            }
+            else
+                return Stop(next);
+            break;
+        }
+
+        case ChunkedState_Dot:
+            if (!IsDigit(ch))
+                return Stop(next); // invalid: no digits at all
+            state_ = ChunkedState_Frac;
+            break;
+
+        case ChunkedState_Frac:
+        {
+            if (num_digits_ == 0)
+            {
+                // Number is of the form "0.xxx...".
+                // Move the leading zeros in the fractional part into the exponent.
+                while (next != last && *next == '0')
+                {
+                    --exponent_;
+                    ++next;
+                }
+                if (next == last)
+                    return last;
+            }
+            const char* const p = next;
+            next = ScanDigits(next, last);
+            significand_ = ReadDecimalDigits(significand_, p, next);
+            num_digits_ += next - p;
+            exponent_ -= next - p;
+            if (next == last)
+                return last;
+            if (*next == 'e' || *next == 'E')
+            {
+                state_ = ChunkedState_ExpFrac;
+                ++pending_;
+                ++next;
+            }
+            else
+                return Stop(next);
+            break;
+        }
+
+        case ChunkedState_ExpInt:
+        case ChunkedState_ExpFrac:
+            if (ch == '-' || ch == '+')
+            {
+                parsed_exponent_is_negative_ = (ch == '-');
+                state_ = (state_ == ChunkedState_ExpInt) ? ChunkedState_ExpIntSign : ChunkedState_ExpFracSign;
+                ++pending_;
+                ++next;
+                break;
+            }
+            if (!IsDigit(ch))
+                return Stop(next); // not an exponent after all
+            state_ = ChunkedState_Exp;
+            pending_ = 0; // the prefix is committed
+            break;
+
+        case ChunkedState_ExpIntSign:
+        case ChunkedState_ExpFracSign:
+            if (!IsDigit(ch))
+                return Stop(next); // not an exponent after all
+            state_ = ChunkedState_Exp;
+            pending_ = 0; // the prefix is committed
+            break;
+
+        case ChunkedState_Exp:
+            while (next != last && IsDigit(*next))
+            {
+                if (parsed_exponent_ <= MaxExp)
+                    parsed_exponent_ = 10 * parsed_exponent_ + DigitValue(*next);
+                ++next;
+            }
+            if (next == last)
+                return last;
+            return Stop(next);
+
+        case ChunkedState_Inf:
+            if (special_ == 8 || ToLowerASCII(ch) != "infinity"[special_])
+                return Stop(next);
+            ++special_;
+            ++pending_;
+            ++next;
+            if (special_ == 3 || special_ == 8) // "inf" resp. "infinity" is complete
+                pending_ = 0;
+            break;
+
+        case ChunkedState_NaN:
+            if (special_ == 3 || ToLowerASCII(ch) != "nan"[special_])
+                return Stop(next);
+            ++special_;
+            ++pending_;
+            ++next;
+            if (special_ == 3)
+                pending_ = 0;
+            break;
+
+        default:
+            RYU_ASSERT(false); // unreachable
+            return Stop(next);
+        }
+    }
+
+    return last;
+}
+
+ryu::StrtodChunkedResult ryu::StrtodChunked::Finish(double& value)
+{
+    const size_t retract = pending_;
+
+    switch (state_)
+    {
+    case ChunkedState_Start:
+    case ChunkedState_Sign:
+    case ChunkedState_Dot:
+        return {retract, StrtodStatus::invalid};
+
+    case ChunkedState_Inf:
+        if (special_ < 3)
+            return {retract, StrtodStatus::invalid};
+        value = is_negative_ ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+        return {retract, StrtodStatus::inf};
+
+    case ChunkedState_NaN:
+        if (special_ < 3)
+            return {retract, StrtodStatus::invalid};
+        value = std::numeric_limits<double>::quiet_NaN();
+        return {retract, StrtodStatus::nan};
+
+    default:
+        break;
+    }
+
+    StrtodStatus status;
+    int32_t parsed_exponent = 0;
+    int64_t exponent = exponent_;
+    switch (state_)
+    {
+    case ChunkedState_Exp:
+        status = StrtodStatus::scientific;
+        parsed_exponent = parsed_exponent_is_negative_ ? -parsed_exponent_ : parsed_exponent_;
+        exponent += parsed_exponent;
+        break;
+    case ChunkedState_Frac:
+    case ChunkedState_ExpFrac:
+    case ChunkedState_ExpFracSign:
+        status = StrtodStatus::fixed;
+        break;
+    default: // Zeros, Int, ExpInt, ExpIntSign
+        status = StrtodStatus::integer;
+        break;
+    }
+
+    // The value computation below matches StrtodImpl.
+    double flt;
+    if (num_digits_ == 0)
+    {
+        flt = 0;
+    }
+    else if (parsed_exponent < -MaxExp || exponent + num_digits_ <= MinDecimalExponent)
+    {
+        flt = 0;
+    }
+    else if (parsed_exponent > +MaxExp || exponent + num_digits_ > MaxDecimalExponent)
+    {
+        flt = std::numeric_limits<double>::infinity();
+    }
+    else if (num_digits_ <= ToBinaryMaxDecimalDigits)
+    {
+        RYU_ASSERT(exponent >= INT_MIN);
+        RYU_ASSERT(exponent <= INT_MAX);
+        flt = ToBinary64(significand_, static_cast<int32_t>(num_digits_), static_cast<int32_t>(exponent));
+    }
+    else
+    {
+        // The digits are no longer available as a contiguous string, so there is nothing to
+        // hand to the slow path here: the caller must reassemble the input and use Strtod.
+        return {retract, StrtodStatus::input_too_long};
+    }
+
+    value = is_negative_ ? -flt : flt;
+    return {retract, status};
 }
 
 //==================================================================================================
@@ -6,8 +6,15 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #define RYU_STRTOD_FALLBACK() 1
 
+namespace drachennest {
+struct ScanNumberToken; // scan_number.h
+}
+
 namespace ryu {
 
 // char* output_end = Dtoa(buffer, value);
@@ -15,7 +22,7 @@ namespace ryu {
 // Converts the given double-precision number into decimal form and stores the result in the given
 // buffer.
 //
-// The buffer must be large enough, i.e. >= DtoaMinBufferLength.
+// The buffer must be large enough, i.e. >= DtoaMaxLength.
 // The output format is similar to printf("%g").
 // The output is _not_ null-terminted.
 //
@@ -25,17 +32,59 @@ namespace ryu {
 //  3. is as close to the input number as possible.
 //
 // Note:
-// This function may temporarily write up to DtoaMinBufferLength characters into the buffer.
+// Dtoa never writes past buffer + DtoaMaxLength, so output slots of exactly DtoaMaxLength
+// characters can be formatted in place, without a bounce buffer.
+
+// The worst case output (and write extent) of Dtoa: a sign, "0." plus six leading zeros (the
+// fixed notation window extends down to 1e-7), and 17 significand digits, e.g.
+//  -0.00000088817841970012523
+constexpr int DtoaMaxLength = 26;
 
-constexpr int DtoaMinBufferLength = 64;
+// Historical name: formatting used to require 64 characters of scratch headroom.
+constexpr int DtoaMinBufferLength = DtoaMaxLength;
 
 char* Dtoa(char* buffer, double value);
 
+// char* output_end = DtoaJson(buffer, value, nonfinite, keep_minus_zero);
+//
+// Like Dtoa, but with RFC 8259 (JSON) conformant output for every input: finite values
+// format exactly as with Dtoa (whose output already fits the JSON number grammar), while
+// infinities and NaNs emit the nonfinite replacement token (default: "null"). With
+// keep_minus_zero = false, negative zero emits "0".
+//
+// The buffer must be large enough, i.e. >= DtoaMaxLength, and the replacement token must
+// not be longer than DtoaMaxLength characters.
+
+char* DtoaJson(char* buffer, double value, const char* nonfinite = "null", bool keep_minus_zero = true);
+
+// FloatingDecimal64 dec = ToDecimal64(value);
+//
+// Converts the given double-precision number into the decimal form (digits, exponent), i.e.
+//  value = digits * 10^exponent
+//
+// The returned digits are optimal in the same sense as for Dtoa. Use this function instead of
+// Dtoa if the decimal representation is needed, but not its ASCII form.
+//
+// PRE: value must be finite and non-zero. The sign of value is ignored.
+//
+// The second overload operates directly on the (biased) IEEE representation, i.e. on the
+// physical significand and exponent fields of the double.
+
+struct FloatingDecimal64 {
+    uint64_t digits; // num_digits <= 17
+    int32_t exponent;
+};
+
+FloatingDecimal64 ToDecimal64(double value);
+FloatingDecimal64 ToDecimal64(uint64_t ieee_significand, uint64_t ieee_exponent);
+
 // StrtodResult conversion_result = Strtod(first, last, value);
 //
 // Converts the given decimal floating-point number into a double-precision binary floating-point
 // number.
-// The function accepts the same inputs as std::strtod.
+// The function accepts the same inputs as std::strtod, including the hexadecimal format
+// ("0x1.8p+1", printf's %a) -- hex inputs are converted by pure bit manipulation, no
+// decimal machinery is involved (see schubfach::DtoaHex for the matching formatter).
 //
 // If the input has more than 17 significant digits, the function may return
 // StrtodStatus::input_too_long. In this case another algorithm must be used to convert the input
@@ -45,16 +94,26 @@ char* Dtoa(char* buffer, double value);
 // This function always succeeds to convert the output of Dtoa back into the correct binary
 // floating-point number.
 
+// The status doubles as the format classification of the accepted token, and this is
+// guaranteed: 'integer' iff the token has neither a '.' nor a (valid) exponent, 'fixed' iff
+// it has a '.' but no exponent, 'scientific' iff it has an exponent -- e.g. to route parsed
+// columns by format (integer-looking tokens to an int column, the rest to doubles) without
+// re-scanning the text.
+
 enum class StrtodStatus {
     invalid,
-    integer,    // Add StrtodFormat ?
-    fixed,      // Add StrtodFormat ?
-    scientific, // Add StrtodFormat ?
+    integer,
+    fixed,
+    scientific,
+    // A hexadecimal token ("0x1.8p+1", strtod's %a format; Strtod only, the JSON grammar
+    // has no hex). The decimal decomposition below does not apply: num_digits and exponent
+    // are 0, like for inf/nan.
+    hex,
     inf,
     nan,
-#if !RYU_STRTOD_FALLBACK()
+    // Strtod only returns input_too_long if RYU_STRTOD_FALLBACK is disabled; StrtodChunked
+    // returns it for any input with more than 17 significant digits (see below).
     input_too_long,
-#endif
 };
 
 struct StrtodResult
@@ -62,19 +121,230 @@ struct StrtodResult
     const char* next;
     StrtodStatus status;
 
+    // For the integer/fixed/scientific (and input_too_long) statuses, the decomposition of
+    // the token as scanned: the token's value is +-digits * 10^exponent, where digits has
+    // num_digits significant decimal digits (leading zeros are not counted, trailing zeros
+    // are -- "0.0150" has num_digits == 3 and exponent == -4). num_digits == 0 iff the
+    // token's digits are all zero. Both fields are 0 for the invalid/inf/nan statuses.
+    // 64-bit, like the scan itself: inputs are not length-limited, so neither field is
+    // guaranteed to fit into an int32. (Exponent digits are only accumulated up to +-999999;
+    // past that the reported exponent is clamped -- the converted value is unaffected.)
+    int64_t num_digits;
+    int64_t exponent;
+
     // Test for success.
     explicit operator bool() const noexcept
     {
-#if !RYU_STRTOD_FALLBACK()
         return status != StrtodStatus::invalid && status != StrtodStatus::input_too_long;
-#else
-        return status != StrtodStatus::invalid;
-#endif
     }
 };
 
 StrtodResult Strtod(const char* next, const char* last, double& value);
 
+// StrtodResult conversion_result = StrtodJson(first, last, value);
+//
+// Like Strtod, but accepts exactly the RFC 8259 (JSON) number grammar:
+//
+//  number = [ '-' ] ( '0' / [1-9]*DIGIT ) [ '.' 1*DIGIT ] [ ('e'/'E') [ '-'/'+' ] 1*DIGIT ]
+//
+// I.e. a leading '+', a leading or trailing '.', redundant leading zeros, "inf"/"nan" forms,
+// and an exponent prefix without digits are rejected. On failure, the returned 'next' points
+// at the offending character, so it can be used directly as an error offset.
+
+StrtodResult StrtodJson(const char* next, const char* last, double& value);
+
+// StrtodResult conversion_result = StrtodRounded(first, last, value, rounding);
+//
+// Like Strtod, but the decimal -> binary conversion uses the given rounding mode instead of
+// round-to-nearest-even. The directed modes return the closest double on the requested side
+// of the exact decimal value, e.g. for interval arithmetic a number parsed once toward
+// -infinity and once toward +infinity yields certified lower and upper bounds (at most one
+// ULP apart, and equal iff the input is exactly representable).
+//
+// The directed modes never flush a non-zero input to zero (the magnitude rounds up to the
+// smallest denormal instead) and never overflow a finite input past the largest finite
+// double when rounding toward zero.
+//
+// The accepted inputs and the returned 'next'/status are exactly those of Strtod.
+// StrtodRounded(..., StrtodRounding::nearest_even) is equivalent to Strtod.
+
+enum class StrtodRounding {
+    nearest_even,
+    toward_zero,
+    toward_neg_infinity,
+    toward_pos_infinity,
+};
+
+StrtodResult StrtodRounded(const char* next, const char* last, double& value, StrtodRounding rounding);
+
+// StrtodManyResult res = StrtodMany(first, last, separator, values, max_count);
+//
+// Parses up to max_count separator-joined numbers from [first, last) and stores them in values,
+// i.e. the expected input is
+//  number <separator> number <separator> ... number
+//
+// Each number is parsed exactly as by Strtod.
+//
+// Returns the number of values parsed and a pointer to the first character that was not consumed:
+// either last, or the start of the field that failed to parse, or the character following the
+// last parsed value if it is not a separator.
+
+struct StrtodManyResult
+{
+    const char* next;
+    size_t count;
+};
+
+StrtodManyResult StrtodMany(const char* first, const char* last, char separator, double* values, size_t max_count);
+
+// StrtodBulkResult res = StrtodBulk(first, last, separator, values, max_count);
+//
+// Like StrtodMany, but built for resumable ingestion: when a field fails to parse, the
+// result additionally records its byte offset (relative to first) and status, and 'next' is
+// positioned at the start of the field following the bad one -- the bad token and its
+// separator are skipped. The caller can report the error and immediately resume with
+// StrtodBulk(res.next, last, ...) instead of re-scanning the chunk to localize the failure:
+//
+//  while (first != last)
+//  {
+//      const auto res = ryu::StrtodBulk(first, last, ',', values, max_count);
+//      // consume res.count values; if (!res) report the error at first + res.error_offset
+//      first = res.next;
+//  }
+//
+// A chunk that stops without a failure (end of input, max_count values parsed, or a
+// non-separator character after a value) reports the status of its last parsed field, with
+// 'next' at the start of the following field (resp. at the offending character). An empty
+// chunk fails at offset 0.
+
+struct StrtodBulkResult
+{
+    const char* next;    // where the next call resumes
+    size_t count;        // #values parsed in this call
+    size_t error_offset; // byte offset (from first) of the field that failed; 0 if none did
+    StrtodStatus status; // the failing field's status, or the last parsed field's status
+
+    // Test for success, i.e. "no field in this chunk failed".
+    explicit operator bool() const noexcept
+    {
+        return status != StrtodStatus::invalid && status != StrtodStatus::input_too_long;
+    }
+};
+
+StrtodBulkResult StrtodBulk(const char* first, const char* last, char separator, double* values, size_t max_count);
+
+// StrtodManyResult res = StrtodFields(first, last, separator, values, count);
+//
+// Parses up to count separator-joined numbers, exactly like StrtodMany, but optimized for
+// fixed-layout lines (e.g. a CSV row with a known column count and similar field widths):
+// the field extents are located up front, then groups of four fields are parsed with their
+// digit loops interleaved, one character per field per round. The four significand chains
+// are independent, so the multiply-adds of adjacent fields overlap in the pipeline --
+// instruction-level parallelism that serial per-field Strtod calls leave unused.
+//
+// The interleaved parse speculates that each field is a plain fixed-notation number (an
+// optional '-', digits, an optional '.' and more digits, at most 17 significant digits).
+// Fields that do not match (exponent notation, "inf"/"nan", very long significands, ...)
+// are re-parsed individually with Strtod, so the results -- values, count and the returned
+// next pointer -- are always identical to StrtodMany.
+//
+// PRE: the separator must not be a character that can appear inside a number (i.e. not a
+// digit and none of '.', '+', '-', 'e', 'E', nor a character of "infinity" / "nan(...)"
+// payloads). The usual suspects (',', ';', ' ', '\t', '|') are all fine.
+
+StrtodManyResult StrtodFields(const char* first, const char* last, char separator, double* values, size_t count);
+
+// StrtodValidated(buffer, tokens, count, values);
+//
+// Conversion stage of the two-stage bulk parse for untrusted input: converts the tokens
+// recorded by drachennest::ScanNumberMany (scan_number.h), values[i] from tokens[i].
+// Separating validation from conversion means the error handling lives entirely in the
+// validation pass -- this loop runs over known-valid tokens only, so its branches always
+// predict parse success.
+//
+// PRE: every token must have passed validation (the grammar ScanNumberMany checks is a
+// subset of what Strtod accepts, so the per-token conversion cannot fail).
+
+void StrtodValidated(const char* buffer, const drachennest::ScanNumberToken* tokens, size_t count, double* values);
+
+// StrtodChunked parser;
+//
+// Resumable variant of Strtod for input that is not contiguous in memory (e.g. numbers
+// straddling the segment boundaries of a ring buffer). The parser accepts the input one
+// segment at a time and keeps its sign/digit/exponent state between segments, so a
+// straddling number parses without first copying it into a contiguous patch buffer:
+//
+//  StrtodChunked parser;
+//  for each segment [first, last):
+//      const char* p = parser.Feed(first, last);
+//      if (p != last)
+//          break; // the number ended at p
+//  StrtodChunkedResult res = parser.Finish(value);
+//
+// Feed consumes characters until either the segment is exhausted (returns last: feed the
+// next segment, or call Finish if there is none) or a character is seen that cannot extend
+// the number (returns a pointer to it: the number is complete, call Finish).
+//
+// Some characters are only part of the number if they are followed by the right
+// continuation -- an exponent prefix "e+" must be followed by a digit, "inf" may or may not
+// extend to "infinity". When such a tentative prefix straddles a segment boundary, Feed has
+// already consumed characters that turn out not to belong to the number and cannot "return"
+// them via its result pointer. Finish reports their count as 'retract': the caller must
+// rewind its input cursor by that many characters (Feed already excludes from its result
+// pointer any such characters that lie in the current segment, so 'retract' is usually 0).
+//
+// Finish accepts the same inputs as Strtod, with three deliberate exceptions: a "nan(...)"
+// payload is not consumed (parsing stops after "nan"), hexadecimal tokens ("0x1.8p+1") are
+// not recognized (parsing stops at the 'x', as Strtod did before it learned the format),
+// and inputs with more than 17 significant digits return StrtodStatus::input_too_long
+// instead of falling back to a slower algorithm -- the digits are no longer available as a
+// contiguous string, so the caller must reassemble the (rare, long) input and use Strtod
+// instead.
+
+struct StrtodChunkedResult
+{
+    size_t retract; // #characters consumed from previous segments that are not part of the number
+    StrtodStatus status;
+
+    // Test for success.
+    explicit operator bool() const noexcept
+    {
+        return status != StrtodStatus::invalid && status != StrtodStatus::input_too_long;
+    }
+};
+
+class StrtodChunked
+{
+public:
+    StrtodChunked()
+    {
+        Reset();
+    }
+
+    // Resets the parser so it can be reused for the next number.
+    void Reset();
+
+    // Consumes characters from [next, last). Returns last if the whole segment was consumed
+    // and the number may continue in the next segment; otherwise the number is complete and
+    // the result points at the first character that is not part of it.
+    const char* Feed(const char* next, const char* last);
+
+    // Finalizes the number at the end of the input and converts it. As for Strtod, 'value'
+    // is only assigned on success.
+    StrtodChunkedResult Finish(double& value);
+
+private:
+    uint64_t significand_;  // the first (up to) 19 significant digits
+    int64_t num_digits_;    // #significant digits seen (bounded by the total input length)
+    int64_t exponent_;      // decimal shift from the fractional digits
+    int32_t parsed_exponent_;
+    uint32_t state_;        // current State (see ryu_64.cc)
+    uint32_t pending_;      // #tentatively consumed characters from previous segments
+    uint32_t special_;      // #matched characters of "infinity" / "nan"
+    bool is_negative_;
+    bool parsed_exponent_is_negative_;
+};
+
 // Round10(x, n) returns: round(x * 10^-n) / 10^-n
 //
 // Use this function to round the given value to a specific number of decimal places.
@@ -0,0 +1,364 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "scan_number.h"
+
+#include <cassert>
+#include <cstring>
+
+#ifndef SN_ASSERT
+#define SN_ASSERT(X) assert(X)
+#endif
+
+// Vectorized character classification for ScanNumberMany. (May be disabled by defining
+// SN_SIMD_CLASSIFY=0.)
+#ifndef SN_SIMD_CLASSIFY
+#if defined(__SSE2__) || (defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define SN_SIMD_CLASSIFY 1
+#else
+#define SN_SIMD_CLASSIFY 0
+#endif
+#endif
+
+#if SN_SIMD_CLASSIFY
+#include <emmintrin.h>
+#endif
+
+//==================================================================================================
+//
+//==================================================================================================
+
+using drachennest::ScanNumberResult;
+using drachennest::ScanNumberState;
+using drachennest::ScanNumberStatus;
+
+static inline bool IsDigit(char ch)
+{
+    return static_cast<unsigned>(ch - '0') <= 9u;
+}
+
+static inline int32_t DigitValue(char ch)
+{
+    SN_ASSERT(IsDigit(ch));
+    return ch - '0';
+}
+
+namespace {
+// The position in the grammar, stored in ScanNumberState::part between chunks.
+enum Part : uint8_t {
+    PartStart = 0,  // nothing consumed yet
+    PartIntStart,   // sign consumed, expecting the first integer digit
+    PartIntZero,    // consumed the single leading '0'
+    PartIntDigits,  // inside the integer digit run
+    PartFracDot,    // consumed the '.', expecting the first fraction digit
+    PartFracDigits, // inside the fraction digit run
+    PartExpPrefix,  // consumed the 'e'/'E', expecting a sign or a digit
+    PartExpSign,    // consumed the exponent sign, expecting a digit
+    PartExpDigits,  // inside the exponent digit run
+};
+}
+
+ScanNumberResult drachennest::ScanNumber(ScanNumberState& state, const char* next, const char* last, bool is_last_chunk)
+{
+    // Exponents are saturated here; values this large describe +-infinity or +-0 for any
+    // meaningful number of digits. (Same limit as ryu::Strtod.)
+    static constexpr int64_t MaxExp = 999999;
+
+    ScanNumberResult result;
+    result.next = next;
+    result.status = ScanNumberStatus::incomplete;
+    result.integer_digits = next;
+    result.integer_end = next;
+    result.fraction_digits = next;
+    result.fraction_end = next;
+    result.exponent = 0;
+    result.is_negative = state.is_negative;
+
+    for (;;)
+    {
+        switch (static_cast<Part>(state.part))
+        {
+        case PartStart:
+            if (next == last)
+                goto end_of_chunk;
+            if (*next == '-')
+            {
+                state.is_negative = true;
+                result.is_negative = true;
+                ++next;
+            }
+            state.part = PartIntStart;
+            break;
+
+        case PartIntStart:
+            if (next == last)
+                goto end_of_chunk;
+            if (!IsDigit(*next))
+                goto invalid;
+            if (*next == '0')
+            {
+                // The leading zero is not a significant digit.
+                ++next;
+                state.part = PartIntZero;
+            }
+            else
+            {
+                state.part = PartIntDigits;
+            }
+            break;
+
+        case PartIntZero:
+            if (next == last)
+                goto end_of_chunk;
+            if (IsDigit(*next)) // no redundant leading zeros ("00", "01")
+                goto invalid;
+            if (*next == '.')
+            {
+                ++next;
+                state.part = PartFracDot;
+                break;
+            }
+            if (*next == 'e' || *next == 'E')
+            {
+                ++next;
+                state.part = PartExpPrefix;
+                break;
+            }
+            goto finish;
+
+        case PartIntDigits:
+        {
+            const char* const p = next;
+            while (next != last && IsDigit(*next))
+                ++next;
+
+            result.integer_digits = p;
+            result.integer_end = next;
+            state.significant_digits = true;
+
+            if (next == last)
+                goto end_of_chunk;
+            if (*next == '.')
+            {
+                ++next;
+                state.part = PartFracDot;
+                break;
+            }
+            if (*next == 'e' || *next == 'E')
+            {
+                ++next;
+                state.part = PartExpPrefix;
+                break;
+            }
+            goto finish;
+        }
+
+        case PartFracDot:
+            if (next == last)
+                goto end_of_chunk;
+            if (!IsDigit(*next)) // at least one digit must follow the '.'
+                goto invalid;
+            state.part = PartFracDigits;
+            break;
+
+        case PartFracDigits:
+        {
+            if (!state.significant_digits)
+            {
+                // Number is of the form 0.xxx...
+                // Skip the leading zeros in the fractional part and adjust the exponent.
+                while (next != last && *next == '0')
+                {
+                    --state.exponent;
+                    ++next;
+                }
+            }
+
+            const char* const p = next;
+            while (next != last && IsDigit(*next))
+            {
+                --state.exponent;
+                ++next;
+            }
+
+            result.fraction_digits = p;
+            result.fraction_end = next;
+            if (p != next)
+                state.significant_digits = true;
+
+            if (next == last)
+                goto end_of_chunk;
+            if (*next == 'e' || *next == 'E')
+            {
+                ++next;
+                state.part = PartExpPrefix;
+                break;
+            }
+            goto finish;
+        }
+
+        case PartExpPrefix:
+            if (next == last)
+                goto end_of_chunk;
+            if (*next == '-' || *next == '+')
+            {
+                state.exponent_is_negative = (*next == '-');
+                ++next;
+                state.part = PartExpSign;
+                break;
+            }
+            if (!IsDigit(*next))
+                goto invalid;
+            state.part = PartExpDigits;
+            break;
+
+        case PartExpSign:
+            if (next == last)
+                goto end_of_chunk;
+            if (!IsDigit(*next)) // at least one digit must follow the exponent prefix
+                goto invalid;
+            state.part = PartExpDigits;
+            break;
+
+        case PartExpDigits:
+            while (next != last && IsDigit(*next))
+            {
+                if (state.parsed_exponent <= MaxExp)
+                    state.parsed_exponent = 10 * state.parsed_exponent + DigitValue(*next);
+                ++next;
+            }
+            if (next == last)
+                goto end_of_chunk;
+            goto finish;
+        }
+    }
+
+finish:
+    result.next = next;
+    result.status = ScanNumberStatus::ok;
+    result.exponent = state.exponent + (state.exponent_is_negative ? -state.parsed_exponent : state.parsed_exponent);
+    return result;
+
+end_of_chunk:
+    result.next = next;
+    if (is_last_chunk)
+    {
+        // A number may only end inside one of the digit runs.
+        switch (static_cast<Part>(state.part))
+        {
+        case PartIntZero:
+        case PartIntDigits:
+        case PartFracDigits:
+        case PartExpDigits:
+            goto finish;
+        default:
+            goto invalid;
+        }
+    }
+    return result;
+
+invalid:
+    result.next = next;
+    result.status = ScanNumberStatus::invalid;
+    return result;
+}
+
+ScanNumberResult drachennest::ScanNumber(const char* next, const char* last)
+{
+    ScanNumberState state;
+    return ScanNumber(state, next, last, /*is_last_chunk*/ true);
+}
+
+//==================================================================================================
+// ScanNumberMany
+//==================================================================================================
+
+static inline bool IsNumberChar(char ch, char separator)
+{
+    return IsDigit(ch) || ch == '.' || ch == '+' || ch == '-' || ch == 'e' || ch == 'E' || ch == separator;
+}
+
+// Returns the first character of [next, last) that is not in the number alphabet (digits,
+// '.', '+', '-', 'e', 'E', separator), or last if there is none.
+static inline const char* ClassifyChars(const char* next, const char* last, char separator)
+{
+#if SN_SIMD_CLASSIFY
+    // All characters involved are ASCII (< 0x80), so the signed 8-bit comparisons below are
+    // exact for them; bytes >= 0x80 compare as negative and correctly fail every test.
+    const __m128i digit_lo = _mm_set1_epi8('0' - 1);
+    const __m128i digit_hi = _mm_set1_epi8('9' + 1);
+    const __m128i dot = _mm_set1_epi8('.');
+    const __m128i plus = _mm_set1_epi8('+');
+    const __m128i minus = _mm_set1_epi8('-');
+    const __m128i e_lower = _mm_set1_epi8('e');
+    const __m128i e_upper = _mm_set1_epi8('E');
+    const __m128i sep = _mm_set1_epi8(separator);
+
+    for ( ; last - next >= 16; next += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(next));
+
+        const __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(chunk, digit_lo), _mm_cmplt_epi8(chunk, digit_hi));
+        const __m128i is_punct = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, dot), _mm_cmpeq_epi8(chunk, sep)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, plus), _mm_cmpeq_epi8(chunk, minus)));
+        const __m128i is_exp = _mm_or_si128(_mm_cmpeq_epi8(chunk, e_lower), _mm_cmpeq_epi8(chunk, e_upper));
+
+        const uint32_t ok = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(is_digit, is_punct), is_exp)));
+        if (ok != 0xFFFF)
+        {
+            // Locate the offending character in this chunk.
+            while (IsNumberChar(*next, separator))
+                ++next;
+            return next;
+        }
+    }
+#endif
+
+    for ( ; next != last; ++next)
+    {
+        if (!IsNumberChar(*next, separator))
+            break;
+    }
+    return next;
+}
+
+drachennest::ScanNumberManyResult drachennest::ScanNumberMany(const char* first, const char* last, char separator, ScanNumberToken* tokens, size_t max_count)
+{
+    SN_ASSERT(first <= last);
+    SN_ASSERT(last - first <= INT32_MAX);
+
+    // The alphabet pass over the whole buffer: hostile garbage fails here, 16 characters
+    // per step, without ever reaching the per-token grammar below.
+    const char* const bad = ClassifyChars(first, last, separator);
+    if (bad != last)
+        return {bad, 0, ScanNumberStatus::invalid};
+
+    const char* next = first;
+    size_t count = 0;
+
+    while (next != last && count < max_count)
+    {
+        // The token extends to the next separator.
+        const char* token_last = last;
+        const void* const sep = std::memchr(next, separator, static_cast<size_t>(last - next));
+        if (sep != nullptr)
+            token_last = static_cast<const char*>(sep);
+
+        const auto scan = ScanNumber(next, token_last);
+        if (scan.status != ScanNumberStatus::ok || scan.next != token_last)
+            return {scan.next, count, ScanNumberStatus::invalid};
+
+        tokens[count++] = {static_cast<int32_t>(next - first), static_cast<int32_t>(token_last - first)};
+        if (token_last == last)
+            return {last, count, ScanNumberStatus::ok};
+
+        next = token_last + 1;
+        if (next == last) // a trailing separator leaves an empty final token
+            return {last, count, ScanNumberStatus::invalid};
+    }
+
+    return {next, count, ScanNumberStatus::ok};
+}
@@ -0,0 +1,106 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace drachennest {
+
+// ScanNumber decomposes a number in RFC 8259 (JSON) format into its significant digit runs and
+// a decimal exponent, without copying and without allocating: the digit runs are returned as
+// pointers into the input buffer.
+//
+// The number described by a sequence of results is
+//
+//  +-0.D * 10^exponent
+//
+// where D is the concatenation of all integer and fraction digits reported (leading zeros are
+// skipped, not reported), 'exponent' is taken from the final (status == ok) result, and the sign
+// is 'is_negative'. The digit runs may contain trailing zeros.
+//
+// The scanner is resumable: if the input ends in the middle of a number (status == incomplete),
+// the scan may be continued on the next chunk of input with the same state object, and only the
+// new characters are examined. Each result only refers to digits in the chunk passed to that
+// call, so the caller may release the previous buffer between calls.
+//
+// On failure (status == invalid), 'next' points at the offending character.
+
+enum class ScanNumberStatus {
+    invalid,    // The input is not a number; 'next' is the error position.
+    ok,         // A complete number was scanned; 'next' is the first character after it.
+    incomplete, // The chunk ended inside the number; resume with the next chunk.
+};
+
+struct ScanNumberState {
+    int64_t exponent;           // (internal) minus the number of fraction digits seen so far
+    int64_t parsed_exponent;    // (internal) value of the explicit exponent seen so far
+    bool is_negative;
+    bool exponent_is_negative;  // (internal)
+    bool significant_digits;    // (internal) seen a non-zero digit yet?
+    uint8_t part;               // (internal) position in the grammar
+
+    constexpr ScanNumberState()
+        : exponent(0)
+        , parsed_exponent(0)
+        , is_negative(false)
+        , exponent_is_negative(false)
+        , significant_digits(false)
+        , part(0)
+    {
+    }
+};
+
+struct ScanNumberResult {
+    const char* next;
+    ScanNumberStatus status;
+    const char* integer_digits;  // integer digits in this chunk: [integer_digits, integer_end)
+    const char* integer_end;
+    const char* fraction_digits; // fraction digits in this chunk: [fraction_digits, fraction_end)
+    const char* fraction_end;
+    int64_t exponent;            // valid iff status == ok
+    bool is_negative;
+};
+
+ScanNumberResult ScanNumber(ScanNumberState& state, const char* next, const char* last, bool is_last_chunk);
+
+// Convenience overload for input that is available in a single buffer.
+ScanNumberResult ScanNumber(const char* next, const char* last);
+
+// ScanNumberManyResult res = ScanNumberMany(first, last, separator, tokens, max_count);
+//
+// Validation stage of the two-stage bulk parse for untrusted input: checks that
+// [first, last) consists of separator-joined numbers (the grammar above) and records their
+// extents, without converting anything. Conversion then runs over the recorded tokens only
+// (ryu::StrtodValidated), so invalid input never pays a conversion-path cost and the
+// conversion loop never sees a validation failure.
+//
+// The buffer is first classified 16 characters at a time (on SSE2 targets): a single byte
+// outside the number alphabet -- digits, '.', '+', '-', 'e', 'E' and the separator --
+// rejects the input at memory speed, before any per-token work. Only then is the structure
+// of each token (digit runs, dot/exponent placement) checked with the grammar.
+//
+// On success, next == last (or, if there are more than max_count tokens, the start of the
+// first unrecorded token -- validate the rest with another call). On failure, next points
+// at the offending character and count is the number of tokens validated before it.
+//
+// PRE: the buffer must not be longer than INT32_MAX characters (the token extents are
+// int32 offsets).
+
+struct ScanNumberToken {
+    int32_t first; // token i is [buffer + first, buffer + last)
+    int32_t last;
+};
+
+struct ScanNumberManyResult {
+    const char* next;
+    size_t count;
+    ScanNumberStatus status; // ok or invalid (never incomplete)
+};
+
+ScanNumberManyResult ScanNumberMany(const char* first, const char* last, char separator, ScanNumberToken* tokens, size_t max_count);
+
+} // namespace drachennest
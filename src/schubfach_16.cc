@@ -0,0 +1,588 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "schubfach_16.h"
+
+#include "itoa.h"
+
+//--------------------------------------------------------------------------------------------------
+// This file contains an implementation of the Schubfach algorithm as described in
+//
+// [1] Raffaello Giulietti, "The Schubfach way to render doubles",
+//     https://drive.google.com/open?id=1luHhyQF9zKlM8yJ1nebU0OgVYhfC6CBN
+//
+// specialized for the 16-bit formats IEEE binary16 ("half") and bfloat16. With at most 11
+// significand bits, all intermediate products fit into 64 bits and the pow10 significands fit
+// into 32 bits, so the whole computation runs in 32-bit arithmetic (plus one 32x32-bit multiply).
+//--------------------------------------------------------------------------------------------------
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#ifndef SF_ASSERT
+#define SF_ASSERT(X) assert(X)
+#endif
+
+//==================================================================================================
+//
+//==================================================================================================
+
+// Returns floor(x / 2^n).
+//
+// Technically, right-shift of negative integers is implementation defined...
+// Should easily be optimized into SAR (or equivalent) instruction.
+static inline int32_t FloorDivPow2(int32_t x, int32_t n)
+{
+#if 0
+    return x < 0 ? ~(~x >> n) : (x >> n);
+#else
+    return x >> n;
+#endif
+}
+
+// Returns floor(log_2(10^e))
+static inline int32_t FloorLog2Pow10(int32_t e)
+{
+    SF_ASSERT(e >= -1233);
+    SF_ASSERT(e <=  1233);
+    return FloorDivPow2(e * 1741647, 19);
+}
+
+//==================================================================================================
+//
+//==================================================================================================
+
+namespace {
+struct Binary16
+{
+    // IEEE-754 half-precision: 1 sign bit, 5 exponent bits, 10 significand bits.
+
+    static constexpr int32_t  SignificandSize = 11;                       // = p   (includes the hidden bit)
+    static constexpr int32_t  ExponentBias    = 16 - 1 + (SignificandSize - 1);
+    static constexpr uint32_t MaxIeeeExponent = 31;
+    static constexpr uint32_t HiddenBit       = uint32_t{1} << (SignificandSize - 1);
+    static constexpr uint32_t SignificandMask = HiddenBit - 1;
+    static constexpr uint32_t ExponentMask    = MaxIeeeExponent << (SignificandSize - 1);
+    static constexpr uint32_t SignMask        = 0x8000u;
+
+    // For binary16, q is in [-24, 5], so k = floor(log_10(2^q)) is in [-8, 1].
+    // The whole table occupies 40 bytes.
+    static uint32_t ComputePow10(int32_t k)
+    {
+        // There are unique beta and r such that 10^k = beta 2^r and
+        // 2^31 <= beta < 2^32, namely r = floor(log_2 10^k) - 31 and
+        // beta = 2^-r 10^k.
+        // Let g = ceil(beta), so (g-1) 2^r < 10^k <= g 2^r, with the latter
+        // value being a pretty good overestimate for 10^k.
+
+        static constexpr int32_t kMin = -1;
+        static constexpr int32_t kMax =  8;
+        static constexpr uint32_t g[kMax - kMin + 1] = {
+            0xCCCCCCCD, //  -1
+            0x80000000, //   0
+            0xA0000000, //   1
+            0xC8000000, //   2
+            0xFA000000, //   3
+            0x9C400000, //   4
+            0xC3500000, //   5
+            0xF4240000, //   6
+            0x98968000, //   7
+            0xBEBC2000, //   8
+        };
+
+        SF_ASSERT(k >= kMin);
+        SF_ASSERT(k <= kMax);
+        return g[static_cast<uint32_t>(k - kMin)];
+    }
+};
+
+struct BFloat16
+{
+    // bfloat16: 1 sign bit, 8 exponent bits, 7 significand bits.
+
+    static constexpr int32_t  SignificandSize = 8;                        // = p   (includes the hidden bit)
+    static constexpr int32_t  ExponentBias    = 128 - 1 + (SignificandSize - 1);
+    static constexpr uint32_t MaxIeeeExponent = 255;
+    static constexpr uint32_t HiddenBit       = uint32_t{1} << (SignificandSize - 1);
+    static constexpr uint32_t SignificandMask = HiddenBit - 1;
+    static constexpr uint32_t ExponentMask    = MaxIeeeExponent << (SignificandSize - 1);
+    static constexpr uint32_t SignMask        = 0x8000u;
+
+    // bfloat16 shares float's 8-bit exponent range, so its table must cover k in [-41, 36].
+    static uint32_t ComputePow10(int32_t k)
+    {
+        // (See Binary16::ComputePow10 above.)
+
+        static constexpr int32_t kMin = -36;
+        static constexpr int32_t kMax =  41;
+        static constexpr uint32_t g[kMax - kMin + 1] = {
+            0xAA24249A, // -36
+            0xD4AD2DC0, // -35
+            0x84EC3C98, // -34
+            0xA6274BBE, // -33
+            0xCFB11EAE, // -32
+            0x81CEB32D, // -31
+            0xA2425FF8, // -30
+            0xCAD2F7F6, // -29
+            0xFD87B5F3, // -28
+            0x9E74D1B8, // -27
+            0xC6120626, // -26
+            0xF79687AF, // -25
+            0x9ABE14CE, // -24
+            0xC16D9A01, // -23
+            0xF1C90081, // -22
+            0x971DA051, // -21
+            0xBCE50865, // -20
+            0xEC1E4A7E, // -19
+            0x9392EE8F, // -18
+            0xB877AA33, // -17
+            0xE69594BF, // -16
+            0x901D7CF8, // -15
+            0xB424DC36, // -14
+            0xE12E1343, // -13
+            0x8CBCCC0A, // -12
+            0xAFEBFF0C, // -11
+            0xDBE6FECF, // -10
+            0x89705F42, //  -9
+            0xABCC7712, //  -8
+            0xD6BF94D6, //  -7
+            0x8637BD06, //  -6
+            0xA7C5AC48, //  -5
+            0xD1B71759, //  -4
+            0x83126E98, //  -3
+            0xA3D70A3E, //  -2
+            0xCCCCCCCD, //  -1
+            0x80000000, //   0
+            0xA0000000, //   1
+            0xC8000000, //   2
+            0xFA000000, //   3
+            0x9C400000, //   4
+            0xC3500000, //   5
+            0xF4240000, //   6
+            0x98968000, //   7
+            0xBEBC2000, //   8
+            0xEE6B2800, //   9
+            0x9502F900, //  10
+            0xBA43B740, //  11
+            0xE8D4A510, //  12
+            0x9184E72A, //  13
+            0xB5E620F5, //  14
+            0xE35FA932, //  15
+            0x8E1BC9C0, //  16
+            0xB1A2BC2F, //  17
+            0xDE0B6B3B, //  18
+            0x8AC72305, //  19
+            0xAD78EBC6, //  20
+            0xD8D726B8, //  21
+            0x87867833, //  22
+            0xA9681640, //  23
+            0xD3C21BCF, //  24
+            0x84595162, //  25
+            0xA56FA5BA, //  26
+            0xCECB8F28, //  27
+            0x813F3979, //  28
+            0xA18F07D8, //  29
+            0xC9F2C9CE, //  30
+            0xFC6F7C41, //  31
+            0x9DC5ADA9, //  32
+            0xC5371913, //  33
+            0xF684DF57, //  34
+            0x9A130B97, //  35
+            0xC097CE7C, //  36
+            0xF0BDC21B, //  37
+            0x96769951, //  38
+            0xBC143FA5, //  39
+            0xEB194F8F, //  40
+            0x92EFD1B9, //  41
+        };
+
+        SF_ASSERT(k >= kMin);
+        SF_ASSERT(k <= kMax);
+        return g[static_cast<uint32_t>(k - kMin)];
+    }
+};
+} // namespace
+
+//==================================================================================================
+//
+//==================================================================================================
+
+static inline uint32_t Lo32(uint64_t x)
+{
+    return static_cast<uint32_t>(x);
+}
+
+static inline uint32_t Hi32(uint64_t x)
+{
+    return static_cast<uint32_t>(x >> 32);
+}
+
+static inline uint32_t RoundToOdd(uint32_t g, uint32_t cp)
+{
+    const uint64_t p = uint64_t{g} * cp;
+
+    // Since g = ceil(beta), the product overestimates beta * cp by less than cp < 2^17. Discard
+    // the low 17 bits, where this error lives, before testing the fractional part for the
+    // round-to-odd bit. (This mirrors the 96-bit product in schubfach_32, which drops its low
+    // 32 bits for the same reason.)
+    const uint32_t y1 = Hi32(p);
+    const uint32_t y0 = Lo32(p) >> 17;
+
+    return y1 | (y0 > 1);
+}
+
+// Returns whether value is divisible by 2^e2
+static inline bool MultipleOfPow2(uint32_t value, int32_t e2)
+{
+    SF_ASSERT(e2 >= 0);
+    SF_ASSERT(e2 <= 31);
+    return (value & ((uint32_t{1} << e2) - 1)) == 0;
+}
+
+namespace {
+struct FloatingDecimal16 {
+    uint32_t digits; // num_digits <= 5
+    int32_t exponent;
+};
+}
+
+template <typename Fp16>
+static inline FloatingDecimal16 ToDecimal16(uint32_t ieee_significand, uint32_t ieee_exponent)
+{
+    uint32_t c;
+    int32_t q;
+    if (ieee_exponent != 0)
+    {
+        c = Fp16::HiddenBit | ieee_significand;
+        q = static_cast<int32_t>(ieee_exponent) - Fp16::ExponentBias;
+
+        if (0 <= -q && -q < Fp16::SignificandSize && MultipleOfPow2(c, -q))
+        {
+            return {c >> -q, 0};
+        }
+    }
+    else
+    {
+        c = ieee_significand;
+        q = 1 - Fp16::ExponentBias;
+    }
+
+    const bool is_even = (c % 2 == 0);
+    const bool accept_lower = is_even;
+    const bool accept_upper = is_even;
+
+    const bool lower_boundary_is_closer = (ieee_significand == 0 && ieee_exponent > 1);
+
+//  const int32_t qb = q - 2;
+    const uint32_t cbl = 4 * c - 2 + lower_boundary_is_closer;
+    const uint32_t cb  = 4 * c;
+    const uint32_t cbr = 4 * c + 2;
+
+    // (q * 1262611         ) >> 22 == floor(log_10(    2^q))
+    // (q * 1262611 - 524031) >> 22 == floor(log_10(3/4 2^q))
+    SF_ASSERT(q >= -1500);
+    SF_ASSERT(q <=  1500);
+    const int32_t k = FloorDivPow2(q * 1262611 - (lower_boundary_is_closer ? 524031 : 0), 22);
+
+    const int32_t h = q + FloorLog2Pow10(-k) + 1;
+    SF_ASSERT(h >= 1);
+    SF_ASSERT(h <= 4);
+
+    const uint32_t pow10 = Fp16::ComputePow10(-k);
+    const uint32_t vbl = RoundToOdd(pow10, cbl << h);
+    const uint32_t vb  = RoundToOdd(pow10, cb  << h);
+    const uint32_t vbr = RoundToOdd(pow10, cbr << h);
+
+    const uint32_t lower = vbl + !accept_lower;
+    const uint32_t upper = vbr - !accept_upper;
+
+    // See Figure 4 in [1].
+    // And the modifications in Figure 6.
+
+    const uint32_t s = vb / 4; // NB: 4 * s == vb & ~3 == vb & -4
+
+    if (s >= 10) // vb >= 40
+    {
+        const uint32_t sp = s / 10; // = vb / 40
+        const bool up_inside = lower <= 40 * sp;
+        const bool wp_inside =          40 * sp + 40 <= upper;
+//      if (up_inside || wp_inside) // NB: At most one of u' and w' is in R_v.
+        if (up_inside != wp_inside)
+        {
+            return {sp + wp_inside, k + 1};
+        }
+    }
+
+    const bool u_inside = lower <= 4 * s;
+    const bool w_inside =          4 * s + 4 <= upper;
+    if (u_inside != w_inside)
+    {
+        return {s + w_inside, k};
+    }
+
+    // NB: s & 1 == vb & 0x4
+    const uint32_t mid = 4 * s + 2; // = 2(s + t)
+    const bool round_up = vb > mid || (vb == mid && (s & 1) != 0);
+
+    return {s + round_up, k};
+}
+
+//==================================================================================================
+// ToChars
+//==================================================================================================
+
+// The digit pairs table and the low-level digit printers are shared by all engines, see
+// itoa.h.
+using drachennest::itoa::Utoa_2Digits;
+using drachennest::itoa::TrailingZeros_2Digits;
+
+
+static inline int32_t PrintDecimalDigitsBackwards(char* buf, uint32_t output)
+{
+    int32_t tz = 0; // number of trailing zeros removed.
+    int32_t nd = 0; // number of decimal digits processed.
+
+    // At most 5 digits remaining.
+
+    if (output >= 100)
+    {
+        const uint32_t q = output / 100;
+        const uint32_t r = output % 100;
+        output = q;
+        buf -= 2;
+        Utoa_2Digits(buf, r);
+        tz = TrailingZeros_2Digits(r);
+        nd = 2;
+
+        if (output >= 100)
+        {
+            const uint32_t q2 = output / 100;
+            const uint32_t r2 = output % 100;
+            output = q2;
+            buf -= 2;
+            Utoa_2Digits(buf, r2);
+            if (tz == nd)
+            {
+                tz += TrailingZeros_2Digits(r2);
+            }
+            nd += 2;
+        }
+    }
+
+    // At most 2 digits remaining.
+
+    SF_ASSERT(output >= 1);
+    SF_ASSERT(output <= 99);
+
+    if (output >= 10)
+    {
+        const uint32_t q = output;
+        buf -= 2;
+        Utoa_2Digits(buf, q);
+        if (tz == nd)
+        {
+            tz += TrailingZeros_2Digits(q);
+        }
+//      nd += 2;
+    }
+    else
+    {
+        const uint32_t q = output;
+        SF_ASSERT(q >= 1);
+        SF_ASSERT(q <= 9);
+        *--buf = static_cast<char>('0' + q);
+    }
+
+    return tz;
+}
+
+static inline int32_t DecimalLength(uint32_t v)
+{
+    SF_ASSERT(v >= 1);
+    SF_ASSERT(v <= 99999u);
+
+    if (v >= 10000u) { return 5; }
+    if (v >= 1000u) { return 4; }
+    if (v >= 100u) { return 3; }
+    if (v >= 10u) { return 2; }
+    return 1;
+}
+
+static inline char* FormatDigits(char* buffer, uint32_t digits, int32_t decimal_exponent, bool force_trailing_dot_zero = false)
+{
+    static constexpr int32_t MinFixedDecimalPoint = -4;
+    static constexpr int32_t MaxFixedDecimalPoint =  9;
+    static_assert(MinFixedDecimalPoint <= -1, "internal error");
+    static_assert(MaxFixedDecimalPoint >=  1, "internal error");
+
+    SF_ASSERT(digits >= 1);
+    SF_ASSERT(digits <= 99999u);
+    SF_ASSERT(decimal_exponent >= -99);
+    SF_ASSERT(decimal_exponent <=  99);
+
+    int32_t num_digits = DecimalLength(digits);
+    const int32_t decimal_point = num_digits + decimal_exponent;
+
+    const bool use_fixed = MinFixedDecimalPoint <= decimal_point && decimal_point <= MaxFixedDecimalPoint;
+
+    // Prepare the buffer.
+    // Avoid calling memset/memcpy with variable arguments below...
+
+    // A single 16-character fill covers every layout: at most 5 digits starting at
+    // position 2 - MinFixedDecimalPoint = 6, and the digit-splitting move below touches at
+    // most position 13. Together with the sign this keeps the write extent within
+    // HtoaMinBufferLength (the 32-character fill inherited from schubfach_32 overflowed
+    // the promised bound by one for negative values).
+    std::memset(buffer, '0', 16);
+    static_assert(2 - MinFixedDecimalPoint <= 15, "internal error");
+    static_assert(MaxFixedDecimalPoint <= 15, "internal error");
+
+    int32_t decimal_digits_position;
+    if (use_fixed)
+    {
+        if (decimal_point <= 0)
+        {
+            // 0.[000]digits
+            decimal_digits_position = 2 - decimal_point;
+        }
+        else
+        {
+            // dig.its
+            // digits[000]
+            decimal_digits_position = 0;
+        }
+    }
+    else
+    {
+        // dE+123 or d.igitsE+123
+        decimal_digits_position = 1;
+    }
+
+    char* digits_end = buffer + decimal_digits_position + num_digits;
+
+    const int32_t tz = PrintDecimalDigitsBackwards(digits_end, digits);
+    digits_end -= tz;
+    num_digits -= tz;
+//  decimal_exponent += tz; // => decimal_point unchanged.
+
+    if (use_fixed)
+    {
+        if (decimal_point <= 0)
+        {
+            // 0.[000]digits
+            buffer[1] = '.';
+            buffer = digits_end;
+        }
+        else if (decimal_point < num_digits)
+        {
+            // dig.its
+            std::memmove(buffer + decimal_point + 1, buffer + decimal_point, 8);
+            buffer[decimal_point] = '.';
+            buffer = digits_end + 1;
+        }
+        else
+        {
+            // digits[000]
+            buffer += decimal_point;
+            if (force_trailing_dot_zero)
+            {
+                std::memcpy(buffer, ".0", 2);
+                buffer += 2;
+            }
+        }
+    }
+    else
+    {
+        buffer[0] = buffer[1];
+        if (num_digits == 1)
+        {
+            // dE+123
+            ++buffer;
+        }
+        else
+        {
+            // d.igitsE+123
+            buffer[1] = '.';
+            buffer = digits_end;
+        }
+
+        const int32_t scientific_exponent = decimal_point - 1;
+//      SF_ASSERT(scientific_exponent != 0);
+
+        std::memcpy(buffer, scientific_exponent < 0 ? "e-" : "e+", 2);
+        buffer += 2;
+
+        const uint32_t k = static_cast<uint32_t>(scientific_exponent < 0 ? -scientific_exponent : scientific_exponent);
+        if (k < 10)
+        {
+            *buffer++ = static_cast<char>('0' + k);
+        }
+        else
+        {
+            Utoa_2Digits(buffer, k);
+            buffer += 2;
+        }
+    }
+
+    return buffer;
+}
+
+template <typename Fp16>
+static inline char* ToChars16(char* buffer, uint32_t bits, bool force_trailing_dot_zero = false)
+{
+    const uint32_t significand = bits & Fp16::SignificandMask;
+    const uint32_t exponent = (bits & Fp16::ExponentMask) >> (Fp16::SignificandSize - 1);
+
+    if (exponent != Fp16::MaxIeeeExponent) // [[likely]]
+    {
+        // Finite
+
+        buffer[0] = '-';
+        buffer += (bits & Fp16::SignMask) != 0;
+
+        if (exponent != 0 || significand != 0) // [[likely]]
+        {
+            // != 0
+
+            const auto dec = ToDecimal16<Fp16>(significand, exponent);
+            return FormatDigits(buffer, dec.digits, dec.exponent, force_trailing_dot_zero);
+        }
+        else
+        {
+            std::memcpy(buffer, "0.0 ", 4);
+            buffer += force_trailing_dot_zero ? 3 : 1;
+            return buffer;
+        }
+    }
+
+    if (significand == 0)
+    {
+        buffer[0] = '-';
+        buffer += (bits & Fp16::SignMask) != 0;
+
+        std::memcpy(buffer, "inf ", 4);
+        return buffer + 3;
+    }
+    else
+    {
+        std::memcpy(buffer, "nan ", 4);
+        return buffer + 3;
+    }
+}
+
+//==================================================================================================
+//
+//==================================================================================================
+
+char* schubfach::Htoa(char* buffer, uint16_t binary16_bits)
+{
+    return ToChars16<Binary16>(buffer, binary16_bits);
+}
+
+char* schubfach::Btoa(char* buffer, uint16_t bfloat16_bits)
+{
+    return ToChars16<BFloat16>(buffer, bfloat16_bits);
+}
@@ -0,0 +1,35 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+namespace schubfach {
+
+// char* output_end = Htoa(buffer, bits);
+//
+// Converts the given half-precision number into decimal form and stores the result in the given
+// buffer. Since there is no standard half-precision type, the number is passed as its (IEEE
+// binary16) bit pattern. Btoa interprets the bits as bfloat16 instead.
+//
+// The buffer must be large enough, i.e. >= HtoaMinBufferLength.
+// The output format is similar to printf("%g").
+// The output is _not_ null-terminted.
+//
+// The output is optimal, i.e. the output string
+//  1. rounds back to the input number when read in (using round-to-nearest-even)
+//  2. is as short as possible,
+//  3. is as close to the input number as possible.
+//
+// Note:
+// These functions may temporarily write up to HtoaMinBufferLength characters into the buffer.
+
+constexpr int HtoaMinBufferLength = 32;
+
+char* Htoa(char* buffer, uint16_t binary16_bits);
+char* Btoa(char* buffer, uint16_t bfloat16_bits);
+
+} // namespace schubfach
@@ -5,6 +5,10 @@
 
 #include "schubfach_32.h"
 
+#include "itoa.h"
+
+#include "pow10_cache_32.h"
+
 //--------------------------------------------------------------------------------------------------
 // This file contains an implementation of the Schubfach algorithm as described in
 //
@@ -25,6 +29,13 @@
 #define SF_ASSERT(X) assert(X)
 #endif
 
+// Some targets (e.g. wasm32) offer unsigned __int128 but lower the 64x64->128 multiplies to
+// a libcall; defining DRACHENNEST_NO_INT128=1 (see the cmake option) forces the 32x32->64
+// decomposition instead.
+#ifndef DRACHENNEST_NO_INT128
+#define DRACHENNEST_NO_INT128 0
+#endif
+
 //==================================================================================================
 //
 //==================================================================================================
@@ -149,94 +160,12 @@ static inline uint64_t ComputePow10_Single(int32_t k)
     // Let g = ceil(beta), so (g-1) 2^r < 10^k <= g 2^r, with the latter
     // value being a pretty good overestimate for 10^k.
 
-    // NB: Since for all the required exponents k, we have g < 2^64,
-    //     all constants can be stored in 128-bit integers.
-
-    static constexpr int32_t kMin = -31;
-    static constexpr int32_t kMax =  45;
-    static constexpr uint64_t g[kMax - kMin + 1] = {
-        0x81CEB32C4B43FCF5, // -31
-        0xA2425FF75E14FC32, // -30
-        0xCAD2F7F5359A3B3F, // -29
-        0xFD87B5F28300CA0E, // -28
-        0x9E74D1B791E07E49, // -27
-        0xC612062576589DDB, // -26
-        0xF79687AED3EEC552, // -25
-        0x9ABE14CD44753B53, // -24
-        0xC16D9A0095928A28, // -23
-        0xF1C90080BAF72CB2, // -22
-        0x971DA05074DA7BEF, // -21
-        0xBCE5086492111AEB, // -20
-        0xEC1E4A7DB69561A6, // -19
-        0x9392EE8E921D5D08, // -18
-        0xB877AA3236A4B44A, // -17
-        0xE69594BEC44DE15C, // -16
-        0x901D7CF73AB0ACDA, // -15
-        0xB424DC35095CD810, // -14
-        0xE12E13424BB40E14, // -13
-        0x8CBCCC096F5088CC, // -12
-        0xAFEBFF0BCB24AAFF, // -11
-        0xDBE6FECEBDEDD5BF, // -10
-        0x89705F4136B4A598, //  -9
-        0xABCC77118461CEFD, //  -8
-        0xD6BF94D5E57A42BD, //  -7
-        0x8637BD05AF6C69B6, //  -6
-        0xA7C5AC471B478424, //  -5
-        0xD1B71758E219652C, //  -4
-        0x83126E978D4FDF3C, //  -3
-        0xA3D70A3D70A3D70B, //  -2
-        0xCCCCCCCCCCCCCCCD, //  -1
-        0x8000000000000000, //   0
-        0xA000000000000000, //   1
-        0xC800000000000000, //   2
-        0xFA00000000000000, //   3
-        0x9C40000000000000, //   4
-        0xC350000000000000, //   5
-        0xF424000000000000, //   6
-        0x9896800000000000, //   7
-        0xBEBC200000000000, //   8
-        0xEE6B280000000000, //   9
-        0x9502F90000000000, //  10
-        0xBA43B74000000000, //  11
-        0xE8D4A51000000000, //  12
-        0x9184E72A00000000, //  13
-        0xB5E620F480000000, //  14
-        0xE35FA931A0000000, //  15
-        0x8E1BC9BF04000000, //  16
-        0xB1A2BC2EC5000000, //  17
-        0xDE0B6B3A76400000, //  18
-        0x8AC7230489E80000, //  19
-        0xAD78EBC5AC620000, //  20
-        0xD8D726B7177A8000, //  21
-        0x878678326EAC9000, //  22
-        0xA968163F0A57B400, //  23
-        0xD3C21BCECCEDA100, //  24
-        0x84595161401484A0, //  25
-        0xA56FA5B99019A5C8, //  26
-        0xCECB8F27F4200F3A, //  27
-        0x813F3978F8940985, //  28
-        0xA18F07D736B90BE6, //  29
-        0xC9F2C9CD04674EDF, //  30
-        0xFC6F7C4045812297, //  31
-        0x9DC5ADA82B70B59E, //  32
-        0xC5371912364CE306, //  33
-        0xF684DF56C3E01BC7, //  34
-        0x9A130B963A6C115D, //  35
-        0xC097CE7BC90715B4, //  36
-        0xF0BDC21ABB48DB21, //  37
-        0x96769950B50D88F5, //  38
-        0xBC143FA4E250EB32, //  39
-        0xEB194F8E1AE525FE, //  40
-        0x92EFD1B8D0CF37BF, //  41
-        0xB7ABC627050305AE, //  42
-        0xE596B7B0C643C71A, //  43
-        0x8F7E32CE7BEA5C70, //  44
-        0xB35DBF821AE4F38C, //  45
-    };
-
-    SF_ASSERT(k >= kMin);
-    SF_ASSERT(k <= kMax);
-    return g[static_cast<uint32_t>(k - kMin)];
+    // NB: The table is shared with dragonbox_32; see pow10_cache_32.h.
+
+    SF_ASSERT(k >= pow10cache::kMinDecimalExponent32);
+    SF_ASSERT(k <= 45);
+
+    return pow10cache::GetPow10Significand32(k);
 }
 
 static inline uint32_t Lo32(uint64_t x)
@@ -249,7 +178,7 @@ static inline uint32_t Hi32(uint64_t x)
     return static_cast<uint32_t>(x >> 32);
 }
 
-#if defined(__SIZEOF_INT128__)
+#if defined(__SIZEOF_INT128__) && !DRACHENNEST_NO_INT128
 
 static inline uint32_t RoundToOdd(uint64_t g, uint32_t cp)
 {
@@ -307,6 +236,39 @@ struct FloatingDecimal32 {
 };
 }
 
+// The digit-selection tail of ToDecimal32: picks the shortest representation in the rounding
+// interval [lower, upper] around vb. (See Figure 4 in [1], and the modifications in
+// Figure 6.) Shared with the batch conversion below.
+static inline FloatingDecimal32 SelectShortest(uint32_t vb, uint32_t lower, uint32_t upper, int32_t k)
+{
+    const uint32_t s = vb / 4; // NB: 4 * s == vb & ~3 == vb & -4
+
+    if (s >= 10) // vb >= 40
+    {
+        const uint32_t sp = s / 10; // = vb / 40
+        const bool up_inside = lower <= 40 * sp;
+        const bool wp_inside =          40 * sp + 40 <= upper;
+//      if (up_inside || wp_inside) // NB: At most one of u' and w' is in R_v.
+        if (up_inside != wp_inside)
+        {
+            return {sp + wp_inside, k + 1};
+        }
+    }
+
+    const bool u_inside = lower <= 4 * s;
+    const bool w_inside =          4 * s + 4 <= upper;
+    if (u_inside != w_inside)
+    {
+        return {s + w_inside, k};
+    }
+
+    // NB: s & 1 == vb & 0x4
+    const uint32_t mid = 4 * s + 2; // = 2(s + t)
+    const bool round_up = vb > mid || (vb == mid && (s & 1) != 0);
+
+    return {s + round_up, k};
+}
+
 static inline FloatingDecimal32 ToDecimal32(uint32_t ieee_significand, uint32_t ieee_exponent)
 {
     uint32_t c;
@@ -356,78 +318,18 @@ static inline FloatingDecimal32 ToDecimal32(uint32_t ieee_significand, uint32_t
     const uint32_t lower = vbl + !accept_lower;
     const uint32_t upper = vbr - !accept_upper;
 
-    // See Figure 4 in [1].
-    // And the modifications in Figure 6.
-
-    const uint32_t s = vb / 4; // NB: 4 * s == vb & ~3 == vb & -4
-
-    if (s >= 10) // vb >= 40
-    {
-        const uint32_t sp = s / 10; // = vb / 40
-        const bool up_inside = lower <= 40 * sp;
-        const bool wp_inside =          40 * sp + 40 <= upper;
-//      if (up_inside || wp_inside) // NB: At most one of u' and w' is in R_v.
-        if (up_inside != wp_inside)
-        {
-            return {sp + wp_inside, k + 1};
-        }
-    }
-
-    const bool u_inside = lower <= 4 * s;
-    const bool w_inside =          4 * s + 4 <= upper;
-    if (u_inside != w_inside)
-    {
-        return {s + w_inside, k};
-    }
-
-    // NB: s & 1 == vb & 0x4
-    const uint32_t mid = 4 * s + 2; // = 2(s + t)
-    const bool round_up = vb > mid || (vb == mid && (s & 1) != 0);
-
-    return {s + round_up, k};
+    return SelectShortest(vb, lower, upper, k);
 }
 
 //==================================================================================================
 // ToChars
 //==================================================================================================
 
-static inline void Utoa_2Digits(char* buf, uint32_t digits)
-{
-    static constexpr char Digits100[200] = {
-        '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
-        '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
-        '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
-        '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
-        '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
-        '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
-        '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
-        '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
-        '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
-        '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
-    };
-
-    SF_ASSERT(digits <= 99);
-    std::memcpy(buf, &Digits100[2 * digits], 2);
-}
+// The digit pairs table and the low-level digit printers are shared by all engines, see
+// itoa.h.
+using drachennest::itoa::Utoa_2Digits;
+using drachennest::itoa::TrailingZeros_2Digits;
 
-static inline int32_t TrailingZeros_2Digits(uint32_t digits)
-{
-    static constexpr int8_t TrailingZeros100[100] = {
-        2, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    };
-
-    SF_ASSERT(digits <= 99);
-    return TrailingZeros100[digits];
-}
 
 static inline int32_t PrintDecimalDigitsBackwards(char* buf, uint32_t output)
 {
@@ -698,3 +600,117 @@ char* schubfach::Ftoa(char* buffer, float value)
 {
     return ToChars(buffer, value);
 }
+
+//==================================================================================================
+// ToDecimal32Batch
+//==================================================================================================
+
+static inline void StoreDecimal32(FloatingDecimal32 dec, size_t i, uint32_t* digits, int8_t* exponents, uint8_t* lengths)
+{
+    SF_ASSERT(dec.exponent >= -46);
+    SF_ASSERT(dec.exponent <= 32);
+
+    digits[i] = dec.digits;
+    exponents[i] = static_cast<int8_t>(dec.exponent);
+    lengths[i] = static_cast<uint8_t>(DecimalLength(dec.digits));
+}
+
+void schubfach::ToDecimal32Batch(const float* values, size_t count, uint32_t* digits, int8_t* exponents, uint8_t* lengths)
+{
+    size_t i = 0;
+
+    // Process groups of four values in lockstep. Everything here is 32-bit (only the pow10
+    // entries and the RoundToOdd products are 64-bit), so all four lanes stay in registers:
+    // the four cache loads issue back to back and the multiply chains of the lanes overlap,
+    // hiding most of their latency. Lanes that take the small-integer shortcut produce their
+    // (trivial) result in the setup pass and skip the arithmetic, which then runs on
+    // placeholder values for them.
+    while (count - i >= 4)
+    {
+        uint32_t cb[4];
+        uint32_t cbl[4];
+        uint32_t cbr[4];
+        int32_t k[4];
+        int32_t h[4];
+        bool is_even[4];
+        uint32_t shortcut_lanes = 0;
+
+        for (int n = 0; n < 4; ++n)
+        {
+            const Single v(values[i + n]);
+            SF_ASSERT(v.IsFinite());
+            SF_ASSERT(!v.IsZero());
+
+            const uint32_t ieee_significand = v.PhysicalSignificand();
+            const uint32_t ieee_exponent = v.PhysicalExponent();
+
+            uint32_t c;
+            int32_t q;
+            if (ieee_exponent != 0)
+            {
+                c = Single::HiddenBit | ieee_significand;
+                q = static_cast<int32_t>(ieee_exponent) - Single::ExponentBias;
+
+                if (0 <= -q && -q < Single::SignificandSize && MultipleOfPow2(c, -q))
+                {
+                    shortcut_lanes |= 1u << n;
+                    StoreDecimal32({c >> -q, 0}, i + n, digits, exponents, lengths);
+
+                    cb[n] = 4;
+                    cbl[n] = 2;
+                    cbr[n] = 6;
+                    k[n] = 0;
+                    h[n] = 1;
+                    is_even[n] = true;
+                    continue;
+                }
+            }
+            else
+            {
+                c = ieee_significand;
+                q = 1 - Single::ExponentBias;
+            }
+
+            const bool lower_boundary_is_closer = (ieee_significand == 0 && ieee_exponent > 1);
+
+            is_even[n] = (c % 2 == 0);
+            cbl[n] = 4 * c - 2 + lower_boundary_is_closer;
+            cb[n]  = 4 * c;
+            cbr[n] = 4 * c + 2;
+            k[n] = FloorDivPow2(q * 1262611 - (lower_boundary_is_closer ? 524031 : 0), 22);
+            h[n] = q + FloorLog2Pow10(-k[n]) + 1;
+        }
+
+        uint64_t pow10[4];
+        for (int n = 0; n < 4; ++n)
+        {
+            pow10[n] = ComputePow10_Single(-k[n]);
+        }
+
+        for (int n = 0; n < 4; ++n)
+        {
+            if (shortcut_lanes & (1u << n))
+                continue;
+
+            const uint32_t vbl = RoundToOdd(pow10[n], cbl[n] << h[n]);
+            const uint32_t vb  = RoundToOdd(pow10[n], cb[n]  << h[n]);
+            const uint32_t vbr = RoundToOdd(pow10[n], cbr[n] << h[n]);
+
+            const uint32_t lower = vbl + !is_even[n];
+            const uint32_t upper = vbr - !is_even[n];
+
+            StoreDecimal32(SelectShortest(vb, lower, upper, k[n]), i + n, digits, exponents, lengths);
+        }
+
+        i += 4;
+    }
+
+    for (; i < count; ++i)
+    {
+        const Single v(values[i]);
+        SF_ASSERT(v.IsFinite());
+        SF_ASSERT(!v.IsZero());
+
+        StoreDecimal32(ToDecimal32(v.PhysicalSignificand(), v.PhysicalExponent()), i, digits, exponents, lengths);
+    }
+}
@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 namespace schubfach {
 
 // char* output_end = Ftoa(buffer, value);
@@ -28,4 +31,22 @@ constexpr int FtoaMinBufferLength = 32;
 
 char* Ftoa(char* buffer, float value);
 
+// ToDecimal32Batch(values, count, digits, exponents, lengths);
+//
+// Converts the given array of single-precision numbers into decimal form, i.e.
+//  values[i] = +- digits[i] * 10^exponents[i]
+// storing the results as structure-of-arrays: digits[i], exponents[i] and lengths[i] (the
+// number of decimal digits in digits[i], <= 9) describe values[i], ready for downstream
+// vector processing. The digits are optimal in the same sense as for Ftoa, but may carry
+// trailing zeros.
+//
+// Groups of four values are converted in lockstep: the arithmetic is almost entirely
+// 32-bit, so the four lanes stay in registers, their pow10 cache loads issue back to back,
+// and their multiply chains overlap.
+//
+// PRE: all values must be finite and non-zero. The signs are ignored (read them off the
+// input if needed -- decimal sign handling is a downstream concern in SoA form).
+
+void ToDecimal32Batch(const float* values, size_t count, uint32_t* digits, int8_t* exponents, uint8_t* lengths);
+
 } // namespace schubfach
@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
 namespace schubfach {
 
 // char* output_end = Dtoa(buffer, value);
@@ -12,7 +16,7 @@ namespace schubfach {
 // Converts the given double-precision number into decimal form and stores the result in the given
 // buffer.
 //
-// The buffer must be large enough, i.e. >= DtoaMinBufferLength.
+// The buffer must be large enough, i.e. >= DtoaMaxLength.
 // The output format is similar to printf("%g").
 // The output is _not_ null-terminted.
 //
@@ -22,10 +26,213 @@ namespace schubfach {
 //  3. is as close to the input number as possible.
 //
 // Note:
-// This function may temporarily write up to DtoaMinBufferLength characters into the buffer.
+// Dtoa never writes past buffer + DtoaMaxLength, so output slots of exactly DtoaMaxLength
+// characters can be formatted in place, without a bounce buffer.
+
+// The worst case output (and write extent) of Dtoa: a sign, "0." plus six leading zeros (the
+// fixed notation window extends down to 1e-7), and 17 significand digits, e.g.
+//  -0.00000088817841970012523
+constexpr int DtoaMaxLength = 26;
 
-constexpr int DtoaMinBufferLength = 64;
+// Historical name: formatting used to require 64 characters of scratch headroom.
+constexpr int DtoaMinBufferLength = DtoaMaxLength;
 
 char* Dtoa(char* buffer, double value);
 
+// DtoaString s = DtoaStr(value);
+//
+// Like Dtoa, but returns the characters by value: a trivially copyable 32-byte struct
+// holding the (additionally null-terminated) output inline, with no heap allocation. Use
+// this to hand a formatted number to string_view-shaped interfaces (logging, formatting
+// layers) without constructing a std::string per call.
+//
+// DtoaConstexpr (schubfach_constexpr.h) produces the same type at compile time.
+
+struct DtoaString {
+    char chars[DtoaMaxLength + 1];
+    int32_t length;
+
+    constexpr const char* data() const { return chars; }
+    constexpr const char* c_str() const { return chars; }
+    constexpr int32_t size() const { return length; }
+    constexpr std::string_view view() const { return std::string_view(chars, static_cast<size_t>(length)); }
+};
+
+DtoaString DtoaStr(double value);
+
+// char* output_end = DtoaJson(buffer, value, nonfinite, keep_minus_zero);
+//
+// Like Dtoa, but guarantees RFC 8259 (JSON) conformant output for every input. Finite
+// values format exactly as with Dtoa -- its output already fits the JSON number grammar
+// (a digit before the decimal point, "e[+-]digits" exponents). Infinities and NaNs, which
+// JSON cannot represent, emit the nonfinite replacement token instead (default: "null",
+// what most serializers fall back to); pass keep_minus_zero = false to emit "0" for
+// negative zero ("-0" is valid JSON, but some consumers normalize it away).
+//
+// The buffer must be large enough, i.e. >= DtoaMaxLength, and the replacement token must
+// not be longer than DtoaMaxLength characters.
+
+char* DtoaJson(char* buffer, double value, const char* nonfinite = "null", bool keep_minus_zero = true);
+
+// char* output_end = DtoaDecimal64(buffer, bid_bits);
+//
+// Converts the given IEEE 754-2008 decimal64 number (passed as its BID-encoded bit pattern,
+// there is no standard decimal64 type) into decimal form and stores the result in the given
+// buffer.
+//
+// The buffer must be large enough, i.e. >= DtoaMaxLength; this function never writes past
+// buffer + DtoaMaxLength. The output format is the same as Dtoa's.
+//
+// Since decimal64 already stores a decimal coefficient and exponent, no decimal search is
+// involved and the output is exact -- the value reads back unchanged. Note that trailing
+// zeros of the coefficient are stripped, so the quantum (which cohort member the encoding
+// uses) is not preserved, only the value. Non-canonical encodings (coefficients >= 10^16)
+// are treated as zero, per the standard.
+
+char* DtoaDecimal64(char* buffer, uint64_t bid_bits);
+
+// char* output_end = DtoaBatch(buffer, values, count, separator);
+//
+// Converts the given array of double-precision numbers into decimal form and stores the
+// separator-joined results in the given buffer, i.e. the output is
+//  values[0] <separator> values[1] <separator> ... values[count - 1]
+//
+// The buffer must be large enough, i.e. >= count * (DtoaMaxLength + 1).
+// Each number is formatted exactly as by Dtoa.
+// The output is _not_ null-terminated.
+//
+// Note:
+// This function never writes more than DtoaMaxLength characters past the start of each
+// formatted number (plus one character for its separator).
+
+char* DtoaBatch(char* buffer, const double* values, size_t count, char separator = ',');
+
+// char* output_end = DtoaScientific(buffer, value);
+//
+// Like Dtoa, but always uses scientific notation with a fixed shape:
+//
+//  [-]d.ddde+XXX
+//
+// i.e. at least one fraction digit, and a sign and exactly three digits in the exponent
+// ("1.5e+000", "-2.5e-308"). Zero is "0.0e+000"; inf/nan are formatted as by Dtoa.
+//
+// The digits are the same (shortest) digits as produced by Dtoa; only the layout differs.
+// Since the layout is known up front, the fixed/scientific selection branches and the
+// memmove of Dtoa are skipped -- use this when the output is normalized to scientific
+// notation anyway.
+//
+// The buffer must be large enough, i.e. >= DtoaMaxLength; like Dtoa, this function never
+// writes past buffer + DtoaMaxLength.
+
+char* DtoaScientific(char* buffer, double value);
+
+// char* output_end = DtoaHex(buffer, value);
+//
+// Formats the given value in the hexadecimal floating-point format of printf("%a"):
+//
+//  [-]0x1.fffffffffffffp[+-]dddd
+//
+// The significand is normalized -- one leading hex digit, which is 1 for every finite
+// non-zero value; subnormals are renormalized into this form (printf prints them with a
+// leading 0 digit instead, both read back to the same bits). Trailing significand zeros are
+// stripped ("0x1.8p+1" for 3.0, "0x1p+0" for 1.0), and the binary exponent is printed with
+// the minimal number of digits. Zero is "0x0p+0"; inf/nan are formatted as by Dtoa.
+//
+// The output is lossless -- formatting is pure bit manipulation, no decimal conversion is
+// involved -- and reads back to the exact input bits via std::strtod or ryu::Strtod. Use
+// this for checkpoint/serialization formats where exactness and speed matter more than
+// readability.
+//
+// The buffer must be large enough, i.e. >= DtoaMaxLength; like Dtoa, this function never
+// writes past buffer + DtoaMaxLength. (The longest output is 24 characters.)
+
+char* DtoaHex(char* buffer, double value);
+
+// char* output_end = DtoaFixedNotation(buffer, value);
+//
+// Like Dtoa, but always uses plain fixed notation ("0.000015", "2500"), never scientific.
+//
+// PRE: |value| must be 0 or in [1e-6, 1e17), i.e. within the range the caller declares by
+// using this function. (Debug builds assert this; outside the range the output is
+// unspecified.)
+//
+// The digits are the same (shortest) digits as produced by Dtoa; only the layout differs.
+// Since the range is known up front, the fixed/scientific selection and the memmove-based
+// digit splitting of Dtoa are compiled out: the digits are divided at the decimal point and
+// printed directly into place. Use this when the output must be "%f"-style anyway.
+//
+// The buffer must be large enough, i.e. >= DtoaFixedNotationMinBufferLength: the compile-time
+// zero pre-fill writes (fixed-size) blocks past the formatted number.
+
+constexpr int DtoaFixedNotationMinBufferLength = 64;
+
+char* DtoaFixedNotation(char* buffer, double value);
+
+// char* output_end = DtoaFixed(buffer, value, precision);
+// char* output_end = DtoaExp(buffer, value, precision);
+//
+// Converts the given double-precision number into decimal form with a fixed number of digits
+// after the decimal point, similar to printf("%.*f") resp. printf("%.*e").
+//
+// The buffer must be large enough:
+//  >= 345 + precision characters for DtoaFixed,
+//  >=  24 + precision characters for DtoaExp.
+// The output is _not_ null-terminated.
+//
+// Note:
+// Rounding (round-half-even) is applied to the shortest round-trip digits produced by
+// ToDecimal64, and precisions exceeding these digits are filled with zeros. For values which are
+// not exactly representable the result may therefore differ from printf, which rounds the exact
+// binary expansion of the value.
+
+char* DtoaFixed(char* buffer, double value, int precision);
+char* DtoaExp(char* buffer, double value, int precision);
+
+// FloatingDecimal64 dec = ToDecimal64(value);
+//
+// Converts the given double-precision number into the decimal form (digits, exponent), i.e.
+//  value = digits * 10^exponent
+//
+// The returned digits are optimal in the same sense as for Dtoa. Use this function instead of
+// Dtoa if the decimal representation is needed, but not its ASCII form.
+//
+// PRE: value must be finite and non-zero. The sign of value is ignored.
+//
+// The second overload operates directly on the (biased) IEEE representation, i.e. on the result
+// of Double::PhysicalSignificand() and Double::PhysicalExponent().
+
+struct FloatingDecimal64 {
+    uint64_t digits; // num_digits <= 17
+    int32_t exponent;
+};
+
+FloatingDecimal64 ToDecimal64(double value);
+FloatingDecimal64 ToDecimal64(uint64_t ieee_significand, uint64_t ieee_exponent);
+
+// int length = DtoaLength(value);
+// int length = DtoaLength(value, dec);
+// char* output_end = FormatKnownLength(buffer, value, dec);
+//
+// DtoaLength computes the exact length of the string Dtoa produces for the given value,
+// without emitting any characters -- e.g. to pre-size the offset array of a string column
+// before formatting into the final buffer.
+//
+// The overload taking a FloatingDecimal64 (and FormatKnownLength) reuse an already-computed
+// decimal, so a two-pass flow runs the conversion math only once:
+//
+//  const FloatingDecimal64 dec = ToDecimal64(value);
+//  offsets[i + 1] = offsets[i] + DtoaLength(value, dec);  // pass 1
+//  ...
+//  FormatKnownLength(&column[offsets[i]], value, dec);    // pass 2
+//
+// PRE: dec must be the result of ToDecimal64(value); it is ignored (and may be anything) if
+// value is zero or not finite. FormatKnownLength writes exactly the same characters as Dtoa
+// and obeys the same DtoaMaxLength write bound -- "known length" refers to the caller, the
+// destination must still provide the DtoaMaxLength headroom of Dtoa.
+
+int DtoaLength(double value);
+int DtoaLength(double value, FloatingDecimal64 dec);
+
+char* FormatKnownLength(char* buffer, double value, FloatingDecimal64 dec);
+
 } // namespace schubfach
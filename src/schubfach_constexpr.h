@@ -0,0 +1,525 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "schubfach_64.h"
+
+#include <cstdint>
+#include <limits>
+
+// Constexpr variants of ToDecimal64 and Dtoa, for baking pre-formatted numbers (threshold
+// tables, bucket edges, ...) into .rodata instead of formatting them at startup.
+//
+// The implementation is a constexpr transliteration of schubfach_64.cc and produces exactly
+// the same characters as Dtoa; the runtime entry points remain the fast path for dynamic
+// values. Everything lives in this header (constexpr requires the definitions at the call
+// site) and adds no object-file footprint: instead of carrying a second copy of the shared
+// pow10 table (pow10_cache_64.h), the required entry is recomputed exactly with compile-time
+// big-integer arithmetic -- slow, but the computation only ever runs in the compiler (or in
+// the rare runtime call, which is supported but not a replacement for Dtoa).
+//
+// Note:
+// Decomposing a double into its bits in a constant expression requires __builtin_bit_cast
+// (GCC 11+, clang 9+, VS 2019 16.8+; std::bit_cast is C++20). On older compilers a pure
+// arithmetic decomposition is used instead, which cannot observe the sign of -0.0 (it
+// formats as "0"); everything else is unaffected.
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_bit_cast)
+#define SF_CX_HAS_BIT_CAST 1
+#endif
+#elif defined(_MSC_VER) && _MSC_VER >= 1927
+#define SF_CX_HAS_BIT_CAST 1
+#endif
+#ifndef SF_CX_HAS_BIT_CAST
+#define SF_CX_HAS_BIT_CAST 0
+#endif
+
+namespace schubfach {
+
+// DtoaConstexpr returns the same DtoaString type (schubfach_64.h) that the runtime DtoaStr
+// produces: the characters Dtoa emits, held by value and additionally null-terminated.
+
+namespace cx_detail {
+
+//--------------------------------------------------------------------------------------------------
+// Bit decomposition
+//--------------------------------------------------------------------------------------------------
+
+constexpr uint64_t BitsFromValue(double value)
+{
+#if SF_CX_HAS_BIT_CAST
+    return __builtin_bit_cast(uint64_t, value);
+#else
+    if (value != value)
+        return 0x7FF8000000000000ull; // nan (the payload is not observable anyway)
+
+    const bool is_negative = value < 0;
+    const uint64_t sign = is_negative ? 0x8000000000000000ull : 0;
+
+    double a = is_negative ? -value : value;
+    if (a > std::numeric_limits<double>::max())
+        return sign | 0x7FF0000000000000ull; // inf
+    if (a == 0)
+        return sign; // NB: -0.0 is not distinguishable from 0.0 by arithmetic comparisons.
+
+    // Scale the value into [2^52, 2^53) (or to the subnormal exponent); scaling by 2 is
+    // exact, and the scaled significand is an integer.
+    int32_t e = 0;
+    while (a >= 9007199254740992.0) // 2^53
+    {
+        a /= 2;
+        ++e;
+    }
+    while (a < 4503599627370496.0 && e > -1074) // 2^52
+    {
+        a *= 2;
+        --e;
+    }
+
+    const uint64_t f = static_cast<uint64_t>(a);
+    if (f & 0x0010000000000000ull) // normal
+        return sign | (static_cast<uint64_t>(e + 1075) << 52) | (f & 0x000FFFFFFFFFFFFFull);
+    else // subnormal (e == -1074)
+        return sign | f;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+// Pow10 cache
+//--------------------------------------------------------------------------------------------------
+
+struct Uint64x2 {
+    uint64_t hi;
+    uint64_t lo;
+};
+
+// Big enough for 10^326 (1084 bits) and for the division remainders below (< 2 * 10^292).
+struct BigInt {
+    uint32_t bigits[36] = {};
+    int32_t size = 0;
+};
+
+constexpr void AssignU32(BigInt& x, uint32_t value)
+{
+    x.bigits[0] = value;
+    x.size = (value != 0) ? 1 : 0;
+}
+
+constexpr void MulU32(BigInt& x, uint32_t value)
+{
+    uint64_t carry = 0;
+    for (int32_t i = 0; i < x.size; ++i)
+    {
+        const uint64_t p = uint64_t{x.bigits[i]} * value + carry;
+        x.bigits[i] = static_cast<uint32_t>(p);
+        carry = p >> 32;
+    }
+    if (carry != 0)
+        x.bigits[x.size++] = static_cast<uint32_t>(carry);
+}
+
+constexpr void AssignPow2(BigInt& x, int32_t e2)
+{
+    for (int32_t i = 0; i < e2 / 32; ++i)
+        x.bigits[i] = 0;
+    x.bigits[e2 / 32] = uint32_t{1} << (e2 % 32);
+    x.size = e2 / 32 + 1;
+}
+
+constexpr void ShiftLeftOne(BigInt& x)
+{
+    uint32_t carry = 0;
+    for (int32_t i = 0; i < x.size; ++i)
+    {
+        const uint32_t b = x.bigits[i];
+        x.bigits[i] = (b << 1) | carry;
+        carry = b >> 31;
+    }
+    if (carry != 0)
+        x.bigits[x.size++] = carry;
+}
+
+constexpr int32_t Compare(const BigInt& lhs, const BigInt& rhs)
+{
+    if (lhs.size != rhs.size)
+        return lhs.size < rhs.size ? -1 : +1;
+    for (int32_t i = lhs.size - 1; i >= 0; --i)
+    {
+        if (lhs.bigits[i] != rhs.bigits[i])
+            return lhs.bigits[i] < rhs.bigits[i] ? -1 : +1;
+    }
+    return 0;
+}
+
+constexpr void Subtract(BigInt& lhs, const BigInt& rhs) // PRE: lhs >= rhs
+{
+    uint32_t borrow = 0;
+    for (int32_t i = 0; i < lhs.size; ++i)
+    {
+        const uint64_t r = (i < rhs.size) ? uint64_t{rhs.bigits[i]} + borrow : borrow;
+        const uint64_t l = lhs.bigits[i];
+        lhs.bigits[i] = static_cast<uint32_t>(l - r);
+        borrow = (l < r) ? 1 : 0;
+    }
+    while (lhs.size > 0 && lhs.bigits[lhs.size - 1] == 0)
+        lhs.size--;
+}
+
+constexpr int32_t BitLength(const BigInt& x)
+{
+    uint32_t b = x.bigits[x.size - 1];
+    int32_t n = 32 * x.size;
+    while ((b & 0x80000000u) == 0)
+    {
+        b <<= 1;
+        --n;
+    }
+    return n;
+}
+
+constexpr uint32_t GetBit(const BigInt& x, int32_t i) // i may be out of range
+{
+    return (0 <= i && i / 32 < x.size) ? ((x.bigits[i / 32] >> (i % 32)) & 1) : 0;
+}
+
+// Computes g(k) = ceil(10^k / 2^r), r = floor(log_2 10^k) - 127, i.e. the entry the runtime
+// implementation loads from the shared pow10 table. (k in [-292, 326].)
+constexpr Uint64x2 ComputePow10(int32_t k)
+{
+    if (k >= 0)
+    {
+        // 10^k, then its top 128 bits, rounded up iff any of the discarded bits is set.
+        BigInt x;
+        AssignU32(x, 1);
+        for (int32_t i = 0; i < k; ++i)
+            MulU32(x, 10);
+
+        const int32_t r = BitLength(x) - 128;
+
+        Uint64x2 g = {0, 0};
+        for (int32_t i = 0; i < 64; ++i)
+        {
+            g.lo |= uint64_t{GetBit(x, r + i)} << i;
+            g.hi |= uint64_t{GetBit(x, r + 64 + i)} << i;
+        }
+        for (int32_t i = 0; i < r; ++i)
+        {
+            if (GetBit(x, i) != 0)
+            {
+                g.lo += 1;
+                g.hi += (g.lo == 0) ? 1 : 0;
+                break;
+            }
+        }
+        return g;
+    }
+    else
+    {
+        // g = ceil(2^-r / 10^-k) with -r = 127 + bitlength(10^-k): binary long division.
+        // The quotient has exactly 128 bits, and the division is never exact.
+        BigInt d;
+        AssignU32(d, 1);
+        for (int32_t i = 0; i < -k; ++i)
+            MulU32(d, 10);
+
+        const int32_t ld = BitLength(d);
+
+        // Process the top ld+1 numerator bits at once: 2^ld yields the leading quotient
+        // bit 1 (2^ld >= d); the remaining 127 numerator bits are all zero.
+        BigInt rem;
+        AssignPow2(rem, ld);
+        Subtract(rem, d);
+
+        Uint64x2 q = {0, 1};
+        for (int32_t i = 0; i < 127; ++i)
+        {
+            ShiftLeftOne(rem);
+            uint64_t bit = 0;
+            if (Compare(rem, d) >= 0)
+            {
+                Subtract(rem, d);
+                bit = 1;
+            }
+            q.hi = (q.hi << 1) | (q.lo >> 63);
+            q.lo = (q.lo << 1) | bit;
+        }
+
+        q.lo += 1; // ceil
+        q.hi += (q.lo == 0) ? 1 : 0;
+        return q;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// ToDecimal64
+//--------------------------------------------------------------------------------------------------
+
+constexpr int32_t FloorDivPow2(int32_t x, int32_t n)
+{
+    return x < 0 ? ~(~x >> n) : (x >> n);
+}
+
+// Returns floor(log_2(10^e))
+constexpr int32_t FloorLog2Pow10(int32_t e)
+{
+    return FloorDivPow2(e * 1741647, 19);
+}
+
+constexpr Uint64x2 Mul128(uint64_t a, uint64_t b)
+{
+    const uint64_t b00 = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+    const uint64_t b01 = (a & 0xFFFFFFFF) * (b >> 32);
+    const uint64_t b10 = (a >> 32) * (b & 0xFFFFFFFF);
+    const uint64_t b11 = (a >> 32) * (b >> 32);
+
+    const uint64_t mid1 = b10 + (b00 >> 32);
+    const uint64_t mid2 = b01 + (mid1 & 0xFFFFFFFF);
+
+    const uint64_t hi = b11 + (mid1 >> 32) + (mid2 >> 32);
+    const uint64_t lo = (b00 & 0xFFFFFFFF) | (mid2 << 32);
+    return {hi, lo};
+}
+
+constexpr uint64_t RoundToOdd(Uint64x2 g, uint64_t cp)
+{
+    const uint64_t x = Mul128(g.lo, cp).hi;
+    Uint64x2 y = Mul128(g.hi, cp);
+
+    y.lo += x;
+    y.hi += (y.lo < x) ? 1 : 0;
+
+    return y.hi | ((y.lo > 1) ? 1 : 0);
+}
+
+constexpr bool MultipleOfPow2(uint64_t value, int32_t e2)
+{
+    return (value & ((uint64_t{1} << e2) - 1)) == 0;
+}
+
+constexpr FloatingDecimal64 ToDecimal64(uint64_t ieee_significand, uint64_t ieee_exponent)
+{
+    constexpr uint64_t HiddenBit = 0x0010000000000000ull;
+    constexpr int32_t SignificandSize = 53;
+    constexpr int32_t ExponentBias = 1023 + 52;
+
+    uint64_t c = 0;
+    int32_t q = 0;
+    if (ieee_exponent != 0)
+    {
+        c = HiddenBit | ieee_significand;
+        q = static_cast<int32_t>(ieee_exponent) - ExponentBias;
+
+        if (0 <= -q && -q < SignificandSize && MultipleOfPow2(c, -q))
+            return {c >> -q, 0};
+    }
+    else
+    {
+        c = ieee_significand;
+        q = 1 - ExponentBias;
+    }
+
+    const bool is_even = (c % 2 == 0);
+    const bool accept_lower = is_even;
+    const bool accept_upper = is_even;
+
+    const bool lower_boundary_is_closer = (ieee_significand == 0 && ieee_exponent > 1);
+
+    const uint64_t cbl = 4 * c - 2 + (lower_boundary_is_closer ? 1 : 0);
+    const uint64_t cb  = 4 * c;
+    const uint64_t cbr = 4 * c + 2;
+
+    const int32_t k = FloorDivPow2(q * 1262611 - (lower_boundary_is_closer ? 524031 : 0), 22);
+
+    const int32_t h = q + FloorLog2Pow10(-k) + 1;
+
+    const Uint64x2 pow10 = ComputePow10(-k);
+    const uint64_t vbl = RoundToOdd(pow10, cbl << h);
+    const uint64_t vb  = RoundToOdd(pow10, cb  << h);
+    const uint64_t vbr = RoundToOdd(pow10, cbr << h);
+
+    const uint64_t lower = vbl + (accept_lower ? 0 : 1);
+    const uint64_t upper = vbr - (accept_upper ? 0 : 1);
+
+    const uint64_t s = vb / 4;
+
+    if (s >= 10)
+    {
+        const uint64_t sp = s / 10;
+        const bool up_inside = lower <= 40 * sp;
+        const bool wp_inside =          40 * sp + 40 <= upper;
+        if (up_inside != wp_inside)
+            return {sp + (wp_inside ? 1 : 0), k + 1};
+    }
+
+    const bool u_inside = lower <= 4 * s;
+    const bool w_inside =          4 * s + 4 <= upper;
+    if (u_inside != w_inside)
+        return {s + (w_inside ? 1 : 0), k};
+
+    const uint64_t mid = 4 * s + 2;
+    const bool round_up = vb > mid || (vb == mid && (s & 1) != 0);
+
+    return {s + (round_up ? 1 : 0), k};
+}
+
+//--------------------------------------------------------------------------------------------------
+// Formatting
+//--------------------------------------------------------------------------------------------------
+
+constexpr int32_t DecimalLength(uint64_t v)
+{
+    int32_t n = 1;
+    while (v >= 10)
+    {
+        v /= 10;
+        ++n;
+    }
+    return n;
+}
+
+// Writes the same characters as the runtime FormatDigits (schubfach_64.cc); returns the
+// number of characters written.
+constexpr int32_t FormatDigits(char* buffer, uint64_t digits, int32_t decimal_exponent)
+{
+    int32_t num_digits = DecimalLength(digits);
+    const int32_t decimal_point = num_digits + decimal_exponent;
+
+    // Strip trailing zeros (leaves decimal_point unchanged).
+    while (digits % 10 == 0)
+    {
+        digits /= 10;
+        --num_digits;
+    }
+
+    char dd[17] = {};
+    for (int32_t i = num_digits - 1; i >= 0; --i)
+    {
+        dd[i] = static_cast<char>('0' + digits % 10);
+        digits /= 10;
+    }
+
+    int32_t pos = 0;
+    const bool use_fixed = -6 <= decimal_point && decimal_point <= 17;
+    if (use_fixed)
+    {
+        if (decimal_point <= 0)
+        {
+            // 0.[000]digits
+            buffer[pos++] = '0';
+            buffer[pos++] = '.';
+            for (int32_t i = 0; i < -decimal_point; ++i)
+                buffer[pos++] = '0';
+            for (int32_t i = 0; i < num_digits; ++i)
+                buffer[pos++] = dd[i];
+        }
+        else if (decimal_point < num_digits)
+        {
+            // dig.its
+            for (int32_t i = 0; i < decimal_point; ++i)
+                buffer[pos++] = dd[i];
+            buffer[pos++] = '.';
+            for (int32_t i = decimal_point; i < num_digits; ++i)
+                buffer[pos++] = dd[i];
+        }
+        else
+        {
+            // digits[000]
+            for (int32_t i = 0; i < num_digits; ++i)
+                buffer[pos++] = dd[i];
+            for (int32_t i = 0; i < decimal_point - num_digits; ++i)
+                buffer[pos++] = '0';
+        }
+    }
+    else
+    {
+        // d[.igits]e+123
+        buffer[pos++] = dd[0];
+        if (num_digits > 1)
+        {
+            buffer[pos++] = '.';
+            for (int32_t i = 1; i < num_digits; ++i)
+                buffer[pos++] = dd[i];
+        }
+
+        const int32_t scientific_exponent = decimal_point - 1;
+        buffer[pos++] = 'e';
+        buffer[pos++] = scientific_exponent < 0 ? '-' : '+';
+
+        const uint32_t e = static_cast<uint32_t>(scientific_exponent < 0 ? -scientific_exponent : scientific_exponent);
+        if (e >= 100)
+            buffer[pos++] = static_cast<char>('0' + e / 100);
+        if (e >= 10)
+            buffer[pos++] = static_cast<char>('0' + e / 10 % 10);
+        buffer[pos++] = static_cast<char>('0' + e % 10);
+    }
+
+    return pos;
+}
+
+} // namespace cx_detail
+
+// constexpr FloatingDecimal64 dec = ToDecimal64Constexpr(value);
+//
+// The constexpr variant of ToDecimal64 (same contract: value must be finite and non-zero,
+// the sign is ignored, the returned digits are optimal).
+
+constexpr FloatingDecimal64 ToDecimal64Constexpr(double value)
+{
+    const uint64_t bits = cx_detail::BitsFromValue(value);
+    return cx_detail::ToDecimal64(bits & 0x000FFFFFFFFFFFFFull, (bits >> 52) & 0x7FF);
+}
+
+// constexpr DtoaString str = DtoaConstexpr(value);
+//
+// The constexpr variant of Dtoa: produces exactly the same characters for every value
+// (including zero, inf and nan), returned by value instead of through a caller buffer.
+
+constexpr DtoaString DtoaConstexpr(double value)
+{
+    DtoaString out = {};
+
+    const uint64_t bits = cx_detail::BitsFromValue(value);
+    const uint64_t significand = bits & 0x000FFFFFFFFFFFFFull;
+    const uint64_t exponent = (bits >> 52) & 0x7FF;
+
+    int32_t pos = 0;
+    if (exponent == 0x7FF && significand != 0)
+    {
+        // nan (unsigned, as for Dtoa)
+        out.chars[pos++] = 'n';
+        out.chars[pos++] = 'a';
+        out.chars[pos++] = 'n';
+    }
+    else
+    {
+        if ((bits & 0x8000000000000000ull) != 0)
+            out.chars[pos++] = '-';
+
+        if (exponent == 0x7FF)
+        {
+            out.chars[pos++] = 'i';
+            out.chars[pos++] = 'n';
+            out.chars[pos++] = 'f';
+        }
+        else if (exponent == 0 && significand == 0)
+        {
+            out.chars[pos++] = '0';
+        }
+        else
+        {
+            const FloatingDecimal64 dec = cx_detail::ToDecimal64(significand, exponent);
+            pos += cx_detail::FormatDigits(out.chars + pos, dec.digits, dec.exponent);
+        }
+    }
+
+    out.length = pos;
+    return out;
+}
+
+} // namespace schubfach
+
+#undef SF_CX_HAS_BIT_CAST
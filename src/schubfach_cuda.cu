@@ -0,0 +1,358 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+// Device port of schubfach_64.cc: ToDecimal64 and the fixed/scientific layout selection,
+// one value per thread. The CPU implementation is the reference; the output of every slot
+// is byte-identical to schubfach::Dtoa. Kept free of the CPU-side micro-optimizations
+// (digit-pair tables, SIMD digit printing, memmove layout tricks): on the GPU the scalar
+// divide loops are cheap relative to the memory traffic, and constant memory is better
+// spent on the pow10 significands.
+
+#include "schubfach_cuda.h"
+
+#include "pow10_cache_64.h"
+
+#include <mutex>
+
+#if defined(__HIP_PLATFORM_AMD__) || defined(__HIPCC__)
+#include <hip/hip_runtime.h>
+#define cudaGetLastError hipGetLastError
+#define cudaMemcpyToSymbol hipMemcpyToSymbol
+#define cudaStream_t hipStream_t
+#define cudaSuccess hipSuccess
+#endif
+
+namespace {
+
+struct uint64x2 {
+    uint64_t hi;
+    uint64_t lo;
+};
+
+struct FloatingDecimal64 {
+    uint64_t digits;
+    int32_t exponent;
+};
+
+// binary64 layout, see struct Double in schubfach_64.cc.
+constexpr int32_t SignificandSize = 53;
+constexpr int32_t ExponentBias = 1023 + (SignificandSize - 1);
+constexpr uint64_t MaxIeeeExponent = 2047;
+constexpr uint64_t HiddenBit = uint64_t{1} << (SignificandSize - 1);
+constexpr uint64_t SignificandMask = HiddenBit - 1;
+
+} // namespace
+
+//==================================================================================================
+// ToDecimal64
+//==================================================================================================
+
+// The pow10 significands g = ceil(10^k 2^-r) for k in [kMinDecimalExponent, 324] (see
+// pow10_cache_64.h), uploaded once from the host cache. ~10KB, well within the constant
+// memory budget, and the warp-uniform index makes constant memory the right home.
+__constant__ uint64x2 kPow10[325 - pow10cache::kMinDecimalExponent];
+
+__device__ static inline uint64x2 ComputePow10_Double(int32_t k)
+{
+    return kPow10[k - pow10cache::kMinDecimalExponent];
+}
+
+__device__ static inline int32_t FloorDivPow2(int32_t x, int32_t n)
+{
+    return x >> n;
+}
+
+__device__ static inline int32_t FloorLog2Pow10(int32_t e)
+{
+    return FloorDivPow2(e * 1741647, 19);
+}
+
+__device__ static inline uint64_t RoundToOdd(uint64x2 g, uint64_t cp)
+{
+    const uint64_t x1 = __umul64hi(g.lo, cp);
+
+    uint64_t y0 = g.hi * cp;
+    uint64_t y1 = __umul64hi(g.hi, cp);
+    y0 += x1;
+    y1 += y0 < x1;
+
+    return y1 | (y0 > 1);
+}
+
+__device__ static inline bool MultipleOfPow2(uint64_t value, int32_t e2)
+{
+    return (value & ((uint64_t{1} << e2) - 1)) == 0;
+}
+
+// The digit-selection tail of ToDecimal64; see SelectShortest in schubfach_64.cc.
+__device__ static inline FloatingDecimal64 SelectShortest(uint64_t vb, uint64_t lower, uint64_t upper, int32_t k)
+{
+    const uint64_t s = vb / 4;
+
+    if (s >= 10) // vb >= 40
+    {
+        const uint64_t sp = s / 10; // = vb / 40
+        const bool up_inside = lower <= 40 * sp;
+        const bool wp_inside =          40 * sp + 40 <= upper;
+        if (up_inside != wp_inside)
+            return {sp + wp_inside, k + 1};
+    }
+
+    const bool u_inside = lower <= 4 * s;
+    const bool w_inside =          4 * s + 4 <= upper;
+    if (u_inside != w_inside)
+        return {s + w_inside, k};
+
+    const uint64_t mid = 4 * s + 2; // = 2(s + t)
+    const bool round_up = vb > mid || (vb == mid && (s & 1) != 0);
+
+    return {s + round_up, k};
+}
+
+// See ToDecimal64Subnormal in schubfach_64.cc.
+__device__ static inline FloatingDecimal64 ToDecimal64Subnormal(uint64_t c)
+{
+    const bool is_even = (c % 2 == 0);
+
+    constexpr int32_t k = -324;
+    constexpr int32_t h = 3;
+
+    // The (exact) cache entry for 10^324, baked in as a constant.
+    constexpr uint64x2 pow10 = {0x9E19DB92B4E31BA9, 0x6C07A2C26A8346D2};
+
+    const uint64_t cbl = 4 * c - 2;
+    const uint64_t cb  = 4 * c;
+    const uint64_t cbr = 4 * c + 2;
+
+    const uint64_t vbl = RoundToOdd(pow10, cbl << h);
+    const uint64_t vb  = RoundToOdd(pow10, cb  << h);
+    const uint64_t vbr = RoundToOdd(pow10, cbr << h);
+
+    const uint64_t lower = vbl + !is_even;
+    const uint64_t upper = vbr - !is_even;
+
+    return SelectShortest(vb, lower, upper, k);
+}
+
+// See ToDecimal64 in schubfach_64.cc.
+__device__ static inline FloatingDecimal64 ToDecimal64(uint64_t ieee_significand, uint64_t ieee_exponent)
+{
+    uint64_t c;
+    int32_t q;
+    if (ieee_exponent != 0)
+    {
+        c = HiddenBit | ieee_significand;
+        q = static_cast<int32_t>(ieee_exponent) - ExponentBias;
+
+        if (0 <= -q && -q < SignificandSize && MultipleOfPow2(c, -q))
+            return {c >> -q, 0};
+    }
+    else
+    {
+        return ToDecimal64Subnormal(ieee_significand);
+    }
+
+    const bool is_even = (c % 2 == 0);
+    const bool accept_lower = is_even;
+    const bool accept_upper = is_even;
+
+    const bool lower_boundary_is_closer = (ieee_significand == 0 && ieee_exponent > 1);
+
+    const uint64_t cbl = 4 * c - 2 + lower_boundary_is_closer;
+    const uint64_t cb  = 4 * c;
+    const uint64_t cbr = 4 * c + 2;
+
+    const int32_t k = FloorDivPow2(q * 1262611 - (lower_boundary_is_closer ? 524031 : 0), 22);
+    const int32_t h = q + FloorLog2Pow10(-k) + 1;
+
+    const uint64x2 pow10 = ComputePow10_Double(-k);
+    const uint64_t vbl = RoundToOdd(pow10, cbl << h);
+    const uint64_t vb  = RoundToOdd(pow10, cb  << h);
+    const uint64_t vbr = RoundToOdd(pow10, cbr << h);
+
+    const uint64_t lower = vbl + !accept_lower;
+    const uint64_t upper = vbr - !accept_upper;
+
+    return SelectShortest(vb, lower, upper, k);
+}
+
+//==================================================================================================
+// ToChars
+//==================================================================================================
+
+// The layout rules of FormatDigits in schubfach_64.cc: the trailing zeros of the decimal
+// digits are stripped (they are recreated by the layout where needed), fixed notation is
+// used for decimal points in [-6, 17], scientific notation with a minimal-width exponent
+// otherwise.
+__device__ static inline int32_t FormatDigits(char* buffer, uint64_t digits, int32_t decimal_exponent)
+{
+    while (digits % 10 == 0)
+    {
+        digits /= 10;
+        ++decimal_exponent;
+    }
+
+    char dig[17];
+    int32_t num_digits = 0;
+    for (; digits != 0; digits /= 10)
+        dig[num_digits++] = static_cast<char>('0' + digits % 10);
+
+    const int32_t decimal_point = num_digits + decimal_exponent;
+    char* next = buffer;
+
+    if (-6 <= decimal_point && decimal_point <= 17)
+    {
+        if (decimal_point <= 0)
+        {
+            // 0.[000]digits
+            *next++ = '0';
+            *next++ = '.';
+            for (int32_t i = 0; i < -decimal_point; ++i)
+                *next++ = '0';
+            for (int32_t i = num_digits - 1; i >= 0; --i)
+                *next++ = dig[i];
+        }
+        else if (decimal_point < num_digits)
+        {
+            // dig.its
+            for (int32_t i = num_digits - 1; i >= num_digits - decimal_point; --i)
+                *next++ = dig[i];
+            *next++ = '.';
+            for (int32_t i = num_digits - decimal_point - 1; i >= 0; --i)
+                *next++ = dig[i];
+        }
+        else
+        {
+            // digits[000]
+            for (int32_t i = num_digits - 1; i >= 0; --i)
+                *next++ = dig[i];
+            for (int32_t i = 0; i < decimal_point - num_digits; ++i)
+                *next++ = '0';
+        }
+    }
+    else
+    {
+        // d[.igits]e+123
+        *next++ = dig[num_digits - 1];
+        if (num_digits > 1)
+        {
+            *next++ = '.';
+            for (int32_t i = num_digits - 2; i >= 0; --i)
+                *next++ = dig[i];
+        }
+
+        const int32_t scientific_exponent = decimal_point - 1;
+        *next++ = 'e';
+        *next++ = scientific_exponent < 0 ? '-' : '+';
+
+        uint32_t k = static_cast<uint32_t>(scientific_exponent < 0 ? -scientific_exponent : scientific_exponent);
+        if (k >= 100)
+        {
+            *next++ = static_cast<char>('0' + k / 100);
+            k %= 100;
+            *next++ = static_cast<char>('0' + k / 10);
+            *next++ = static_cast<char>('0' + k % 10);
+        }
+        else if (k >= 10)
+        {
+            *next++ = static_cast<char>('0' + k / 10);
+            *next++ = static_cast<char>('0' + k % 10);
+        }
+        else
+        {
+            *next++ = static_cast<char>('0' + k);
+        }
+    }
+
+    return static_cast<int32_t>(next - buffer);
+}
+
+// See ToChars in schubfach_64.cc (force_trailing_dot_zero = false).
+__device__ static inline int32_t FormatValue(char* buffer, double value)
+{
+    const uint64_t bits = __double_as_longlong(value);
+
+    const uint64_t significand = bits & SignificandMask;
+    const uint64_t exponent = (bits >> (SignificandSize - 1)) & MaxIeeeExponent;
+    const uint64_t sign = bits >> 63;
+
+    char* next = buffer;
+
+    if (exponent != MaxIeeeExponent)
+    {
+        // Finite
+        if (sign)
+            *next++ = '-';
+
+        if (exponent != 0 || significand != 0)
+        {
+            const FloatingDecimal64 dec = ToDecimal64(significand, exponent);
+            return static_cast<int32_t>(next - buffer) + FormatDigits(next, dec.digits, dec.exponent);
+        }
+
+        *next++ = '0';
+        return static_cast<int32_t>(next - buffer);
+    }
+
+    if (significand == 0)
+    {
+        if (sign)
+            *next++ = '-';
+        *next++ = 'i';
+        *next++ = 'n';
+        *next++ = 'f';
+    }
+    else
+    {
+        *next++ = 'n';
+        *next++ = 'a';
+        *next++ = 'n';
+    }
+    return static_cast<int32_t>(next - buffer);
+}
+
+static __global__ void DtoaBulkKernel(const double* values, size_t count, char* text, int32_t* lengths)
+{
+    const size_t i = blockIdx.x * size_t{blockDim.x} + threadIdx.x;
+    if (i >= count)
+        return;
+
+    lengths[i] = FormatValue(text + i * schubfach_cuda::SlotLength, values[i]);
+}
+
+//==================================================================================================
+//
+//==================================================================================================
+
+// Uploads the host-side pow10 cache into constant memory, once per process.
+static bool UploadPow10()
+{
+    static bool ok = false;
+    static std::once_flag once;
+    std::call_once(once, [] {
+        uint64x2 table[325 - pow10cache::kMinDecimalExponent];
+        for (int32_t k = pow10cache::kMinDecimalExponent; k <= 324; ++k)
+        {
+            const pow10cache::Significand128 g = pow10cache::GetPow10Significand(k);
+            table[k - pow10cache::kMinDecimalExponent] = {g.hi, g.lo};
+        }
+        ok = cudaMemcpyToSymbol(kPow10, table, sizeof(table)) == cudaSuccess;
+    });
+    return ok;
+}
+
+bool schubfach_cuda::DtoaBulk(const double* d_values, size_t count, char* d_text, int32_t* d_lengths, void* stream)
+{
+    if (!UploadPow10())
+        return false;
+    if (count == 0)
+        return true;
+
+    constexpr uint32_t BlockSize = 256;
+    const uint32_t num_blocks = static_cast<uint32_t>((count + BlockSize - 1) / BlockSize);
+
+    DtoaBulkKernel<<<num_blocks, BlockSize, 0, static_cast<cudaStream_t>(stream)>>>(d_values, count, d_text, d_lengths);
+    return cudaGetLastError() == cudaSuccess;
+}
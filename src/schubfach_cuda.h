@@ -0,0 +1,36 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace schubfach_cuda {
+
+// Bulk GPU formatting with the schubfach algorithm (cmake option DRACHENNEST_CUDA; the
+// translation unit also compiles under hipcc). The kernel is a device port of
+// schubfach_64.cc -- ToDecimal64 plus the fixed/scientific layout selection -- with the
+// pow10 significands in constant memory; the output is byte-identical to schubfach::Dtoa.
+//
+// Each value is formatted into its own fixed-stride slot of SlotLength bytes, and
+// lengths[i] receives the number of characters of slot i. Fixed slots keep the kernel free
+// of a device-wide scan; the exclusive prefix sum of the lengths yields the offsets for
+// compaction, on whichever side of the bus the text is consumed.
+//
+// Formatting is one value per thread: the digit loops are short (<= 17 digits) and
+// independent, so a warp-cooperative split of a single value does not pay for its shuffles;
+// the warp cooperates by formatting 32 adjacent values with coalesced loads instead.
+
+constexpr int SlotLength = 26; // == schubfach::DtoaMaxLength
+
+// Formats values[0..count) into the slots of 'text' (count * SlotLength bytes) and writes
+// the per-slot lengths. All pointers are device pointers; 'stream' is a cudaStream_t (resp.
+// hipStream_t) or nullptr for the default stream. The launch is asynchronous. Returns false
+// if the launch (or the one-time upload of the pow10 table) fails.
+
+bool DtoaBulk(const double* d_values, size_t count, char* d_text, int32_t* d_lengths, void* stream = nullptr);
+
+} // namespace schubfach_cuda
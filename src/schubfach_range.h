@@ -0,0 +1,156 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "itoa.h"
+#include "schubfach_64.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace schubfach {
+
+// char* output_end = Dtoa<MinExp10, MaxExp10>(buffer, value);
+//
+// Like Dtoa, for callers that know the decade range of their column: the template arguments
+// declare 10^MinExp10 <= |value| < 10^MaxExp10 (for finite non-zero values). Layout
+// branches that cannot fire for the declared range -- the scientific notation for a sensor
+// column in [1e-3, 1e4], the "0.000" prefix for timestamps in [1e9, 1e10] -- compile away,
+// and the zero fill becomes a compile-time constant (the same trade as DtoaFixedNotation).
+//
+// The hint is an optimization, never a correctness obligation: zeros, infinities, NaNs and
+// values outside the declared decades take a cold call to the general Dtoa instead. The
+// output is byte-identical to Dtoa for every input.
+//
+// The buffer must be >= DtoaFixedNotationMinBufferLength (64) characters: like
+// DtoaFixedNotation, the fixed-notation path trades scratch headroom for plain stores.
+
+template <int32_t MinExp10, int32_t MaxExp10>
+char* Dtoa(char* buffer, double value)
+{
+    using drachennest::itoa::DecimalLength;
+    using drachennest::itoa::PrintDecimalDigitsBackwards;
+    using drachennest::itoa::ExponentToChars;
+
+    static_assert(MinExp10 < MaxExp10, "Dtoa<MinExp10, MaxExp10>: empty decade range");
+    static_assert(MinExp10 >= -324, "Dtoa<MinExp10, MaxExp10>: below the smallest double decade");
+    static_assert(MaxExp10 <=  309, "Dtoa<MinExp10, MaxExp10>: above the largest double decade");
+
+    // |value| in [10^k, 10^(k+1)) puts the decimal point of the shortest digits at k + 1.
+    constexpr int32_t MinDecimalPoint = MinExp10 + 1;
+    constexpr int32_t MaxDecimalPoint = MaxExp10;
+
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const uint64_t abs_bits = bits & 0x7FFFFFFFFFFFFFFFull;
+    if (abs_bits - 1 >= 0x7FF0000000000000ull - 1) // zero, inf or nan
+        return schubfach::Dtoa(buffer, value);
+
+    const FloatingDecimal64 dec = ToDecimal64(value);
+    const int32_t num_digits = DecimalLength(dec.digits);
+    const int32_t decimal_point = num_digits + dec.exponent;
+
+    if (decimal_point < MinDecimalPoint || decimal_point > MaxDecimalPoint)
+        return schubfach::Dtoa(buffer, value); // outside the declared decades: cold restart
+
+    buffer[0] = '-';
+    buffer += bits >> 63;
+
+    // Dtoa uses fixed notation for decimal points in [-6, 17] (see FormatDigits in
+    // schubfach_64.cc); a range on one side of the window reduces to a single layout.
+    constexpr bool HasFixed      = MinDecimalPoint <= 17 && MaxDecimalPoint >= -6;
+    constexpr bool HasScientific = MinDecimalPoint <  -6 || MaxDecimalPoint >  17;
+
+    if (HasFixed && (!HasScientific || (-6 <= decimal_point && decimal_point <= 17)))
+    {
+        static constexpr uint64_t Pow10[18] = {
+                               1,
+                              10,
+                             100,
+                            1000,
+                           10000,
+                          100000,
+                         1000000,
+                        10000000,
+                       100000000,
+                      1000000000,
+                     10000000000,
+                    100000000000,
+                   1000000000000,
+                  10000000000000,
+                 100000000000000,
+                1000000000000000,
+               10000000000000000,
+              100000000000000000,
+        };
+
+        // The decimal point range of this branch, with the window clamp folded in.
+        constexpr int32_t FMin = MinDecimalPoint < -6 ? -6 : MinDecimalPoint;
+        constexpr int32_t FMax = MaxDecimalPoint > 17 ? 17 : MaxDecimalPoint;
+
+        // Zero-fill the area the padding can cover (see FormatDigitsFixedNotation in
+        // schubfach_64.cc): a compile-time length, so the compiler emits plain stores.
+        constexpr int32_t MaxPrefix = FMin <= 0 ? (2 - FMin) : 0;
+        constexpr int32_t MaxSplit  = FMax >  0 ? (FMax + 1 + 17) : 0;
+        constexpr int32_t ZeroFill  = MaxPrefix > MaxSplit ? MaxPrefix : MaxSplit;
+        for (int32_t i = 0; i < ZeroFill; i += 16)
+            std::memset(buffer + i, '0', 16);
+
+        if (FMin <= 0 && decimal_point <= 0)
+        {
+            // 0.[000]digits
+            char* const digits_end = buffer + (2 - decimal_point) + num_digits;
+            const int32_t tz = PrintDecimalDigitsBackwards(digits_end, dec.digits);
+            buffer[1] = '.';
+            return digits_end - tz;
+        }
+
+        const int32_t num_fraction_digits = num_digits - decimal_point;
+        if (num_fraction_digits <= 0)
+        {
+            // digits[000]
+            PrintDecimalDigitsBackwards(buffer + num_digits, dec.digits);
+            return buffer + decimal_point;
+        }
+
+        // dig.its
+        const uint64_t q = dec.digits / Pow10[num_fraction_digits];
+        const uint64_t r = dec.digits % Pow10[num_fraction_digits];
+
+        PrintDecimalDigitsBackwards(buffer + decimal_point, q);
+        if (r == 0)
+        {
+            // The fraction digits are all zero (the shortest digits may come with a
+            // trailing zero): an integer after all.
+            return buffer + decimal_point;
+        }
+
+        buffer[decimal_point] = '.';
+        char* const digits_end = buffer + decimal_point + 1 + num_fraction_digits;
+        const int32_t tz = PrintDecimalDigitsBackwards(digits_end, r);
+        return digits_end - tz;
+    }
+
+    // d[.igits]e+123: print the digits at buffer + 1, then copy the leading digit one place
+    // to the left. No zero fill: the skipped trailing zeros lie past the returned end.
+    char* digits_end = buffer + 1 + num_digits;
+    const int32_t tz = PrintDecimalDigitsBackwards(digits_end, dec.digits);
+    digits_end -= tz;
+
+    buffer[0] = buffer[1];
+    if (num_digits - tz == 1)
+        ++buffer;
+    else
+    {
+        buffer[1] = '.';
+        buffer = digits_end;
+    }
+
+    return ExponentToChars(buffer, decimal_point - 1);
+}
+
+} // namespace schubfach
@@ -0,0 +1,69 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "stats.h"
+
+//==================================================================================================
+//
+//==================================================================================================
+
+#if DRACHENNEST_STATS
+
+drachennest::stats_impl::AtomicCounters drachennest::stats_impl::counters;
+
+drachennest::Stats drachennest::StatsSnapshot()
+{
+    const auto& c = stats_impl::counters;
+
+    Stats s;
+    s.strtod_integer       = c.strtod_integer.load(std::memory_order_relaxed);
+    s.strtod_to_binary     = c.strtod_to_binary.load(std::memory_order_relaxed);
+    s.strtod_long          = c.strtod_long.load(std::memory_order_relaxed);
+    s.grisu3_ok            = c.grisu3_ok.load(std::memory_order_relaxed);
+    s.grisu3_fallback      = c.grisu3_fallback.load(std::memory_order_relaxed);
+    s.schubfach_integer    = c.schubfach_integer.load(std::memory_order_relaxed);
+    s.schubfach_subnormal  = c.schubfach_subnormal.load(std::memory_order_relaxed);
+    s.schubfach_shorter    = c.schubfach_shorter.load(std::memory_order_relaxed);
+    s.schubfach_inside     = c.schubfach_inside.load(std::memory_order_relaxed);
+    s.schubfach_nearest    = c.schubfach_nearest.load(std::memory_order_relaxed);
+    s.dragonbox_integer    = c.dragonbox_integer.load(std::memory_order_relaxed);
+    s.dragonbox_asymmetric = c.dragonbox_asymmetric.load(std::memory_order_relaxed);
+    s.dragonbox_shorter    = c.dragonbox_shorter.load(std::memory_order_relaxed);
+    s.dragonbox_regular    = c.dragonbox_regular.load(std::memory_order_relaxed);
+    return s;
+}
+
+void drachennest::StatsReset()
+{
+    auto& c = stats_impl::counters;
+
+    c.strtod_integer.store(0, std::memory_order_relaxed);
+    c.strtod_to_binary.store(0, std::memory_order_relaxed);
+    c.strtod_long.store(0, std::memory_order_relaxed);
+    c.grisu3_ok.store(0, std::memory_order_relaxed);
+    c.grisu3_fallback.store(0, std::memory_order_relaxed);
+    c.schubfach_integer.store(0, std::memory_order_relaxed);
+    c.schubfach_subnormal.store(0, std::memory_order_relaxed);
+    c.schubfach_shorter.store(0, std::memory_order_relaxed);
+    c.schubfach_inside.store(0, std::memory_order_relaxed);
+    c.schubfach_nearest.store(0, std::memory_order_relaxed);
+    c.dragonbox_integer.store(0, std::memory_order_relaxed);
+    c.dragonbox_asymmetric.store(0, std::memory_order_relaxed);
+    c.dragonbox_shorter.store(0, std::memory_order_relaxed);
+    c.dragonbox_regular.store(0, std::memory_order_relaxed);
+}
+
+#else // ^^^ DRACHENNEST_STATS ^^^
+
+drachennest::Stats drachennest::StatsSnapshot()
+{
+    return Stats{};
+}
+
+void drachennest::StatsReset()
+{
+}
+
+#endif
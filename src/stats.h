@@ -0,0 +1,93 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+// Opt-in instrumentation of the conversion engines: when DRACHENNEST_STATS is enabled (e.g.
+// via the cmake option of the same name), the engines count how often their fast and slow
+// paths run, answering capacity questions like "what fraction of Strtod calls take the
+// over-long fallback" or "how often does grisu3 hit Dragon4" without a debugger.
+//
+// The counters are global and incremented with relaxed atomics; when disabled, the counting
+// macro compiles away and the counters read as zero.
+
+#ifndef DRACHENNEST_STATS
+#define DRACHENNEST_STATS 0
+#endif
+
+#if DRACHENNEST_STATS
+#include <atomic>
+#endif
+
+namespace drachennest {
+
+// A snapshot of the instrumentation counters.
+struct Stats {
+    // ryu::Strtod (and the functions built on it)
+    uint64_t strtod_integer;        // integer fast path: a single int -> double conversion
+    uint64_t strtod_to_binary;      // regular path: <= 17 digits, one table lookup
+    uint64_t strtod_long;           // over-long input: exact slow path (RYU_STRTOD_FALLBACK)
+
+    // grisu3::Dtoa
+    uint64_t grisu3_ok;             // Grisu3 produced provably shortest digits
+    uint64_t grisu3_fallback;       // Grisu3 was too imprecise; the fallback ran
+
+    // schubfach::ToDecimal64
+    uint64_t schubfach_integer;     // the value is a small integer: exact shortcut
+    uint64_t schubfach_subnormal;   // subnormal: constant-exponent specialized path (also counted below)
+    uint64_t schubfach_shorter;     // a representation one digit shorter was in the interval
+    uint64_t schubfach_inside;      // exactly one of u, w was in the interval
+    uint64_t schubfach_nearest;     // neither: round s to the nearest
+
+    // dragonbox::ToDecimal64
+    uint64_t dragonbox_integer;     // the value is a small integer: exact shortcut
+    uint64_t dragonbox_asymmetric;  // shorter-interval case (significand == hidden bit)
+    uint64_t dragonbox_shorter;     // a representation with kappa + 1 trailing zeros was accepted
+    uint64_t dragonbox_regular;     // regular path
+};
+
+// Returns the current counter values. Thread-safe; a snapshot taken while conversions are
+// running on other threads is approximate (the counters are read individually, relaxed).
+Stats StatsSnapshot();
+
+// Resets all counters to zero, e.g. to measure a specific workload window.
+void StatsReset();
+
+#if DRACHENNEST_STATS
+namespace stats_impl {
+
+// Must mirror Stats field for field.
+struct AtomicCounters {
+    std::atomic<uint64_t> strtod_integer;
+    std::atomic<uint64_t> strtod_to_binary;
+    std::atomic<uint64_t> strtod_long;
+    std::atomic<uint64_t> grisu3_ok;
+    std::atomic<uint64_t> grisu3_fallback;
+    std::atomic<uint64_t> schubfach_integer;
+    std::atomic<uint64_t> schubfach_subnormal;
+    std::atomic<uint64_t> schubfach_shorter;
+    std::atomic<uint64_t> schubfach_inside;
+    std::atomic<uint64_t> schubfach_nearest;
+    std::atomic<uint64_t> dragonbox_integer;
+    std::atomic<uint64_t> dragonbox_asymmetric;
+    std::atomic<uint64_t> dragonbox_shorter;
+    std::atomic<uint64_t> dragonbox_regular;
+};
+
+extern AtomicCounters counters;
+
+} // namespace stats_impl
+#endif
+
+} // namespace drachennest
+
+#if DRACHENNEST_STATS
+#define DRACHENNEST_COUNT(counter) \
+    (::drachennest::stats_impl::counters.counter.fetch_add(1, std::memory_order_relaxed))
+#else
+#define DRACHENNEST_COUNT(counter) static_cast<void>(0)
+#endif
@@ -0,0 +1,283 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "to_chars.h"
+
+#include "schubfach_64.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#ifndef TC_ASSERT
+#define TC_ASSERT(X) assert(X)
+#endif
+
+//==================================================================================================
+//
+//==================================================================================================
+
+template <typename Dest, typename Source>
+static inline Dest ReinterpretBits(Source source)
+{
+    static_assert(sizeof(Dest) == sizeof(Source), "size mismatch");
+
+    Dest dest;
+    std::memcpy(&dest, &source, sizeof(Source));
+    return dest;
+}
+
+namespace {
+struct Double
+{
+    static_assert(std::numeric_limits<double>::is_iec559
+               && std::numeric_limits<double>::digits == 53
+               && std::numeric_limits<double>::max_exponent == 1024,
+        "IEEE-754 double-precision implementation required");
+
+    static constexpr uint64_t MaxIeeeExponent = 2047;
+    static constexpr uint64_t HiddenBit       = 0x0010000000000000ull;
+    static constexpr uint64_t SignificandMask = 0x000FFFFFFFFFFFFFull;
+    static constexpr uint64_t ExponentMask    = 0x7FF0000000000000ull;
+    static constexpr uint64_t SignMask        = 0x8000000000000000ull;
+
+    uint64_t bits;
+
+    explicit Double(double d) : bits(ReinterpretBits<uint64_t>(d)) {}
+
+    uint64_t PhysicalSignificand() const {
+        return bits & SignificandMask;
+    }
+
+    uint64_t PhysicalExponent() const {
+        return (bits & ExponentMask) >> 52;
+    }
+
+    bool IsFinite() const {
+        return (bits & ExponentMask) != ExponentMask;
+    }
+
+    bool IsZero() const {
+        return (bits & ~SignMask) == 0;
+    }
+
+    bool SignBit() const {
+        return (bits & SignMask) != 0;
+    }
+};
+} // namespace
+
+//==================================================================================================
+// Formatting
+//==================================================================================================
+
+// The scratch buffer must hold the longest possible output (see ToCharsMaxLength): for the
+// fixed format this is "0." + 323 zeros + 17 digits (the smallest denormal), or 309 integer
+// digits (the largest finite double), plus the sign.
+
+static constexpr int ScratchSize = drachennest::ToCharsMaxLength;
+
+static inline int32_t DecimalLength(uint64_t v)
+{
+    int32_t len = 1;
+    for (; v >= 10; v /= 10) {
+        ++len;
+    }
+    return len;
+}
+
+static inline void PrintDecimalDigits(char* buf, uint64_t digits, int32_t num_digits)
+{
+    for (int32_t i = num_digits; i > 0; --i)
+    {
+        buf[i - 1] = static_cast<char>('0' + digits % 10);
+        digits /= 10;
+    }
+}
+
+static inline char* FormatExponent(char* buffer, int32_t scientific_exponent)
+{
+    std::memcpy(buffer, scientific_exponent < 0 ? "e-" : "e+", 2);
+    buffer += 2;
+
+    uint32_t k = static_cast<uint32_t>(scientific_exponent < 0 ? -scientific_exponent : scientific_exponent);
+    TC_ASSERT(k <= 324);
+    if (k >= 100)
+    {
+        *buffer++ = static_cast<char>('0' + k / 100);
+        k %= 100;
+        *buffer++ = static_cast<char>('0' + k / 10);
+        *buffer++ = static_cast<char>('0' + k % 10);
+    }
+    else if (k >= 10)
+    {
+        *buffer++ = static_cast<char>('0' + k / 10);
+        *buffer++ = static_cast<char>('0' + k % 10);
+    }
+    else
+    {
+        *buffer++ = static_cast<char>('0' + k);
+    }
+
+    return buffer;
+}
+
+static inline char* FormatFixed(char* buffer, uint64_t digits, int32_t decimal_exponent)
+{
+    TC_ASSERT(digits >= 1);
+
+    const int32_t num_digits = DecimalLength(digits);
+    const int32_t decimal_point = num_digits + decimal_exponent;
+
+    if (decimal_point <= 0)
+    {
+        // 0.[000]digits
+        buffer[0] = '0';
+        buffer[1] = '.';
+        std::memset(buffer + 2, '0', static_cast<size_t>(-decimal_point));
+        buffer += 2 + (-decimal_point);
+        PrintDecimalDigits(buffer, digits, num_digits);
+        return buffer + num_digits;
+    }
+    else if (decimal_point < num_digits)
+    {
+        // dig.its
+        PrintDecimalDigits(buffer, digits, num_digits); // (then insert the decimal point)
+        std::memmove(buffer + decimal_point + 1, buffer + decimal_point, static_cast<size_t>(num_digits - decimal_point));
+        buffer[decimal_point] = '.';
+        return buffer + num_digits + 1;
+    }
+    else
+    {
+        // digits[000]
+        PrintDecimalDigits(buffer, digits, num_digits);
+        std::memset(buffer + num_digits, '0', static_cast<size_t>(decimal_point - num_digits));
+        return buffer + decimal_point;
+    }
+}
+
+static inline char* FormatScientific(char* buffer, uint64_t digits, int32_t decimal_exponent)
+{
+    TC_ASSERT(digits >= 1);
+
+    const int32_t num_digits = DecimalLength(digits);
+    const int32_t scientific_exponent = (num_digits - 1) + decimal_exponent;
+
+    if (num_digits == 1)
+    {
+        // dE+123
+        *buffer++ = static_cast<char>('0' + digits);
+    }
+    else
+    {
+        // d.igitsE+123
+        PrintDecimalDigits(buffer + 1, digits, num_digits);
+        buffer[0] = buffer[1];
+        buffer[1] = '.';
+        buffer += 1 + num_digits;
+    }
+
+    return FormatExponent(buffer, scientific_exponent);
+}
+
+static inline char* FormatValue(char* buffer, double value, drachennest::chars_format fmt)
+{
+    const Double v(value);
+
+    if (v.IsFinite())
+    {
+        buffer[0] = '-';
+        buffer += v.SignBit();
+
+        if (!v.IsZero()) // [[likely]]
+        {
+            if (fmt == drachennest::chars_format::general)
+                return schubfach::Dtoa(buffer, value < 0 ? -value : value);
+
+            auto dec = schubfach::ToDecimal64(v.PhysicalSignificand(), v.PhysicalExponent());
+
+            // The decimal digits may contain trailing zeros, which are not part of the shortest
+            // representation.
+            while (dec.digits % 10 == 0)
+            {
+                dec.digits /= 10;
+                ++dec.exponent;
+            }
+
+            if (fmt == drachennest::chars_format::fixed)
+                return FormatFixed(buffer, dec.digits, dec.exponent);
+            else
+                return FormatScientific(buffer, dec.digits, dec.exponent);
+        }
+
+        *buffer++ = '0';
+        if (fmt == drachennest::chars_format::scientific)
+        {
+            std::memcpy(buffer, "e+0", 3);
+            buffer += 3;
+        }
+        return buffer;
+    }
+
+    if (v.PhysicalSignificand() == 0)
+    {
+        buffer[0] = '-';
+        buffer += v.SignBit();
+
+        std::memcpy(buffer, "inf ", 4);
+        return buffer + 3;
+    }
+    else
+    {
+        buffer[0] = '-';
+        buffer += v.SignBit();
+
+        std::memcpy(buffer, "nan ", 4);
+        return buffer + 3;
+    }
+}
+
+//==================================================================================================
+//
+//==================================================================================================
+
+drachennest::to_chars_result drachennest::to_chars(char* first, char* last, double value, chars_format fmt)
+{
+    static_assert(ScratchSize >= schubfach::DtoaMinBufferLength, "invalid parameter");
+
+    // With enough headroom for the worst case (resp. for Dtoa's temporary writes in the
+    // general format, whose final output is always short), format directly in place.
+    const auto headroom = last - first;
+    if (headroom >= ScratchSize || (fmt == chars_format::general && headroom >= schubfach::DtoaMinBufferLength))
+        return {FormatValue(first, value, fmt), std::errc()};
+
+    // Otherwise format into a scratch buffer first: Dtoa may temporarily write up to
+    // DtoaMinBufferLength characters, which must not spill past the caller's 'last'.
+    char scratch[ScratchSize];
+
+    char* const end = FormatValue(scratch, value, fmt);
+
+    const auto size = end - scratch;
+    if (size > headroom)
+        return {last, std::errc::value_too_large};
+
+    std::memcpy(first, scratch, static_cast<size_t>(size));
+    return {first + size, std::errc()};
+}
+
+void drachennest::DtoaAppend(std::string& out, double value, chars_format fmt)
+{
+    // Grow by the worst case up front, format directly into the string's storage, and shrink
+    // to the actual length: the text is written exactly once. In the general format Dtoa's
+    // temporary-write area bounds the required headroom, not the worst-case fixed output.
+    const size_t size = out.size();
+    const size_t headroom = (fmt == chars_format::fixed) ? ScratchSize : schubfach::DtoaMinBufferLength;
+
+    out.resize(size + headroom);
+    char* const first = &out[size];
+    char* const end = FormatValue(first, value, fmt);
+    out.resize(size + static_cast<size_t>(end - first));
+}
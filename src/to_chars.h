@@ -0,0 +1,73 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <string>
+#include <system_error>
+
+namespace drachennest {
+
+// A std::to_chars-compatible front end over schubfach.
+//
+// to_chars_result res = to_chars(first, last, value, fmt);
+//
+// Converts the given double-precision number into decimal form and stores the result in
+// [first, last). In contrast to Dtoa, the buffer bounds are honored: if the buffer is too small,
+// no characters are written and res.ec == std::errc::value_too_large (with res.ptr == last).
+// On success res.ec == std::errc() and res.ptr points one past the last character written.
+// The output is _not_ null-terminated.
+//
+// The digits are the optimal (shortest round-trip) digits as produced by Dtoa; chars_format only
+// selects the textual layout:
+//  general:    fixed or scientific notation, as by Dtoa,
+//  scientific: always d[.igits]e+123,
+//  fixed:      always [digits].[digits], without an exponent.
+
+enum class chars_format {
+    fixed      = 1,
+    scientific = 2,
+    general    = fixed | scientific,
+};
+
+struct to_chars_result {
+    char* ptr;
+    std::errc ec;
+};
+
+// The longest possible output of to_chars: for the fixed format this is "0." + 323 zeros +
+// 17 digits (the smallest denormal), plus the sign. Destinations with at least this much
+// headroom are formatted in place, without an intermediate scratch buffer.
+
+constexpr int ToCharsMaxLength = 384;
+
+to_chars_result to_chars(char* first, char* last, double value, chars_format fmt = chars_format::general);
+
+// DtoaAppend(str, value, fmt);
+//
+// Appends the output of to_chars to the given string. The text is formatted directly into
+// the string's storage (grown by the worst case up front, then shrunk to the actual length),
+// so no caller-side copy of a scratch buffer is required.
+
+void DtoaAppend(std::string& out, double value, chars_format fmt = chars_format::general);
+
+// OutputIt out = DtoaTo(out, value, fmt);
+//
+// Writes the output of to_chars to the given output iterator (e.g. std::back_inserter) and
+// returns the iterator one past the last character written.
+
+template <typename OutputIt>
+inline OutputIt DtoaTo(OutputIt out, double value, chars_format fmt = chars_format::general)
+{
+    char buffer[ToCharsMaxLength];
+    const to_chars_result res = to_chars(buffer, buffer + ToCharsMaxLength, value, fmt);
+    for (const char* p = buffer; p != res.ptr; ++p)
+    {
+        *out++ = *p;
+    }
+    return out;
+}
+
+} // namespace drachennest
@@ -0,0 +1,160 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "write_file.h"
+
+#include "schubfach_64.h"
+
+#include <cassert>
+#include <cstring>
+
+#ifndef WF_ASSERT
+#define WF_ASSERT(X) assert(X)
+#endif
+
+//==================================================================================================
+//
+//==================================================================================================
+
+using drachennest::FileWriter;
+
+FileWriter::FileWriter(const char* path, size_t buffer_size)
+{
+    // Each buffer must be able to hold at least one formatted number plus its separator.
+    if (buffer_size < static_cast<size_t>(schubfach::DtoaMinBufferLength) + 1)
+        buffer_size = static_cast<size_t>(schubfach::DtoaMinBufferLength) + 1;
+
+    file_ = std::fopen(path, "wb");
+    if (file_ == nullptr)
+    {
+        failed_ = true;
+        return;
+    }
+
+    buffers_[0].resize(buffer_size);
+    buffers_[1].resize(buffer_size);
+    next_ = buffers_[0].data();
+    last_ = buffers_[0].data() + buffer_size;
+
+    writer_ = std::thread(&FileWriter::WriterThread, this);
+}
+
+FileWriter::~FileWriter()
+{
+    Finish();
+}
+
+bool FileWriter::IsOpen() const
+{
+    return file_ != nullptr;
+}
+
+void FileWriter::WriterThread()
+{
+    for (;;)
+    {
+        const char* chars;
+        size_t count;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            buffer_ready_.wait(lock, [&] { return pending_chars_ != nullptr || finished_; });
+            if (pending_chars_ == nullptr)
+                return;
+            chars = pending_chars_;
+            count = pending_count_;
+        }
+
+        const bool ok = std::fwrite(chars, 1, count, file_) == count;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!ok)
+                failed_ = true;
+            pending_chars_ = nullptr;
+            pending_count_ = 0;
+        }
+        buffer_written_.notify_one();
+    }
+}
+
+void FileWriter::FlushBuffer()
+{
+    const char* const chars = buffers_[current_].data();
+    const size_t count = static_cast<size_t>(next_ - chars);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // Wait until the writer thread is done with the other buffer, then hand it this one.
+        buffer_written_.wait(lock, [&] { return pending_chars_ == nullptr; });
+        if (count != 0 && !failed_)
+        {
+            pending_chars_ = chars;
+            pending_count_ = count;
+        }
+    }
+    buffer_ready_.notify_one();
+
+    current_ ^= 1;
+    next_ = buffers_[current_].data();
+    last_ = buffers_[current_].data() + buffers_[current_].size();
+}
+
+void FileWriter::Write(double value, char separator)
+{
+    if (file_ == nullptr)
+        return;
+
+    if (last_ - next_ < schubfach::DtoaMinBufferLength + 1)
+        FlushBuffer();
+
+    next_ = schubfach::Dtoa(next_, value);
+    *next_++ = separator;
+}
+
+void FileWriter::Write(const double* values, size_t count, char separator)
+{
+    for (size_t i = 0; i != count; ++i)
+        Write(values[i], separator);
+}
+
+void FileWriter::WriteChars(const char* chars, size_t count)
+{
+    if (file_ == nullptr)
+        return;
+
+    while (count != 0)
+    {
+        if (next_ == last_)
+            FlushBuffer();
+
+        const size_t n = count < static_cast<size_t>(last_ - next_) ? count : static_cast<size_t>(last_ - next_);
+        std::memcpy(next_, chars, n);
+        next_ += n;
+        chars += n;
+        count -= n;
+    }
+}
+
+bool FileWriter::Finish()
+{
+    if (file_ != nullptr)
+    {
+        FlushBuffer();      // flush the remaining output...
+        FlushBuffer();      // ...and wait until the writer thread is done with it
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_ = true;
+        }
+        buffer_ready_.notify_one();
+        writer_.join();
+
+        if (std::fclose(file_) != 0)
+            failed_ = true;
+        file_ = nullptr;
+    }
+
+    return !failed_;
+}
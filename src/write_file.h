@@ -0,0 +1,76 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace drachennest {
+
+// FileWriter dumps double columns to a text file, overlapping formatting and disk I/O:
+// values are formatted with schubfach::Dtoa into one buffer while the previous buffer is
+// flushed by a writer thread, so the export is bound by the slower of the two instead of
+// alternating between them.
+//
+// A buffer is handed to the writer thread once fewer than DtoaMinBufferLength + 1
+// characters remain (a formatted number plus its separator), so a single Write never splits
+// a number across buffers.
+//
+// Write failures are sticky: once a flush fails, subsequent Writes are dropped and Finish
+// (and the destructor) report the failure. The destructor flushes and closes the file, but
+// call Finish explicitly to observe errors.
+
+class FileWriter {
+public:
+    // Opens the file for writing, truncating it. 'buffer_size' is the size of each of the
+    // two buffers; each Write blocks only if the writer thread is still flushing the other.
+    explicit FileWriter(const char* path, size_t buffer_size = 1u << 20);
+    ~FileWriter();
+
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    // Did the file open successfully?
+    bool IsOpen() const;
+
+    // Formats the given value (schubfach::Dtoa) followed by 'separator'.
+    void Write(double value, char separator = '\n');
+
+    // Formats the given values (schubfach::Dtoa), each followed by 'separator'.
+    void Write(const double* values, size_t count, char separator = '\n');
+
+    // Writes the given characters verbatim (e.g. a header line).
+    void WriteChars(const char* chars, size_t count);
+
+    // Flushes the remaining buffered output, stops the writer thread and closes the file.
+    // Returns false if the file could not be opened or any write failed.
+    bool Finish();
+
+private:
+    void FlushBuffer(); // hand the current buffer to the writer thread and swap
+    void WriterThread();
+
+    std::FILE* file_ = nullptr;
+    std::vector<char> buffers_[2];
+    char* next_ = nullptr;          // write position in the current buffer
+    char* last_ = nullptr;          // end of the current buffer
+    int current_ = 0;               // index of the buffer being formatted into
+
+    std::thread writer_;
+    std::mutex mutex_;
+    std::condition_variable buffer_ready_;
+    std::condition_variable buffer_written_;
+    const char* pending_chars_ = nullptr;   // buffer handed to the writer thread, or nullptr
+    size_t pending_count_ = 0;
+    bool finished_ = false;
+    bool failed_ = false;
+};
+
+} // namespace drachennest
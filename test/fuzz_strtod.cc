@@ -0,0 +1,109 @@
+// Fuzz target for the ryu::Strtod parser.
+//
+// Feeds arbitrary bytes to Strtod and, when the input is accepted, cross-checks the parsed
+// value against the ext/google_double_conversion reference parser. Every call is also
+// time-bounded: a pathologically slow parse (slow-path blowup) aborts just like a wrong
+// value would.
+//
+// Built with -DDRACHENNEST_LIBFUZZER=ON (clang) this is a libFuzzer entry point:
+//
+//     ./fuzz_strtod corpus/
+//
+// In the default build it is a standalone regression driver which runs each file argument
+// through the same check once, so a found corpus can be replayed anywhere:
+//
+//     ./fuzz_strtod crash-* corpus/*
+
+#include "../src/ryu_64.h"
+
+#include "double-conversion/double-conversion.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static inline uint64_t BitsFromDouble(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    const char* const first = reinterpret_cast<const char*>(data);
+    const char* const last = first + size;
+
+    double value = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto res = ryu::Strtod(first, last, value);
+    const auto stop = std::chrono::steady_clock::now();
+
+    // Slow-path blowups are bugs, too. One second for a bounded-length number is orders of
+    // magnitude beyond the dragon4 worst case.
+    if (std::chrono::duration<double>(stop - start).count() > 1.0)
+    {
+        std::fprintf(stderr, "fuzz_strtod: parse took too long (%zu bytes)\n", size);
+        std::abort();
+    }
+
+    if (!res)
+        return 0;
+
+    if (res.status == ryu::StrtodStatus::inf)
+    {
+        if (!std::isinf(value))
+            std::abort();
+        return 0;
+    }
+    if (res.status == ryu::StrtodStatus::nan)
+    {
+        if (!std::isnan(value))
+            std::abort();
+        return 0;
+    }
+
+    // A numeric parse consumed exactly [+-]?digits[.digits][(e|E)...]; the strict reference
+    // parser must accept the same characters and produce the same bits.
+    const double_conversion::StringToDoubleConverter s2d(0, 0.0, std::nan(""), nullptr, nullptr);
+    int processed = 0;
+    const double reference = s2d.StringToDouble(first, static_cast<int>(res.next - first), &processed);
+    if (std::isnan(reference) || BitsFromDouble(reference) != BitsFromDouble(value))
+    {
+        std::fprintf(stderr, "fuzz_strtod: mismatch on \"%.*s\": got %.17g, reference %.17g\n",
+            static_cast<int>(res.next - first), first, value, reference);
+        std::abort();
+    }
+
+    return 0;
+}
+
+#if FUZZ_STANDALONE
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::FILE* const file = std::fopen(argv[i], "rb");
+        if (file == nullptr)
+        {
+            std::fprintf(stderr, "fuzz_strtod: cannot open '%s'\n", argv[i]);
+            return 2;
+        }
+
+        char buffer[1 << 16];
+        const size_t size = std::fread(buffer, 1, sizeof(buffer), file);
+        std::fclose(file);
+
+        LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(buffer), size);
+        std::printf("fuzz_strtod: %s ok (%zu bytes)\n", argv[i], size);
+    }
+
+    return 0;
+}
+
+#endif // FUZZ_STANDALONE
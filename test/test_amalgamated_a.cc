@@ -0,0 +1,83 @@
+// Smoke test for the generated single-header amalgamation (scripts/amalgamate.py).
+//
+// The header is included from two translation units (this one and test_amalgamated_b.cc) to
+// prove that every definition is inline and the link stays ODR-clean; the conversions are
+// then checked against hard-coded strings and a randomized Dtoa -> Strtod round-trip. This
+// target deliberately does _not_ link the drachennest library -- the amalgamation defines
+// the same public names, and mixing the two would itself be an ODR violation.
+
+#include "drachennest_amalgamated.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Defined in test_amalgamated_b.cc.
+bool RoundTripInOtherTu(double value);
+
+static int num_failures = 0;
+
+static void CheckDtoa(double value, const char* expected)
+{
+    char buf[schubfach::DtoaMaxLength];
+    char* const end = schubfach::Dtoa(buf, value);
+    if (static_cast<size_t>(end - buf) != std::strlen(expected) || std::memcmp(buf, expected, std::strlen(expected)) != 0)
+    {
+        std::fprintf(stderr, "FAIL: Dtoa produced \"%.*s\", expected \"%s\"\n",
+            static_cast<int>(end - buf), buf, expected);
+        ++num_failures;
+    }
+}
+
+static double DoubleFromBits(uint64_t bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int main()
+{
+    CheckDtoa(0.0, "0");
+    CheckDtoa(-0.0, "-0");
+    CheckDtoa(1.5, "1.5");
+    CheckDtoa(0.1, "0.1");
+    CheckDtoa(1e+100, "1e+100");
+    CheckDtoa(DoubleFromBits(0x0000000000000001), "5e-324");
+    CheckDtoa(DoubleFromBits(0x7FEFFFFFFFFFFFFF), "1.7976931348623157e+308");
+
+    uint64_t bits = 0;
+    for (int i = 0; i < 100000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        bits &= 0x7FEFFFFFFFFFFFFF; // +0.0 ... +max, no infinities or NaNs
+
+        const double value = DoubleFromBits(bits);
+
+        char buf[schubfach::DtoaMaxLength];
+        char* const end = schubfach::Dtoa(buf, value);
+
+        double parsed = 0;
+        const ryu::StrtodResult res = ryu::Strtod(buf, end, parsed);
+        if (!res || res.next != end || parsed != value)
+        {
+            std::fprintf(stderr, "FAIL: round-trip of \"%.*s\"\n", static_cast<int>(end - buf), buf);
+            ++num_failures;
+        }
+
+        if (!RoundTripInOtherTu(value))
+        {
+            std::fprintf(stderr, "FAIL: round-trip of %.17g in the other translation unit\n", value);
+            ++num_failures;
+        }
+    }
+
+    if (num_failures != 0)
+    {
+        std::fprintf(stderr, "%d failure(s).\n", num_failures);
+        return 1;
+    }
+
+    std::printf("All tests passed.\n");
+    return 0;
+}
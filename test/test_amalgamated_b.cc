@@ -0,0 +1,15 @@
+// Second translation unit of the amalgamation smoke test (see test_amalgamated_a.cc): the
+// generated header is included here as well, so the link fails if any of its definitions is
+// not inline.
+
+#include "drachennest_amalgamated.h"
+
+bool RoundTripInOtherTu(double value)
+{
+    char buf[schubfach::DtoaMaxLength];
+    char* const end = schubfach::Dtoa(buf, value);
+
+    double parsed = 0;
+    const ryu::StrtodResult res = ryu::Strtod(buf, end, parsed);
+    return res && res.next == end && parsed == value;
+}
@@ -0,0 +1,40 @@
+#include "catch.hpp"
+
+#include "../src/cpu_dispatch.h"
+#include "../src/schubfach_64.h"
+
+#include <cstring>
+#include <string>
+
+TEST_CASE("CpuDispatch")
+{
+    // The features are detected once; asking twice must return the same answer.
+    const drachennest::CpuFeatures& cpu1 = drachennest::CpuInfo();
+    const drachennest::CpuFeatures& cpu2 = drachennest::CpuInfo();
+    CHECK(&cpu1 == &cpu2);
+
+    CHECK(drachennest::DtoaDispatch != nullptr);
+    CHECK(drachennest::StrtodDispatch != nullptr);
+
+    // The dispatched kernels implement the schubfach::Dtoa resp. ryu::Strtod contracts.
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 10000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        bits &= 0x7FEFFFFFFFFFFFFF;
+
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+
+        char buf1[schubfach::DtoaMaxLength];
+        char buf2[schubfach::DtoaMaxLength];
+        char* const end1 = schubfach::Dtoa(buf1, value);
+        char* const end2 = drachennest::DtoaDispatch(buf2, value);
+        CHECK(std::string(buf1, end1) == std::string(buf2, end2));
+
+        double parsed;
+        const auto res = drachennest::StrtodDispatch(buf2, end2, parsed);
+        CHECK(res.status != ryu::StrtodStatus::invalid);
+        CHECK(parsed == value);
+    }
+}
@@ -3,19 +3,35 @@
 #include "double-conversion/double-conversion.h"
 
 #include "grisu2.h"
+#include "grisu2_32.h"
 #include "grisu2b.h"
 #include "grisu3.h"
 #include "ryu_32.h"
 #include "ryu_64.h"
+#include "dragon4.h"
+#include "schubfach_16.h"
+#include "schubfach_constexpr.h"
 #include "schubfach_32.h"
 #include "schubfach_64.h"
+#include "schubfach_range.h"
 #include "dragonbox.h"
+#include "dragonbox_32.h"
+#include "drachennest_c.h"
+#include "dtoa_cache.h"
+#include "format.h"
+#include "to_chars.h"
 
 #include <cassert>
+#include <cfloat>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 #include <cmath>
 
 #include "scan_number.h"
@@ -88,6 +104,7 @@ struct D2S_Grisu2
 {
     bool Optimal() const { return false; }
     const char* Name() const { return "grisu2"; }
+    char* operator()(char* buf, int /*buflen*/, float f) { return grisu2::Ftoa(buf, f); }
     char* operator()(char* buf, int /*buflen*/, double f) { return grisu2::Dtoa(buf, f); }
 };
 
@@ -125,6 +142,7 @@ struct D2S_Dragonbox
 {
     bool Optimal() const { return true; }
     const char* Name() const { return "dragonbox"; }
+    char* operator()(char* buf, int /*buflen*/, float f) { return dragonbox::Ftoa(buf, f); }
     char* operator()(char* buf, int /*buflen*/, double f) { return dragonbox::Dtoa(buf, f); }
 };
 
@@ -295,8 +313,10 @@ static void CheckSingle(Converter d2s, float f0)
 static void CheckSingle(float f)
 {
     CheckSingle(D2S_DoubleConversion{}, f);
+    CheckSingle(D2S_Grisu2{}, f);
     CheckSingle(D2S_Ryu{}, f);
     CheckSingle(D2S_Schubfach{}, f);
+    CheckSingle(D2S_Dragonbox{}, f);
 }
 
 inline void CheckSingleBits(uint32_t bits)
@@ -330,6 +350,7 @@ static void CheckSingle(float value, const std::string& expected)
     CheckSingle(D2S_DoubleConversion{}, value, expected);
     CheckSingle(D2S_Ryu{}, value, expected);
     CheckSingle(D2S_Schubfach{}, value, expected);
+    CheckSingle(D2S_Dragonbox{}, value, expected);
 }
 
 static void CheckSingleBits(uint32_t bits, const std::string& expected)
@@ -759,6 +780,107 @@ TEST_CASE("Single - Ryu")
     CheckSingleBits(0x5B99C7AD, "86570435000000000");
 }
 
+// Some numbers to check different code paths in grisu2::Ftoa
+TEST_CASE("Single - Grisu2 code paths")
+{
+    CheckSingleBits(0x461C4000); // 10000 (small integer shortcut)
+    CheckSingleBits(0x49927C00); // 1200000
+    CheckSingleBits(0x00000001); // 1e-45 (DigitGen: exit integral loop)
+    CheckSingleBits(0x007FFFFF); // 1.1754942e-38 (DigitGen: exit fractional loop)
+    CheckSingleBits(0x0B000000); // lower boundary is closer
+    CheckSingleBits(0x7F7FFFFF); // max normal
+    CheckSingleBits(0x3F9E0610);
+    CheckSingleBits(0x4F80004F);
+    CheckSingleBits(0x2D13C428);
+}
+
+TEST_CASE("Single - ToDecimal32Batch")
+{
+    // Compare the SoA batch output against Ftoa: after moving trailing zeros into the
+    // exponent, both must produce the same decimal.
+    const auto CheckBatch = [](const std::vector<float>& values) {
+        std::vector<uint32_t> digits(values.size());
+        std::vector<int8_t> exponents(values.size());
+        std::vector<uint8_t> lengths(values.size());
+        schubfach::ToDecimal32Batch(values.data(), values.size(), digits.data(), exponents.data(), lengths.data());
+
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            char buf[schubfach::FtoaMinBufferLength];
+            char* const end = schubfach::Ftoa(buf, values[i]);
+            const auto expected = ScanNumber(buf, end);
+
+            CAPTURE(values[i]);
+            CHECK(std::to_string(digits[i]).size() == lengths[i]);
+
+            uint32_t d = digits[i];
+            int e = exponents[i];
+            while (d % 10 == 0)
+            {
+                d /= 10;
+                ++e;
+            }
+            CHECK(std::to_string(d) == expected.digits);
+            CHECK(e == expected.exponent);
+        }
+    };
+
+    // Boundary values; 7 values, so both the 4-wide groups and the scalar tail run.
+    CheckBatch({1.0f, 0.5f, 3.4028235e+38f, 1.4e-45f, 2.0f, 1.0e-7f, 0.1f});
+
+    std::vector<float> values;
+    uint64_t bits = 0x0000000000000049;
+    while (values.size() < 10007)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull; // (Knuth's LCG)
+
+        const uint32_t b = static_cast<uint32_t>(bits >> 32) & 0x7FFFFFFF;
+        if (b == 0 || (b & 0x7F800000) == 0x7F800000) // finite, non-zero
+            continue;
+        values.push_back(ReinterpretBits<float>(b));
+    }
+    CheckBatch(values);
+}
+
+TEST_CASE("Single - ToDecimal32")
+{
+    // NB: The digits may contain trailing zeros; Ftoa strips them while formatting.
+    const auto db = dragonbox::ToDecimal32(0.5f);
+    CHECK(db.significand == 5000000u);
+    CHECK(db.exponent == -7);
+
+    // The IEEE overload must agree with the value overload.
+    const float value = 12345.679f;
+    const uint32_t bits = ReinterpretBits<uint32_t>(value);
+    const uint32_t f = bits & 0x007FFFFFu;
+    const uint32_t e = (bits >> 23) & 0xFF;
+
+    const auto db2 = dragonbox::ToDecimal32(f, e);
+    CHECK(db2.significand == dragonbox::ToDecimal32(value).significand);
+    CHECK(db2.exponent == dragonbox::ToDecimal32(value).exponent);
+
+    // dragonbox::Ftoa and schubfach::Ftoa both produce the shortest correctly-rounded
+    // digits, so their outputs must agree byte for byte. (test_exhaustive_f32 checks this
+    // for every bit pattern; this is the smoke-test version.)
+    uint64_t lcg = 0x0000000000000051;
+    for (int i = 0; i < 10000; ++i)
+    {
+        lcg = lcg * 6364136223846793005ull + 1442695040888963407ull;
+
+        const uint32_t b = static_cast<uint32_t>(lcg >> 32);
+        if ((b & 0x7F800000) == 0x7F800000) // keep it finite
+            continue;
+        const float v = ReinterpretBits<float>(b);
+
+        char buf1[BufSize];
+        char buf2[BufSize];
+        const std::string s1(buf1, dragonbox::Ftoa(buf1, v));
+        const std::string s2(buf2, schubfach::Ftoa(buf2, v));
+        CAPTURE(b);
+        CHECK(s1 == s2);
+    }
+}
+
 TEST_CASE("Double")
 {
     CheckDouble(MakeDouble(20, -1074), "1e-322");
@@ -779,6 +901,22 @@ TEST_CASE("Double")
     CheckDouble(MakeDouble(0, 2046, 0x000FFFFFFFFFFFFF), "1.7976931348623157e+308"); // max normal
 }
 
+TEST_CASE("Double - subnormals")
+{
+    // Random subnormal bit patterns, differentially against the reference implementation
+    // (schubfach takes the specialized constant-exponent path for all of these).
+    uint64_t bits = 0x00000000000000B5;
+    for (int i = 0; i < 10000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull; // (Knuth's LCG)
+
+        const uint64_t significand = bits & 0x000FFFFFFFFFFFFFull;
+        if (significand == 0)
+            continue;
+        CheckDoubleBits(significand);
+    }
+}
+
 //inline void CheckPermutations(uint64_t e, uint64_t f)
 //{
 //    uint64_t p = next_permutation(f);
@@ -1108,3 +1246,1471 @@ TEST_CASE("Double - random numbers")
     }
 }
 #endif
+
+//==================================================================================================
+//
+//==================================================================================================
+
+TEST_CASE("Double - DtoaBatch")
+{
+    const double values[] = {1.0, -0.5, 1e+300, 5e-324, 12345.6789};
+
+    char buf[5 * schubfach::DtoaMinBufferLength];
+    char* const end = schubfach::DtoaBatch(buf, values, 5, ',');
+
+    CHECK(std::string(buf, end) == "1,-0.5,1e+300,5e-324,12345.6789");
+    CHECK(schubfach::DtoaBatch(buf, values, 0) == buf);
+}
+
+TEST_CASE("Double - Dragonbox DtoaBatch")
+{
+    // Groups of four finite, non-zero values take the ToDecimal64x4 kernel; the zero, the
+    // infinity and the NaN force the scalar path in between.
+    const double values[] = {
+        1.0, -0.5, 1e+300, 5e-324,
+        0.0, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN(), -0.0,
+        12345.6789, 0.1, -2.5, 1e-7,
+    };
+
+    char buf[12 * (dragonbox::DtoaMaxLength + 1)];
+    char* const end = dragonbox::DtoaBatch(buf, values, 12, ',');
+
+    CHECK(std::string(buf, end) == "1,-0.5,1e+300,5e-324,0,inf,nan,-0,12345.6789,0.1,-2.5,0.0000001");
+    CHECK(dragonbox::DtoaBatch(buf, values, 0) == buf);
+
+    // The batch output must be byte-identical to the per-value output.
+    uint64_t bits = 0;
+    for (int lap = 0; lap < 1000; ++lap)
+    {
+        double group[4];
+        for (int j = 0; j < 4; ++j)
+        {
+            bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+            const uint64_t masked = bits & 0x7FEFFFFFFFFFFFFF;
+            group[j] = ReinterpretBits<double>(masked != 0 ? masked : uint64_t{1});
+        }
+
+        dragonbox::FloatingDecimal64 dec[4];
+        dragonbox::ToDecimal64x4(group, dec);
+        for (int j = 0; j < 4; ++j)
+        {
+            const auto ref = dragonbox::ToDecimal64(group[j]);
+            CHECK(dec[j].significand == ref.significand);
+            CHECK(dec[j].exponent == ref.exponent);
+        }
+
+        char batch[4 * (dragonbox::DtoaMaxLength + 1)];
+        char* const batch_end = dragonbox::DtoaBatch(batch, group, 4, ',');
+
+        std::string ref;
+        for (int j = 0; j < 4; ++j)
+        {
+            char single[dragonbox::DtoaMaxLength];
+            if (j != 0)
+                ref += ',';
+            ref.append(single, dragonbox::Dtoa(single, group[j]));
+        }
+        CHECK(std::string(batch, batch_end) == ref);
+    }
+}
+
+TEST_CASE("Double - ToDecimal64")
+{
+    // NB: The digits may contain trailing zeros; Dtoa strips them while formatting.
+    const auto sf = schubfach::ToDecimal64(0.5);
+    CHECK(sf.digits == 5000000000000000ull);
+    CHECK(sf.exponent == -16);
+
+    const auto db = dragonbox::ToDecimal64(0.5);
+    CHECK(db.significand == 5000000000000000ull);
+    CHECK(db.exponent == -16);
+
+    // The IEEE overloads must agree with the value overloads.
+    const double value = 12345.6789;
+    const uint64_t bits = ReinterpretBits<uint64_t>(value);
+    const uint64_t f = bits & 0x000FFFFFFFFFFFFFull;
+    const uint64_t e = (bits >> 52) & 0x7FF;
+
+    const auto sf2 = schubfach::ToDecimal64(f, e);
+    CHECK(sf2.digits == schubfach::ToDecimal64(value).digits);
+    CHECK(sf2.exponent == schubfach::ToDecimal64(value).exponent);
+
+    const auto db2 = dragonbox::ToDecimal64(f, e);
+    CHECK(db2.significand == dragonbox::ToDecimal64(value).significand);
+    CHECK(db2.exponent == dragonbox::ToDecimal64(value).exponent);
+}
+
+static std::string DtoaFixedStr(double value, int precision)
+{
+    char buf[512];
+    char* end = schubfach::DtoaFixed(buf, value, precision);
+    return std::string(buf, end);
+}
+
+static std::string DtoaExpStr(double value, int precision)
+{
+    char buf[64];
+    char* end = schubfach::DtoaExp(buf, value, precision);
+    return std::string(buf, end);
+}
+
+TEST_CASE("Double - DtoaFixed")
+{
+    CHECK(DtoaFixedStr(0.0, 0) == "0");
+    CHECK(DtoaFixedStr(0.0, 2) == "0.00");
+    CHECK(DtoaFixedStr(-0.0, 2) == "-0.00");
+    CHECK(DtoaFixedStr(1.0, 0) == "1");
+    CHECK(DtoaFixedStr(1.0, 3) == "1.000");
+    CHECK(DtoaFixedStr(-1.5, 1) == "-1.5");
+    CHECK(DtoaFixedStr(1234.5678, 2) == "1234.57");
+    CHECK(DtoaFixedStr(1234.5678, 6) == "1234.567800");
+    CHECK(DtoaFixedStr(0.00123, 5) == "0.00123");
+    CHECK(DtoaFixedStr(0.00123, 2) == "0.00");
+    CHECK(DtoaFixedStr(0.006, 2) == "0.01");
+    CHECK(DtoaFixedStr(9.5, 0) == "10"); // round-half-even on the (exact) digits "95"
+    CHECK(DtoaFixedStr(8.5, 0) == "8");
+    CHECK(DtoaFixedStr(0.996, 2) == "1.00");
+    CHECK(DtoaFixedStr(1e+20, 0) == "100000000000000000000");
+    CHECK(DtoaFixedStr(1e+20, 2) == "100000000000000000000.00");
+    CHECK(DtoaFixedStr(5e-324, 2) == "0.00");
+    CHECK(DtoaFixedStr(std::numeric_limits<double>::infinity(), 2) == "inf");
+    CHECK(DtoaFixedStr(-std::numeric_limits<double>::infinity(), 2) == "-inf");
+    CHECK(DtoaFixedStr(std::numeric_limits<double>::quiet_NaN(), 2) == "nan");
+}
+
+TEST_CASE("Double - DtoaExp")
+{
+    CHECK(DtoaExpStr(0.0, 0) == "0e+00");
+    CHECK(DtoaExpStr(0.0, 2) == "0.00e+00");
+    CHECK(DtoaExpStr(1.0, 0) == "1e+00");
+    CHECK(DtoaExpStr(1.0, 3) == "1.000e+00");
+    CHECK(DtoaExpStr(-1.5, 1) == "-1.5e+00");
+    CHECK(DtoaExpStr(1234.5678, 3) == "1.235e+03");
+    CHECK(DtoaExpStr(1234.5678, 9) == "1.234567800e+03");
+    CHECK(DtoaExpStr(0.00123, 2) == "1.23e-03");
+    CHECK(DtoaExpStr(9.96, 1) == "1.0e+01"); // carry into a new digit
+    CHECK(DtoaExpStr(1e+100, 2) == "1.00e+100");
+    // NB: rounds the shortest digits "5e-324", not the exact binary expansion ("4.94e-324").
+    CHECK(DtoaExpStr(5e-324, 2) == "5.00e-324");
+    CHECK(DtoaExpStr(std::numeric_limits<double>::infinity(), 2) == "inf");
+    CHECK(DtoaExpStr(-std::numeric_limits<double>::infinity(), 2) == "-inf");
+    CHECK(DtoaExpStr(std::numeric_limits<double>::quiet_NaN(), 2) == "nan");
+}
+
+static std::string DtoaJsonStr(double value, const char* nonfinite = "null", bool keep_minus_zero = true)
+{
+    char buf1[schubfach::DtoaMaxLength];
+    char buf2[dragonbox::DtoaMaxLength];
+    char buf3[ryu::DtoaMaxLength];
+    const std::string s1(buf1, schubfach::DtoaJson(buf1, value, nonfinite, keep_minus_zero));
+    const std::string s2(buf2, dragonbox::DtoaJson(buf2, value, nonfinite, keep_minus_zero));
+    const std::string s3(buf3, ryu::DtoaJson(buf3, value, nonfinite, keep_minus_zero));
+    CHECK(s1 == s2);
+    CHECK(s1 == s3);
+    return s1;
+}
+
+TEST_CASE("Double - DtoaJson")
+{
+    CHECK(DtoaJsonStr(0.0) == "0");
+    CHECK(DtoaJsonStr(-0.0) == "-0");
+    CHECK(DtoaJsonStr(-0.0, "null", false) == "0");
+    CHECK(DtoaJsonStr(1.5) == "1.5");
+    CHECK(DtoaJsonStr(-1.5, "null", false) == "-1.5");
+    CHECK(DtoaJsonStr(1e+100) == "1e+100");
+    CHECK(DtoaJsonStr(5e-324) == "5e-324");
+    CHECK(DtoaJsonStr(std::numeric_limits<double>::infinity()) == "null");
+    CHECK(DtoaJsonStr(-std::numeric_limits<double>::infinity()) == "null");
+    CHECK(DtoaJsonStr(std::numeric_limits<double>::quiet_NaN()) == "null");
+    CHECK(DtoaJsonStr(std::numeric_limits<double>::quiet_NaN(), "0") == "0");
+
+    // Every finite output must agree with Dtoa and parse under the strict RFC 8259 number
+    // grammar (StrtodJson rejects anything a JSON parser would).
+    uint64_t bits = 1;
+    for (int i = 0; i < 10000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        bits &= 0x7FEFFFFFFFFFFFFF;
+
+        const double value = ReinterpretBits<double>(bits);
+
+        char buf[schubfach::DtoaMaxLength];
+        char* const end = schubfach::DtoaJson(buf, value);
+
+        char ref[schubfach::DtoaMaxLength];
+        char* const ref_end = schubfach::Dtoa(ref, value);
+        CHECK(std::string(buf, end) == std::string(ref, ref_end));
+
+        double parsed = 0;
+        const auto res = ryu::StrtodJson(buf, end, parsed);
+        CHECK(static_cast<bool>(res));
+        CHECK(res.next == end);
+        CHECK(parsed == value);
+    }
+}
+
+static std::string ToCharsStr(double value, drachennest::chars_format fmt, int buffer_size = 64)
+{
+    char buf[384];
+    REQUIRE(buffer_size <= 384);
+    const auto res = drachennest::to_chars(buf, buf + buffer_size, value, fmt);
+    REQUIRE(res.ec == std::errc());
+    return std::string(buf, res.ptr);
+}
+
+TEST_CASE("Double - to_chars")
+{
+    using drachennest::chars_format;
+
+    CHECK(ToCharsStr(0.0, chars_format::general) == "0");
+    CHECK(ToCharsStr(-0.0, chars_format::fixed) == "-0");
+    CHECK(ToCharsStr(0.0, chars_format::scientific) == "0e+0");
+    CHECK(ToCharsStr(1.5, chars_format::general) == "1.5");
+    CHECK(ToCharsStr(1.5, chars_format::scientific) == "1.5e+0");
+    CHECK(ToCharsStr(1.5, chars_format::fixed) == "1.5");
+    CHECK(ToCharsStr(1e+300, chars_format::scientific) == "1e+300");
+    CHECK(ToCharsStr(-12345.6789, chars_format::fixed) == "-12345.6789");
+    CHECK(ToCharsStr(1e-6, chars_format::fixed) == "0.000001");
+    CHECK(ToCharsStr(1e-6, chars_format::scientific) == "1e-6");
+    CHECK(ToCharsStr(1e+20, chars_format::fixed, 21) == "100000000000000000000");
+    CHECK(ToCharsStr(5e-324, chars_format::fixed, 384) == "0." + std::string(323, '0') + "5");
+    CHECK(ToCharsStr(std::numeric_limits<double>::infinity(), chars_format::general) == "inf");
+    CHECK(ToCharsStr(-std::numeric_limits<double>::quiet_NaN(), chars_format::general, 4) == "-nan");
+
+    // The buffer bounds must be honored: nothing is written if the output does not fit.
+    char buf[8];
+    std::memset(buf, 'x', sizeof(buf));
+    const auto res = drachennest::to_chars(buf, buf + 8, 12345.6789, chars_format::general);
+    CHECK(res.ec == std::errc::value_too_large);
+    CHECK(res.ptr == buf + 8);
+    CHECK(std::string(buf, 8) == "xxxxxxxx");
+
+    const auto res2 = drachennest::to_chars(buf, buf + 8, 0.109375, chars_format::general);
+    CHECK(res2.ec == std::errc());
+    CHECK(std::string(buf, res2.ptr) == "0.109375");
+
+    // The in-place path (large destination) and the scratch path (exact-size destination)
+    // must produce identical output.
+    for (const double value : {1.5, -12345.6789, 1e-6, 5e-324, 1.7976931348623157e308})
+    {
+        for (const auto fmt : {chars_format::general, chars_format::scientific, chars_format::fixed})
+        {
+            const std::string expected = ToCharsStr(value, fmt, 384);
+            CHECK(ToCharsStr(value, fmt, static_cast<int>(expected.size())) == expected);
+        }
+    }
+}
+
+TEST_CASE("Double - DtoaAppend")
+{
+    using drachennest::chars_format;
+
+    std::string out = "x = ";
+    drachennest::DtoaAppend(out, 1.5);
+    CHECK(out == "x = 1.5");
+
+    drachennest::DtoaAppend(out, -0.25, chars_format::fixed);
+    CHECK(out == "x = 1.5-0.25");
+
+    drachennest::DtoaAppend(out, 1e+300, chars_format::scientific);
+    CHECK(out == "x = 1.5-0.251e+300");
+
+    out.clear();
+    drachennest::DtoaAppend(out, 5e-324, chars_format::fixed);
+    CHECK(out == "0." + std::string(323, '0') + "5");
+
+    // The appended text must match to_chars exactly.
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const double value = ReinterpretBits<double>(bits);
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        bits &= 0x7FEFFFFFFFFFFFFF; // keep it finite
+
+        out.clear();
+        drachennest::DtoaAppend(out, value);
+        CHECK(out == ToCharsStr(value, chars_format::general));
+    }
+}
+
+TEST_CASE("Double - DtoaTo")
+{
+    using drachennest::chars_format;
+
+    std::string out;
+    drachennest::DtoaTo(std::back_inserter(out), 1.5);
+    drachennest::DtoaTo(std::back_inserter(out), -0.25, chars_format::fixed);
+    CHECK(out == "1.5-0.25");
+
+    // A char* is an output iterator, too.
+    char buf[64];
+    char* const end = drachennest::DtoaTo(buf, 12345.6789);
+    CHECK(std::string(buf, end) == "12345.6789");
+}
+
+static std::string DtoaApproxStr(double value, int max_digits)
+{
+    char buf[grisu2b::DtoaMinBufferLength];
+    char* end = grisu2b::DtoaApprox(buf, value, max_digits);
+    return std::string(buf, end);
+}
+
+TEST_CASE("Double - DtoaApprox")
+{
+    CHECK(DtoaApproxStr(0.0, 6) == "0");
+    CHECK(DtoaApproxStr(-0.0, 6) == "-0");
+    CHECK(DtoaApproxStr(std::numeric_limits<double>::infinity(), 6) == "inf");
+    CHECK(DtoaApproxStr(-std::numeric_limits<double>::infinity(), 6) == "-inf");
+    CHECK(DtoaApproxStr(std::numeric_limits<double>::quiet_NaN(), 6) == "nan");
+
+    CHECK(DtoaApproxStr(1.5, 6) == "1.5");
+    CHECK(DtoaApproxStr(-2500.0, 6) == "-2500");
+    CHECK(DtoaApproxStr(3.141592653589793, 6) == "3.14159");
+    CHECK(DtoaApproxStr(3.141592653589793, 1) == "3");
+    CHECK(DtoaApproxStr(2.718281828459045, 4) == "2.718");
+    CHECK(DtoaApproxStr(0.000123456789, 4) == "0.0001235");
+    CHECK(DtoaApproxStr(999999.9, 6) == "1000000"); // round-up carries through all digits
+    CHECK(DtoaApproxStr(1.25e+25, 3) == "1.25e+25");
+    CHECK(DtoaApproxStr(6.62607015e-34, 3) == "6.63e-34");
+
+    // For any precision the output must parse back to within half a unit in the last
+    // generated digit (plus the slack of the approximate scaling).
+    uint64_t bits = 0x0000000000000017;
+    for (int i = 0; i < 100000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        bits &= 0x7FEFFFFFFFFFFFFF; // keep it finite
+
+        const double value = ReinterpretBits<double>(bits);
+        const std::string str = DtoaApproxStr(value, 6);
+
+        double parsed = 0;
+        const auto res = ryu::Strtod(str.data(), str.data() + str.size(), parsed);
+        CHECK(static_cast<bool>(res));
+        CHECK(res.next == str.data() + str.size());
+
+        const double tolerance = std::fabs(value) * 1.0e-5;
+        if (!(std::fabs(parsed - value) <= tolerance))
+        {
+            CAPTURE(value);
+            CAPTURE(str);
+            CHECK(std::fabs(parsed - value) <= tolerance);
+            break;
+        }
+    }
+}
+
+//==================================================================================================
+//
+//==================================================================================================
+
+static std::string HtoaStr(uint16_t bits)
+{
+    char buf[schubfach::HtoaMinBufferLength];
+    char* end = schubfach::Htoa(buf, bits);
+    return std::string(buf, end);
+}
+
+static std::string BtoaStr(uint16_t bits)
+{
+    char buf[schubfach::HtoaMinBufferLength];
+    char* end = schubfach::Btoa(buf, bits);
+    return std::string(buf, end);
+}
+
+TEST_CASE("Half")
+{
+    CHECK(HtoaStr(0x0000) == "0");
+    CHECK(HtoaStr(0x8000) == "-0");
+    CHECK(HtoaStr(0x0001) == "6e-8");       // min denormal
+    CHECK(HtoaStr(0x03FF) == "0.000061");   // max denormal
+    CHECK(HtoaStr(0x0400) == "0.00006104"); // min normal
+    CHECK(HtoaStr(0x0401) == "0.0000611");
+    CHECK(HtoaStr(0x3C00) == "1");
+    CHECK(HtoaStr(0x3C01) == "1.001");
+    CHECK(HtoaStr(0x3555) == "0.3333");
+    CHECK(HtoaStr(0xC500) == "-5");
+    CHECK(HtoaStr(0x7BFF) == "65500");      // max normal
+    CHECK(HtoaStr(0x7C00) == "inf");
+    CHECK(HtoaStr(0xFC00) == "-inf");
+    CHECK(HtoaStr(0x7E00) == "nan");
+}
+
+TEST_CASE("BFloat16")
+{
+    CHECK(BtoaStr(0x0000) == "0");
+    CHECK(BtoaStr(0x0001) == "9e-41");    // min denormal
+    CHECK(BtoaStr(0x007F) == "1.17e-38"); // max denormal
+    CHECK(BtoaStr(0x0080) == "1.18e-38"); // min normal
+    CHECK(BtoaStr(0x3F80) == "1");
+    CHECK(BtoaStr(0x3F81) == "1.01");
+    CHECK(BtoaStr(0x4049) == "3.14");
+    CHECK(BtoaStr(0xC2F7) == "-123.5");
+    CHECK(BtoaStr(0x7F7F) == "3.39e+38"); // max normal
+    CHECK(BtoaStr(0x7F80) == "inf");
+    CHECK(BtoaStr(0xFF80) == "-inf");
+    CHECK(BtoaStr(0x7FC0) == "nan");
+}
+
+// The value of any finite 16-bit pattern is exactly representable as a double, and the positive
+// finite patterns are ordered by value. The output therefore round-trips iff the (correctly
+// rounded) parsed value is closer to the input than to either of its neighbors (ties going to
+// the even significand).
+static void CheckAll16(char* (*dtoa16)(char*, uint16_t), int significand_size, int exponent_bias, uint32_t max_finite_bits)
+{
+    const auto value16 = [=](uint32_t bits) {
+        const uint32_t significand_mask = (uint32_t{1} << (significand_size - 1)) - 1;
+        const uint32_t f = bits & significand_mask;
+        const uint32_t e = bits >> (significand_size - 1);
+        const uint64_t c = (e != 0) ? ((significand_mask + 1) | f) : f;
+        const int q = static_cast<int>(e != 0 ? e : 1) - exponent_bias;
+        return std::ldexp(static_cast<double>(c), q);
+    };
+
+    for (uint32_t bits = 1; bits <= max_finite_bits; ++bits)
+    {
+        CAPTURE(bits);
+
+        char buf[schubfach::HtoaMinBufferLength];
+        char* end = dtoa16(buf, static_cast<uint16_t>(bits));
+
+        double parsed = 0;
+        const auto res = ryu::Strtod(buf, end, parsed);
+        CHECK(res.next == end);
+
+        const double v = value16(bits);
+        const double dist = std::fabs(parsed - v);
+
+        const double lo = value16(bits - 1);
+        const double dist_lo = std::fabs(parsed - lo);
+        CHECK((dist < dist_lo || (dist == dist_lo && bits % 2 == 0)));
+
+        if (bits < max_finite_bits)
+        {
+            const double hi = value16(bits + 1);
+            const double dist_hi = std::fabs(parsed - hi);
+            CHECK((dist < dist_hi || (dist == dist_hi && bits % 2 == 0)));
+        }
+    }
+}
+
+TEST_CASE("Half - all values")
+{
+    CheckAll16(schubfach::Htoa, 11, 15 + 10, 0x7BFF);
+}
+
+TEST_CASE("BFloat16 - all values")
+{
+    CheckAll16(schubfach::Btoa, 8, 127 + 7, 0x7F7F);
+}
+
+// Canary-guarded slots for every 16-bit pattern (cf. "Dtoa - max length"): Htoa/Btoa must
+// never write before the buffer or past buffer + HtoaMinBufferLength. Negative values used
+// to overflow the bound by one character (the sign plus a 32-character zero fill).
+static void CheckWriteBound16(char* (*dtoa16)(char*, uint16_t))
+{
+    for (uint32_t bits = 0; bits <= 0xFFFF; ++bits)
+    {
+        char storage[8 + schubfach::HtoaMinBufferLength + 8];
+        std::memset(storage, '#', sizeof(storage));
+
+        char* const buffer = storage + 8;
+        char* const end = dtoa16(buffer, static_cast<uint16_t>(bits));
+
+        CAPTURE(bits);
+        CHECK(end - buffer >= 1);
+        CHECK(end - buffer <= schubfach::HtoaMinBufferLength);
+
+        bool canaries_intact = true;
+        for (int i = 0; i < 8; ++i)
+        {
+            canaries_intact = canaries_intact
+                && storage[i] == '#'
+                && buffer[schubfach::HtoaMinBufferLength + i] == '#';
+        }
+        CHECK(canaries_intact);
+    }
+}
+
+TEST_CASE("Half - max length")
+{
+    CheckWriteBound16(schubfach::Htoa);
+}
+
+TEST_CASE("BFloat16 - max length")
+{
+    CheckWriteBound16(schubfach::Btoa);
+}
+
+// Encodes (-1)^sign * coefficient * 10^exponent as BID decimal64.
+static uint64_t MakeDecimal64(bool sign, uint64_t coefficient, int exponent)
+{
+    const uint64_t biased_exponent = static_cast<uint64_t>(exponent + 398);
+    const uint64_t sign_bit = sign ? 0x8000000000000000ull : 0;
+
+    if (coefficient < 0x0020000000000000ull) // fits into 53 bits
+        return sign_bit | (biased_exponent << 53) | coefficient;
+    else
+        return sign_bit | 0x6000000000000000ull | (biased_exponent << 51) | (coefficient & 0x0007FFFFFFFFFFFFull);
+}
+
+static std::string Dec64Str(uint64_t bid_bits)
+{
+    char buf[schubfach::DtoaMaxLength];
+    char* end = schubfach::DtoaDecimal64(buf, bid_bits);
+    return std::string(buf, end);
+}
+
+TEST_CASE("Decimal64")
+{
+    CHECK(Dec64Str(MakeDecimal64(false, 0, 0)) == "0");
+    CHECK(Dec64Str(MakeDecimal64(true, 0, 0)) == "-0");
+    CHECK(Dec64Str(MakeDecimal64(false, 0, 100)) == "0"); // all cohort members of zero print "0"
+    CHECK(Dec64Str(MakeDecimal64(false, 1, 0)) == "1");
+    CHECK(Dec64Str(MakeDecimal64(false, 100, -2)) == "1"); // trailing zeros are stripped
+    CHECK(Dec64Str(MakeDecimal64(false, 42, 0)) == "42");
+    CHECK(Dec64Str(MakeDecimal64(false, 5, -1)) == "0.5");
+    CHECK(Dec64Str(MakeDecimal64(false, 12345, -3)) == "12.345");
+    CHECK(Dec64Str(MakeDecimal64(true, 12345, -3)) == "-12.345");
+    CHECK(Dec64Str(MakeDecimal64(false, 101, 2)) == "10100");
+
+    // Values that are not representable as binary doubles print exactly.
+    CHECK(Dec64Str(MakeDecimal64(false, 1, -1)) == "0.1");
+    CHECK(Dec64Str(MakeDecimal64(false, 9999999999999999ull, 0)) == "9999999999999999");
+
+    // The 54-bit coefficient form (an implicit '100' prefix).
+    CHECK(Dec64Str(MakeDecimal64(false, 9007199254740993ull, 0)) == "9007199254740993");
+    CHECK(Dec64Str(MakeDecimal64(true, 9999999999999999ull, -15)) == "-9.999999999999999");
+
+    // The extremes of the exponent range.
+    CHECK(Dec64Str(MakeDecimal64(false, 1, -398)) == "1e-398");
+    CHECK(Dec64Str(MakeDecimal64(false, 9999999999999999ull, 369)) == "9.999999999999999e+384");
+    CHECK(Dec64Str(MakeDecimal64(false, 1, 369)) == "1e+369");
+
+    // Non-canonical encodings (coefficient >= 10^16) represent zero.
+    CHECK(Dec64Str(MakeDecimal64(false, 10000000000000000ull, 0)) == "0");
+    CHECK(Dec64Str(MakeDecimal64(true, 11258999068426239ull, 5)) == "-0"); // largest encodable coefficient
+
+    CHECK(Dec64Str(0x7800000000000000ull) == "inf");
+    CHECK(Dec64Str(0xF800000000000000ull) == "-inf");
+    CHECK(Dec64Str(0x7C00000000000000ull) == "nan");
+    CHECK(Dec64Str(0xFC00000000000000ull) == "nan"); // the sign of nan is ignored, as for Dtoa
+}
+
+//==================================================================================================
+// DtoaStr
+//==================================================================================================
+
+// The whole point of the type: pass-by-value with no heap in sight.
+static_assert(sizeof(schubfach::DtoaString) == 32, "");
+static_assert(std::is_trivially_copyable<schubfach::DtoaString>::value, "");
+
+TEST_CASE("Double - DtoaStr")
+{
+    CHECK(schubfach::DtoaStr(0.0).view() == "0");
+    CHECK(schubfach::DtoaStr(-0.0).view() == "-0");
+    CHECK(schubfach::DtoaStr(1.5).view() == "1.5");
+    CHECK(schubfach::DtoaStr(-12345.6789).view() == "-12345.6789");
+    CHECK(schubfach::DtoaStr(std::numeric_limits<double>::infinity()).view() == "inf");
+    CHECK(schubfach::DtoaStr(std::numeric_limits<double>::quiet_NaN()).view() == "nan");
+
+    uint64_t bits = 0x00000000000000DD;
+    for (int i = 0; i < 10000; ++i)
+    {
+        const double value = ReinterpretBits<double>(bits);
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull; // (Knuth's LCG)
+        bits &= 0x7FEFFFFFFFFFFFFF; // keep it finite
+
+        const schubfach::DtoaString s = schubfach::DtoaStr(value);
+
+        char buf[schubfach::DtoaMaxLength];
+        char* const end = schubfach::Dtoa(buf, value);
+
+        CAPTURE(value);
+        REQUIRE(s.size() == end - buf);
+        CHECK(s.view() == std::string_view(buf, static_cast<size_t>(end - buf)));
+        CHECK(s.c_str()[s.size()] == '\0');
+    }
+}
+
+//==================================================================================================
+// DtoaConstexpr
+//==================================================================================================
+
+static constexpr bool CxStrEq(const schubfach::DtoaString& s, const char* expected)
+{
+    int32_t i = 0;
+    for (; expected[i] != '\0'; ++i)
+    {
+        if (i >= s.size() || s.chars[i] != expected[i])
+            return false;
+    }
+    return i == s.size();
+}
+
+// The whole point: these run in the compiler, the strings are .rodata.
+static_assert(CxStrEq(schubfach::DtoaConstexpr(0.0), "0"), "");
+static_assert(CxStrEq(schubfach::DtoaConstexpr(-0.0), "-0"), "");
+static_assert(CxStrEq(schubfach::DtoaConstexpr(1.5), "1.5"), "");
+static_assert(CxStrEq(schubfach::DtoaConstexpr(0.1), "0.1"), "");
+static_assert(CxStrEq(schubfach::DtoaConstexpr(-1.0 / 3.0), "-0.3333333333333333"), "");
+static_assert(CxStrEq(schubfach::DtoaConstexpr(1e100), "1e+100"), "");
+static_assert(CxStrEq(schubfach::DtoaConstexpr(5e-324), "5e-324"), "");
+static_assert(CxStrEq(schubfach::DtoaConstexpr(1.7976931348623157e+308), "1.7976931348623157e+308"), "");
+static_assert(CxStrEq(schubfach::DtoaConstexpr(std::numeric_limits<double>::infinity()), "inf"), "");
+static_assert(CxStrEq(schubfach::DtoaConstexpr(-std::numeric_limits<double>::infinity()), "-inf"), "");
+static_assert(CxStrEq(schubfach::DtoaConstexpr(std::numeric_limits<double>::quiet_NaN()), "nan"), "");
+
+static_assert(schubfach::ToDecimal64Constexpr(3.0).digits == 3, "");
+static_assert(schubfach::ToDecimal64Constexpr(3.0).exponent == 0, "");
+static_assert(schubfach::ToDecimal64Constexpr(0.1).digits == 1000000000000000ull, ""); // NB: trailing zeros are stripped by the formatter, not by ToDecimal64
+static_assert(schubfach::ToDecimal64Constexpr(0.1).exponent == -16, "");
+static_assert(schubfach::ToDecimal64Constexpr(1.7976931348623157e+308).digits == 17976931348623157ull, "");
+
+TEST_CASE("DtoaConstexpr - agrees with Dtoa")
+{
+    // The constexpr variants are callable at runtime too (just slowly); use that to compare
+    // them with the runtime implementation over random values.
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 10000; ++i)
+    {
+        const double value = ReinterpretBits<double>(bits);
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull; // (Knuth's LCG)
+        bits &= 0x7FEFFFFFFFFFFFFF; // keep it finite
+
+        const schubfach::DtoaString cx = schubfach::DtoaConstexpr(value);
+
+        char buf[schubfach::DtoaMaxLength];
+        char* const end = schubfach::Dtoa(buf, value);
+
+        CAPTURE(value);
+        REQUIRE(cx.size() == end - buf);
+        CHECK(std::memcmp(cx.data(), buf, static_cast<size_t>(cx.size())) == 0);
+        CHECK(cx.c_str()[cx.size()] == '\0');
+
+        if (value != 0.0)
+        {
+            const auto dec0 = schubfach::ToDecimal64Constexpr(value);
+            const auto dec1 = schubfach::ToDecimal64(value);
+            CHECK(dec0.digits == dec1.digits);
+            CHECK(dec0.exponent == dec1.exponent);
+        }
+    }
+}
+
+//==================================================================================================
+// C API
+//==================================================================================================
+
+TEST_CASE("C API")
+{
+    CHECK(dn_abi_version() == 1);
+
+    char buf[DN_DTOA_MAX_LENGTH];
+    CHECK(std::string(buf, buf + dn_dtoa(buf, 1.5)) == "1.5");
+    CHECK(std::string(buf, buf + dn_dtoa(buf, -0.0)) == "-0");
+
+    const double values[3] = {1.0, 0.5, -2.5e-308};
+    char batch[3 * (DN_DTOA_MAX_LENGTH + 1)];
+    CHECK(std::string(batch, batch + dn_dtoa_batch(batch, values, 3, ',')) == "1,0.5,-2.5e-308");
+
+    double parsed = 0;
+    CHECK(dn_strtod("1.5x", 4, &parsed) == 3);
+    CHECK(parsed == 1.5);
+    CHECK(dn_strtod("x", 1, &parsed) == 0);
+    CHECK(parsed == 1.5); // unchanged
+
+    double many[4] = {};
+    size_t consumed = 0;
+    CHECK(dn_strtod_many("1,2,3", 5, ',', many, 4, &consumed) == 3);
+    CHECK(consumed == 5);
+    CHECK(many[0] == 1.0);
+    CHECK(many[2] == 3.0);
+}
+
+//==================================================================================================
+// Format
+//==================================================================================================
+
+TEST_CASE("Format")
+{
+    char buf[256];
+
+    {
+        char* end = drachennest::Format(buf, DRACHENNEST_FMT("ts={} val={} q={}"), 1.5, -0.25, 42);
+        CHECK(std::string(buf, end) == "ts=1.5 val=-0.25 q=42");
+    }
+    {
+        // No placeholders: a pure (compile-time sized) copy.
+        char* end = drachennest::Format(buf, DRACHENNEST_FMT("hello"));
+        CHECK(std::string(buf, end) == "hello");
+    }
+    {
+        char* end = drachennest::Format(buf, DRACHENNEST_FMT(""));
+        CHECK(end == buf);
+    }
+    {
+        // Placeholders at the start, adjacent, and at the end.
+        char* end = drachennest::Format(buf, DRACHENNEST_FMT("{}{},{}"), 1.0, 2.0, 3.0);
+        CHECK(std::string(buf, end) == "12,3");
+    }
+    {
+        // Single braces are literal characters.
+        char* end = drachennest::Format(buf, DRACHENNEST_FMT("{x} = {}"), 0.1);
+        CHECK(std::string(buf, end) == "{x} = 0.1");
+    }
+    {
+        // The integer overloads route to Itoa, char is copied verbatim.
+        char* end = drachennest::Format(buf, DRACHENNEST_FMT("{}{}{}"), int64_t{-9223372036854775807 - 1}, ' ', uint64_t{18446744073709551615ull});
+        CHECK(std::string(buf, end) == "-9223372036854775808 18446744073709551615");
+    }
+
+    {
+        // The placeholders format exactly as Dtoa.
+        uint64_t bits = 0x0000000000000001;
+        for (int i = 0; i < 1000; ++i)
+        {
+            const double value = ReinterpretBits<double>(bits);
+            bits = bits * 6364136223846793005ull + 1442695040888963407ull; // (Knuth's LCG)
+            bits &= 0x7FEFFFFFFFFFFFFF; // keep it finite
+
+            char expected[BufSize];
+            char* const expected_end = schubfach::Dtoa(expected, value);
+
+            char* const end = drachennest::Format(buf, DRACHENNEST_FMT("v={}!"), value);
+            CHECK(std::string(buf, end) == "v=" + std::string(expected, expected_end) + "!");
+        }
+    }
+
+    {
+        // FormatMaxLength is usable as a (compile-time) buffer size.
+        auto fmt = DRACHENNEST_FMT("ts={} val={} q={}");
+        constexpr int32_t max_length = drachennest::FormatMaxLength<decltype(fmt), double, double, int32_t>();
+        CHECK(max_length == (17 - 6) + schubfach::DtoaMaxLength + schubfach::DtoaMaxLength + drachennest::ItoaMaxLength);
+    }
+}
+
+//==================================================================================================
+// Dragon4Fixed
+//==================================================================================================
+
+// Checks Dragon4Fixed against printf's (exact) "%.*e" formatting.
+static void CheckFixed(double value, int num_digits)
+{
+    const uint64_t bits = ReinterpretBits<uint64_t>(value);
+
+    constexpr uint64_t kSignificandMask = 0x000FFFFFFFFFFFFF;
+    constexpr uint64_t kHiddenBit = 0x0010000000000000;
+    const uint64_t physical_significand = bits & kSignificandMask;
+    const uint64_t biased_exponent = bits >> 52;
+
+    const uint64_t f = (biased_exponent == 0) ? physical_significand : (physical_significand | kHiddenBit);
+    const int e = ((biased_exponent == 0) ? 1 : static_cast<int>(biased_exponent)) - (0x3FF + 52);
+
+    char buf[128];
+    int exponent = 0;
+    char* const end = dragon4::Dragon4Fixed(buf, num_digits, exponent, f, e);
+    REQUIRE(end - buf == num_digits);
+    *end = '\0';
+
+    char expected[160];
+    std::snprintf(expected, sizeof(expected), "%.*e", num_digits - 1, value);
+
+    // "D.DDD...e+XX" ==> digits "DDDD...", exponent XX + 1
+    char expected_digits[128];
+    expected_digits[0] = expected[0];
+    std::memcpy(expected_digits + 1, expected + 2, static_cast<size_t>(num_digits - 1));
+    expected_digits[num_digits] = '\0';
+    const int expected_exponent = std::atoi(std::strchr(expected, 'e') + 1) + 1;
+
+    CAPTURE(value);
+    CAPTURE(num_digits);
+    CHECK(std::strcmp(buf, expected_digits) == 0);
+    CHECK(exponent == expected_exponent);
+}
+
+TEST_CASE("Dragon4Fixed")
+{
+    for (const int num_digits : {1, 2, 17, 50, 80})
+    {
+        CheckFixed(1.0, num_digits);
+        CheckFixed(0.1, num_digits);
+        CheckFixed(1.0 / 3.0, num_digits);
+        CheckFixed(0.95, num_digits);
+        CheckFixed(9.9999999999999999e99, num_digits);
+        CheckFixed(1.7976931348623157e308, num_digits);   // max double
+        CheckFixed(5e-324, num_digits);                   // min subnormal
+        CheckFixed(2.2250738585072014e-308, num_digits);  // min normal
+    }
+
+    // All-nines rounding: 0.999... rounds up to 1.0 and shifts the exponent.
+    CheckFixed(0.999, 2);
+    CheckFixed(0.9999999999999999, 16);
+    CheckFixed(9.999999999999999e99, 7);
+}
+
+TEST_CASE("DigitGenerator")
+{
+    // The digits must not depend on how the calls to Generate are batched, and once
+    // Finished, all further digits are zero.
+    const double value = 0.1;
+    const uint64_t bits = ReinterpretBits<uint64_t>(value);
+    const uint64_t f = (bits & 0x000FFFFFFFFFFFFF) | 0x0010000000000000;
+    const int e = static_cast<int>(bits >> 52) - (0x3FF + 52);
+
+    char all[100];
+    {
+        dragon4::Arena arena;
+        dragon4::DigitGenerator gen(arena, f, e);
+        CHECK(gen.Exponent() == 0); // 0.1 = 0.1... * 10^0
+        gen.Generate(all, 100);
+        CHECK(gen.Finished());
+    }
+
+    char pieces[100];
+    {
+        dragon4::Arena arena;
+        dragon4::DigitGenerator gen(arena, f, e);
+        char* next = pieces;
+        next = gen.Generate(next, 1);
+        next = gen.Generate(next, 9);
+        next = gen.Generate(next, 45);
+        next = gen.Generate(next, 45);
+        CHECK(next == pieces + 100);
+    }
+
+    CHECK(std::memcmp(all, pieces, 100) == 0);
+
+    // 0.1 = 0.1000000000000000055511151231257827021181583404541015625
+    // i.e. 55 significant digits, zeros afterwards.
+    CHECK(std::memcmp(all, "1000000000000000055511151231257827021181583404541015625", 55) == 0);
+    for (int i = 55; i < 100; ++i)
+    {
+        CHECK(all[i] == '0');
+    }
+}
+
+//==================================================================================================
+// Dragon4Wide
+//==================================================================================================
+
+TEST_CASE("Dragon4Wide - agrees with Dragon4")
+{
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 100000; ++i)
+    {
+        const double value = ReinterpretBits<double>(bits);
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull; // (Knuth's LCG)
+        bits &= 0x7FEFFFFFFFFFFFFF; // keep it finite
+        if (value == 0.0)
+            continue;
+
+        const uint64_t value_bits = ReinterpretBits<uint64_t>(value);
+        const uint64_t physical_significand = value_bits & 0x000FFFFFFFFFFFFF;
+        const uint64_t biased_exponent = value_bits >> 52;
+
+        const uint64_t f = (biased_exponent == 0) ? physical_significand : (physical_significand | 0x0010000000000000);
+        const int e = ((biased_exponent == 0) ? 1 : static_cast<int>(biased_exponent)) - (0x3FF + 52);
+        const bool accept_bounds = (f % 2 == 0);
+        const bool lower_boundary_is_closer = (physical_significand == 0 && biased_exponent > 1);
+
+        uint64_t digits = 0;
+        int exponent = 0;
+        dragon4::Dragon4(digits, exponent, f, e, accept_bounds, lower_boundary_is_closer);
+
+        char buf[dragon4::Dragon4WideMaxDigits];
+        int wide_exponent = 0;
+        const char* const end = dragon4::Dragon4Wide(buf, wide_exponent, 0, f, e, accept_bounds, lower_boundary_is_closer);
+
+        uint64_t wide_digits = 0;
+        for (const char* p = buf; p != end; ++p)
+        {
+            wide_digits = 10 * wide_digits + static_cast<uint32_t>(*p - '0');
+        }
+
+        CAPTURE(value);
+        CHECK(digits == wide_digits);
+        CHECK(exponent == wide_exponent);
+    }
+}
+
+#if LDBL_MANT_DIG == 64
+TEST_CASE("Dragon4Wide - x87 round-trip")
+{
+    // Decompose random x87 80-bit long doubles (64-bit significand with an explicit integer
+    // bit, i.e. f_hi = 0) and check that the shortest digits read back to the same value.
+    uint64_t rng = 0x0123456789ABCDEF;
+    for (int i = 0; i < 10000; ++i)
+    {
+        rng = rng * 6364136223846793005ull + 1442695040888963407ull; // (Knuth's LCG)
+        const uint64_t significand = rng | 0x8000000000000000; // normalized
+        rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+        const int binary_exponent = static_cast<int>(rng % 1000) - 500; // value = significand * 2^binary_exponent
+
+        const long double value = std::ldexp(static_cast<long double>(significand), binary_exponent);
+
+        char digits[dragon4::Dragon4WideMaxDigits];
+        int exponent = 0;
+        const char* const digits_end = dragon4::Dragon4Wide(digits, exponent, 0, significand, binary_exponent,
+                                                            /*accept_bounds*/ significand % 2 == 0,
+                                                            /*lower_boundary_is_closer*/ false);
+        const int num_digits = static_cast<int>(digits_end - digits);
+        REQUIRE(num_digits >= 1);
+        REQUIRE(num_digits <= 21); // x87 shortest output needs at most 21 digits
+
+        // digits * 10^exponent == 0.DDDD... * 10^(exponent + num_digits)
+        char text[64];
+        std::snprintf(text, sizeof(text), "0.%.*se%d", num_digits, digits, exponent + num_digits);
+
+        CAPTURE(text);
+        CHECK(std::strtold(text, nullptr) == value);
+    }
+}
+#endif
+
+// Checks Dragon4Wide for a small dyadic value against its (short) exact digits, encoded once
+// at x87 precision (p = 64) and once at binary128 precision (p = 113).
+static void CheckWideDyadic(uint64_t f, int e, const char* expected_digits, int expected_exponent)
+{
+    int precision = 0;
+    for (uint64_t t = f; t != 0; t >>= 1)
+    {
+        ++precision;
+    }
+
+    for (const int p : {64, 113})
+    {
+        // value = f * 2^e = (f * 2^(p - precision)) * 2^(e - (p - precision))
+        const int shift = p - precision;
+        const uint64_t f_hi = (shift < 64) ? ((shift == 0) ? 0 : (f >> (64 - shift))) : (f << (shift - 64));
+        const uint64_t f_lo = (shift < 64) ? (f << shift) : 0;
+
+        char digits[dragon4::Dragon4WideMaxDigits];
+        int exponent = 0;
+        const char* const digits_end = dragon4::Dragon4Wide(digits, exponent, f_hi, f_lo, e - shift,
+                                                            /*accept_bounds*/ true,
+                                                            /*lower_boundary_is_closer*/ false);
+
+        CAPTURE(f);
+        CAPTURE(e);
+        CAPTURE(p);
+        REQUIRE(digits_end - digits == static_cast<int>(std::strlen(expected_digits)));
+        CHECK(std::memcmp(digits, expected_digits, std::strlen(expected_digits)) == 0);
+        CHECK(exponent == expected_exponent);
+    }
+}
+
+TEST_CASE("Dragon4Wide - dyadic values")
+{
+    // Exactly representable values have the same shortest digits in every (sufficiently wide)
+    // format, so these vectors are precision-independent.
+    CheckWideDyadic(1, 0, "1", 0);              // 1
+    CheckWideDyadic(1, -1, "5", -1);            // 0.5
+    CheckWideDyadic(12345, 0, "12345", 0);      // 12345
+    CheckWideDyadic(3, -5, "9375", -5);         // 0.09375
+    CheckWideDyadic(1, -10, "9765625", -10);    // 2^-10
+    CheckWideDyadic(7, 20, "7340032", 0);       // 7 * 2^20
+}
+
+//==================================================================================================
+// Grisu3 fallback policy
+//==================================================================================================
+
+TEST_CASE("Grisu3 - FallbackPolicy")
+{
+    // Both fallback algorithms produce shortest output, so the two policies must agree
+    // exactly; the flag must not depend on the policy.
+    int num_fallbacks = 0;
+
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 100000; ++i)
+    {
+        const double value = ReinterpretBits<double>(bits);
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull; // (Knuth's LCG)
+        bits &= 0x7FEFFFFFFFFFFFFF; // keep it finite
+        if (ReinterpretBits<double>(bits) == 0.0)
+            continue;
+
+        char buf0[grisu3::DtoaMinBufferLength];
+        char buf1[grisu3::DtoaMinBufferLength];
+        const auto res0 = grisu3::Dtoa(buf0, value, grisu3::FallbackPolicy::dragon4);
+        const auto res1 = grisu3::Dtoa(buf1, value, grisu3::FallbackPolicy::schubfach);
+
+        CHECK(res0.was_fallback == res1.was_fallback);
+        REQUIRE(res0.end - buf0 == res1.end - buf1);
+        CHECK(std::memcmp(buf0, buf1, static_cast<size_t>(res0.end - buf0)) == 0);
+
+        // The plain Dtoa must be unchanged by the new entry point.
+        char buf2[grisu3::DtoaMinBufferLength];
+        char* const end2 = grisu3::Dtoa(buf2, value);
+        REQUIRE(end2 - buf2 == res0.end - buf0);
+        CHECK(std::memcmp(buf0, buf2, static_cast<size_t>(end2 - buf2)) == 0);
+
+        num_fallbacks += res0.was_fallback ? 1 : 0;
+    }
+
+    // The fallback rate is small, but not zero.
+    CHECK(num_fallbacks > 0);
+    CHECK(num_fallbacks < 100000 / 10);
+}
+
+//==================================================================================================
+// Stats
+//==================================================================================================
+
+#include "../src/stats.h"
+
+TEST_CASE("Stats")
+{
+    drachennest::StatsReset();
+
+    char buf[64];
+    grisu3::Dtoa(buf, 1.5);
+    schubfach::Dtoa(buf, 1.5);
+    dragonbox::Dtoa(buf, 1.5);
+
+    // This test runs with and without DRACHENNEST_STATS: with instrumentation compiled in,
+    // the conversions above must have been counted; without, the counters read as zero.
+    const auto stats = drachennest::StatsSnapshot();
+#if DRACHENNEST_STATS
+    CHECK(stats.grisu3_ok + stats.grisu3_fallback >= 1);
+    CHECK(stats.schubfach_integer + stats.schubfach_shorter + stats.schubfach_inside + stats.schubfach_nearest >= 1);
+    CHECK(stats.dragonbox_integer + stats.dragonbox_asymmetric + stats.dragonbox_shorter + stats.dragonbox_regular >= 1);
+
+    double value = 0;
+    const std::string input = "123456789012345678901234567890e-20"; // > 17 digits
+    ryu::Strtod(input.data(), input.data() + input.size(), value);
+    CHECK(drachennest::StatsSnapshot().strtod_long == 1);
+
+    drachennest::StatsReset();
+    CHECK(drachennest::StatsSnapshot().grisu3_ok == 0);
+#else
+    CHECK(stats.grisu3_ok == 0);
+    CHECK(stats.schubfach_nearest == 0);
+    CHECK(stats.dragonbox_regular == 0);
+#endif
+}
+
+//==================================================================================================
+// DtoaMaxLength
+//==================================================================================================
+
+// Formats into a DtoaMaxLength-sized slot surrounded by canary bytes, i.e. the in-place
+// formatting guarantee for columnar string buffers: nothing before the slot, nothing past
+// buffer + DtoaMaxLength may be written.
+template <typename Dtoa>
+static void CheckWriteBound(Dtoa dtoa, int max_length, double value)
+{
+    char storage[8 + 64 + 8];
+    std::memset(storage, '#', sizeof(storage));
+
+    char* const buffer = storage + 8;
+    char* const end = dtoa(buffer, value);
+
+    CHECK(end - buffer >= 1);
+    CHECK(end - buffer <= max_length);
+    for (int i = 0; i < 8; ++i)
+    {
+        CHECK(storage[i] == '#');
+        CHECK(buffer[max_length + i] == '#');
+    }
+}
+
+TEST_CASE("Dtoa - max length")
+{
+    const auto CheckAll = [](double value) {
+        // schubfach::Dtoa is an overload set (the range-hint template in schubfach_range.h
+        // shares the name), so wrap it for the deduced parameter.
+        CheckWriteBound([](char* p, double v) { return schubfach::Dtoa(p, v); }, schubfach::DtoaMaxLength, value);
+        CheckWriteBound(schubfach::Dtoa<-324, 309>, schubfach::DtoaFixedNotationMinBufferLength, value);
+        CheckWriteBound(dragonbox::Dtoa, dragonbox::DtoaMaxLength, value);
+        CheckWriteBound(ryu::Dtoa, ryu::DtoaMaxLength, value);
+        CheckWriteBound(schubfach::DtoaScientific, schubfach::DtoaMaxLength, value);
+        CheckWriteBound(schubfach::DtoaHex, schubfach::DtoaMaxLength, value);
+        CheckWriteBound(drachennest::CachedDtoa, schubfach::DtoaMaxLength, value);
+    };
+
+    // The worst case layouts: long digit strings on both sides of the fixed window, and the
+    // extreme exponents.
+    CheckAll(0.0);
+    CheckAll(-0.0);
+    CheckAll(1.0);
+    CheckAll(-8.8817841970012523e-7);  // "-0.00000088817841970012523" (26 chars)
+    CheckAll(8.8817841970012523e-7);
+    CheckAll(-2.2250738585072014e-308);
+    CheckAll(1.7976931348623157e+308);
+    CheckAll(5e-324);
+    CheckAll(123456789012345.67);
+    CheckAll(-99999999999999999.0);
+    CheckAll(std::numeric_limits<double>::infinity());
+    CheckAll(-std::numeric_limits<double>::infinity());
+    CheckAll(std::numeric_limits<double>::quiet_NaN());
+
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 10000; ++i)
+    {
+        CheckAll(ReinterpretBits<double>(bits));
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        bits &= 0x7FEFFFFFFFFFFFFF; // keep it finite
+    }
+}
+
+//==================================================================================================
+// Small-integer fast path
+//==================================================================================================
+
+TEST_CASE("Dtoa - small integers")
+{
+    char buf[schubfach::DtoaMinBufferLength];
+
+    // Exact integers below 2^27 take the bit-test shortcut in schubfach::Dtoa; values at and
+    // above the cutoff take the regular path. The output must be identical either way.
+    for (int64_t i = 1; i <= 1000000; ++i)
+    {
+        char* const end = schubfach::Dtoa(buf, static_cast<double>(i));
+        CHECK(std::string(buf, end) == std::to_string(i));
+    }
+
+    for (int64_t i = (int64_t{1} << 27) - 100; i <= (int64_t{1} << 27) + 100; ++i)
+    {
+        char* const end = schubfach::Dtoa(buf, static_cast<double>(i));
+        CHECK(std::string(buf, end) == std::to_string(i));
+
+        char* const neg_end = schubfach::Dtoa(buf, -static_cast<double>(i));
+        CHECK(std::string(buf, neg_end) == "-" + std::to_string(i));
+    }
+}
+
+//==================================================================================================
+// DtoaScientific
+//==================================================================================================
+
+static std::string Sci(double value)
+{
+    char buf[schubfach::DtoaMinBufferLength];
+    char* const end = schubfach::DtoaScientific(buf, value);
+    return std::string(buf, end);
+}
+
+TEST_CASE("DtoaScientific")
+{
+    CHECK(Sci(0.0) == "0.0e+000");
+    CHECK(Sci(-0.0) == "-0.0e+000");
+    CHECK(Sci(1.0) == "1.0e+000");
+    CHECK(Sci(1.5) == "1.5e+000");
+    CHECK(Sci(-1.5) == "-1.5e+000");
+    CHECK(Sci(12345.0) == "1.2345e+004");
+    CHECK(Sci(1e22) == "1.0e+022");
+    CHECK(Sci(5e-324) == "5.0e-324");
+    CHECK(Sci(2.5e-308) == "2.5e-308");
+    CHECK(Sci(1.7976931348623157e308) == "1.7976931348623157e+308");
+    CHECK(Sci(std::numeric_limits<double>::infinity()) == "inf");
+    CHECK(Sci(-std::numeric_limits<double>::infinity()) == "-inf");
+    CHECK(Sci(std::numeric_limits<double>::quiet_NaN()) == "nan");
+
+    // The digits are the same as Dtoa's, so the output must round-trip.
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 10000; ++i)
+    {
+        const double value = ReinterpretBits<double>(bits);
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        bits &= 0x7FEFFFFFFFFFFFFF; // keep it finite
+        if (ReinterpretBits<double>(bits) == 0.0)
+            continue;
+
+        const std::string str = Sci(value);
+        double parsed = 0;
+        const auto res = ryu::Strtod(str.data(), str.data() + str.size(), parsed);
+        CHECK(static_cast<bool>(res));
+        CHECK(res.next == str.data() + str.size());
+        CHECK(parsed == value);
+    }
+}
+
+//==================================================================================================
+// DtoaHex
+//==================================================================================================
+
+static std::string Hex(double value)
+{
+    char buf[schubfach::DtoaMinBufferLength];
+    char* const end = schubfach::DtoaHex(buf, value);
+    return std::string(buf, end);
+}
+
+TEST_CASE("DtoaHex")
+{
+    CHECK(Hex(0.0) == "0x0p+0");
+    CHECK(Hex(-0.0) == "-0x0p+0");
+    CHECK(Hex(1.0) == "0x1p+0");
+    CHECK(Hex(-2.0) == "-0x1p+1");
+    CHECK(Hex(3.0) == "0x1.8p+1");
+    CHECK(Hex(0.1) == "0x1.999999999999ap-4");
+    CHECK(Hex(1024.0) == "0x1p+10");
+    CHECK(Hex(std::numeric_limits<double>::epsilon()) == "0x1p-52");
+    CHECK(Hex(std::numeric_limits<double>::min()) == "0x1p-1022");
+    CHECK(Hex(std::numeric_limits<double>::max()) == "0x1.fffffffffffffp+1023");
+    CHECK(Hex(std::numeric_limits<double>::infinity()) == "inf");
+    CHECK(Hex(-std::numeric_limits<double>::infinity()) == "-inf");
+    CHECK(Hex(std::numeric_limits<double>::quiet_NaN()) == "nan");
+
+    // Subnormals are renormalized to a leading 1 digit (printf's %a keeps the exponent at
+    // -1022 and prints "0x0.0000000000001p-1022" here; both read back to the same bits).
+    CHECK(Hex(std::numeric_limits<double>::denorm_min()) == "0x1p-1074");
+    CHECK(Hex(ReinterpretBits<double>(0x000FFFFFFFFFFFFF)) == "0x1.ffffffffffffep-1023");
+
+    // The output is exact: it reads back to the input bits via the C library.
+    uint64_t bits = 0x30;
+    for (int i = 0; i < 10000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        if ((bits & 0x7FF0000000000000ull) == 0x7FF0000000000000ull)
+            continue; // keep it finite
+
+        const double value = ReinterpretBits<double>(bits);
+
+        char buf[schubfach::DtoaMaxLength + 1];
+        *schubfach::DtoaHex(buf, value) = '\0';
+
+        const double parsed = std::strtod(buf, nullptr);
+        CHECK(ReinterpretBits<uint64_t>(parsed) == bits);
+    }
+}
+
+//==================================================================================================
+// DtoaLength
+//==================================================================================================
+
+TEST_CASE("DtoaLength")
+{
+    const auto CheckLength = [](double value) {
+        char buf[schubfach::DtoaMaxLength];
+        char* const end = schubfach::Dtoa(buf, value);
+        const int length = static_cast<int>(end - buf);
+
+        CHECK(schubfach::DtoaLength(value) == length);
+
+        // The two-pass flow: compute the decimal once, then predict and format from it.
+        schubfach::FloatingDecimal64 dec = {1, 0};
+        if (value == value && value != 0.0 && value * 0.5 != value) // finite, non-zero
+            dec = schubfach::ToDecimal64(value);
+
+        CHECK(schubfach::DtoaLength(value, dec) == length);
+
+        char buf2[schubfach::DtoaMaxLength];
+        char* const end2 = schubfach::FormatKnownLength(buf2, value, dec);
+        CHECK(std::string(buf2, end2) == std::string(buf, end));
+    };
+
+    CheckLength(0.0);
+    CheckLength(-0.0);
+    CheckLength(1.0);
+    CheckLength(-1.5);
+    CheckLength(2500.0);
+    CheckLength(1e22);
+    CheckLength(-8.8817841970012523e-7);
+    CheckLength(5e-324);
+    CheckLength(1.7976931348623157e+308);
+    CheckLength(std::numeric_limits<double>::infinity());
+    CheckLength(-std::numeric_limits<double>::infinity());
+    CheckLength(std::numeric_limits<double>::quiet_NaN());
+
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 100000; ++i)
+    {
+        CheckLength(ReinterpretBits<double>(bits));
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        bits &= 0x7FEFFFFFFFFFFFFF; // keep it finite
+    }
+}
+
+//==================================================================================================
+// CachedDtoa
+//==================================================================================================
+
+TEST_CASE("CachedDtoa")
+{
+    char buf1[schubfach::DtoaMinBufferLength];
+    char buf2[schubfach::DtoaMinBufferLength];
+
+    const auto CheckSame = [&](double value) {
+        char* const end1 = schubfach::Dtoa(buf1, value);
+        char* const end2 = drachennest::CachedDtoa(buf2, value);
+        CHECK(std::string(buf1, end1) == std::string(buf2, end2));
+    };
+
+    CheckSame(0.0);
+    CheckSame(-0.0);
+    CheckSame(1.0);
+    CheckSame(-1.5);
+    CheckSame(std::numeric_limits<double>::infinity());
+    CheckSame(-std::numeric_limits<double>::infinity());
+    CheckSame(std::numeric_limits<double>::quiet_NaN());
+
+    // Repeated values (cache hits, including promotions) and fresh values (misses, evictions)
+    // must all produce Dtoa's output.
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 10000; ++i)
+    {
+        const double value = ReinterpretBits<double>(bits);
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        bits &= 0x7FEFFFFFFFFFFFFF; // keep it finite
+
+        CheckSame(value);
+        CheckSame(value);
+        CheckSame(value);
+    }
+
+    // Skewed reuse: a small working set hammered in a loop stays correct while colliding
+    // values churn through.
+    for (int i = 0; i < 1000; ++i)
+    {
+        for (int k = 0; k < 16; ++k)
+        {
+            CheckSame(static_cast<double>(k) * 0.25);
+        }
+        CheckSame(static_cast<double>(i) * 1e-3);
+    }
+}
+
+//==================================================================================================
+// DtoaFixedNotation
+//==================================================================================================
+
+static std::string FixedNotation(double value)
+{
+    char buf[schubfach::DtoaFixedNotationMinBufferLength];
+    char* const end = schubfach::DtoaFixedNotation(buf, value);
+    return std::string(buf, end);
+}
+
+TEST_CASE("DtoaFixedNotation")
+{
+    CHECK(FixedNotation(0.0) == "0");
+    CHECK(FixedNotation(-0.0) == "-0");
+    CHECK(FixedNotation(1.0) == "1");
+    CHECK(FixedNotation(1.5) == "1.5");
+    CHECK(FixedNotation(-1.5) == "-1.5");
+    CHECK(FixedNotation(0.1) == "0.1");
+    CHECK(FixedNotation(0.125) == "0.125");
+    CHECK(FixedNotation(1e-6) == "0.000001");
+    CHECK(FixedNotation(1.5e-6) == "0.0000015");
+    CHECK(FixedNotation(15.0) == "15");
+    CHECK(FixedNotation(2500.0) == "2500");
+    CHECK(FixedNotation(1e15) == "1000000000000000");
+    CHECK(FixedNotation(1234567890123456.0) == "1234567890123456");
+    CHECK(FixedNotation(9007199254740991.0) == "9007199254740991");
+    CHECK(FixedNotation(std::numeric_limits<double>::infinity()) == "inf");
+    CHECK(FixedNotation(-std::numeric_limits<double>::infinity()) == "-inf");
+    CHECK(FixedNotation(std::numeric_limits<double>::quiet_NaN()) == "nan");
+
+    // The digits are the same as Dtoa's, so the output must round-trip.
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 10000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+
+        // Map the random bits into the supported range [1e-6, 1e17).
+        const double u = static_cast<double>(bits >> 11) / 9007199254740992.0; // [0, 1)
+        const int32_t e = static_cast<int32_t>(bits % 23) - 5;                 // [-5, 17]
+        const double value = u * std::pow(10.0, e);
+        if (value < 1e-6 || value >= 1e17)
+            continue;
+
+        const std::string str = FixedNotation(value);
+        CHECK(str.find('e') == std::string::npos);
+
+        double parsed = 0;
+        const auto res = ryu::Strtod(str.data(), str.data() + str.size(), parsed);
+        CHECK(static_cast<bool>(res));
+        CHECK(res.next == str.data() + str.size());
+        CHECK(parsed == value);
+    }
+}
+
+//==================================================================================================
+// Dtoa<MinExp10, MaxExp10>
+//==================================================================================================
+
+// The range hint is an optimization only: the output must be byte-identical to Dtoa for
+// every input, whether the value is inside the declared decades or takes the fallback.
+template <int32_t MinExp10, int32_t MaxExp10>
+static void CheckRangeDtoa(double value)
+{
+    char buf[schubfach::DtoaFixedNotationMinBufferLength];
+    char* const end = schubfach::Dtoa<MinExp10, MaxExp10>(buf, value);
+
+    char ref[schubfach::DtoaMaxLength];
+    char* const ref_end = schubfach::Dtoa(ref, value);
+
+    CAPTURE(value);
+    REQUIRE(end - buf == ref_end - ref);
+    CHECK(std::memcmp(buf, ref, static_cast<size_t>(end - buf)) == 0);
+}
+
+static void CheckRangeDtoaAll(double value)
+{
+    CheckRangeDtoa<  -3,   4>(value); // sensors: fixed notation only
+    CheckRangeDtoa<   9,  10>(value); // timestamps: integer layout only
+    CheckRangeDtoa< -30, -20>(value); // scientific only (negative exponents)
+    CheckRangeDtoa<  20,  30>(value); // scientific only (positive exponents)
+    CheckRangeDtoa< -10,  20>(value); // straddles the fixed/scientific window
+    CheckRangeDtoa<-324, 309>(value); // full double range: the hint always holds
+}
+
+TEST_CASE("Dtoa - range hints")
+{
+    const double specials[] = {
+        0.0,
+        -0.0,
+        std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::quiet_NaN(),
+        std::numeric_limits<double>::denorm_min(),
+        std::numeric_limits<double>::min(),
+        std::numeric_limits<double>::max(),
+    };
+    for (const double value : specials)
+    {
+        CheckRangeDtoaAll(value);
+    }
+
+    // Decade boundaries of the ranges above, just inside and just outside.
+    const double boundaries[] = {
+        1e-3, 9.999999999999999e-4, 1e4, 9999.999999999999,
+        1e9, 1e10, 9999999999.0, 1e-30, 1e-20, 1e20, 1e30,
+        1e-7, 1e17, 1e18, 123.456, 0.5,
+    };
+    for (const double value : boundaries)
+    {
+        CheckRangeDtoaAll(value);
+        CheckRangeDtoaAll(-value);
+    }
+
+    // Random values spread over the decades around all the declared ranges; values outside
+    // a given range exercise its fallback path.
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 10000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull; // (Knuth's LCG)
+
+        const double u = static_cast<double>(bits >> 11) / 9007199254740992.0; // [0, 1)
+        const int32_t e = static_cast<int32_t>(bits % 70) - 35;                // [-35, 34]
+        const double value = u * std::pow(10.0, e);
+        if (value == 0.0)
+            continue;
+
+        CheckRangeDtoaAll(value);
+        CheckRangeDtoaAll(-value);
+    }
+
+    // And full random bit patterns against the full-range instantiation.
+    for (int i = 0; i < 10000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        bits &= 0x7FEFFFFFFFFFFFFF; // keep it finite
+
+        CheckRangeDtoa<-324, 309>(ReinterpretBits<double>(bits));
+        CheckRangeDtoa<-324, 309>(-ReinterpretBits<double>(bits));
+    }
+}
@@ -0,0 +1,326 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include "../src/dtoa_column.h"
+#include "../src/schubfach_64.h"
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+using drachennest::DtoaColumn;
+using drachennest::DtoaColumnStream;
+
+TEST_CASE("DtoaColumn")
+{
+    std::vector<double> values;
+    uint64_t bits = 0x2A;
+    for (int i = 0; i < 10000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        values.push_back(static_cast<double>(static_cast<int64_t>(bits >> 32)) * 1.0e-3);
+    }
+
+    std::string expected;
+    std::vector<int32_t> expected_offsets = {0};
+    for (const double value : values)
+    {
+        char buf[schubfach::DtoaMaxLength];
+        expected.append(buf, schubfach::Dtoa(buf, value));
+        expected_offsets.push_back(static_cast<int32_t>(expected.size()));
+    }
+
+    std::vector<char> buffer(values.size() * schubfach::DtoaMaxLength);
+    std::vector<int32_t> offsets(values.size() + 1);
+
+    // A worst-case sized buffer stays on the in-place path throughout.
+    const size_t size = DtoaColumn(buffer.data(), buffer.size(), values.data(), values.size(), offsets.data());
+    REQUIRE(size == expected.size());
+    CHECK(std::memcmp(buffer.data(), expected.data(), size) == 0);
+    CHECK(offsets == expected_offsets);
+
+    // An exactly sized buffer forces the tail values through the bounce buffer.
+    const size_t exact = DtoaColumn(buffer.data(), size, values.data(), values.size(), offsets.data());
+    REQUIRE(exact == expected.size());
+    CHECK(std::memcmp(buffer.data(), expected.data(), exact) == 0);
+    CHECK(offsets == expected_offsets);
+
+    // One character short: the column does not fit.
+    CHECK(DtoaColumn(buffer.data(), size - 1, values.data(), values.size(), offsets.data()) == 0);
+}
+
+TEST_CASE("DtoaColumnStream")
+{
+    std::vector<double> values;
+    uint64_t bits = 0x2B;
+    for (int i = 0; i < 100000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        values.push_back(static_cast<double>(static_cast<int64_t>(bits >> 32)) * 1.0e-3);
+    }
+
+    std::vector<int32_t> expected_offsets(values.size() + 1);
+    std::vector<char> expected(values.size() * schubfach::DtoaMaxLength);
+    const size_t expected_size = DtoaColumn(expected.data(), expected.size(), values.data(), values.size(), expected_offsets.data());
+    REQUIRE(expected_size != 0u);
+
+    // A small destination stays on the regular-store path.
+    std::vector<char> buffer(values.size() * schubfach::DtoaMaxLength);
+    std::vector<int32_t> offsets(values.size() + 1);
+    const size_t size = DtoaColumnStream(buffer.data(), buffer.size(), values.data(), values.size(), offsets.data());
+    REQUIRE(size == expected_size);
+    CHECK(std::memcmp(buffer.data(), expected.data(), size) == 0);
+    CHECK(offsets == expected_offsets);
+
+    // A destination past the non-temporal threshold goes through the staging block.
+    std::vector<char> large(16 * 1024 * 1024);
+    const size_t streamed = DtoaColumnStream(large.data(), large.size(), values.data(), values.size(), offsets.data());
+    REQUIRE(streamed == expected_size);
+    CHECK(std::memcmp(large.data(), expected.data(), streamed) == 0);
+    CHECK(offsets == expected_offsets);
+
+    // Prefetching disabled.
+    const size_t no_prefetch = DtoaColumnStream(large.data(), large.size(), values.data(), values.size(), offsets.data(), 0);
+    REQUIRE(no_prefetch == expected_size);
+    CHECK(std::memcmp(large.data(), expected.data(), no_prefetch) == 0);
+    CHECK(offsets == expected_offsets);
+
+    // One character short: the column does not fit (small and large destinations).
+    CHECK(DtoaColumnStream(buffer.data(), expected_size - 1, values.data(), values.size(), offsets.data()) == 0u);
+    std::vector<double> wide(1024 * 1024, -1.2345678901234567e-300);
+    std::vector<int32_t> wide_offsets(wide.size() + 1);
+    CHECK(DtoaColumnStream(large.data(), large.size(), wide.data(), wide.size(), wide_offsets.data()) == 0u);
+}
+
+TEST_CASE("DtoaColumnSorted")
+{
+    // Random-bits data: the exponents scatter over the whole pow10 cache, the case the
+    // exponent sort is for. The count is not a multiple of the chunk size.
+    std::vector<double> values;
+    uint64_t bits = 0x2E;
+    for (int i = 0; i < 10000 + 123; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        values.push_back(value);
+    }
+    values.push_back(0.0);
+    values.push_back(-0.0);
+    values.push_back(std::numeric_limits<double>::infinity());
+    values.push_back(std::numeric_limits<double>::quiet_NaN());
+
+    std::vector<int32_t> expected_offsets(values.size() + 1);
+    std::vector<char> expected(values.size() * schubfach::DtoaMaxLength);
+    const size_t expected_size = DtoaColumn(expected.data(), expected.size(), values.data(), values.size(), expected_offsets.data());
+    REQUIRE(expected_size != 0u);
+
+    std::vector<char> buffer(values.size() * schubfach::DtoaMaxLength);
+    std::vector<int32_t> offsets(values.size() + 1);
+    const size_t size = drachennest::DtoaColumnSorted(buffer.data(), buffer.size(), values.data(), values.size(), offsets.data());
+    REQUIRE(size == expected_size);
+    CHECK(std::memcmp(buffer.data(), expected.data(), size) == 0);
+    CHECK(offsets == expected_offsets);
+
+    // An exactly sized buffer forces the tail values through the bounce buffer.
+    const size_t exact = drachennest::DtoaColumnSorted(buffer.data(), size, values.data(), values.size(), offsets.data());
+    REQUIRE(exact == expected_size);
+    CHECK(std::memcmp(buffer.data(), expected.data(), exact) == 0);
+    CHECK(offsets == expected_offsets);
+
+    // One character short: the column does not fit.
+    CHECK(drachennest::DtoaColumnSorted(buffer.data(), size - 1, values.data(), values.size(), offsets.data()) == 0u);
+}
+
+TEST_CASE("DtoaColumn statistics")
+{
+    // A random column with NaNs, infinities and signed zeros mixed in.
+    std::vector<double> values;
+    uint64_t bits = 0x2D;
+    for (int i = 0; i < 10000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        values.push_back(static_cast<double>(static_cast<int64_t>(bits >> 32)) * 1.0e-3);
+        if (i % 500 == 0)
+            values.push_back(std::numeric_limits<double>::quiet_NaN());
+        if (i % 1000 == 0)
+            values.push_back(i % 2000 == 0 ? 0.0 : -0.0);
+    }
+    values.push_back(+std::numeric_limits<double>::infinity());
+    values.push_back(-std::numeric_limits<double>::infinity());
+
+    double expected_min = +std::numeric_limits<double>::infinity();
+    double expected_max = -std::numeric_limits<double>::infinity();
+    size_t expected_nans = 0;
+    for (const double value : values)
+    {
+        if (value != value)
+        {
+            ++expected_nans;
+            continue;
+        }
+        if (value < expected_min)
+            expected_min = value;
+        if (expected_max < value)
+            expected_max = value;
+    }
+
+    std::vector<int32_t> expected_offsets(values.size() + 1);
+    std::vector<char> expected(values.size() * schubfach::DtoaMaxLength);
+    const size_t expected_size = DtoaColumn(expected.data(), expected.size(), values.data(), values.size(), expected_offsets.data());
+    REQUIRE(expected_size != 0u);
+
+    // Output, offsets and return value are exactly those of the plain DtoaColumn.
+    std::vector<char> buffer(values.size() * schubfach::DtoaMaxLength);
+    std::vector<int32_t> offsets(values.size() + 1);
+    drachennest::ColumnStats stats;
+    const size_t size = DtoaColumn(buffer.data(), buffer.size(), values.data(), values.size(), offsets.data(), stats);
+    REQUIRE(size == expected_size);
+    CHECK(std::memcmp(buffer.data(), expected.data(), size) == 0);
+    CHECK(offsets == expected_offsets);
+    CHECK(stats.min == expected_min);
+    CHECK(stats.max == expected_max);
+    CHECK(stats.num_nans == expected_nans);
+
+    // The statistics accumulate across calls, so a chunked column yields the same totals.
+    drachennest::ColumnStats chunked;
+    const size_t half = values.size() / 2;
+    REQUIRE(DtoaColumn(buffer.data(), buffer.size(), values.data(), half, offsets.data(), chunked) != 0u);
+    REQUIRE(DtoaColumn(buffer.data(), buffer.size(), values.data() + half, values.size() - half, offsets.data(), chunked) != 0u);
+    CHECK(chunked.min == expected_min);
+    CHECK(chunked.max == expected_max);
+    CHECK(chunked.num_nans == expected_nans);
+
+    // The streaming formatter, on both the regular-store and the staging path.
+    drachennest::ColumnStats stream_stats;
+    const size_t streamed = DtoaColumnStream(buffer.data(), buffer.size(), values.data(), values.size(), offsets.data(), stream_stats);
+    REQUIRE(streamed == expected_size);
+    CHECK(std::memcmp(buffer.data(), expected.data(), streamed) == 0);
+    CHECK(offsets == expected_offsets);
+    CHECK(stream_stats.min == expected_min);
+    CHECK(stream_stats.max == expected_max);
+    CHECK(stream_stats.num_nans == expected_nans);
+
+    std::vector<char> large(16 * 1024 * 1024);
+    drachennest::ColumnStats large_stats;
+    const size_t large_size = DtoaColumnStream(large.data(), large.size(), values.data(), values.size(), offsets.data(), large_stats);
+    REQUIRE(large_size == expected_size);
+    CHECK(std::memcmp(large.data(), expected.data(), large_size) == 0);
+    CHECK(offsets == expected_offsets);
+    CHECK(large_stats.min == expected_min);
+    CHECK(large_stats.max == expected_max);
+    CHECK(large_stats.num_nans == expected_nans);
+}
+
+TEST_CASE("DtoaColumn small inputs")
+{
+    char buffer[schubfach::DtoaMaxLength];
+    int32_t offsets[2];
+
+    const size_t empty = DtoaColumn(buffer, sizeof(buffer), nullptr, 0, offsets);
+    CHECK(empty == 0u);
+    CHECK(offsets[0] == 0);
+
+    const double value = -2.5e3;
+    const size_t one = DtoaColumn(buffer, sizeof(buffer), &value, 1, offsets);
+    CHECK(std::string(buffer, one) == "-2500");
+    CHECK(offsets[0] == 0);
+    CHECK(offsets[1] == 5);
+}
+
+static std::string SequenceFormat(drachennest::DtoaSequence& seq, double value)
+{
+    char buf[schubfach::DtoaMaxLength];
+    return std::string(buf, seq.Format(buf, value));
+}
+
+static std::string PlainFormat(double value)
+{
+    char buf[schubfach::DtoaMaxLength];
+    return std::string(buf, schubfach::Dtoa(buf, value));
+}
+
+TEST_CASE("DtoaSequence")
+{
+    drachennest::DtoaSequence seq;
+
+    // A monotone timestamp column: consecutive values share almost the whole string.
+    double timestamp = 1724832000.001;
+    for (int i = 0; i < 10000; ++i)
+    {
+        CHECK(SequenceFormat(seq, timestamp) == PlainFormat(timestamp));
+        timestamp += 0.001;
+    }
+
+    // Repeated values, decade crossings, sign changes and layout switches.
+    const double cases[] = {
+        999.999, 999.999, 1000.0, 1000.001, -1000.001, -1000.002,
+        0.000999, 0.001, 2500.0, 2600.0, 1e-7, 1.5e-7, 1e18, 1.5e18, 123.456,
+        0.0, -0.0, 123.457,
+    };
+    for (const double value : cases)
+    {
+        CHECK(SequenceFormat(seq, value) == PlainFormat(value));
+    }
+
+    const double inf = std::numeric_limits<double>::infinity();
+    CHECK(SequenceFormat(seq, inf) == "inf");
+    CHECK(SequenceFormat(seq, -inf) == "-inf");
+    CHECK(SequenceFormat(seq, std::numeric_limits<double>::quiet_NaN()) == "nan");
+    CHECK(SequenceFormat(seq, 123.458) == "123.458");
+
+    // Random values: unrelated consecutive values must fall back correctly.
+    uint64_t bits = 0x2C;
+    for (int i = 0; i < 10000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (value != value)
+            continue;
+
+        CHECK(SequenceFormat(seq, value) == PlainFormat(value));
+    }
+}
+
+TEST_CASE("DtoaColumnSequence")
+{
+    // The timestamp column DtoaSequence is for, with a few irregular values mixed in.
+    std::vector<double> values;
+    double timestamp = 1724832000.001;
+    for (int i = 0; i < 10000; ++i)
+    {
+        values.push_back(timestamp);
+        timestamp += 0.001;
+        if (i % 1000 == 0)
+            values.push_back(static_cast<double>(i) * 1e-5);
+    }
+
+    std::vector<int32_t> expected_offsets(values.size() + 1);
+    std::vector<char> expected(values.size() * schubfach::DtoaMaxLength);
+    const size_t expected_size = DtoaColumn(expected.data(), expected.size(), values.data(), values.size(), expected_offsets.data());
+    REQUIRE(expected_size != 0u);
+
+    std::vector<char> buffer(values.size() * schubfach::DtoaMaxLength);
+    std::vector<int32_t> offsets(values.size() + 1);
+    const size_t size = drachennest::DtoaColumnSequence(buffer.data(), buffer.size(), values.data(), values.size(), offsets.data());
+    REQUIRE(size == expected_size);
+    CHECK(std::memcmp(buffer.data(), expected.data(), size) == 0);
+    CHECK(offsets == expected_offsets);
+
+    // An exactly sized buffer forces the tail values through the bounce buffer.
+    const size_t exact = drachennest::DtoaColumnSequence(buffer.data(), size, values.data(), values.size(), offsets.data());
+    REQUIRE(exact == expected_size);
+    CHECK(std::memcmp(buffer.data(), expected.data(), exact) == 0);
+    CHECK(offsets == expected_offsets);
+
+    // One character short: the column does not fit.
+    CHECK(drachennest::DtoaColumnSequence(buffer.data(), size - 1, values.data(), values.size(), offsets.data()) == 0u);
+}
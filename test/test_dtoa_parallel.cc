@@ -0,0 +1,73 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include "../src/dtoa_parallel.h"
+#include "../src/schubfach_64.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using drachennest::ParallelDtoa;
+
+// The sequential loop ParallelDtoa must be equivalent to.
+static std::string FormatSequential(const std::vector<double>& values, char separator)
+{
+    std::string text;
+    for (const double value : values)
+    {
+        char buf[schubfach::DtoaMaxLength];
+        text.append(buf, schubfach::Dtoa(buf, value));
+        text += separator;
+    }
+    return text;
+}
+
+TEST_CASE("ParallelDtoa")
+{
+    std::vector<double> values;
+    uint64_t bits = 0x2A;
+    for (int i = 0; i < 50000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        values.push_back(static_cast<double>(static_cast<int64_t>(bits >> 32)) * 1.0e-3);
+    }
+
+    const std::string expected = FormatSequential(values, '\n');
+
+    for (const int num_threads : {0, 1, 2, 7})
+    {
+        const auto result = ParallelDtoa(values.data(), values.size(), '\n', num_threads);
+
+        REQUIRE(result.text.size() == expected.size());
+        CHECK(std::memcmp(result.text.data(), expected.data(), expected.size()) == 0);
+
+        // The offsets delimit one field per value, covering the buffer exactly.
+        REQUIRE(result.offsets.size() == values.size());
+        size_t prev = 0;
+        for (size_t i = 0; i < result.offsets.size(); ++i)
+        {
+            REQUIRE(prev < result.offsets[i]);
+            CHECK(result.text[result.offsets[i] - 1] == '\n');
+            prev = result.offsets[i];
+        }
+        CHECK(prev == result.text.size());
+    }
+}
+
+TEST_CASE("ParallelDtoa small inputs")
+{
+    const auto empty = ParallelDtoa(nullptr, 0);
+    CHECK(empty.text.empty());
+    CHECK(empty.offsets.empty());
+
+    const double value = 1.5;
+    const auto one = ParallelDtoa(&value, 1, ',');
+    CHECK(std::string(one.text.data(), one.text.size()) == "1.5,");
+    REQUIRE(one.offsets.size() == 1);
+    CHECK(one.offsets[0] == 4);
+}
@@ -0,0 +1,169 @@
+// Exhaustive single-precision verification harness.
+//
+// Sweeps every float bit pattern (2^32, NaNs excluded), formats it with ryu::Ftoa,
+// schubfach::Ftoa and dragonbox::Ftoa, compares the outputs pairwise, and round-trips each
+// through ryu::Strtof back to the original bits. Unlike the catch2 spot checks in
+// test_dtoa.cc this is a standalone target, meant to be run (overnight, if need be) on
+// every compiler or library upgrade.
+//
+// Usage: test_exhaustive_f32 [--threads=N] [--step=K]
+//
+// --threads=N   number of worker threads (default: the hardware concurrency)
+// --step=K      check every K-th bit pattern only (default: 1, i.e. exhaustive);
+//               useful for a quick smoke run, e.g. --step=4099.
+
+#include "../src/dragonbox_32.h"
+#include "../src/ryu_32.h"
+#include "../src/schubfach_32.h"
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static inline float FloatFromBits(uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline uint32_t BitsFromFloat(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline bool IsNaN(uint32_t bits)
+{
+    return (bits & 0x7FFFFFFF) > 0x7F800000;
+}
+
+struct WorkerResult {
+    uint64_t num_checked = 0;
+    uint64_t num_failures = 0;
+};
+
+static constexpr int MaxReportedFailures = 20;
+static std::atomic<int> num_reported_failures{0};
+
+static void ReportFailure(uint32_t bits, const char* what, const char* s1, int len1, const char* s2, int len2)
+{
+    if (num_reported_failures.fetch_add(1) >= MaxReportedFailures)
+        return;
+    std::fprintf(stderr, "FAIL %08" PRIX32 " (%s): \"%.*s\" vs \"%.*s\"\n",
+        bits, what, len1, s1, len2, s2);
+}
+
+// Checks the bit patterns first, first + step, first + 2*step, ... below 2^32.
+static WorkerResult Sweep(uint64_t first, uint64_t step)
+{
+    WorkerResult result;
+
+    for (uint64_t i = first; i <= UINT32_MAX; i += step)
+    {
+        const uint32_t bits = static_cast<uint32_t>(i);
+        if (IsNaN(bits))
+            continue;
+
+        const float value = FloatFromBits(bits);
+
+        char buf1[ryu::FtoaMinBufferLength];
+        char buf2[schubfach::FtoaMinBufferLength];
+        char buf3[dragonbox::FtoaMinBufferLength];
+        char* const end1 = ryu::Ftoa(buf1, value);
+        char* const end2 = schubfach::Ftoa(buf2, value);
+        char* const end3 = dragonbox::Ftoa(buf3, value);
+        const int len1 = static_cast<int>(end1 - buf1);
+        const int len2 = static_cast<int>(end2 - buf2);
+        const int len3 = static_cast<int>(end3 - buf3);
+
+        ++result.num_checked;
+
+        // The implementations must agree byte for byte: all produce the shortest
+        // correctly-rounded digits, so any difference means one of them is wrong.
+        if (len1 != len2 || std::memcmp(buf1, buf2, static_cast<size_t>(len1)) != 0)
+        {
+            ++result.num_failures;
+            ReportFailure(bits, "pairwise", buf1, len1, buf2, len2);
+            continue;
+        }
+        if (len1 != len3 || std::memcmp(buf1, buf3, static_cast<size_t>(len1)) != 0)
+        {
+            ++result.num_failures;
+            ReportFailure(bits, "pairwise dragonbox", buf1, len1, buf3, len3);
+            continue;
+        }
+
+        // The output must parse back to exactly the input bits (this also distinguishes
+        // -0.0 from 0.0).
+        float parsed = 0;
+        const auto res = ryu::Strtof(buf1, end1, parsed);
+        if (!res || res.next != end1 || BitsFromFloat(parsed) != bits)
+        {
+            ++result.num_failures;
+            ReportFailure(bits, "round-trip", buf1, len1, buf2, len2);
+        }
+    }
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    int num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    uint64_t step = 1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--threads=", 10) == 0)
+        {
+            num_threads = std::atoi(argv[i] + 10);
+        }
+        else if (std::strncmp(argv[i], "--step=", 7) == 0)
+        {
+            step = static_cast<uint64_t>(std::atoll(argv[i] + 7));
+        }
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--threads=N] [--step=K]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (num_threads < 1)
+        num_threads = 1;
+    if (step < 1)
+        step = 1;
+
+    std::printf("Sweeping every %" PRIu64 ". float bit pattern on %d threads...\n", step, num_threads);
+
+    // Thread t checks first + t*step, first + num_threads*step, ...: the threads interleave,
+    // so they finish at about the same time regardless of how the cost varies over the
+    // exponent range.
+    std::vector<std::thread> threads;
+    std::vector<WorkerResult> results(static_cast<size_t>(num_threads));
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([t, num_threads, step, &results] {
+            results[static_cast<size_t>(t)] = Sweep(static_cast<uint64_t>(t) * step, static_cast<uint64_t>(num_threads) * step);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    uint64_t num_checked = 0;
+    uint64_t num_failures = 0;
+    for (const auto& r : results)
+    {
+        num_checked += r.num_checked;
+        num_failures += r.num_failures;
+    }
+
+    std::printf("Checked %" PRIu64 " values: %" PRIu64 " failures.\n", num_checked, num_failures);
+    return num_failures == 0 ? 0 : 1;
+}
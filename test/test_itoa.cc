@@ -0,0 +1,134 @@
+#include "catch.hpp"
+
+#include "../src/itoa.h"
+
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+
+template <typename Int>
+static std::string ItoaStr(Int value)
+{
+    char buf[drachennest::ItoaMaxLength];
+    char* const end = drachennest::Itoa(buf, value);
+    return std::string(buf, end);
+}
+
+TEST_CASE("Itoa")
+{
+    CHECK(ItoaStr(uint32_t{0}) == "0");
+    CHECK(ItoaStr(uint32_t{9}) == "9");
+    CHECK(ItoaStr(uint32_t{10}) == "10");
+    CHECK(ItoaStr(uint32_t{4294967295u}) == "4294967295");
+    CHECK(ItoaStr(uint64_t{18446744073709551615ull}) == "18446744073709551615");
+    CHECK(ItoaStr(int32_t{-1}) == "-1");
+    CHECK(ItoaStr(std::numeric_limits<int32_t>::min()) == "-2147483648");
+    CHECK(ItoaStr(std::numeric_limits<int64_t>::min()) == "-9223372036854775808");
+    CHECK(ItoaStr(std::numeric_limits<int64_t>::max()) == "9223372036854775807");
+
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 100000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+
+        CHECK(ItoaStr(bits) == std::to_string(bits));
+        CHECK(ItoaStr(static_cast<int64_t>(bits)) == std::to_string(static_cast<int64_t>(bits)));
+        CHECK(ItoaStr(static_cast<uint32_t>(bits)) == std::to_string(static_cast<uint32_t>(bits)));
+        CHECK(ItoaStr(static_cast<int32_t>(bits)) == std::to_string(static_cast<int32_t>(bits)));
+    }
+}
+
+TEST_CASE("Itoa - building blocks")
+{
+    char buf[8];
+
+    drachennest::itoa::Utoa_2Digits(buf, 7);
+    CHECK(std::string(buf, 2) == "07");
+
+    drachennest::itoa::Utoa_4Digits(buf, 42);
+    CHECK(std::string(buf, 4) == "0042");
+    drachennest::itoa::Utoa_4Digits(buf, 9999);
+    CHECK(std::string(buf, 4) == "9999");
+
+    CHECK(drachennest::itoa::TrailingZeros_2Digits(0) == 2);
+    CHECK(drachennest::itoa::TrailingZeros_2Digits(30) == 1);
+    CHECK(drachennest::itoa::TrailingZeros_2Digits(42) == 0);
+
+    std::memset(buf, '0', 8);
+    const int32_t tz = drachennest::itoa::Utoa_8Digits_skip_trailing_zeros(buf, 12300000);
+    CHECK(std::string(buf, 8) == "12300000");
+    CHECK(tz == 5);
+}
+
+// Writes v into a '0'-prefilled buffer (PrintDecimalDigitsBackwards may skip trailing
+// zeros) and returns the printed digits along with the reported trailing-zero count.
+static std::string PrintBackwardsStr(uint64_t v, int32_t* tz)
+{
+    char buf[32];
+    std::memset(buf, '0', sizeof(buf));
+    const int32_t num_digits = drachennest::itoa::DecimalLength(v);
+    *tz = drachennest::itoa::PrintDecimalDigitsBackwards(buf + num_digits, v);
+    return std::string(buf, static_cast<size_t>(num_digits));
+}
+
+TEST_CASE("Itoa - digit-generation kit")
+{
+    // DecimalLength at the decade boundaries, up to the 17-digit maximum of ToDecimal64.
+    uint64_t pow10 = 1;
+    for (int32_t digits = 1; digits <= 17; ++digits)
+    {
+        CHECK(drachennest::itoa::DecimalLength(pow10) == digits);
+        CHECK(drachennest::itoa::DecimalLength(10 * pow10 - 1) == digits);
+        pow10 *= 10;
+    }
+
+    int32_t tz;
+    CHECK(PrintBackwardsStr(1, &tz) == "1");
+    CHECK(tz == 0);
+    CHECK(PrintBackwardsStr(10, &tz) == "10");
+    CHECK(tz == 1);
+    CHECK(PrintBackwardsStr(12300, &tz) == "12300");
+    CHECK(tz == 2);
+    CHECK(PrintBackwardsStr(10000000000000000ull, &tz) == "10000000000000000");
+    CHECK(tz == 16);
+    CHECK(PrintBackwardsStr(99999999999999999ull, &tz) == "99999999999999999");
+    CHECK(tz == 0);
+
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 100000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+
+        const uint64_t v = bits % 99999999999999999ull + 1; // 1 <= v <= 10^17 - 1
+        const std::string expected = std::to_string(v);
+
+        CHECK(drachennest::itoa::DecimalLength(v) == static_cast<int32_t>(expected.size()));
+        CHECK(PrintBackwardsStr(v, &tz) == expected);
+        CHECK(tz == static_cast<int32_t>(expected.size() - expected.find_last_not_of('0') - 1));
+    }
+}
+
+TEST_CASE("Itoa - exponent suffix table")
+{
+    char buf[16];
+
+    for (int32_t e = drachennest::itoa::MinTableExponent; e <= drachennest::itoa::MaxTableExponent; ++e)
+    {
+        CAPTURE(e);
+
+        char expected[16];
+
+        // Exactly three digits.
+        std::snprintf(expected, sizeof(expected), "e%c%03d", e < 0 ? '-' : '+', e < 0 ? -e : e);
+        CHECK(std::string(buf, drachennest::itoa::ExponentToChars_3Digits(buf, e)) == expected);
+
+        // No leading zeros.
+        std::snprintf(expected, sizeof(expected), "e%c%d", e < 0 ? '-' : '+', e < 0 ? -e : e);
+        CHECK(std::string(buf, drachennest::itoa::ExponentToChars(buf, e)) == expected);
+
+        // At least two digits (the printf convention).
+        std::snprintf(expected, sizeof(expected), "e%c%02d", e < 0 ? '-' : '+', e < 0 ? -e : e);
+        CHECK(std::string(buf, drachennest::itoa::ExponentToChars(buf, e, 2)) == expected);
+    }
+}
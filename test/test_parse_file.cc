@@ -0,0 +1,149 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include "../src/parse_file.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using drachennest::ParseBuffer;
+using drachennest::ParseFile;
+using drachennest::ParseFileResult;
+using drachennest::ParseFileStatus;
+
+static ParseFileResult Parse(const std::string& input, std::vector<double>& values, int num_threads = 1)
+{
+    values.resize(input.size() / 2 + 1);
+    const auto res = ParseBuffer(input.data(), input.data() + input.size(), values.data(), values.size(), num_threads);
+    values.resize(res.num_values);
+    return res;
+}
+
+TEST_CASE("ParseBuffer")
+{
+    std::vector<double> values;
+
+    {
+        const auto res = Parse("", values);
+        CHECK(static_cast<bool>(res));
+        CHECK(res.num_records == 0);
+        CHECK(values.empty());
+    }
+
+    {
+        const auto res = Parse("1.5\n-2.5e3\n0\n", values);
+        CHECK(static_cast<bool>(res));
+        CHECK(res.num_records == 3);
+        CHECK(res.errors.empty());
+        REQUIRE(values.size() == 3);
+        CHECK(values[0] == 1.5);
+        CHECK(values[1] == -2.5e3);
+        CHECK(values[2] == 0.0);
+    }
+
+    // Missing trailing newline, CRLF line endings, and empty lines are fine.
+    {
+        const auto res = Parse("1\r\n\n\n2\r\n3", values);
+        CHECK(static_cast<bool>(res));
+        CHECK(res.num_records == 3);
+        REQUIRE(values.size() == 3);
+        CHECK(values[0] == 1.0);
+        CHECK(values[1] == 2.0);
+        CHECK(values[2] == 3.0);
+    }
+
+    // A record that is not exactly one number produces an error entry (the byte offset of
+    // the offending character) and no value.
+    {
+        const auto res = Parse("1\nx\n2\n3.5.7\n4\n", values);
+        CHECK(static_cast<bool>(res));
+        CHECK(res.num_records == 5);
+        REQUIRE(values.size() == 3);
+        CHECK(values[0] == 1.0);
+        CHECK(values[1] == 2.0);
+        CHECK(values[2] == 4.0);
+        REQUIRE(res.errors.size() == 2);
+        CHECK(res.errors[0].offset == 2); // 'x'
+        CHECK(res.errors[1].offset == 9); // the second '.' of "3.5.7"
+    }
+
+    // If the buffer is too small, num_records reports the required size.
+    {
+        const std::string input = "1\n2\n3\n";
+        double small[2];
+        const auto res = ParseBuffer(input.data(), input.data() + input.size(), small, 2, 1);
+        CHECK(res.status == ParseFileStatus::buffer_too_small);
+        CHECK(res.num_records == 3);
+    }
+}
+
+TEST_CASE("ParseBuffer threads")
+{
+    // The values must come back in file order with per-chunk slices that tile them,
+    // regardless of the thread count.
+    std::string input;
+    for (int i = 0; i < 100000; ++i)
+    {
+        input += std::to_string(i);
+        input += ".25\n";
+    }
+
+    for (const int num_threads : {1, 2, 3, 8})
+    {
+        std::vector<double> values;
+        const auto res = Parse(input, values, num_threads);
+        CHECK(static_cast<bool>(res));
+        REQUIRE(res.num_values == 100000);
+        for (int i = 0; i < 100000; ++i)
+        {
+            if (values[static_cast<size_t>(i)] != i + 0.25)
+            {
+                CHECK(values[static_cast<size_t>(i)] == i + 0.25);
+                break;
+            }
+        }
+
+        size_t values_offset = 0;
+        size_t errors_offset = 0;
+        for (const auto& chunk : res.chunks)
+        {
+            CHECK(chunk.values_offset == values_offset);
+            CHECK(chunk.errors_offset == errors_offset);
+            values_offset += chunk.num_values;
+            errors_offset += chunk.num_errors;
+        }
+        CHECK(values_offset == res.num_values);
+        CHECK(errors_offset == res.errors.size());
+    }
+}
+
+TEST_CASE("ParseFile")
+{
+    const char* const path = "test_parse_file.tmp";
+
+    {
+        std::FILE* const file = std::fopen(path, "wb");
+        REQUIRE(file != nullptr);
+        std::fputs("1.5\n2.5\n3.5\n", file);
+        std::fclose(file);
+    }
+
+    double values[8];
+    const auto res = ParseFile(path, values, 8);
+    CHECK(static_cast<bool>(res));
+    CHECK(res.num_values == 3);
+    CHECK(values[0] == 1.5);
+    CHECK(values[1] == 2.5);
+    CHECK(values[2] == 3.5);
+
+    std::remove(path);
+
+    // A file that does not exist is an io_error.
+    const auto res2 = ParseFile(path, values, 8);
+    CHECK(res2.status == ParseFileStatus::io_error);
+}
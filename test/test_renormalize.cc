@@ -0,0 +1,118 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include "../src/renormalize.h"
+#include "../src/ryu_64.h"
+#include "../src/schubfach_64.h"
+
+#include <cstring>
+#include <string>
+
+using drachennest::Renormalize;
+
+static std::string Renormalized(const std::string& input, bool* changed = nullptr)
+{
+    char out[schubfach::DtoaMaxLength];
+    const auto res = Renormalize(input.data(), input.data() + input.size(), out);
+    REQUIRE(static_cast<bool>(res));
+    REQUIRE(res.next == input.data() + input.size());
+    if (changed != nullptr)
+        *changed = res.changed;
+    return std::string(out, res.out_end);
+}
+
+TEST_CASE("Renormalize - canonical inputs are copied")
+{
+    for (const char* text : {
+             "0", "-0", "1", "-1", "1.5", "-1.5", "0.1", "2500", "-2500",
+             "0.00000095367431640625", "9007199254740991", "1.2345e+25",
+             "-2.5e-12", "7e+300", "1e-300", "1.7976931348623157e+308",
+         })
+    {
+        CAPTURE(text);
+        bool changed = true;
+        CHECK(Renormalized(text, &changed) == text);
+        CHECK(!changed);
+    }
+}
+
+TEST_CASE("Renormalize - non-canonical inputs are rewritten")
+{
+    static const struct {
+        char const* input;
+        char const* expected;
+    } cases[] = {
+        {"+1.5",                  "1.5"       },
+        {"1.50",                  "1.5"       },
+        {"01.5",                  "1.5"       },
+        {".5",                    "0.5"       },
+        {"1.",                    "1"         },
+        {"1e5",                   "100000"    },
+        {"1E5",                   "100000"    },
+        {"1e+05",                 "100000"    },
+        {"2.5e-7",                "0.00000025"},
+        {"0.0000000025",          "2.5e-9"    },
+        {"0.3000000000000000",    "0.3"       },
+        {"0.10000000000000001",   "0.1"       }, // rounds to the same double as "0.1"
+        {"0.1000000000000000055511151231257827", "0.1"},
+        {"0.000",                 "0"         },
+        {"17976931348623157e+292", "1.7976931348623157e+308"},
+        {"1e999",                 "inf"       },
+    };
+
+    for (const auto& c : cases)
+    {
+        CAPTURE(c.input);
+        bool changed = false;
+        CHECK(Renormalized(c.input, &changed) == c.expected);
+        CHECK(changed);
+    }
+}
+
+TEST_CASE("Renormalize - invalid input")
+{
+    const char* const text = "x1.5";
+    char out[schubfach::DtoaMaxLength];
+    const auto res = Renormalize(text, text + 4, out);
+    CHECK(!static_cast<bool>(res));
+    CHECK(res.out_end == nullptr);
+    CHECK(res.next == text);
+
+    // Only the leading number is consumed.
+    const char* const partial = "1.25,abc";
+    const auto res2 = Renormalize(partial, partial + 8, out);
+    REQUIRE(static_cast<bool>(res2));
+    CHECK(res2.next == partial + 4);
+    CHECK(std::string(out, res2.out_end) == "1.25");
+    CHECK(!res2.changed);
+}
+
+TEST_CASE("Renormalize - agrees with Dtoa")
+{
+    uint64_t bits = 1;
+    for (int i = 0; i < 100000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        bits &= 0x7FEFFFFFFFFFFFFF; // exclude Inf/NaN
+
+        double value;
+        std::memcpy(&value, &bits, sizeof(double));
+
+        char expected_buf[schubfach::DtoaMaxLength];
+        const std::string expected(expected_buf, schubfach::Dtoa(expected_buf, value));
+
+        // The canonical text must pass through unchanged...
+        bool changed = true;
+        CHECK(Renormalized(expected, &changed) == expected);
+        CHECK(!changed);
+
+        // ...and a non-canonical spelling of the same value must map onto it.
+        char widened_buf[64];
+        const int widened_len = snprintf(widened_buf, sizeof(widened_buf), "%.17e", value);
+        CHECK(Renormalized(std::string(widened_buf, widened_len)) == expected);
+    }
+}
@@ -0,0 +1,148 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include "../src/renumber.h"
+#include "../src/schubfach_64.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using drachennest::RenumberJson;
+using drachennest::RenumberStats;
+
+static std::string Renumber(const std::string& input, RenumberStats* stats = nullptr)
+{
+    std::vector<char> buffer(16 * input.size() + 64);
+    const size_t size = RenumberJson(buffer.data(), buffer.size(), input.data(), input.data() + input.size(), stats);
+    return std::string(buffer.data(), size);
+}
+
+TEST_CASE("RenumberJson")
+{
+    CHECK(Renumber("") == "");
+    CHECK(Renumber("{}") == "{}");
+    CHECK(Renumber("1.5000") == "1.5");
+    CHECK(Renumber("0.10000000000000001") == "0.1");
+    CHECK(Renumber("2.5000000000000001e0") == "2.5");
+    CHECK(Renumber("0.30000000000000004440892098500626") == "0.30000000000000004");
+    CHECK(Renumber("-0.0") == "-0");
+    CHECK(Renumber("1e-999") == "0");          // underflows to zero, which is the value written back
+    CHECK(Renumber("1e5") == "100000");        // shortest form may be longer than the source
+
+    // A full record: structure and whitespace are copied verbatim, every number is
+    // rewritten, numbers inside strings are not.
+    CHECK(Renumber("{\"ts\": 170000000.000, \"values\": [1.5000, -2.50], \"tag\": \"v1.5000\"}")
+        == "{\"ts\": 170000000, \"values\": [1.5, -2.5], \"tag\": \"v1.5000\"}");
+
+    // String escapes: an escaped quote does not end the string, an escaped backslash does
+    // not escape the closing quote.
+    CHECK(Renumber("[\"a \\\"1.5000\\\" b\", 1.5000]") == "[\"a \\\"1.5000\\\" b\", 1.5]");
+    CHECK(Renumber("[\"c:\\\\\", 1.5000]") == "[\"c:\\\\\", 1.5]");
+    CHECK(Renumber("\"unterminated 1.5000") == "\"unterminated 1.5000");
+
+    // Malformed number-shaped tokens and out-of-range numbers are copied verbatim (and
+    // only counted), so the output never diverges from the input by more than the rewrite.
+    {
+        RenumberStats stats;
+        CHECK(Renumber("[1.5000, -x, 1e+, 1e999, -1e999]", &stats) == "[1.5, -x, 1e+, 1e999, -1e999]");
+        CHECK(stats.num_numbers == 1);
+        CHECK(stats.num_invalid == 2);
+        CHECK(stats.num_nonfinite == 2);
+    }
+
+    // RFC 8259 has no leading zeros: the scanner rejects "01" at the '1', the '0' is copied
+    // verbatim as a malformed token and the "1" is then rewritten, so the text survives.
+    {
+        RenumberStats stats;
+        CHECK(Renumber("01", &stats) == "01");
+        CHECK(stats.num_numbers == 1);
+        CHECK(stats.num_invalid == 1);
+    }
+}
+
+TEST_CASE("RenumberJson - buffer too small")
+{
+    const std::string input = "{\"values\": [1.5000, 25.00e-1]}";
+    const std::string expected = "{\"values\": [1.5, 2.5]}";
+
+    std::vector<char> buffer(expected.size());
+    CHECK(RenumberJson(buffer.data(), buffer.size(), input.data(), input.data() + input.size()) == expected.size());
+    CHECK(std::string(buffer.data(), expected.size()) == expected);
+
+    // One character less fails -- for every prefix of the input, so the shortfall is
+    // detected on each of the emission paths (mid-batch and trailing literal).
+    for (size_t size = 0; size < expected.size(); ++size)
+    {
+        CHECK(RenumberJson(buffer.data(), size, input.data(), input.data() + input.size()) == 0);
+    }
+}
+
+TEST_CASE("RenumberJson - batches")
+{
+    // More numbers than one internal batch holds, verified against per-number Dtoa. The
+    // values are x.25 / x.75, so appending zeros keeps the value (and the grammar) intact.
+    std::string input = "[";
+    std::string expected = "[";
+    for (int i = 0; i < 1000; ++i)
+    {
+        if (i != 0)
+        {
+            input += ',';
+            expected += ',';
+        }
+
+        char buf[schubfach::DtoaMaxLength];
+        char* const end = schubfach::Dtoa(buf, 0.5 * i + 0.25);
+        input.append(buf, end);
+        input += "000";
+        expected.append(buf, end);
+    }
+    input += ']';
+    expected += ']';
+
+    RenumberStats stats;
+    CHECK(Renumber(input, &stats) == expected);
+    CHECK(stats.num_numbers == 1000);
+    CHECK(stats.num_invalid == 0);
+    CHECK(stats.num_nonfinite == 0);
+}
+
+TEST_CASE("RenumberJson - round-trip")
+{
+    // printf("%.17g") output parses back to the exact double, so the rewrite must produce
+    // the shortest form of the very same value.
+    std::string input;
+    std::string expected;
+
+    uint64_t bits = 0x77;
+    for (int i = 0; i < 2000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        const uint64_t finite = bits & 0xFFEFFFFFFFFFFFFFull; // clear one exponent bit: no inf/nan
+
+        double value;
+        std::memcpy(&value, &finite, sizeof(value));
+
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%.17g", value);
+        input += buf;
+        input += '\n';
+
+        char* const end = schubfach::Dtoa(buf, value);
+        expected.append(buf, end);
+        expected += '\n';
+    }
+
+    RenumberStats stats;
+    CHECK(Renumber(input, &stats) == expected);
+    CHECK(stats.num_numbers == 2000);
+    CHECK(stats.num_invalid == 0);
+    CHECK(stats.num_nonfinite == 0);
+}
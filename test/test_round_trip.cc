@@ -0,0 +1,44 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include "../src/round_trip.h"
+
+#include <cstring>
+#include <limits>
+
+static double DoubleFromBits(uint64_t bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+TEST_CASE("RoundTripCheck")
+{
+    CHECK(drachennest::RoundTripCheck(0.0));
+    CHECK(drachennest::RoundTripCheck(-0.0));
+    CHECK(drachennest::RoundTripCheck(1.0));
+    CHECK(drachennest::RoundTripCheck(-1.0));
+    CHECK(drachennest::RoundTripCheck(0.1));
+    CHECK(drachennest::RoundTripCheck(std::numeric_limits<double>::max()));
+    CHECK(drachennest::RoundTripCheck(std::numeric_limits<double>::min()));
+    CHECK(drachennest::RoundTripCheck(std::numeric_limits<double>::denorm_min()));
+    CHECK(drachennest::RoundTripCheck(std::numeric_limits<double>::infinity()));
+    CHECK(drachennest::RoundTripCheck(-std::numeric_limits<double>::infinity()));
+    CHECK(drachennest::RoundTripCheck(std::numeric_limits<double>::quiet_NaN()));
+
+    uint64_t bits = 0x0000000000000001;
+    for (int i = 0; i < 100000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+
+        const uint64_t finite = bits % 0x7FF0000000000000ull; // exponents 0..2046
+        CAPTURE(finite);
+        CHECK(drachennest::RoundTripCheck(DoubleFromBits(finite)));
+        CHECK(drachennest::RoundTripCheck(DoubleFromBits(finite | 0x8000000000000000ull)));
+    }
+}
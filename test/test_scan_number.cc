@@ -0,0 +1,222 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include "../src/scan_number.h"
+
+#include <string>
+
+using drachennest::ScanNumber;
+using drachennest::ScanNumberResult;
+using drachennest::ScanNumberState;
+using drachennest::ScanNumberStatus;
+
+// The decomposition produced by one or more ScanNumber calls, with the digit runs
+// materialized for easy comparison.
+struct Decomposition {
+    ScanNumberStatus status;
+    std::string digits;
+    int64_t exponent;
+    bool is_negative;
+    int64_t consumed; // offset of 'next' from the start of the input
+};
+
+static void Append(Decomposition& d, const ScanNumberResult& res)
+{
+    d.digits.append(res.integer_digits, res.integer_end);
+    d.digits.append(res.fraction_digits, res.fraction_end);
+}
+
+static Decomposition Scan(const std::string& input)
+{
+    const auto res = ScanNumber(input.data(), input.data() + input.size());
+
+    Decomposition d{res.status, {}, res.exponent, res.is_negative, res.next - input.data()};
+    Append(d, res);
+    return d;
+}
+
+// Scans the input in two chunks, split at 'pos'. The first chunk is copied into a separate
+// buffer which is destroyed before the second call, to check that no result refers to the
+// previous chunk.
+static Decomposition ScanChunked(const std::string& input, size_t pos)
+{
+    ScanNumberState state;
+    Decomposition d{ScanNumberStatus::incomplete, {}, 0, false, 0};
+
+    {
+        const std::string chunk = input.substr(0, pos);
+        const auto res = ScanNumber(state, chunk.data(), chunk.data() + chunk.size(), /*is_last_chunk*/ false);
+        Append(d, res);
+        d.status = res.status;
+        d.consumed = res.next - chunk.data();
+        if (res.status != ScanNumberStatus::incomplete)
+        {
+            d.exponent = res.exponent;
+            d.is_negative = res.is_negative;
+            return d;
+        }
+    }
+
+    const char* const next = input.data() + pos;
+    const char* const last = input.data() + input.size();
+    const auto res = ScanNumber(state, next, last, /*is_last_chunk*/ true);
+    Append(d, res);
+    d.status = res.status;
+    d.exponent = res.exponent;
+    d.is_negative = res.is_negative;
+    d.consumed = pos + (res.next - next);
+    return d;
+}
+
+static bool ScanOk(const std::string& input, const std::string& digits, int64_t exponent, bool is_negative = false)
+{
+    const auto d = Scan(input);
+    if (d.status != ScanNumberStatus::ok)
+        return false;
+    if (d.digits != digits || d.exponent != exponent || d.is_negative != is_negative)
+        return false;
+    if (d.consumed != static_cast<int64_t>(input.size()))
+        return false;
+
+    // The same decomposition must be produced regardless of where the input is split.
+    for (size_t pos = 0; pos <= input.size(); ++pos)
+    {
+        const auto c = ScanChunked(input, pos);
+        if (c.status != ScanNumberStatus::ok)
+            return false;
+        if (c.digits != digits || c.exponent != exponent || c.is_negative != is_negative)
+            return false;
+    }
+
+    return true;
+}
+
+// Returns the error offset, or -1 if the input (unexpectedly) scanned.
+static int ScanInvalidAt(const std::string& input)
+{
+    const auto d = Scan(input);
+    if (d.status != ScanNumberStatus::invalid)
+        return -1;
+    return static_cast<int>(d.consumed);
+}
+
+TEST_CASE("ScanNumber")
+{
+    CHECK(ScanOk("0", "", 0));
+    CHECK(ScanOk("-0", "", 0, true));
+    CHECK(ScanOk("1", "1", 0));
+    CHECK(ScanOk("-42", "42", 0, true));
+    CHECK(ScanOk("10", "10", 0));
+    CHECK(ScanOk("1.5", "15", -1));
+    CHECK(ScanOk("-1.5", "15", -1, true));
+    CHECK(ScanOk("0.5", "5", -1));
+    CHECK(ScanOk("0.0025", "25", -4));
+    CHECK(ScanOk("0.000", "", -3));
+    CHECK(ScanOk("1e3", "1", 3));
+    CHECK(ScanOk("1E3", "1", 3));
+    CHECK(ScanOk("1e+3", "1", 3));
+    CHECK(ScanOk("1e-3", "1", -3));
+    CHECK(ScanOk("1.25e-7", "125", -9));
+    CHECK(ScanOk("0.001e5", "1", 2));
+    CHECK(ScanOk("123456789012345678901234567890", "123456789012345678901234567890", 0));
+}
+
+TEST_CASE("ScanNumber invalid")
+{
+    CHECK(ScanInvalidAt("") == 0);
+    CHECK(ScanInvalidAt("+1") == 0);    // no leading '+'
+    CHECK(ScanInvalidAt(".5") == 0);    // no leading '.'
+    CHECK(ScanInvalidAt("-.5") == 1);
+    CHECK(ScanInvalidAt("-") == 1);
+    CHECK(ScanInvalidAt("01") == 1);    // no redundant leading zeros
+    CHECK(ScanInvalidAt("-00") == 2);
+    CHECK(ScanInvalidAt("1.") == 2);    // no trailing '.'
+    CHECK(ScanInvalidAt("1.e3") == 2);
+    CHECK(ScanInvalidAt("1e") == 2);    // exponent prefix requires digits
+    CHECK(ScanInvalidAt("1e+") == 3);
+    CHECK(ScanInvalidAt("1e-x") == 3);
+    CHECK(ScanInvalidAt("inf") == 0);
+    CHECK(ScanInvalidAt("nan") == 0);
+}
+
+TEST_CASE("ScanNumber trailing characters")
+{
+    // Trailing characters are not consumed (the caller decides whether the terminator is valid).
+    const std::string input = "1.25,";
+    const auto d = Scan(input);
+    CHECK(d.status == ScanNumberStatus::ok);
+    CHECK(d.digits == "125");
+    CHECK(d.exponent == -2);
+    CHECK(d.consumed == 4);
+}
+
+TEST_CASE("ScanNumberMany")
+{
+    using drachennest::ScanNumberMany;
+    using drachennest::ScanNumberToken;
+
+    ScanNumberToken tokens[8];
+
+    // A valid buffer: every token extent is recorded, nothing is converted.
+    const std::string input = "1.5,-2e3,0.25,42";
+    const auto res = ScanNumberMany(input.data(), input.data() + input.size(), ',', tokens, 8);
+    CHECK(res.status == ScanNumberStatus::ok);
+    CHECK(res.next == input.data() + input.size());
+    REQUIRE(res.count == 4);
+    CHECK(input.substr(static_cast<size_t>(tokens[0].first), static_cast<size_t>(tokens[0].last - tokens[0].first)) == "1.5");
+    CHECK(input.substr(static_cast<size_t>(tokens[1].first), static_cast<size_t>(tokens[1].last - tokens[1].first)) == "-2e3");
+    CHECK(input.substr(static_cast<size_t>(tokens[2].first), static_cast<size_t>(tokens[2].last - tokens[2].first)) == "0.25");
+    CHECK(input.substr(static_cast<size_t>(tokens[3].first), static_cast<size_t>(tokens[3].last - tokens[3].first)) == "42");
+
+    // max_count stops the validation with next at the first unrecorded token.
+    const auto res2 = ScanNumberMany(input.data(), input.data() + input.size(), ',', tokens, 2);
+    CHECK(res2.status == ScanNumberStatus::ok);
+    CHECK(res2.count == 2);
+    CHECK(*res2.next == '0');
+
+    // A character outside the number alphabet fails in the classification pass, long
+    // before any grammar work.
+    const std::string garbage = "1.5,2.5,xyz{]!,3.5";
+    const auto res3 = ScanNumberMany(garbage.data(), garbage.data() + garbage.size(), ',', tokens, 8);
+    CHECK(res3.status == ScanNumberStatus::invalid);
+    CHECK(res3.count == 0);
+    CHECK(*res3.next == 'x');
+
+    // Structural failures point at the offending character, with the preceding tokens
+    // recorded.
+    const std::string bad = "1.5,2.e5,3.5";
+    const auto res4 = ScanNumberMany(bad.data(), bad.data() + bad.size(), ',', tokens, 8);
+    CHECK(res4.status == ScanNumberStatus::invalid);
+    CHECK(res4.count == 1);
+    CHECK(res4.next == bad.data() + 6);
+
+    // Empty tokens are invalid, including one left by a trailing separator.
+    const std::string empty_mid = "1,,2";
+    CHECK(ScanNumberMany(empty_mid.data(), empty_mid.data() + empty_mid.size(), ',', tokens, 8).status == ScanNumberStatus::invalid);
+    const std::string trailing = "1,2,";
+    CHECK(ScanNumberMany(trailing.data(), trailing.data() + trailing.size(), ',', tokens, 8).status == ScanNumberStatus::invalid);
+
+    // An empty buffer validates to zero tokens.
+    const auto res5 = ScanNumberMany(input.data(), input.data(), ',', tokens, 8);
+    CHECK(res5.status == ScanNumberStatus::ok);
+    CHECK(res5.count == 0);
+}
+
+TEST_CASE("ScanNumber incomplete")
+{
+    // Without is_last_chunk, a number that runs into the end of the chunk is incomplete...
+    const std::string input = "1.25";
+    ScanNumberState state;
+    const auto res = ScanNumber(state, input.data(), input.data() + input.size(), /*is_last_chunk*/ false);
+    CHECK(res.status == ScanNumberStatus::incomplete);
+
+    // ...and an empty final chunk completes it.
+    ScanNumberState state2 = state;
+    const auto res2 = ScanNumber(state2, input.data() + input.size(), input.data() + input.size(), /*is_last_chunk*/ true);
+    CHECK(res2.status == ScanNumberStatus::ok);
+    CHECK(res2.exponent == -2);
+}
@@ -0,0 +1,128 @@
+// Differential harness for the GPU bulk formatter (cmake option DRACHENNEST_CUDA): formats
+// a deterministic random stream plus the edge cases on the device and compares every slot
+// byte for byte against the CPU reference schubfach::Dtoa.
+//
+// Usage: test_schubfach_cuda [--seed=S] [--count=N]
+
+#include "../src/schubfach_64.h"
+#include "../src/schubfach_cuda.h"
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__HIP_PLATFORM_AMD__) || defined(__HIPCC__)
+#include <hip/hip_runtime.h>
+#define cudaDeviceSynchronize hipDeviceSynchronize
+#define cudaFree hipFree
+#define cudaMalloc hipMalloc
+#define cudaMemcpy hipMemcpy
+#define cudaMemcpyDeviceToHost hipMemcpyDeviceToHost
+#define cudaMemcpyHostToDevice hipMemcpyHostToDevice
+#define cudaSuccess hipSuccess
+#else
+#include <cuda_runtime.h>
+#endif
+
+// SplitMix64, the generator of test_stress_f64.cc.
+static inline uint64_t NextRandom(uint64_t& state)
+{
+    state += 0x9E3779B97F4A7C15ull;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static inline double DoubleFromBits(uint64_t bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t seed = 1;
+    size_t count = size_t{1} << 22;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--seed=", 7) == 0)
+            seed = std::strtoull(argv[i] + 7, nullptr, 10);
+        else if (std::strncmp(argv[i], "--count=", 8) == 0)
+            count = std::strtoull(argv[i] + 8, nullptr, 10);
+    }
+
+    std::vector<double> values;
+    values.reserve(count);
+
+    // Edge cases first, then the random stream (all bit patterns, both signs).
+    const double specials[] = {
+        0.0, -0.0, 1.0, -1.0, 0.1, 1e-7, 1e15, 1e16, 5e-324, 2.2250738585072014e-308,
+        1.7976931348623157e+308, DoubleFromBits(0x7FF0000000000000ull), DoubleFromBits(0xFFF0000000000000ull),
+        DoubleFromBits(0x7FF8000000000000ull),
+    };
+    for (const double v : specials)
+        values.push_back(v);
+
+    uint64_t state = seed;
+    while (values.size() < count)
+        values.push_back(DoubleFromBits(NextRandom(state)));
+
+    double* d_values = nullptr;
+    char* d_text = nullptr;
+    int32_t* d_lengths = nullptr;
+    if (cudaMalloc(&d_values, count * sizeof(double)) != cudaSuccess
+        || cudaMalloc(&d_text, count * schubfach_cuda::SlotLength) != cudaSuccess
+        || cudaMalloc(&d_lengths, count * sizeof(int32_t)) != cudaSuccess)
+    {
+        std::fprintf(stderr, "FAIL: device allocation failed\n");
+        return 1;
+    }
+
+    cudaMemcpy(d_values, values.data(), count * sizeof(double), cudaMemcpyHostToDevice);
+
+    if (!schubfach_cuda::DtoaBulk(d_values, count, d_text, d_lengths))
+    {
+        std::fprintf(stderr, "FAIL: kernel launch failed\n");
+        return 1;
+    }
+    cudaDeviceSynchronize();
+
+    std::vector<char> text(count * schubfach_cuda::SlotLength);
+    std::vector<int32_t> lengths(count);
+    cudaMemcpy(text.data(), d_text, text.size(), cudaMemcpyDeviceToHost);
+    cudaMemcpy(lengths.data(), d_lengths, count * sizeof(int32_t), cudaMemcpyDeviceToHost);
+
+    cudaFree(d_lengths);
+    cudaFree(d_text);
+    cudaFree(d_values);
+
+    int num_failures = 0;
+    for (size_t i = 0; i < count && num_failures < 20; ++i)
+    {
+        char buf[schubfach::DtoaMaxLength];
+        char* const end = schubfach::Dtoa(buf, values[i]);
+        const std::string expected(buf, end);
+        const std::string got(&text[i * schubfach_cuda::SlotLength], static_cast<size_t>(lengths[i]));
+
+        if (got != expected)
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &values[i], sizeof(bits));
+            std::fprintf(stderr, "FAIL %016" PRIX64 ": got \"%s\", expected \"%s\" [replay with --seed=%" PRIu64 "]\n",
+                bits, got.c_str(), expected.c_str(), seed);
+            ++num_failures;
+        }
+    }
+
+    if (num_failures != 0)
+        return 1;
+
+    std::printf("OK: %zu values\n", count);
+    return 0;
+}
@@ -0,0 +1,149 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include "../bench/stress_gen.h"
+
+#include "../src/grisu3.h"
+#include "../src/ryu_64.h"
+#include "../src/schubfach_64.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// The bench scenarios use NumFloats = 1 << 14 values; a few hundred are enough to pin the
+// properties down here (Grisu3FallbackValues runs ~200 conversions per value generated).
+static constexpr size_t TestCount = 256;
+
+// Round-trips 'value' through shortest formatting and ryu::Strtod.
+static bool RoundTrips(double value)
+{
+    char buf[schubfach::DtoaMaxLength];
+    char* const end = schubfach::Dtoa(buf, value);
+
+    double parsed = 0;
+    const auto res = ryu::Strtod(buf, end, parsed);
+    return res && res.next == end && parsed == value;
+}
+
+TEST_CASE("Stress generator - deterministic")
+{
+    // Same seed, same stream -- this is what makes a bench regression replayable here.
+    CHECK(stress_gen::Grisu3FallbackValues(64) == stress_gen::Grisu3FallbackValues(64));
+    CHECK(stress_gen::SeventeenDigitValues(64) == stress_gen::SeventeenDigitValues(64));
+    CHECK(stress_gen::ExponentExtremeValues(64) == stress_gen::ExponentExtremeValues(64));
+    CHECK(stress_gen::DigitStrings(64, 18, -300, 300) == stress_gen::DigitStrings(64, 18, -300, 300));
+
+    CHECK(stress_gen::SeventeenDigitValues(64, 1) != stress_gen::SeventeenDigitValues(64, 2));
+}
+
+TEST_CASE("Stress generator - grisu3 fallback")
+{
+    const auto values = stress_gen::Grisu3FallbackValues(TestCount);
+    REQUIRE(values.size() == TestCount);
+
+    for (const double value : values)
+    {
+        CAPTURE(value);
+
+        char buf[grisu3::DtoaMinBufferLength];
+        const auto res = grisu3::Dtoa(buf, value, grisu3::FallbackPolicy::schubfach);
+        CHECK(res.was_fallback);
+
+        // The fallback failure is a property of the value, not of the policy.
+        const auto res_d4 = grisu3::Dtoa(buf, value, grisu3::FallbackPolicy::dragon4);
+        CHECK(res_d4.was_fallback);
+
+        CHECK(RoundTrips(value));
+    }
+}
+
+TEST_CASE("Stress generator - 17 digits shortest")
+{
+    const auto values = stress_gen::SeventeenDigitValues(TestCount);
+    REQUIRE(values.size() == TestCount);
+
+    for (const double value : values)
+    {
+        CAPTURE(value);
+
+        // Count the significant digits of the shortest form independently, from ryu.
+        char buf[ryu::DtoaMaxLength];
+        char* const end = ryu::Dtoa(buf, value);
+
+        int count = 0;
+        int trailing_zeros = 0;
+        bool leading = true;
+        for (char* p = buf; p != end && *p != 'e'; ++p)
+        {
+            if (*p < '0' || *p > '9')
+                continue;
+            if (leading && *p == '0')
+                continue;
+            leading = false;
+            ++count;
+            trailing_zeros = (*p == '0') ? trailing_zeros + 1 : 0;
+        }
+        CHECK(count - trailing_zeros == 17);
+
+        CHECK(RoundTrips(value));
+    }
+}
+
+TEST_CASE("Stress generator - exponent extremes")
+{
+    const auto values = stress_gen::ExponentExtremeValues(TestCount);
+    REQUIRE(values.size() == TestCount);
+
+    for (const double value : values)
+    {
+        CAPTURE(value);
+
+        CHECK(std::isfinite(value));
+        CHECK(value > 0);
+
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint64_t exponent = bits >> 52;
+        CHECK((exponent <= 63 || exponent >= 1983));
+
+        CHECK(RoundTrips(value));
+    }
+}
+
+TEST_CASE("Stress generator - digit strings")
+{
+    for (const int digits : {1, 2, 17, 18})
+    {
+        CAPTURE(digits);
+
+        const auto numbers = stress_gen::DigitStrings(TestCount, digits, -300, 300);
+        REQUIRE(numbers.size() == TestCount);
+
+        for (const std::string& str : numbers)
+        {
+            CAPTURE(str);
+
+            // Exactly 'digits' significant digits: the mantissa is "d" or "d.d...d" with a
+            // nonzero first and last digit, followed by the exponent.
+            const size_t e = str.find('e');
+            REQUIRE(e != std::string::npos);
+            const size_t mantissa_digits = (digits > 1) ? e - 1 : e;
+            CHECK(mantissa_digits == static_cast<size_t>(digits));
+            CHECK(str[0] != '0');
+            CHECK(str[e - 1] != '0');
+
+            // Parses completely, and agrees with the reference parser.
+            double parsed = 0;
+            const auto res = ryu::Strtod(str.data(), str.data() + str.size(), parsed);
+            CHECK(res);
+            CHECK(res.next == str.data() + str.size());
+            CHECK(parsed == std::strtod(str.c_str(), nullptr));
+        }
+    }
+}
@@ -2,15 +2,19 @@
 
 #include "ryu_32.h"
 #include "ryu_64.h"
+#include "scan_number.h"
+#include "schubfach_64.h"
 
 #include "double-conversion/double-conversion.h"
 
 #include <cfloat>
 #include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <limits>
+#include <vector>
 
-#define TEST_LONG_INPUT() 0
+#define TEST_LONG_INPUT() 1
 
 //==================================================================================================
 // Strtod
@@ -459,8 +463,14 @@ TEST_CASE("Strtod - syntax")
     CHECK(check("0.1.2", StrtodStatus::fixed, 3));
     CHECK(check("1 000.0", StrtodStatus::integer, 1));
     CHECK(check("1+2", StrtodStatus::integer, 1));
-    CHECK(check("0x1", StrtodStatus::integer, 1));
-    CHECK(check("0x42", StrtodStatus::integer, 1));
+    CHECK(check("0x1", StrtodStatus::hex));
+    CHECK(check("0x42", StrtodStatus::hex));
+    CHECK(check("0x", StrtodStatus::integer, 1));
+    CHECK(check("0x.p1", StrtodStatus::integer, 1));
+    CHECK(check("-0x1.8p+1", StrtodStatus::hex));
+    CHECK(check("0x1p", StrtodStatus::hex, 3));
+    CHECK(check("0x1p+", StrtodStatus::hex, 3));
+    CHECK(check("0x1.8p-1x", StrtodStatus::hex, 8));
     CHECK(check("-123.123foo", StrtodStatus::fixed, 8));
     CHECK(check("123\345", StrtodStatus::integer, 3));
     CHECK(check("1e1\345", StrtodStatus::scientific, 3));
@@ -561,6 +571,182 @@ TEST_CASE("Strtod - syntax")
 #endif
 }
 
+TEST_CASE("Strtod - hex")
+{
+    using ryu::StrtodStatus;
+
+    auto check = [](const std::string& input, double expected, int consumed = -1)
+    {
+        if (consumed < 0)
+            consumed = static_cast<int>(input.size());
+
+        const char* next = input.data();
+        const char* last = input.data() + input.size();
+
+        double value;
+        const auto res = ryu::Strtod(next, last, value);
+
+        return (res.status == StrtodStatus::hex) && (res.next == next + consumed)
+            && (BitsFromFloat(value) == BitsFromFloat(expected));
+    };
+
+    CHECK(check("0x0p+0", 0.0));
+    CHECK(check("-0x0p+0", -0.0));
+    CHECK(check("0x1p+0", 1.0));
+    CHECK(check("0x1.8p+1", 3.0));
+    CHECK(check("0X1.8P1", 3.0));
+    CHECK(check("0x10p-4", 1.0));
+    CHECK(check("0x.8p1", 1.0));
+    CHECK(check("0x1.p4", 16.0));
+    CHECK(check("0xf", 15.0));
+    CHECK(check("0x1p10", 1024.0));
+    CHECK(check("0x1.999999999999ap-4", 0.1));
+    CHECK(check("0x1p-1074", std::numeric_limits<double>::denorm_min()));
+    CHECK(check("0x1.fffffffffffffp+1023", std::numeric_limits<double>::max()));
+
+    // Subnormals need not be normalized; glibc's printf("%a") keeps the exponent at the
+    // minimum and prints a leading 0 digit instead.
+    CHECK(check("0x0.0000000000001p-1022", std::numeric_limits<double>::denorm_min()));
+    CHECK(check("0x0.4p-1072", std::numeric_limits<double>::denorm_min()));
+
+    // The exponent prefix only counts with at least one digit (like the decimal "1e+"),
+    // and a bare "0x" is not a hex token at all: the subject sequence is just "0".
+    CHECK(check("0x1p", 1.0, 3));
+    CHECK(check("0x1p+", 1.0, 3));
+    CHECK(check("0x1pa", 1.0, 3));
+
+    // Round to nearest, ties to even; dropped digits beyond the 60 accumulated significand
+    // bits still participate via the sticky bit.
+    CHECK(check("0x1.00000000000008p+0", 1.0));                                           // tie: down to even
+    CHECK(check("0x1.00000000000018p+0", 1.0 + 2 * DBL_EPSILON));                         // tie: up to even
+    CHECK(check("0x1.00000000000008000000000000001p+0", 1.0 + DBL_EPSILON));              // above the tie
+    CHECK(check("0x1p-1075", 0.0));                                                       // tie: down to even
+    CHECK(check("0x1.1p-1075", std::numeric_limits<double>::denorm_min()));               // above the tie
+    CHECK(check("0x0.fffffffffffff8p-1022", FloatFromBits(0x0010000000000000)));          // tie: up to the smallest normal
+
+    // Overflow and underflow.
+    CHECK(check("0x1p+1024", std::numeric_limits<double>::infinity()));
+    CHECK(check("0x1.fffffffffffff8p+1023", std::numeric_limits<double>::infinity()));    // tie: up to inf
+    CHECK(check("-0x1p+999999999", -std::numeric_limits<double>::infinity()));
+    CHECK(check("0x1p-2000", 0.0));
+    CHECK(check("0x1p-999999999", 0.0));
+
+    // Against the C library, including digit counts past the accumulator.
+    static const char* const Inputs[] = {
+        "0x123456789abcdef123p0",
+        "0xde.adbeefp-8",
+        "0x1.5555555555555555555555p-2",
+        "0x1234567890abcdef1234567890abcdefp-121",
+        "0x0.00000000000000001234p-1022",
+    };
+    for (const std::string input : Inputs)
+    {
+        double value;
+        const auto res = ryu::Strtod(input.data(), input.data() + input.size(), value);
+        CHECK(res.status == StrtodStatus::hex);
+        CHECK(res.next == input.data() + input.size());
+        CHECK(BitsFromFloat(value) == BitsFromFloat(std::strtod(input.c_str(), nullptr)));
+    }
+
+    // The directed rounding modes apply to hex tokens, too.
+    {
+        const std::string input = "0x1.00000000000001p+0"; // not representable
+
+        double lo;
+        double hi;
+        ryu::StrtodRounded(input.data(), input.data() + input.size(), lo, ryu::StrtodRounding::toward_neg_infinity);
+        ryu::StrtodRounded(input.data(), input.data() + input.size(), hi, ryu::StrtodRounding::toward_pos_infinity);
+        CHECK(BitsFromFloat(lo) == BitsFromFloat(1.0));
+        CHECK(BitsFromFloat(hi) == BitsFromFloat(1.0 + DBL_EPSILON));
+    }
+
+    // DtoaHex output reads back to the exact input bits.
+    uint64_t bits = 0x2F;
+    for (int i = 0; i < 10000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        if ((bits & 0x7FF0000000000000ull) == 0x7FF0000000000000ull)
+            continue; // inf/nan do not use the hex format
+
+        char buf[schubfach::DtoaMaxLength];
+        char* end = schubfach::DtoaHex(buf, FloatFromBits(bits));
+
+        double parsed;
+        const auto res = ryu::Strtod(buf, end, parsed);
+        CHECK(res.status == StrtodStatus::hex);
+        CHECK(res.next == end);
+        CHECK(BitsFromFloat(parsed) == bits);
+    }
+}
+
+TEST_CASE("Strtod - token decomposition")
+{
+    using ryu::StrtodStatus;
+
+    // The result reports the token's value as +-digits * 10^exponent with num_digits
+    // significant digits, so format routing does not need to re-scan the text.
+    auto check = [](const std::string& input, StrtodStatus ec, int64_t num_digits, int64_t exponent)
+    {
+        double value;
+        const auto res = ryu::Strtod(input.data(), input.data() + input.size(), value);
+
+        CAPTURE(input);
+        CHECK(res.status == ec);
+        CHECK(res.num_digits == num_digits);
+        CHECK(res.exponent == exponent);
+    };
+
+    check("0", StrtodStatus::integer, 0, 0);
+    check("000", StrtodStatus::integer, 0, 0);
+    check("123", StrtodStatus::integer, 3, 0);
+    check("-123", StrtodStatus::integer, 3, 0);
+    check("00123", StrtodStatus::integer, 3, 0);
+    check("120", StrtodStatus::integer, 3, 0);
+    check("1.25", StrtodStatus::fixed, 3, -2);
+    check("-1.25", StrtodStatus::fixed, 3, -2);
+    check("0.0150", StrtodStatus::fixed, 3, -4);
+    check("123.000000456", StrtodStatus::fixed, 12, -9);
+    check("1.", StrtodStatus::fixed, 1, 0);
+    check(".5", StrtodStatus::fixed, 1, -1);
+    check("0.000", StrtodStatus::fixed, 0, -3);
+    check("1e3", StrtodStatus::scientific, 1, 3);
+    check("1.5E-7", StrtodStatus::scientific, 2, -8);
+    check("20e1", StrtodStatus::scientific, 2, 1);
+    check("123.456e78", StrtodStatus::scientific, 6, 75);
+    check("-123123e-1000000", StrtodStatus::scientific, 6, -1000000);
+
+    // The decomposition also covers integer tokens past the fast path and long inputs
+    // through the fallback.
+    check("123456789012345678901", StrtodStatus::integer, 21, 0);
+    check("1.23456789012345678901", StrtodStatus::fixed, 21, -20);
+
+    // Both fields are 0 for the invalid/inf/nan statuses.
+    check("", StrtodStatus::invalid, 0, 0);
+    check("foo", StrtodStatus::invalid, 0, 0);
+    check("inf", StrtodStatus::inf, 0, 0);
+    check("-Infinity", StrtodStatus::inf, 0, 0);
+    check("nan", StrtodStatus::nan, 0, 0);
+
+    // Hex tokens are binary, not decimal; both fields are 0 as well.
+    check("0x1.8p+1", StrtodStatus::hex, 0, 0);
+
+    // StrtodJson and StrtodRounded share the scanner and report the same fields.
+    {
+        double value;
+        const auto res = ryu::StrtodJson("1.25e2", "1.25e2" + 6, value);
+        CHECK(res.status == StrtodStatus::scientific);
+        CHECK(res.num_digits == 3);
+        CHECK(res.exponent == 0);
+    }
+    {
+        double value;
+        const auto res = ryu::StrtodRounded("0.0150", "0.0150" + 6, value, ryu::StrtodRounding::toward_zero);
+        CHECK(res.status == StrtodStatus::fixed);
+        CHECK(res.num_digits == 3);
+        CHECK(res.exponent == -4);
+    }
+}
+
 static double Strtod(const std::string& digits, int exponent)
 {
     std::string input = digits;
@@ -1120,3 +1306,684 @@ TEST_CASE("Strtod - Regression")
                "803481241600376705491726170293986797332763671875E-319"));
 #endif
 }
+
+//==================================================================================================
+// StrtodMany
+//==================================================================================================
+
+TEST_CASE("StrtodMany")
+{
+    const std::string input = "1.5,-2e3,0.25,nan,42";
+    double values[8] = {};
+
+    const auto res = ryu::StrtodMany(input.data(), input.data() + input.size(), ',', values, 8);
+    CHECK(res.count == 5);
+    CHECK(res.next == input.data() + input.size());
+    CHECK(values[0] == 1.5);
+    CHECK(values[1] == -2e3);
+    CHECK(values[2] == 0.25);
+    CHECK(std::isnan(values[3]));
+    CHECK(values[4] == 42.0);
+
+    // max_count limits the number of parsed values.
+    const auto res2 = ryu::StrtodMany(input.data(), input.data() + input.size(), ',', values, 2);
+    CHECK(res2.count == 2);
+    CHECK(*res2.next == ',');
+
+    // Parsing stops at the first field that is not a number.
+    const std::string bad = "1.0,x,2.0";
+    const auto res3 = ryu::StrtodMany(bad.data(), bad.data() + bad.size(), ',', values, 8);
+    CHECK(res3.count == 1);
+    CHECK(*res3.next == 'x');
+}
+
+//==================================================================================================
+// StrtodFields
+//==================================================================================================
+
+// StrtodFields must behave exactly like StrtodMany.
+static void CheckFieldsAgainstMany(const std::string& input, size_t count)
+{
+    CAPTURE(input);
+    CAPTURE(count);
+
+    double expected[64] = {};
+    double actual[64] = {};
+    REQUIRE(count <= 64);
+
+    const char* const first = input.data();
+    const char* const last = input.data() + input.size();
+
+    const auto res_many = ryu::StrtodMany(first, last, ',', expected, count);
+    const auto res_fields = ryu::StrtodFields(first, last, ',', actual, count);
+
+    CHECK(res_fields.count == res_many.count);
+    CHECK(res_fields.next == res_many.next);
+    for (size_t i = 0; i < res_many.count; ++i)
+    {
+        CAPTURE(i);
+        CHECK(BitsFromFloat(actual[i]) == BitsFromFloat(expected[i]));
+    }
+}
+
+TEST_CASE("StrtodFields")
+{
+    // The speculative fast path: plain fixed-notation fields.
+    const std::string row = "101.25,-0.0375,42,1250.5,0.0001,-17,3.14159265358979,99.99";
+    double values[8] = {};
+    const auto res = ryu::StrtodFields(row.data(), row.data() + row.size(), ',', values, 8);
+    CHECK(res.count == 8);
+    CHECK(res.next == row.data() + row.size());
+    CHECK(values[0] == 101.25);
+    CHECK(values[1] == -0.0375);
+    CHECK(values[2] == 42.0);
+    CHECK(values[3] == 1250.5);
+    CHECK(values[4] == 0.0001);
+    CHECK(values[5] == -17.0);
+    CHECK(values[6] == 3.14159265358979);
+    CHECK(values[7] == 99.99);
+
+    CheckFieldsAgainstMany(row, 8);
+    CheckFieldsAgainstMany(row, 5); // count < fields: stop at the separator
+    CheckFieldsAgainstMany(row, 3); // tail handled by the serial loop
+    CheckFieldsAgainstMany(row, 64); // count > fields
+
+    // Fields the speculation must hand over to Strtod.
+    CheckFieldsAgainstMany("1e3,-2.5e-7,inf,nan,0.1,2,3,4", 8);
+    CheckFieldsAgainstMany("-0,0.00000000000000000001,9007199254740993,123456789012345678,1,2,3,4", 8);
+
+    // Failures in every lane position.
+    CheckFieldsAgainstMany("x,1,2,3,4,5,6,7", 8);
+    CheckFieldsAgainstMany("1,x,2,3,4,5,6,7", 8);
+    CheckFieldsAgainstMany("1,2,x,3,4,5,6,7", 8);
+    CheckFieldsAgainstMany("1,2,3,x,4,5,6,7", 8);
+    CheckFieldsAgainstMany("1,2,3,4,5,x,6,7", 8);
+
+    // Partially consumed and empty fields.
+    CheckFieldsAgainstMany("1.5x,2,3,4,5,6,7,8", 8);
+    CheckFieldsAgainstMany("1,,2,3,4,5,6,7", 8);
+    CheckFieldsAgainstMany("1,2,3,4,", 8);
+    CheckFieldsAgainstMany("", 8);
+    CheckFieldsAgainstMany("1.2.3,1,2,3", 4);
+
+    // Round-trip parity on random rows of 8 shortest-form fields.
+    uint64_t bits = 0x5851F42D4C957F2Dull;
+    for (int iter = 0; iter < 2000; ++iter)
+    {
+        std::string line;
+        double inputs[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+            const uint64_t b = bits & 0x7FEFFFFFFFFFFFFFull;
+            inputs[i] = FloatFromBits(b);
+
+            char buf[schubfach::DtoaMaxLength];
+            char* end = schubfach::Dtoa(buf, inputs[i]);
+            if (i != 0)
+                line += ',';
+            line.append(buf, end);
+        }
+
+        double parsed[8] = {};
+        const auto r = ryu::StrtodFields(line.data(), line.data() + line.size(), ',', parsed, 8);
+        CAPTURE(line);
+        CHECK(r.count == 8);
+        for (int i = 0; i < 8; ++i)
+        {
+            CHECK(BitsFromFloat(parsed[i]) == BitsFromFloat(inputs[i]));
+        }
+    }
+}
+
+//==================================================================================================
+// StrtodBulk
+//==================================================================================================
+
+TEST_CASE("StrtodBulk")
+{
+    double values[8] = {};
+
+    // A clean chunk parses like StrtodMany and reports the status of its last field.
+    const std::string input = "1.5,-2e3,0.25";
+    const auto res = ryu::StrtodBulk(input.data(), input.data() + input.size(), ',', values, 8);
+    CHECK(static_cast<bool>(res));
+    CHECK(res.count == 3);
+    CHECK(res.next == input.data() + input.size());
+    CHECK(res.status == ryu::StrtodStatus::fixed);
+    CHECK(values[0] == 1.5);
+    CHECK(values[1] == -2e3);
+    CHECK(values[2] == 0.25);
+
+    // A bad field is reported with its byte offset, and next resumes after it.
+    const std::string bad = "1.0,x7,2.0,?,3.0";
+    const char* next = bad.data();
+    const char* const last = bad.data() + bad.size();
+
+    const auto res2 = ryu::StrtodBulk(next, last, ',', values, 8);
+    CHECK(!res2);
+    CHECK(res2.count == 1);
+    CHECK(res2.error_offset == 4);
+    CHECK(res2.status == ryu::StrtodStatus::invalid);
+    CHECK(values[0] == 1.0);
+    next = res2.next;
+    CHECK(*next == '2');
+
+    const auto res3 = ryu::StrtodBulk(next, last, ',', values, 8);
+    CHECK(!res3);
+    CHECK(res3.count == 1);
+    CHECK(res3.error_offset == 4);
+    CHECK(bad.data() + (next - bad.data()) + res3.error_offset == bad.data() + 11);
+    CHECK(values[0] == 2.0);
+    next = res3.next;
+
+    const auto res4 = ryu::StrtodBulk(next, last, ',', values, 8);
+    CHECK(static_cast<bool>(res4));
+    CHECK(res4.count == 1);
+    CHECK(res4.next == last);
+    CHECK(values[0] == 3.0);
+
+    // max_count stops the chunk with next at the start of the following field.
+    const auto res5 = ryu::StrtodBulk(input.data(), input.data() + input.size(), ',', values, 2);
+    CHECK(static_cast<bool>(res5));
+    CHECK(res5.count == 2);
+    CHECK(*res5.next == '0');
+
+    // An empty chunk fails at offset 0.
+    const auto res6 = ryu::StrtodBulk(input.data(), input.data(), ',', values, 8);
+    CHECK(!res6);
+    CHECK(res6.count == 0);
+    CHECK(res6.error_offset == 0);
+
+    // A trailing separator leaves an empty final field, which fails at the end of the chunk.
+    const std::string trailing = "1,2,";
+    const auto res7 = ryu::StrtodBulk(trailing.data(), trailing.data() + trailing.size(), ',', values, 8);
+    CHECK(!res7);
+    CHECK(res7.count == 2);
+    CHECK(res7.error_offset == 4);
+    CHECK(res7.next == trailing.data() + trailing.size());
+}
+
+//==================================================================================================
+// StrtodValidated
+//==================================================================================================
+
+TEST_CASE("StrtodValidated")
+{
+    // The two-stage bulk parse: validate first (ScanNumberMany), then convert the recorded
+    // tokens only.
+    const std::string input = "1.5,-2e3,0.25,42,0.0000001";
+    drachennest::ScanNumberToken tokens[8];
+    const auto res = drachennest::ScanNumberMany(input.data(), input.data() + input.size(), ',', tokens, 8);
+    REQUIRE(res.status == drachennest::ScanNumberStatus::ok);
+    REQUIRE(res.count == 5);
+
+    double values[8] = {};
+    ryu::StrtodValidated(input.data(), tokens, res.count, values);
+    CHECK(values[0] == 1.5);
+    CHECK(values[1] == -2e3);
+    CHECK(values[2] == 0.25);
+    CHECK(values[3] == 42.0);
+    CHECK(values[4] == 0.0000001);
+
+    // Random round-trips through the full two-stage pipeline.
+    uint64_t bits = 0x000000000000004D;
+    std::string buffer;
+    std::vector<double> expected;
+    for (int i = 0; i < 1000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        bits &= 0x7FEFFFFFFFFFFFFF; // keep it finite
+
+        const double value = FloatFromBits(bits);
+        char buf[schubfach::DtoaMaxLength];
+        if (i != 0)
+            buffer += ',';
+        buffer.append(buf, schubfach::Dtoa(buf, value));
+        expected.push_back(value);
+    }
+
+    std::vector<drachennest::ScanNumberToken> all_tokens(expected.size());
+    const auto res2 = drachennest::ScanNumberMany(buffer.data(), buffer.data() + buffer.size(), ',', all_tokens.data(), all_tokens.size());
+    REQUIRE(res2.status == drachennest::ScanNumberStatus::ok);
+    REQUIRE(res2.count == expected.size());
+
+    std::vector<double> parsed(expected.size());
+    ryu::StrtodValidated(buffer.data(), all_tokens.data(), res2.count, parsed.data());
+    CHECK(parsed == expected);
+}
+
+//==================================================================================================
+// StrtofMany
+//==================================================================================================
+
+TEST_CASE("StrtofMany")
+{
+    const std::string input = "1.5,-2e3,0.25,nan,42";
+    float values[8] = {};
+
+    const auto res = ryu::StrtofMany(input.data(), input.data() + input.size(), ',', values, 8);
+    CHECK(res.count == 5);
+    CHECK(res.next == input.data() + input.size());
+    CHECK(values[0] == 1.5f);
+    CHECK(values[1] == -2e3f);
+    CHECK(values[2] == 0.25f);
+    CHECK(std::isnan(values[3]));
+    CHECK(values[4] == 42.0f);
+
+    // max_count limits the number of parsed values.
+    const auto res2 = ryu::StrtofMany(input.data(), input.data() + input.size(), ',', values, 2);
+    CHECK(res2.count == 2);
+    CHECK(*res2.next == ',');
+
+    // Parsing stops at the first field that is not a number.
+    const std::string bad = "1.0,x,2.0";
+    const auto res3 = ryu::StrtofMany(bad.data(), bad.data() + bad.size(), ',', values, 8);
+    CHECK(res3.count == 1);
+    CHECK(*res3.next == 'x');
+}
+
+//==================================================================================================
+// StrtodJson
+//==================================================================================================
+
+static bool JsonAccepts(const std::string& input, double expected)
+{
+    double value = 0;
+    const auto res = ryu::StrtodJson(input.data(), input.data() + input.size(), value);
+    return static_cast<bool>(res) && res.next == input.data() + input.size() && value == expected;
+}
+
+// Returns the error offset, or -1 if the input (unexpectedly) parsed.
+static int JsonRejectsAt(const std::string& input)
+{
+    double value = 0;
+    const auto res = ryu::StrtodJson(input.data(), input.data() + input.size(), value);
+    if (res)
+        return -1;
+    return static_cast<int>(res.next - input.data());
+}
+
+TEST_CASE("StrtodJson")
+{
+    CHECK(JsonAccepts("0", 0.0));
+    CHECK(JsonAccepts("-0", -0.0));
+    CHECK(JsonAccepts("42", 42.0));
+    CHECK(JsonAccepts("-1", -1.0));
+    CHECK(JsonAccepts("0.5", 0.5));
+    CHECK(JsonAccepts("1.5e3", 1.5e3));
+    CHECK(JsonAccepts("1E+3", 1e3));
+    CHECK(JsonAccepts("2e-308", 2e-308));
+    CHECK(JsonAccepts("123456789012345678901234567890", 123456789012345678901234567890.0));
+
+    CHECK(JsonRejectsAt("") == 0);
+    CHECK(JsonRejectsAt("+1") == 0);    // no leading '+'
+    CHECK(JsonRejectsAt(".5") == 0);    // no leading '.'
+    CHECK(JsonRejectsAt("-.5") == 1);
+    CHECK(JsonRejectsAt("01") == 1);    // no redundant leading zeros
+    CHECK(JsonRejectsAt("-00") == 2);
+    CHECK(JsonRejectsAt("1.") == 2);    // no trailing '.'
+    CHECK(JsonRejectsAt("1.e3") == 2);
+    CHECK(JsonRejectsAt("1e") == 2);    // exponent prefix requires digits
+    CHECK(JsonRejectsAt("1e+") == 3);
+    CHECK(JsonRejectsAt("1e-x") == 3);
+    CHECK(JsonRejectsAt("inf") == 0);
+    CHECK(JsonRejectsAt("nan") == 0);
+    CHECK(JsonRejectsAt("-inf") == 1);
+
+    // Like Strtod, trailing characters are not consumed (the caller decides whether the
+    // terminator is valid).
+    {
+        const std::string input = "1.25,";
+        double value = 0;
+        const auto res = ryu::StrtodJson(input.data(), input.data() + input.size(), value);
+        CHECK(static_cast<bool>(res));
+        CHECK(value == 1.25);
+        CHECK(*res.next == ',');
+    }
+}
+
+//==================================================================================================
+// StrtodRounded
+//==================================================================================================
+
+static double ParseRounded(const std::string& input, ryu::StrtodRounding rounding)
+{
+    double value = 0;
+    const auto res = ryu::StrtodRounded(input.data(), input.data() + input.size(), value, rounding);
+    CHECK(static_cast<bool>(res));
+    CHECK(res.next == input.data() + input.size());
+    return value;
+}
+
+TEST_CASE("StrtodRounded - exact inputs")
+{
+    using ryu::StrtodRounding;
+
+    // Exactly representable inputs convert to the same double in every mode.
+    // (Note: the shortest round-trip spelling of a double is usually *not* exact -- see the
+    // denorm_min/max checks in the directed test case below.)
+    for (const char* input : {
+             "0", "1", "-1", "1.5", "-2500", "0.25", "9007199254740991", "1e22",
+             "3.0517578125e-05", "0.0001220703125", // 2^-15, 2^-13
+             // the exact decimal expansion of the double nearest to 0.1 (> 17 digits)
+             "0.1000000000000000055511151231257827021181583404541015625",
+         })
+    {
+        CAPTURE(input);
+        const double expected = ParseRounded(input, StrtodRounding::nearest_even);
+        CHECK(BitsFromFloat(ParseRounded(input, StrtodRounding::toward_zero)) == BitsFromFloat(expected));
+        CHECK(BitsFromFloat(ParseRounded(input, StrtodRounding::toward_neg_infinity)) == BitsFromFloat(expected));
+        CHECK(BitsFromFloat(ParseRounded(input, StrtodRounding::toward_pos_infinity)) == BitsFromFloat(expected));
+    }
+}
+
+TEST_CASE("StrtodRounded - directed")
+{
+    using ryu::StrtodRounding;
+
+    const double d01 = 0.1; // > 1/10 (nearest-even rounds up)
+    const double d01_pred = FloatFromBits(BitsFromFloat(d01) - 1);
+    CHECK(ParseRounded("0.1", StrtodRounding::nearest_even) == d01);
+    CHECK(ParseRounded("0.1", StrtodRounding::toward_zero) == d01_pred);
+    CHECK(ParseRounded("0.1", StrtodRounding::toward_neg_infinity) == d01_pred);
+    CHECK(ParseRounded("0.1", StrtodRounding::toward_pos_infinity) == d01);
+
+    CHECK(ParseRounded("-0.1", StrtodRounding::toward_zero) == -d01_pred);
+    CHECK(ParseRounded("-0.1", StrtodRounding::toward_neg_infinity) == -d01);
+    CHECK(ParseRounded("-0.1", StrtodRounding::toward_pos_infinity) == -d01_pred);
+
+    const double d03 = 0.3; // < 3/10 (nearest-even rounds down)
+    const double d03_succ = FloatFromBits(BitsFromFloat(d03) + 1);
+    CHECK(ParseRounded("0.3", StrtodRounding::toward_zero) == d03);
+    CHECK(ParseRounded("0.3", StrtodRounding::toward_neg_infinity) == d03);
+    CHECK(ParseRounded("0.3", StrtodRounding::toward_pos_infinity) == d03_succ);
+
+    // Overflow: rounding toward zero never leaves the finite range.
+    const double max = std::numeric_limits<double>::max();
+    const double inf = std::numeric_limits<double>::infinity();
+    CHECK(ParseRounded("1e400", StrtodRounding::nearest_even) == inf);
+    CHECK(ParseRounded("1e400", StrtodRounding::toward_zero) == max);
+    CHECK(ParseRounded("1e400", StrtodRounding::toward_neg_infinity) == max);
+    CHECK(ParseRounded("1e400", StrtodRounding::toward_pos_infinity) == inf);
+    CHECK(ParseRounded("-1e400", StrtodRounding::toward_zero) == -max);
+    CHECK(ParseRounded("-1e400", StrtodRounding::toward_neg_infinity) == -inf);
+    CHECK(ParseRounded("-1e400", StrtodRounding::toward_pos_infinity) == -max);
+    CHECK(ParseRounded("2e308", StrtodRounding::nearest_even) == inf); // overflows inside the conversion
+    CHECK(ParseRounded("2e308", StrtodRounding::toward_zero) == max);
+
+    // Underflow: a non-zero input never flushes to zero when rounded away from zero.
+    const double denorm_min = std::numeric_limits<double>::denorm_min();
+    CHECK(ParseRounded("1e-400", StrtodRounding::nearest_even) == 0.0);
+    CHECK(ParseRounded("1e-400", StrtodRounding::toward_zero) == 0.0);
+    CHECK(ParseRounded("1e-400", StrtodRounding::toward_pos_infinity) == denorm_min);
+    CHECK(BitsFromFloat(ParseRounded("1e-400", StrtodRounding::toward_neg_infinity)) == BitsFromFloat(0.0));
+    CHECK(ParseRounded("-1e-400", StrtodRounding::toward_neg_infinity) == -denorm_min);
+    CHECK(BitsFromFloat(ParseRounded("-1e-400", StrtodRounding::toward_pos_infinity)) == BitsFromFloat(-0.0));
+    CHECK(ParseRounded("3e-324", StrtodRounding::nearest_even) == denorm_min); // below denorm_min, above half of it
+    CHECK(ParseRounded("3e-324", StrtodRounding::toward_zero) == 0.0);
+    CHECK(ParseRounded("3e-324", StrtodRounding::toward_pos_infinity) == denorm_min);
+
+    // The shortest round-trip spellings of denorm_min and max are strictly below the exact
+    // values, so rounding toward zero lands one double lower.
+    CHECK(ParseRounded("4.9406564584124654e-324", StrtodRounding::toward_zero) == 0.0);
+    CHECK(ParseRounded("4.9406564584124654e-324", StrtodRounding::toward_pos_infinity) == denorm_min);
+    CHECK(ParseRounded("1.7976931348623157e+308", StrtodRounding::toward_zero) == FloatFromBits(BitsFromFloat(max) - 1));
+    CHECK(ParseRounded("1.7976931348623157e+308", StrtodRounding::toward_pos_infinity) == max);
+
+    // Long inputs (> 17 significant digits) take the big-integer slow path. The exact decimal
+    // expansion of the double nearest to 0.1, minus resp. plus one unit in the last decimal
+    // place, lies strictly below resp. above that double.
+    const std::string exact01 = "0.1000000000000000055511151231257827021181583404541015625";
+    const std::string below = exact01.substr(0, exact01.size() - 1); // ...51562
+    const std::string above = exact01 + "1";                         // ...156251
+    CHECK(ParseRounded(below, StrtodRounding::nearest_even) == d01);
+    CHECK(ParseRounded(below, StrtodRounding::toward_zero) == d01_pred);
+    CHECK(ParseRounded(below, StrtodRounding::toward_pos_infinity) == d01);
+    CHECK(ParseRounded(above, StrtodRounding::toward_zero) == d01);
+    CHECK(ParseRounded(above, StrtodRounding::toward_pos_infinity) == FloatFromBits(BitsFromFloat(d01) + 1));
+}
+
+TEST_CASE("StrtodRounded - brackets the exact value")
+{
+    using ryu::StrtodRounding;
+
+    uint64_t bits = 1;
+    for (int i = 0; i < 10000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        bits &= 0x7FEFFFFFFFFFFFFF; // exclude Inf/NaN
+
+        double value;
+        std::memcpy(&value, &bits, sizeof(double));
+
+        // Decimal spellings of varying precision: shorter than the shortest round-trip form
+        // (inexact), round-trip exact, and long enough for the big-integer slow path.
+        for (const char* format : {"%.8e", "%.17e", "%.25e"})
+        {
+            char buf[64];
+            const int len = snprintf(buf, sizeof(buf), format, value);
+            const std::string input(buf, len);
+            CAPTURE(input);
+
+            const double nearest = ParseRounded(input, StrtodRounding::nearest_even);
+            const double lo = ParseRounded(input, StrtodRounding::toward_neg_infinity);
+            const double hi = ParseRounded(input, StrtodRounding::toward_pos_infinity);
+            const double to_zero = ParseRounded(input, StrtodRounding::toward_zero);
+
+            // nearest_even is equivalent to Strtod.
+            double via_strtod = 0;
+            ryu::Strtod(input.data(), input.data() + input.size(), via_strtod);
+            CHECK(BitsFromFloat(nearest) == BitsFromFloat(via_strtod));
+
+            // [lo, hi] is a certified interval of width <= 1 ULP around the exact value, and
+            // the nearest double is one of its endpoints.
+            CHECK(lo <= hi);
+            CHECK((lo == hi || std::nextafter(lo, std::numeric_limits<double>::infinity()) == hi));
+            CHECK((BitsFromFloat(nearest) == BitsFromFloat(lo) || BitsFromFloat(nearest) == BitsFromFloat(hi)));
+
+            // toward_zero picks the endpoint with the smaller magnitude.
+            CHECK(BitsFromFloat(to_zero) == BitsFromFloat(value < 0 ? hi : lo));
+        }
+    }
+}
+
+//==================================================================================================
+// StrtodChunked
+//==================================================================================================
+
+// Feeds the given segments to a StrtodChunked parser and checks that value, status and the
+// number of consumed characters agree with Strtod on the concatenated input.
+static bool ChunkedAgreesWithStrtod(const std::vector<std::string>& segments)
+{
+    std::string input;
+    for (const std::string& seg : segments)
+        input += seg;
+
+    double expected_value = 0;
+    const auto expected = ryu::Strtod(input.data(), input.data() + input.size(), expected_value);
+
+    ryu::StrtodChunked parser;
+    size_t fed = 0;        // #characters handed to the parser
+    size_t unconsumed = 0; // #characters Feed returned in the last segment
+    for (const std::string& seg : segments)
+    {
+        const char* const seg_last = seg.data() + seg.size();
+        const char* const p = parser.Feed(seg.data(), seg_last);
+        fed += seg.size();
+        if (p != seg_last)
+        {
+            unconsumed = static_cast<size_t>(seg_last - p);
+            break;
+        }
+    }
+
+    double value = 0;
+    const auto res = parser.Finish(value);
+
+    if (res.status != expected.status)
+        return false;
+
+    const size_t consumed = fed - unconsumed - res.retract;
+    if (consumed != static_cast<size_t>(expected.next - input.data()))
+        return false;
+
+    if (static_cast<bool>(expected) || expected.status == ryu::StrtodStatus::inf || expected.status == ryu::StrtodStatus::nan)
+    {
+        if (BitsFromFloat(value) != BitsFromFloat(expected_value))
+            return false;
+    }
+
+    return true;
+}
+
+// Checks the whole input at once, every two-way split, and one character at a time.
+static bool ChunkedAgreesWithStrtodForAllSplits(const std::string& input)
+{
+    if (!ChunkedAgreesWithStrtod({input}))
+        return false;
+
+    for (size_t i = 0; i <= input.size(); ++i)
+    {
+        if (!ChunkedAgreesWithStrtod({input.substr(0, i), input.substr(i)}))
+            return false;
+    }
+
+    std::vector<std::string> chars;
+    for (const char ch : input)
+        chars.emplace_back(1, ch);
+    return ChunkedAgreesWithStrtod(chars);
+}
+
+TEST_CASE("StrtodChunked - agrees with Strtod")
+{
+    for (const char* input : {
+             // valid numbers
+             "0", "-0", "1", "-1", "+1", "1.5", "-1.5", ".5", "-.25", "1.", "0.125",
+             "0.0625e+2", "12345678901234567", "17976931348623157", "1e308", "1e-308",
+             "4.9406564584124654e-324", "1.7976931348623157e+308", "123e65", "1E+22",
+             "1e-2", "1e+05", "1e00005", "0e+1", "00", "012", "0.000125", "123.456e-789",
+             "-1e+9999", "123123e+1000000",
+             // trailing garbage, incomplete exponents ("0x42" is excluded: hex tokens are a
+             // documented exception, Strtod accepts them but the chunked parser stops at 'x')
+             "0x", "1e", "1e+", "1e-", "1.5e", "1.5e+x", "1e+5x", "1.2a-3", "-1x",
+             "-1.0.", "0.1.2", "1 000.0", "1+2", "1e5e5", "12e+x",
+             // specials (including incomplete/overlong spellings)
+             "inf", "-inf", "Infinity", "-INF", "in", "infi", "infini", "infinix",
+             "infinityy", "nan", "NaN", "-nan", "na", "nanx",
+             // invalid
+             "", "-", "+", ".", ".x", "x", "e5", "+e5",
+         })
+    {
+        CAPTURE(input);
+        CHECK(ChunkedAgreesWithStrtodForAllSplits(input));
+    }
+}
+
+TEST_CASE("StrtodChunked - retract")
+{
+    using ryu::StrtodStatus;
+
+    // "12e" "+" "x": the exponent prefix straddles two segment boundaries and turns out not
+    // to be an exponent. The 'x' is returned by Feed; the 'e' and the '+' were consumed in
+    // previous segments and must be given back via retract.
+    {
+        ryu::StrtodChunked parser;
+        const char* const seg1 = "12e";
+        const char* const seg2 = "+";
+        const char* const seg3 = "x";
+        CHECK(parser.Feed(seg1, seg1 + 3) == seg1 + 3);
+        CHECK(parser.Feed(seg2, seg2 + 1) == seg2 + 1);
+        CHECK(parser.Feed(seg3, seg3 + 1) == seg3);
+
+        double value = 0;
+        const auto res = parser.Finish(value);
+        CHECK(res.status == StrtodStatus::integer);
+        CHECK(res.retract == 2);
+        CHECK(value == 12.0);
+    }
+
+    // If the tentative characters lie in the current segment, Feed already excludes them
+    // from its result pointer and retract is 0.
+    {
+        ryu::StrtodChunked parser;
+        const char* const seg = "12e+x";
+        CHECK(parser.Feed(seg, seg + 5) == seg + 2);
+
+        double value = 0;
+        const auto res = parser.Finish(value);
+        CHECK(res.status == StrtodStatus::integer);
+        CHECK(res.retract == 0);
+        CHECK(value == 12.0);
+    }
+
+    // An "inf" that fails to extend to "infinity" at end-of-input.
+    {
+        ryu::StrtodChunked parser;
+        const char* const seg1 = "-inf";
+        const char* const seg2 = "ini";
+        CHECK(parser.Feed(seg1, seg1 + 4) == seg1 + 4);
+        CHECK(parser.Feed(seg2, seg2 + 3) == seg2 + 3);
+
+        double value = 0;
+        const auto res = parser.Finish(value);
+        CHECK(res.status == StrtodStatus::inf);
+        CHECK(res.retract == 3);
+        CHECK(value == -std::numeric_limits<double>::infinity());
+    }
+}
+
+TEST_CASE("StrtodChunked - limitations")
+{
+    using ryu::StrtodStatus;
+
+    // More than 17 significant digits: the digits are no longer available as a contiguous
+    // string, so the parser cannot fall back to a slower algorithm.
+    {
+        ryu::StrtodChunked parser;
+        const char* const seg1 = "123456789";
+        const char* const seg2 = "012345678";
+        CHECK(parser.Feed(seg1, seg1 + 9) == seg1 + 9);
+        CHECK(parser.Feed(seg2, seg2 + 9) == seg2 + 9);
+
+        double value = 0;
+        const auto res = parser.Finish(value);
+        CHECK(res.status == StrtodStatus::input_too_long);
+        CHECK(!static_cast<bool>(res));
+    }
+
+    // A "nan(...)" payload is not consumed.
+    {
+        ryu::StrtodChunked parser;
+        const char* const seg = "nan(12)";
+        CHECK(parser.Feed(seg, seg + 7) == seg + 3);
+
+        double value = 0;
+        const auto res = parser.Finish(value);
+        CHECK(res.status == StrtodStatus::nan);
+        CHECK(res.retract == 0);
+        CHECK(std::isnan(value));
+    }
+
+    // Reset allows the parser to be reused for the next number.
+    {
+        ryu::StrtodChunked parser;
+        const char* const seg1 = "1.";
+        const char* const seg2 = "5";
+        CHECK(parser.Feed(seg1, seg1 + 2) == seg1 + 2);
+        CHECK(parser.Feed(seg2, seg2 + 1) == seg2 + 1);
+
+        double value = 0;
+        CHECK(parser.Finish(value).status == StrtodStatus::fixed);
+        CHECK(value == 1.5);
+
+        parser.Reset();
+        const char* const seg3 = "2e";
+        const char* const seg4 = "3";
+        CHECK(parser.Feed(seg3, seg3 + 2) == seg3 + 2);
+        CHECK(parser.Feed(seg4, seg4 + 1) == seg4 + 1);
+
+        CHECK(parser.Finish(value).status == StrtodStatus::scientific);
+        CHECK(value == 2e3);
+    }
+}
@@ -0,0 +1,110 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include "../src/parse_file.h"
+#include "../src/write_file.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using drachennest::FileWriter;
+using drachennest::ParseFile;
+
+static std::string ReadAll(const char* path)
+{
+    std::string content;
+    std::FILE* const file = std::fopen(path, "rb");
+    REQUIRE(file != nullptr);
+    for (;;)
+    {
+        char buf[256];
+        const size_t n = std::fread(buf, 1, sizeof(buf), file);
+        content.append(buf, n);
+        if (n < sizeof(buf))
+            break;
+    }
+    std::fclose(file);
+    return content;
+}
+
+TEST_CASE("FileWriter")
+{
+    const char* const path = "test_write_file.tmp";
+
+    {
+        FileWriter writer(path);
+        REQUIRE(writer.IsOpen());
+        writer.WriteChars("# column a\n", 11);
+        writer.Write(1.5);
+        writer.Write(-2.5e3);
+        writer.Write(0.25, ',');
+        CHECK(writer.Finish());
+    }
+    CHECK(ReadAll(path) == "# column a\n1.5\n-2500\n0.25,");
+
+    std::remove(path);
+}
+
+TEST_CASE("FileWriter roundtrip")
+{
+    const char* const path = "test_write_file.tmp";
+
+    // Use a tiny buffer so the values are spread over many buffer swaps, and check that the
+    // file parses back to the same values.
+    std::vector<double> values;
+    for (int i = 0; i < 10000; ++i)
+        values.push_back(i * 1.0e-3);
+
+    {
+        FileWriter writer(path, /*buffer_size*/ 256);
+        REQUIRE(writer.IsOpen());
+        writer.Write(values.data(), values.size());
+        CHECK(writer.Finish());
+    }
+
+    std::vector<double> parsed(values.size());
+    const auto res = ParseFile(path, parsed.data(), parsed.size());
+    CHECK(static_cast<bool>(res));
+    REQUIRE(res.num_values == values.size());
+    for (size_t i = 0; i != values.size(); ++i)
+    {
+        if (parsed[i] != values[i])
+        {
+            CHECK(parsed[i] == values[i]);
+            break;
+        }
+    }
+
+    std::remove(path);
+}
+
+TEST_CASE("FileWriter minimal buffer")
+{
+    const char* const path = "test_write_file.tmp";
+
+    // A caller-supplied buffer_size below the minimum is raised to one worst-case number
+    // plus its separator; writing the longest output must not overrun the buffer.
+    {
+        FileWriter writer(path, /*buffer_size*/ 1);
+        REQUIRE(writer.IsOpen());
+        writer.Write(-1.2551272886980568e-7); // "-0.00000012551272886980568" (26 chars)
+        writer.Write(-1.2551272886980568e-7, ',');
+        CHECK(writer.Finish());
+    }
+    CHECK(ReadAll(path) == "-0.00000012551272886980568\n-0.00000012551272886980568,");
+
+    std::remove(path);
+}
+
+TEST_CASE("FileWriter open failure")
+{
+    FileWriter writer("no/such/directory/test_write_file.tmp");
+    CHECK(!writer.IsOpen());
+    writer.Write(1.0); // dropped, must not crash
+    CHECK(!writer.Finish());
+}
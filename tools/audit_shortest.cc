@@ -0,0 +1,312 @@
+// Copyright 2020 Alexander Bolz
+//
+// Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+// audit_shortest [--threads=N] [--max-report=N] FILE...
+//
+// Audits files of newline-separated numeric text for values that are not in shortest
+// round-trip form (see bench/results/grisu2_not_short.png for how such values get into
+// stored datasets in the first place). Each file is memory-mapped and scanned in parallel:
+// every record is validated with the streaming scanner (drachennest::ScanNumber, i.e. the
+// RFC 8259 number grammar), parsed with ryu::Strtod, and re-formatted with schubfach::Dtoa;
+// a record whose text differs from the re-formatted output is an offender.
+//
+// Offenders (and records that are not valid numbers) are printed with their byte offset:
+//
+//  data.txt:174282: "2.5999999999999996e+17" -> "2.6e+17"
+//  data.txt:174305: not a number: "1e"
+//
+// --threads=N     number of worker threads (default: one per hardware thread)
+// --max-report=N  print at most N lines per file (default 100; 0 prints none, the summary
+//                 and the exit code still cover all records)
+//
+// Exit code: 0 if every record of every file is in shortest form, 1 if there are offenders
+// or invalid records, 2 on I/O or usage errors.
+
+#include "scan_number.h"
+#include "ryu_64.h"
+#include "schubfach_64.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct Offender {
+    size_t offset;        // byte offset of the record
+    std::string token;    // the record text
+    std::string shortest; // the shortest form, or empty if the record is not a number
+};
+
+struct ChunkReport {
+    size_t num_records = 0;
+    size_t num_offenders = 0;
+    size_t num_invalid = 0;
+    std::vector<Offender> offenders; // capped at max_report entries per chunk
+};
+
+// Returns the end of the record starting at 'next': one past the next '\n', or 'last'.
+inline const char* FindRecordEnd(const char* next, const char* last)
+{
+    const void* const nl = std::memchr(next, '\n', static_cast<size_t>(last - next));
+    if (nl == nullptr)
+        return last;
+    return static_cast<const char*>(nl) + 1;
+}
+
+// Strips the record separator (and a preceding '\r') from [next, end).
+inline const char* TrimRecordEnd(const char* next, const char* end)
+{
+    if (end != next && end[-1] == '\n')
+        --end;
+    if (end != next && end[-1] == '\r')
+        --end;
+    return end;
+}
+
+void AuditRecords(const char* base, const char* next, const char* last, size_t max_report, ChunkReport& out)
+{
+    while (next != last)
+    {
+        const char* const end = FindRecordEnd(next, last);
+        const char* const field_end = TrimRecordEnd(next, end);
+        if (field_end != next) // skip empty lines
+        {
+            ++out.num_records;
+
+            const auto scan = drachennest::ScanNumber(next, field_end);
+            if (scan.status != drachennest::ScanNumberStatus::ok || scan.next != field_end)
+            {
+                ++out.num_invalid;
+                if (out.offenders.size() < max_report)
+                    out.offenders.push_back({static_cast<size_t>(next - base), std::string(next, field_end), std::string()});
+            }
+            else
+            {
+                double value = 0;
+                ryu::Strtod(next, field_end, value); // cannot fail: the grammar accepted above is a subset of Strtod's
+
+                char buf[schubfach::DtoaMaxLength];
+                char* const buf_end = schubfach::Dtoa(buf, value);
+
+                if (buf_end - buf != field_end - next || std::memcmp(buf, next, static_cast<size_t>(buf_end - buf)) != 0)
+                {
+                    ++out.num_offenders;
+                    if (out.offenders.size() < max_report)
+                        out.offenders.push_back({static_cast<size_t>(next - base), std::string(next, field_end), std::string(buf, buf_end)});
+                }
+            }
+        }
+        next = end;
+    }
+}
+
+void AuditBuffer(const char* first, const char* last, int num_threads, size_t max_report, std::vector<ChunkReport>& reports)
+{
+    const size_t size = static_cast<size_t>(last - first);
+
+    if (num_threads <= 0)
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (num_threads < 1)
+        num_threads = 1;
+
+    // Below this size the thread fan-out costs more than it saves.
+    constexpr size_t MinBytesPerThread = 1u << 16;
+    if (size / MinBytesPerThread < static_cast<size_t>(num_threads))
+        num_threads = static_cast<int>(size / MinBytesPerThread) + 1;
+
+    // Split [first, last) into one byte range per thread, moving each split point forward to
+    // the next record boundary, so no record is ever audited by two threads.
+    std::vector<const char*> bounds;
+    bounds.push_back(first);
+    for (int i = 1; bounds.back() != last; ++i)
+    {
+        const char* chunk_last = last;
+        if (i < num_threads)
+        {
+            chunk_last = first + (size / static_cast<size_t>(num_threads)) * static_cast<size_t>(i);
+            if (chunk_last < bounds.back()) // a record spanning multiple split points
+                chunk_last = bounds.back();
+            chunk_last = FindRecordEnd(chunk_last, last);
+        }
+        bounds.push_back(chunk_last);
+    }
+
+    const size_t num_chunks = bounds.size() - 1;
+    reports.resize(num_chunks);
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < num_chunks; ++i)
+    {
+        threads.emplace_back([&, i] {
+            AuditRecords(first, bounds[i], bounds[i + 1], max_report, reports[i]);
+        });
+    }
+    if (num_chunks != 0)
+        AuditRecords(first, bounds[0], bounds[1], max_report, reports[0]);
+    for (auto& t : threads)
+        t.join();
+}
+
+// Audits the given file; returns 0/1/2 as documented above.
+int AuditFile(const char* path, int num_threads, size_t max_report)
+{
+    const auto start_time = std::chrono::steady_clock::now();
+
+    const char* first = nullptr;
+    size_t size = 0;
+
+#if defined(_WIN32)
+    const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        std::fprintf(stderr, "audit_shortest: cannot open %s\n", path);
+        return 2;
+    }
+    LARGE_INTEGER file_size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart != 0)
+    {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr)
+        {
+            first = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            size = static_cast<size_t>(file_size.QuadPart);
+        }
+        if (first == nullptr)
+        {
+            if (mapping != nullptr)
+                CloseHandle(mapping);
+            CloseHandle(file);
+            std::fprintf(stderr, "audit_shortest: cannot map %s\n", path);
+            return 2;
+        }
+    }
+#else
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        std::fprintf(stderr, "audit_shortest: cannot open %s\n", path);
+        return 2;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 0)
+    {
+        close(fd);
+        std::fprintf(stderr, "audit_shortest: cannot stat %s\n", path);
+        return 2;
+    }
+    if (st.st_size != 0)
+    {
+        size = static_cast<size_t>(st.st_size);
+        void* const data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            std::fprintf(stderr, "audit_shortest: cannot map %s\n", path);
+            return 2;
+        }
+        first = static_cast<const char*>(data);
+    }
+#endif
+
+    std::vector<ChunkReport> reports;
+    AuditBuffer(first, first + size, num_threads, max_report, reports);
+
+#if defined(_WIN32)
+    if (first != nullptr)
+    {
+        UnmapViewOfFile(first);
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+#else
+    if (first != nullptr)
+        munmap(const_cast<char*>(first), size);
+    close(fd);
+#endif
+
+    // Print the collected offenders (the chunks are in file order, so this is offset order)
+    // and the per-file summary.
+    size_t num_records = 0;
+    size_t num_offenders = 0;
+    size_t num_invalid = 0;
+    size_t num_printed = 0;
+    for (const ChunkReport& report : reports)
+    {
+        num_records += report.num_records;
+        num_offenders += report.num_offenders;
+        num_invalid += report.num_invalid;
+        for (const Offender& off : report.offenders)
+        {
+            if (num_printed >= max_report)
+                break;
+            ++num_printed;
+            if (off.shortest.empty())
+                std::printf("%s:%zu: not a number: \"%s\"\n", path, off.offset, off.token.c_str());
+            else
+                std::printf("%s:%zu: \"%s\" -> \"%s\"\n", path, off.offset, off.token.c_str(), off.shortest.c_str());
+        }
+    }
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    std::fprintf(stderr, "%s: %zu records, %zu not shortest, %zu invalid (%.0f MB/s)\n",
+        path, num_records, num_offenders, num_invalid,
+        elapsed > 0 ? static_cast<double>(size) / (1024.0 * 1024.0) / elapsed : 0.0);
+
+    return (num_offenders != 0 || num_invalid != 0) ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int num_threads = 0;
+    size_t max_report = 100;
+
+    int exit_code = 0;
+    int num_files = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* const arg = argv[i];
+        if (std::strncmp(arg, "--threads=", 10) == 0)
+        {
+            num_threads = std::atoi(arg + 10);
+        }
+        else if (std::strncmp(arg, "--max-report=", 13) == 0)
+        {
+            max_report = static_cast<size_t>(std::atoll(arg + 13));
+        }
+        else
+        {
+            ++num_files;
+            const int rc = AuditFile(arg, num_threads, max_report);
+            if (rc > exit_code)
+                exit_code = rc;
+        }
+    }
+
+    if (num_files == 0)
+    {
+        std::fprintf(stderr, "usage: audit_shortest [--threads=N] [--max-report=N] FILE...\n");
+        return 2;
+    }
+    return exit_code;
+}